@@ -136,6 +136,7 @@ ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
         VPATH += $(QUANTUM_DIR)/pointing_device
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device.c
         SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_drivers.c
+        SRC += $(QUANTUM_DIR)/pointing_device/pointing_device_accel.c
         ifneq ($(strip $(POINTING_DEVICE_DRIVER)), custom)
             SRC += drivers/sensors/$(strip $(POINTING_DEVICE_DRIVER)).c
             OPT_DEFS += -DPOINTING_DEVICE_DRIVER_$(strip $(shell echo $(POINTING_DEVICE_DRIVER) | tr '[:lower:]' '[:upper:]'))
@@ -675,6 +676,7 @@ ifeq ($(strip $(SPLIT_KEYBOARD)), yes)
                        $(QUANTUM_DIR)/split_common/transactions.c
 
         OPT_DEFS += -DSPLIT_COMMON_TRANSACTIONS
+        QUANTUM_LIB_SRC += transaction_batch.c
 
         # Functions added via QUANTUM_LIB_SRC are only included in the final binary if they're called.
         # Unused functions are pruned away, which is why we can add multiple drivers here without bloat.
@@ -790,6 +792,9 @@ ifeq ($(strip $(SEND_STRING_ENABLE)), yes)
     OPT_DEFS += -DSEND_STRING_ENABLE
     COMMON_VPATH += $(QUANTUM_DIR)/send_string
     SRC += $(QUANTUM_DIR)/send_string/send_string.c
+    ifeq ($(strip $(SEND_STRING_ASYNC_ENABLE)), yes)
+        OPT_DEFS += -DSEND_STRING_ASYNC_ENABLE
+    endif
 endif
 
 ifeq ($(strip $(AUTO_SHIFT_ENABLE)), yes)
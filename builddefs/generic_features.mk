@@ -29,12 +29,14 @@ GENERIC_FEATURES = \
     HAPTIC \
     KEY_LOCK \
     KEY_OVERRIDE \
+    LATENCY_TRACE \
     LEADER \
     PROGRAMMABLE_BUTTON \
     SECURE \
     SPACE_CADET \
     SWAP_HANDS \
     TAP_DANCE \
+    TASK_SCHEDULER \
     VELOCIKEY \
     WPM \
     DYNAMIC_TAPPING_TERM \
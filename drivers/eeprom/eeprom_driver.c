@@ -19,41 +19,187 @@
 
 #include "eeprom_driver.h"
 
+#ifdef EEPROM_WRITE_BEHIND
+#    include "debug.h"
+#    include "timer.h"
+
+_Static_assert(EEPROM_WRITE_BEHIND_ENTRY_SIZE <= 255, "EEPROM_WRITE_BEHIND_ENTRY_SIZE must fit in a byte");
+
+typedef struct {
+    uintptr_t address;
+    uint8_t   size; // zero when the entry is free
+    uint8_t   data[EEPROM_WRITE_BEHIND_ENTRY_SIZE];
+} pending_write_t;
+
+// Entries never overlap, so at most one of them holds the latest value of any given byte
+static pending_write_t             pending_writes[EEPROM_WRITE_BEHIND_ENTRIES];
+static uint8_t                     next_eviction = 0;
+static uint32_t                    last_write    = 0;
+static eeprom_write_behind_stats_t write_behind_stats;
+
+static bool ranges_overlap(uintptr_t a, size_t a_len, uintptr_t b, size_t b_len) {
+    return a < b + b_len && b < a + a_len;
+}
+
+static bool ranges_touch(uintptr_t a, size_t a_len, uintptr_t b, size_t b_len) {
+    return a <= b + b_len && b <= a + a_len;
+}
+
+static void pending_write_flush(pending_write_t *entry) {
+    uint8_t stored[EEPROM_WRITE_BEHIND_ENTRY_SIZE];
+    eeprom_read_block(stored, (const void *)entry->address, entry->size);
+    // Values that were changed and then changed back cost nothing
+    if (memcmp(stored, entry->data, entry->size) != 0) {
+        eeprom_write_block(entry->data, (void *)entry->address, entry->size);
+        write_behind_stats.written += entry->size;
+    }
+    entry->size = 0;
+}
+
+static void buffered_read_block(void *buf, const void *addr, size_t len) {
+    uintptr_t address = (uintptr_t)addr;
+    eeprom_read_block(buf, addr, len);
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        pending_write_t *entry = &pending_writes[i];
+        if (entry->size && ranges_overlap(entry->address, entry->size, address, len)) {
+            uintptr_t start = entry->address > address ? entry->address : address;
+            uintptr_t end   = entry->address + entry->size < address + len ? entry->address + entry->size : address + len;
+            memcpy((uint8_t *)buf + (start - address), &entry->data[start - entry->address], end - start);
+        }
+    }
+}
+
+static void buffered_write_block(const void *buf, void *addr, size_t len) {
+    uintptr_t        address = (uintptr_t)addr;
+    pending_write_t *target  = NULL;
+
+    write_behind_stats.requested += len;
+    last_write = timer_read32();
+
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        pending_write_t *entry = &pending_writes[i];
+        if (!entry->size) {
+            continue;
+        }
+        uintptr_t start = entry->address < address ? entry->address : address;
+        uintptr_t end   = entry->address + entry->size > address + len ? entry->address + entry->size : address + len;
+        if (!target && ranges_touch(entry->address, entry->size, address, len) && end - start <= EEPROM_WRITE_BEHIND_ENTRY_SIZE) {
+            target = entry;
+        } else if (entry->address >= address && entry->address + entry->size <= address + len) {
+            // Completely overwritten, so there is no point in writing it out
+            entry->size = 0;
+        } else if (ranges_overlap(entry->address, entry->size, address, len)) {
+            // The older data has to land first, so that the new write ends up on top
+            pending_write_flush(entry);
+        }
+    }
+
+    if (len > EEPROM_WRITE_BEHIND_ENTRY_SIZE) {
+        eeprom_write_block(buf, addr, len);
+        write_behind_stats.written += len;
+        return;
+    }
+
+    if (target) {
+        // Grow the entry to cover both ranges, keeping its existing data in place
+        uintptr_t start = target->address < address ? target->address : address;
+        uintptr_t end   = target->address + target->size > address + len ? target->address + target->size : address + len;
+        memmove(&target->data[target->address - start], target->data, target->size);
+        target->address = start;
+        target->size    = end - start;
+    } else {
+        for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES && !target; i++) {
+            if (!pending_writes[i].size) {
+                target = &pending_writes[i];
+            }
+        }
+        if (!target) {
+            target        = &pending_writes[next_eviction];
+            next_eviction = (next_eviction + 1) % EEPROM_WRITE_BEHIND_ENTRIES;
+            pending_write_flush(target);
+        }
+        target->address = address;
+        target->size    = len;
+    }
+    memcpy(&target->data[address - target->address], buf, len);
+}
+
+static bool has_pending_writes(void) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        if (pending_writes[i].size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void eeprom_driver_flush(void) {
+    if (!has_pending_writes()) {
+        return;
+    }
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        if (pending_writes[i].size) {
+            pending_write_flush(&pending_writes[i]);
+        }
+    }
+    dprintf("EEPROM write-behind: %lu of %lu bytes written\n", (unsigned long)write_behind_stats.written, (unsigned long)write_behind_stats.requested);
+}
+
+void eeprom_driver_discard(void) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        pending_writes[i].size = 0;
+    }
+}
+
+void eeprom_driver_task(void) {
+    if (has_pending_writes() && timer_elapsed32(last_write) >= EEPROM_WRITE_BEHIND_TIMEOUT) {
+        eeprom_driver_flush();
+    }
+}
+
+void eeprom_driver_get_write_behind_stats(eeprom_write_behind_stats_t *stats) {
+    *stats = write_behind_stats;
+}
+#else
+#    define buffered_read_block eeprom_read_block
+#    define buffered_write_block eeprom_write_block
+#endif
+
 uint8_t eeprom_read_byte(const uint8_t *addr) {
     uint8_t ret = 0;
-    eeprom_read_block(&ret, addr, 1);
+    buffered_read_block(&ret, addr, 1);
     return ret;
 }
 
 uint16_t eeprom_read_word(const uint16_t *addr) {
     uint16_t ret = 0;
-    eeprom_read_block(&ret, addr, 2);
+    buffered_read_block(&ret, addr, 2);
     return ret;
 }
 
 uint32_t eeprom_read_dword(const uint32_t *addr) {
     uint32_t ret = 0;
-    eeprom_read_block(&ret, addr, 4);
+    buffered_read_block(&ret, addr, 4);
     return ret;
 }
 
 void eeprom_write_byte(uint8_t *addr, uint8_t value) {
-    eeprom_write_block(&value, addr, 1);
+    buffered_write_block(&value, addr, 1);
 }
 
 void eeprom_write_word(uint16_t *addr, uint16_t value) {
-    eeprom_write_block(&value, addr, 2);
+    buffered_write_block(&value, addr, 2);
 }
 
 void eeprom_write_dword(uint32_t *addr, uint32_t value) {
-    eeprom_write_block(&value, addr, 4);
+    buffered_write_block(&value, addr, 4);
 }
 
 void eeprom_update_block(const void *buf, void *addr, size_t len) {
     uint8_t read_buf[len];
-    eeprom_read_block(read_buf, addr, len);
+    buffered_read_block(read_buf, addr, len);
     if (memcmp(buf, read_buf, len) != 0) {
-        eeprom_write_block(buf, addr, len);
+        buffered_write_block(buf, addr, len);
     }
 }
 
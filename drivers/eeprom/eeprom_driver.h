@@ -20,3 +20,43 @@
 
 void eeprom_driver_init(void);
 void eeprom_driver_erase(void);
+
+#ifdef EEPROM_WRITE_BEHIND
+/* Write-behind buffer for the byte/word/dword/update helpers.
+ *
+ * Small writes are held in RAM and merged with later writes to the same or
+ * adjacent addresses, then handed to the driver once nothing has been written
+ * for EEPROM_WRITE_BEHIND_TIMEOUT milliseconds. Reads through the helpers see
+ * pending data. eeprom_read_block() and eeprom_write_block() belong to the
+ * driver itself and bypass the buffer, so call eeprom_driver_flush() first if
+ * the same range may also have been written through the helpers.
+ */
+
+#    ifndef EEPROM_WRITE_BEHIND_ENTRIES
+#        define EEPROM_WRITE_BEHIND_ENTRIES 4
+#    endif
+
+#    ifndef EEPROM_WRITE_BEHIND_ENTRY_SIZE
+#        define EEPROM_WRITE_BEHIND_ENTRY_SIZE 16
+#    endif
+
+#    ifndef EEPROM_WRITE_BEHIND_TIMEOUT
+#        define EEPROM_WRITE_BEHIND_TIMEOUT 2000
+#    endif
+
+typedef struct {
+    uint32_t requested; // bytes the helpers were asked to change
+    uint32_t written;   // bytes actually handed to the driver
+} eeprom_write_behind_stats_t;
+
+/* Writes out everything pending */
+void eeprom_driver_flush(void);
+
+/* Drops everything pending without writing it, for when the contents are about to be erased */
+void eeprom_driver_discard(void);
+
+/* Writes out everything pending once the quiet period has passed */
+void eeprom_driver_task(void);
+
+void eeprom_driver_get_write_behind_stats(eeprom_write_behind_stats_t *stats);
+#endif
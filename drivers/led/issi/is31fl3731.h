@@ -46,6 +46,11 @@ void IS31FL3731_set_led_control_register(uint8_t index, bool red, bool green, bo
 void IS31FL3731_update_pwm_buffers(uint8_t addr, uint8_t index);
 void IS31FL3731_update_led_control_registers(uint8_t addr, uint8_t index);
 
+#ifdef DEBUG_ISSI_FLUSH_RATE
+// Bytes of PWM data sent to the drivers over the last second
+uint32_t IS31FL3731_get_flush_rate(void);
+#endif
+
 #define C1_1 0x24
 #define C1_2 0x25
 #define C1_3 0x26
@@ -44,10 +44,15 @@ void IS31FL3733_set_led_control_register(uint8_t index, bool red, bool green, bo
 // This should not be called from an interrupt
 // (eg. from a timer interrupt).
 // Call this while idle (in between matrix scans).
-// If the buffer is dirty, it will update the driver with the buffer.
+// Only the pages of the buffer that have changed are sent to the driver.
 void IS31FL3733_update_pwm_buffers(uint8_t addr, uint8_t index);
 void IS31FL3733_update_led_control_registers(uint8_t addr, uint8_t index);
 
+#ifdef DEBUG_ISSI_FLUSH_RATE
+// Bytes of PWM data sent to the drivers over the last second
+uint32_t IS31FL3733_get_flush_rate(void);
+#endif
+
 #define PUR_0R 0x00   // No PUR resistor
 #define PUR_05KR 0x02 // 0.5k Ohm resistor in t_NOL
 #define PUR_3KR 0x03  // 3.0k Ohm resistor on all the time
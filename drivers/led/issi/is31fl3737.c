@@ -17,9 +17,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <string.h>
 #include "is31fl3737.h"
 #include "i2c_master.h"
 #include "wait.h"
+#ifdef DEBUG_ISSI_FLUSH_RATE
+#    include "timer.h"
+#endif
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -73,6 +77,15 @@
 #    define ISSI_GLOBALCURRENT 0xFF
 #endif
 
+#if defined(ISSI_ASYNC_FLUSH) && !defined(I2C_ASYNC_ENABLE)
+#    error "ISSI_ASYNC_FLUSH requires I2C_ASYNC_ENABLE"
+#endif
+
+// The PWM registers are flushed in pages of 16, with a dirty bit per page
+#define ISSI_PWM_PAGE_SIZE 16
+#define ISSI_PWM_PAGE_COUNT (192 / ISSI_PWM_PAGE_SIZE)
+#define ISSI_PWM_PAGES_ALL ((1 << ISSI_PWM_PAGE_COUNT) - 1)
+
 // Transfer buffer for TWITransmitData()
 uint8_t g_twi_transfer_buffer[20];
 
@@ -83,8 +96,39 @@ uint8_t g_twi_transfer_buffer[20];
 // buffers and the transfers in IS31FL3737_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
 
-uint8_t g_pwm_buffer[DRIVER_COUNT][192];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[DRIVER_COUNT][192];
+uint16_t g_pwm_buffer_dirty_pages[DRIVER_COUNT] = {0};
+
+#ifdef ISSI_ASYNC_FLUSH
+// Staging copy of the PWM registers being flushed, which must outlive the asynchronous transfer
+static uint8_t g_pwm_async_buffer[1 + 192];
+static uint8_t g_pwm_async_length = 0;
+static uint8_t g_pwm_async_addr   = 0;
+static int8_t  g_pwm_async_driver = -1;
+#endif
+
+#ifdef DEBUG_ISSI_FLUSH_RATE
+static uint32_t g_flush_timer      = 0;
+static uint32_t g_flush_bytes      = 0;
+static uint32_t g_last_flush_bytes = 0;
+
+static void IS31FL3737_flush_rate_task(uint16_t bytes) {
+    g_flush_bytes += bytes;
+
+    uint32_t timer_now = timer_read32();
+    if (TIMER_DIFF_32(timer_now, g_flush_timer) >= 1000) {
+        g_last_flush_bytes = g_flush_bytes;
+        g_flush_timer      = timer_now;
+        g_flush_bytes      = 0;
+    }
+}
+
+uint32_t IS31FL3737_get_flush_rate(void) {
+    return g_last_flush_bytes;
+}
+#else
+#    define IS31FL3737_flush_rate_task(bytes)
+#endif
 
 uint8_t g_led_control_registers[DRIVER_COUNT][24]             = {0};
 bool    g_led_control_registers_update_required[DRIVER_COUNT] = {false};
@@ -102,30 +146,80 @@ void IS31FL3737_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+// Returns false if any page failed to send
+static bool IS31FL3737_write_pwm_pages(uint8_t addr, uint8_t *pwm_buffer, uint16_t pages) {
     // assumes PG1 is already selected
 
-    // transmit PWM registers in 12 transfers of 16 bytes
+    // transmit each requested page of PWM registers as a transfer of 16 bytes
     // g_twi_transfer_buffer[] is 20 bytes
 
-    // iterate over the pwm_buffer contents at 16 byte intervals
-    for (int i = 0; i < 192; i += 16) {
+    for (uint8_t page = 0; page < ISSI_PWM_PAGE_COUNT; page++) {
+        if (!(pages & (1 << page))) {
+            continue;
+        }
+
+        uint8_t i                = page * ISSI_PWM_PAGE_SIZE;
         g_twi_transfer_buffer[0] = i;
         // copy the data from i to i+15
         // device will auto-increment register for data after the first byte
         // thus this sets registers 0x00-0x0F, 0x10-0x1F, etc. in one transfer
-        for (int j = 0; j < 16; j++) {
-            g_twi_transfer_buffer[1 + j] = pwm_buffer[i + j];
-        }
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, ISSI_PWM_PAGE_SIZE);
 
 #if ISSI_PERSISTENCE > 0
-        for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0) break;
+        bool sent = false;
+        for (uint8_t i = 0; i < ISSI_PERSISTENCE && !sent; i++) {
+            sent = i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) == 0;
+        }
+        if (!sent) {
+            return false;
         }
 #else
-        i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT);
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 17, ISSI_TIMEOUT) != 0) {
+            return false;
+        }
 #endif
+        IS31FL3737_flush_rate_task(17);
     }
+    return true;
+}
+
+#ifdef ISSI_ASYNC_FLUSH
+static bool IS31FL3737_write_pwm_pages_async(uint8_t addr, uint8_t *pwm_buffer, uint16_t pages) {
+    // A single transfer spans the first to the last dirty page, any clean pages in between are resent as-is.
+    uint8_t first  = __builtin_ctz(pages) * ISSI_PWM_PAGE_SIZE;
+    uint8_t length = (32 - __builtin_clz(pages)) * ISSI_PWM_PAGE_SIZE - first;
+
+    g_pwm_async_buffer[0] = first;
+    memcpy(g_pwm_async_buffer + 1, pwm_buffer + first, length);
+    IS31FL3737_flush_rate_task(length + 1);
+    g_pwm_async_addr   = addr;
+    g_pwm_async_length = length + 1;
+    return i2c_transmit_async(addr << 1, g_pwm_async_buffer, length + 1, ISSI_TIMEOUT) == I2C_STATUS_SUCCESS;
+}
+
+// Waits for the background transfer started by IS31FL3737_write_pwm_pages_async()
+static bool IS31FL3737_settle_pwm_pages_async(void) {
+    bool sent = i2c_async_wait() == I2C_STATUS_SUCCESS;
+#    if ISSI_PERSISTENCE > 0
+    // Like the synchronous path, retry a failed transfer up to ISSI_PERSISTENCE times in all
+    if (!sent && ISSI_PERSISTENCE > 1) {
+        // Other registers may have been written since, so select PG1 again
+        IS31FL3737_write_register(g_pwm_async_addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
+        IS31FL3737_write_register(g_pwm_async_addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
+    }
+    for (uint8_t i = 1; i < ISSI_PERSISTENCE && !sent; i++) {
+        sent = i2c_transmit(g_pwm_async_addr << 1, g_pwm_async_buffer, g_pwm_async_length, ISSI_TIMEOUT) == 0;
+    }
+#    endif
+    return sent;
+}
+#endif
+
+void IS31FL3737_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    // assumes PG1 is already selected
+
+    // transmit PWM registers in 12 transfers of 16 bytes
+    IS31FL3737_write_pwm_pages(addr, pwm_buffer, ISSI_PWM_PAGES_ALL);
 }
 
 void IS31FL3737_init(uint8_t addr) {
@@ -154,6 +248,10 @@ void IS31FL3737_init(uint8_t addr) {
     for (int i = 0x00; i <= 0xBF; i++) {
         IS31FL3737_write_register(addr, i, 0x00);
     }
+    // The buffer no longer matches the chip and only the address is known here so resend every driver
+    for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+        g_pwm_buffer_dirty_pages[i] = ISSI_PWM_PAGES_ALL;
+    }
 
     // Unlock the command register.
     IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
@@ -173,15 +271,22 @@ void IS31FL3737_init(uint8_t addr) {
     wait_ms(10);
 }
 
+// Only registers whose value changes mark their page dirty, so effects that rewrite every LED each frame flush just the difference
+static inline void IS31FL3737_set_pwm(uint8_t driver, uint8_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_pages[driver] |= 1 << (reg / ISSI_PWM_PAGE_SIZE);
+    }
+}
+
 void IS31FL3737_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3737_set_pwm(led.driver, led.r, red);
+        IS31FL3737_set_pwm(led.driver, led.g, green);
+        IS31FL3737_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -222,14 +327,31 @@ void IS31FL3737_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void IS31FL3737_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
+#ifdef ISSI_ASYNC_FLUSH
+    // Settle the previous background flush; if it still failed, that driver is in an unknown state so resend everything
+    if (g_pwm_async_driver >= 0 && !IS31FL3737_settle_pwm_pages_async()) {
+        g_pwm_buffer_dirty_pages[g_pwm_async_driver] = ISSI_PWM_PAGES_ALL;
+    }
+    g_pwm_async_driver = -1;
+#endif
+
+    if (g_pwm_buffer_dirty_pages[index]) {
         // Firstly we need to unlock the command register and select PG1
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
         IS31FL3737_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM);
 
-        IS31FL3737_write_pwm_buffer(addr, g_pwm_buffer[index]);
+#ifdef ISSI_ASYNC_FLUSH
+        bool sent = IS31FL3737_write_pwm_pages_async(addr, g_pwm_buffer[index], g_pwm_buffer_dirty_pages[index]);
+        if (sent) {
+            g_pwm_async_driver = index;
+        }
+#else
+        bool sent = IS31FL3737_write_pwm_pages(addr, g_pwm_buffer[index], g_pwm_buffer_dirty_pages[index]);
+#endif
+        // Pages that didn't make it may have been partly written, so resend everything next time
+        g_pwm_buffer_dirty_pages[index] = sent ? 0 : ISSI_PWM_PAGES_ALL;
     }
-    g_pwm_buffer_update_required[index] = false;
+    IS31FL3737_flush_rate_task(0);
 }
 
 void IS31FL3737_update_led_control_registers(uint8_t addr, uint8_t index) {
@@ -48,6 +48,11 @@ void IS31FL3737_set_led_control_register(uint8_t index, bool red, bool green, bo
 void IS31FL3737_update_pwm_buffers(uint8_t addr1, uint8_t addr2);
 void IS31FL3737_update_led_control_registers(uint8_t addr1, uint8_t addr2);
 
+#ifdef DEBUG_ISSI_FLUSH_RATE
+// Bytes of PWM data sent to the drivers over the last second
+uint32_t IS31FL3737_get_flush_rate(void);
+#endif
+
 #define PUR_0R 0x00   // No PUR resistor
 #define PUR_05KR 0x01 // 0.5k Ohm resistor in t_NOL
 #define PUR_1KR 0x02  // 1.0k Ohm resistor in t_NOL
@@ -23,6 +23,10 @@
 #include <string.h>
 #include "i2c_master.h"
 #include "progmem.h"
+#include "util.h"
+#ifdef DEBUG_ISSI_FLUSH_RATE
+#    include "timer.h"
+#endif
 
 // This is a 7-bit address, that gets left-shifted and bit 0
 // set to 0 for write, 1 for read (as per I2C protocol)
@@ -75,6 +79,13 @@
 
 #define ISSI_MAX_LEDS 351
 
+// The PWM registers are flushed in chunks of 18, with a dirty bit per chunk.
+// PG0 holds the first 180 registers, PG1 the remaining 171 (ending in a 9 byte chunk).
+#define ISSI_PWM_CHUNK_SIZE 18
+#define ISSI_PWM_CHUNK_COUNT ((ISSI_MAX_LEDS + ISSI_PWM_CHUNK_SIZE - 1) / ISSI_PWM_CHUNK_SIZE)
+#define ISSI_PWM_CHUNKS_ALL ((1UL << ISSI_PWM_CHUNK_COUNT) - 1)
+#define ISSI_PWM_PAGE_SIZE 180
+
 // Transfer buffer for TWITransmitData()
 uint8_t g_twi_transfer_buffer[20] = {0xFF};
 
@@ -84,12 +95,35 @@ uint8_t g_twi_transfer_buffer[20] = {0xFF};
 // We could optimize this and take out the unused registers from these
 // buffers and the transfers in IS31FL3741_write_pwm_buffer() but it's
 // probably not worth the extra complexity.
-uint8_t g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
-bool    g_pwm_buffer_update_required[DRIVER_COUNT]        = {false};
-bool    g_scaling_registers_update_required[DRIVER_COUNT] = {false};
+uint8_t  g_pwm_buffer[DRIVER_COUNT][ISSI_MAX_LEDS];
+uint32_t g_pwm_buffer_dirty_chunks[DRIVER_COUNT]           = {0};
+bool     g_scaling_registers_update_required[DRIVER_COUNT] = {false};
 
 uint8_t g_scaling_registers[DRIVER_COUNT][ISSI_MAX_LEDS];
 
+#ifdef DEBUG_ISSI_FLUSH_RATE
+static uint32_t g_flush_timer      = 0;
+static uint32_t g_flush_bytes      = 0;
+static uint32_t g_last_flush_bytes = 0;
+
+static void IS31FL3741_flush_rate_task(uint16_t bytes) {
+    g_flush_bytes += bytes;
+
+    uint32_t timer_now = timer_read32();
+    if (TIMER_DIFF_32(timer_now, g_flush_timer) >= 1000) {
+        g_last_flush_bytes = g_flush_bytes;
+        g_flush_timer      = timer_now;
+        g_flush_bytes      = 0;
+    }
+}
+
+uint32_t IS31FL3741_get_flush_rate(void) {
+    return g_last_flush_bytes;
+}
+#else
+#    define IS31FL3741_flush_rate_task(bytes)
+#endif
+
 void IS31FL3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
     g_twi_transfer_buffer[0] = reg;
     g_twi_transfer_buffer[1] = data;
@@ -103,53 +137,49 @@ void IS31FL3741_write_register(uint8_t addr, uint8_t reg, uint8_t data) {
 #endif
 }
 
-bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
-    // unlock the command register and select PG2
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-    IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM0);
+static bool IS31FL3741_write_pwm_chunks(uint8_t addr, uint8_t *pwm_buffer, uint32_t chunks) {
+    uint8_t page = 0xFF;
 
-    for (int i = 0; i < 342; i += 18) {
-        if (i == 180) {
-            // unlock the command register and select PG2
+    for (uint8_t chunk = 0; chunk < ISSI_PWM_CHUNK_COUNT; chunk++) {
+        if (!(chunks & (1UL << chunk))) {
+            continue;
+        }
+
+        uint16_t i      = chunk * ISSI_PWM_CHUNK_SIZE;
+        uint8_t  length = MIN(ISSI_PWM_CHUNK_SIZE, ISSI_MAX_LEDS - i);
+
+        // only switch to a page when one of its chunks needs sending
+        if (page != i / ISSI_PWM_PAGE_SIZE) {
+            page = i / ISSI_PWM_PAGE_SIZE;
+            // unlock the command register and select PG0 or PG1
             IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER_WRITELOCK, 0xC5);
-            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, ISSI_PAGE_PWM1);
+            IS31FL3741_write_register(addr, ISSI_COMMANDREGISTER, page == 0 ? ISSI_PAGE_PWM0 : ISSI_PAGE_PWM1);
         }
 
-        g_twi_transfer_buffer[0] = i % 180;
-        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, 18);
+        g_twi_transfer_buffer[0] = i % ISSI_PWM_PAGE_SIZE;
+        memcpy(g_twi_transfer_buffer + 1, pwm_buffer + i, length);
 
 #if ISSI_PERSISTENCE > 0
         for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
+            if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
                 return false;
             }
         }
 #else
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 19, ISSI_TIMEOUT) != 0) {
+        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, length + 1, ISSI_TIMEOUT) != 0) {
             return false;
         }
 #endif
+        IS31FL3741_flush_rate_task(length + 1);
     }
 
-    // transfer the left cause the total number is 351
-    g_twi_transfer_buffer[0] = 162;
-    memcpy(g_twi_transfer_buffer + 1, pwm_buffer + 342, 9);
-
-#if ISSI_PERSISTENCE > 0
-    for (uint8_t i = 0; i < ISSI_PERSISTENCE; i++) {
-        if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
-            return false;
-        }
-    }
-#else
-    if (i2c_transmit(addr << 1, g_twi_transfer_buffer, 10, ISSI_TIMEOUT) != 0) {
-        return false;
-    }
-#endif
-
     return true;
 }
 
+bool IS31FL3741_write_pwm_buffer(uint8_t addr, uint8_t *pwm_buffer) {
+    return IS31FL3741_write_pwm_chunks(addr, pwm_buffer, ISSI_PWM_CHUNKS_ALL);
+}
+
 void IS31FL3741_init(uint8_t addr) {
     // In order to avoid the LEDs being driven with garbage data
     // in the LED driver's PWM registers, shutdown is enabled last.
@@ -173,19 +203,31 @@ void IS31FL3741_init(uint8_t addr) {
 
     // IS31FL3741_update_led_scaling_registers(addr, 0xFF, 0xFF, 0xFF);
 
+    // The chip may have been reset behind the buffer's back and only the address is known here so resend every driver
+    for (uint8_t i = 0; i < DRIVER_COUNT; i++) {
+        g_pwm_buffer_dirty_chunks[i] = ISSI_PWM_CHUNKS_ALL;
+    }
+
     // Wait 10ms to ensure the device has woken up.
     wait_ms(10);
 }
 
+// Only registers whose value changes mark their chunk dirty, so effects that rewrite every LED each frame flush just the difference
+static inline void IS31FL3741_set_pwm(uint8_t driver, uint16_t reg, uint8_t value) {
+    if (g_pwm_buffer[driver][reg] != value) {
+        g_pwm_buffer[driver][reg] = value;
+        g_pwm_buffer_dirty_chunks[driver] |= 1UL << (reg / ISSI_PWM_CHUNK_SIZE);
+    }
+}
+
 void IS31FL3741_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
     is31_led led;
     if (index >= 0 && index < DRIVER_LED_TOTAL) {
         memcpy_P(&led, (&g_is31_leds[index]), sizeof(led));
 
-        g_pwm_buffer[led.driver][led.r]          = red;
-        g_pwm_buffer[led.driver][led.g]          = green;
-        g_pwm_buffer[led.driver][led.b]          = blue;
-        g_pwm_buffer_update_required[led.driver] = true;
+        IS31FL3741_set_pwm(led.driver, led.r, red);
+        IS31FL3741_set_pwm(led.driver, led.g, green);
+        IS31FL3741_set_pwm(led.driver, led.b, blue);
     }
 }
 
@@ -221,19 +263,17 @@ void IS31FL3741_set_led_control_register(uint8_t index, bool red, bool green, bo
 }
 
 void IS31FL3741_update_pwm_buffers(uint8_t addr, uint8_t index) {
-    if (g_pwm_buffer_update_required[index]) {
-        IS31FL3741_write_pwm_buffer(addr, g_pwm_buffer[index]);
+    if (g_pwm_buffer_dirty_chunks[index]) {
+        // Chunks that didn't make it may have been partly written, so resend everything next time
+        g_pwm_buffer_dirty_chunks[index] = IS31FL3741_write_pwm_chunks(addr, g_pwm_buffer[index], g_pwm_buffer_dirty_chunks[index]) ? 0 : ISSI_PWM_CHUNKS_ALL;
     }
-
-    g_pwm_buffer_update_required[index] = false;
+    IS31FL3741_flush_rate_task(0);
 }
 
 void IS31FL3741_set_pwm_buffer(const is31_led *pled, uint8_t red, uint8_t green, uint8_t blue) {
-    g_pwm_buffer[pled->driver][pled->r] = red;
-    g_pwm_buffer[pled->driver][pled->g] = green;
-    g_pwm_buffer[pled->driver][pled->b] = blue;
-
-    g_pwm_buffer_update_required[pled->driver] = true;
+    IS31FL3741_set_pwm(pled->driver, pled->r, red);
+    IS31FL3741_set_pwm(pled->driver, pled->g, green);
+    IS31FL3741_set_pwm(pled->driver, pled->b, blue);
 }
 
 void IS31FL3741_update_led_control_registers(uint8_t addr, uint8_t index) {
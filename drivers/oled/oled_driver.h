@@ -170,6 +170,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #    define OLED_UPDATE_INTERVAL 50
 #endif
 
+#if !defined(OLED_RENDER_INTERVAL)
+#    define OLED_RENDER_INTERVAL 0
+#endif
+
 typedef struct __attribute__((__packed__)) {
     uint8_t *current_element;
     uint16_t remaining_element_count;
@@ -199,6 +203,9 @@ void oled_clear(void);
 // Renders the dirty chunks of the buffer to oled display
 void oled_render(void);
 
+// Returns the time in milliseconds taken to send the last frame, from its first chunk to its last
+uint32_t oled_render_time(void);
+
 // Moves cursor to character position indicated by column and line, wraps if out of bounds
 // Max column denoted by 'oled_max_chars()' and max lines by 'oled_max_lines()' functions
 void oled_set_cursor(uint8_t col, uint8_t line);
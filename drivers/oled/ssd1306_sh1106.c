@@ -105,6 +105,10 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #define HAS_FLAGS(bits, flags) ((bits & flags) == flags)
 
+#if defined(OLED_ASYNC_RENDER) && !defined(I2C_ASYNC_ENABLE)
+#    error "OLED_ASYNC_RENDER requires I2C_ASYNC_ENABLE"
+#endif
+
 // Display buffer's is the same as the OLED memory layout
 // this is so we don't end up with rounding errors with
 // parts of the display unusable or don't get cleared correctly
@@ -131,6 +135,14 @@ uint32_t oled_scroll_timeout;
 #if OLED_UPDATE_INTERVAL > 0
 uint16_t oled_update_timeout;
 #endif
+bool     oled_frame_in_progress = false;
+uint32_t oled_frame_timer       = 0;
+uint32_t oled_frame_time        = 0;
+#ifdef OLED_ASYNC_RENDER
+// Staging copy of the data being sent, which must outlive the asynchronous transfer
+uint8_t         oled_async_buffer[1 + OLED_MATRIX_SIZE];
+OLED_BLOCK_TYPE oled_async_blocks = 0;
+#endif
 
 // Internal variables to reduce math instructions
 
@@ -245,10 +257,12 @@ void oled_clear(void) {
     oled_dirty  = OLED_ALL_BLOCKS_MASK;
 }
 
-static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
+static void calc_bounds(uint8_t update_start, uint8_t update_end, uint8_t *cmd_array) {
     // Calculate commands to set memory addressing bounds.
-    uint8_t start_page   = OLED_BLOCK_SIZE * update_start / OLED_DISPLAY_WIDTH;
-    uint8_t start_column = OLED_BLOCK_SIZE * update_start % OLED_DISPLAY_WIDTH;
+    uint16_t start_byte   = OLED_BLOCK_SIZE * update_start;
+    uint16_t end_byte     = OLED_BLOCK_SIZE * update_end - 1;
+    uint8_t  start_page   = start_byte / OLED_DISPLAY_WIDTH;
+    uint8_t  start_column = start_byte % OLED_DISPLAY_WIDTH;
 #if (OLED_IC == OLED_IC_SH1106)
     // Commands for Page Addressing Mode. Sets starting page and column; has no end bound.
     // Column value must be split into high and low nybble and sent as two commands.
@@ -260,10 +274,17 @@ static void calc_bounds(uint8_t update_start, uint8_t *cmd_array) {
     cmd_array[5] = NOP;
 #else
     // Commands for use in Horizontal Addressing mode.
-    cmd_array[1] = start_column;
+    // A range within a single page gets a window of just those columns, anything larger is made of whole pages.
+    uint8_t end_page = end_byte / OLED_DISPLAY_WIDTH;
+    if (start_page == end_page) {
+        cmd_array[1] = start_column;
+        cmd_array[2] = end_byte % OLED_DISPLAY_WIDTH;
+    } else {
+        cmd_array[1] = 0;
+        cmd_array[2] = OLED_DISPLAY_WIDTH - 1;
+    }
     cmd_array[4] = start_page;
-    cmd_array[2] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) % OLED_DISPLAY_WIDTH + cmd_array[1];
-    cmd_array[5] = (OLED_BLOCK_SIZE + OLED_DISPLAY_WIDTH - 1) / OLED_DISPLAY_WIDTH - 1;
+    cmd_array[5] = end_page;
 #endif
 }
 
@@ -290,27 +311,100 @@ static void rotate_90(const uint8_t *src, uint8_t *dest) {
     }
 }
 
+#ifdef OLED_RENDER_COALESCE
+// Whether the blocks in [update_start, update_end) can be sent through a single column & page window
+static bool is_single_window(uint8_t update_start, uint8_t update_end) {
+    uint16_t start_byte = OLED_BLOCK_SIZE * update_start;
+    uint16_t end_byte   = OLED_BLOCK_SIZE * update_end;
+    if (start_byte / OLED_DISPLAY_WIDTH == (end_byte - 1) / OLED_DISPLAY_WIDTH) {
+        return true;
+    }
+#    if (OLED_IC == OLED_IC_SH1106)
+    // Page Addressing Mode wraps around within the page, so can't span pages
+    return false;
+#    else
+    return start_byte % OLED_DISPLAY_WIDTH == 0 && end_byte % OLED_DISPLAY_WIDTH == 0;
+#    endif
+}
+#endif
+
+static bool oled_write_data(const uint8_t *data, uint16_t size) {
+#ifdef OLED_ASYNC_RENDER
+    // Other I2C calls wait for this transfer, so only the data is sent in the background
+    oled_async_buffer[0] = I2C_DATA;
+    memcpy(&oled_async_buffer[1], data, size);
+    return i2c_transmit_async((OLED_DISPLAY_ADDRESS << 1), oled_async_buffer, size + 1, OLED_I2C_TIMEOUT) == I2C_STATUS_SUCCESS;
+#else
+    return I2C_WRITE_REG(I2C_DATA, data, size) == I2C_STATUS_SUCCESS;
+#endif
+}
+
 void oled_render(void) {
     if (!oled_initialized) {
         return;
     }
 
+#ifdef OLED_ASYNC_RENDER
+    // Leave the bus alone while the previous chunk is still going out
+    if (i2c_async_busy()) {
+        return;
+    }
+
+    // Resend the previous chunk if it failed
+    if (oled_async_blocks) {
+        if (i2c_async_wait() != I2C_STATUS_SUCCESS) {
+            print("oled_render data failed\n");
+            oled_dirty |= oled_async_blocks;
+        }
+        oled_async_blocks = 0;
+    }
+#endif
+
     // Do we have work to do?
     oled_dirty &= OLED_ALL_BLOCKS_MASK;
     if (!oled_dirty || oled_scrolling) {
+        if (oled_frame_in_progress) {
+            oled_frame_in_progress = false;
+            oled_frame_time        = timer_elapsed32(oled_frame_timer);
+        }
         return;
     }
 
+    if (!oled_frame_in_progress) {
+#if OLED_RENDER_INTERVAL > 0
+        // Cap the frame rate, by holding off starting on the next frame
+        if (timer_elapsed32(oled_frame_timer) < OLED_RENDER_INTERVAL) {
+            return;
+        }
+#endif
+        oled_frame_in_progress = true;
+        oled_frame_timer       = timer_read32();
+    }
+
     // Find first dirty block
     uint8_t update_start = 0;
     while (!(oled_dirty & ((OLED_BLOCK_TYPE)1 << update_start))) {
         ++update_start;
     }
+    uint8_t update_end = update_start + 1;
+
+#ifdef OLED_RENDER_COALESCE
+    // Merge in the dirty blocks that follow, as long as they fit in the same window
+    if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
+        while (update_end < OLED_BLOCK_COUNT && (oled_dirty & ((OLED_BLOCK_TYPE)1 << update_end))) {
+            ++update_end;
+        }
+        while (update_end > update_start + 1 && !is_single_window(update_start, update_end)) {
+            --update_end;
+        }
+    }
+#endif
+    OLED_BLOCK_TYPE update_blocks = (OLED_BLOCK_TYPE)(OLED_ALL_BLOCKS_MASK >> (OLED_BLOCK_COUNT - (update_end - update_start))) << update_start;
 
     // Set column & page position
     static uint8_t display_start[] = {I2C_CMD, COLUMN_ADDR, 0, OLED_DISPLAY_WIDTH - 1, PAGE_ADDR, 0, OLED_DISPLAY_HEIGHT / 8 - 1};
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
-        calc_bounds(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
+        calc_bounds(update_start, update_end, &display_start[1]); // Offset from I2C_CMD byte at the start
     } else {
         calc_bounds_90(update_start, &display_start[1]); // Offset from I2C_CMD byte at the start
     }
@@ -323,7 +417,7 @@ void oled_render(void) {
 
     if (!HAS_FLAGS(oled_rotation, OLED_ROTATION_90)) {
         // Send render data chunk as is
-        if (I2C_WRITE_REG(I2C_DATA, &oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        if (!oled_write_data(&oled_buffer[OLED_BLOCK_SIZE * update_start], OLED_BLOCK_SIZE * (update_end - update_start))) {
             print("oled_render data failed\n");
             return;
         }
@@ -339,7 +433,7 @@ void oled_render(void) {
         }
 
         // Send render data chunk after rotating
-        if (I2C_WRITE_REG(I2C_DATA, &temp_buffer[0], OLED_BLOCK_SIZE) != I2C_STATUS_SUCCESS) {
+        if (!oled_write_data(&temp_buffer[0], OLED_BLOCK_SIZE)) {
             print("oled_render90 data failed\n");
             return;
         }
@@ -349,7 +443,19 @@ void oled_render(void) {
     oled_on();
 
     // Clear dirty flag
-    oled_dirty &= ~((OLED_BLOCK_TYPE)1 << update_start);
+    oled_dirty &= ~update_blocks;
+#ifdef OLED_ASYNC_RENDER
+    oled_async_blocks = update_blocks;
+#else
+    if (!oled_dirty) {
+        oled_frame_in_progress = false;
+        oled_frame_time        = timer_elapsed32(oled_frame_timer);
+    }
+#endif
+}
+
+uint32_t oled_render_time(void) {
+    return oled_frame_time;
 }
 
 void oled_set_cursor(uint8_t col, uint8_t line) {
@@ -0,0 +1,75 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "color.h"
+#include "qp.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter surface configurables (add to your keyboard's config.h)
+
+#ifndef SURFACE_NUM_DEVICES
+/**
+ * @def This controls the maximum number of surface devices that Quantum Painter can use at any one time.
+ *      Increasing this number allows for multiple framebuffers to be used.
+ */
+#    define SURFACE_NUM_DEVICES 1
+#endif
+
+/**
+ * @def The number of bytes of framebuffer required by a surface of the given dimensions and bits per pixel.
+ */
+#define SURFACE_REQUIRED_BUFFER_BYTE_SIZE(w, h, bpp) ((((uint32_t)(w)) * (h) * (bpp) + 7) / 8)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter surface device factories
+
+/**
+ * Factory method for an RGB565 surface (aka framebuffer). Surfaces can only be drawn to 16bpp RGB565 panels.
+ *
+ * @param panel_width[in] the width of the surface
+ * @param panel_height[in] the height of the surface
+ * @param buffer[in] the framebuffer, at least SURFACE_REQUIRED_BUFFER_BYTE_SIZE(panel_width, panel_height, 16) bytes
+ * @return the device handle used with all drawing routines in Quantum Painter
+ */
+painter_device_t qp_rgb565_surface_make_device(uint16_t panel_width, uint16_t panel_height, void *buffer);
+
+/**
+ * Factory method for a 1bpp monochrome surface (aka framebuffer). Pixels are set when their value is 50% or higher.
+ *
+ * @param panel_width[in] the width of the surface
+ * @param panel_height[in] the height of the surface
+ * @param buffer[in] the framebuffer, at least SURFACE_REQUIRED_BUFFER_BYTE_SIZE(panel_width, panel_height, 1) bytes
+ * @return the device handle used with all drawing routines in Quantum Painter
+ */
+painter_device_t qp_mono_surface_make_device(uint16_t panel_width, uint16_t panel_height, void *buffer);
+
+/**
+ * Factory method for a palette-based surface (aka framebuffer). Colors drawn to the surface are stored as the index of
+ * the closest palette entry, and are converted to the target panel's native format when the surface is drawn.
+ *
+ * @param panel_width[in] the width of the surface
+ * @param panel_height[in] the height of the surface
+ * @param bits_per_pixel[in] 1, 2 or 4 -- or 8 if \ref QUANTUM_PAINTER_SUPPORTS_256_PALETTE is enabled
+ * @param buffer[in] the framebuffer, at least SURFACE_REQUIRED_BUFFER_BYTE_SIZE(panel_width, panel_height, bits_per_pixel) bytes
+ * @param palette[in] the 2^bits_per_pixel colors of the palette, or NULL for evenly spaced grayscale levels
+ * @return the device handle used with all drawing routines in Quantum Painter
+ */
+painter_device_t qp_palette_surface_make_device(uint16_t panel_width, uint16_t panel_height, uint8_t bits_per_pixel, void *buffer, const HSV *palette);
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter surface helpers
+
+/**
+ * Pushes the surface to another device, only the area drawn since the last push is transmitted unless
+ * `entire_surface` is set.
+ *
+ * @param surface[in] the surface to copy from
+ * @param target[in] the device to copy to, which must already be initialised
+ * @param x[in] the x-location on the target of the surface's left edge
+ * @param y[in] the y-location on the target of the surface's top edge
+ * @param entire_surface[in] whether the whole surface should be transmitted, rather than only its dirty region
+ * @return whether the transfer succeeded
+ */
+bool qp_surface_draw(painter_device_t surface, painter_device_t target, uint16_t x, uint16_t y, bool entire_surface);
@@ -0,0 +1,211 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "qp_internal.h"
+#include "qp_comms.h"
+#include "qp_surface.h"
+#include "qp_surface_internal.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver storage
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+surface_painter_device_t surface_drivers[SURFACE_NUM_DEVICES] = {0};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Comms -- surfaces live in RAM, so there's nothing to talk to
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool qp_surface_comms_init(painter_device_t device) {
+    return true;
+}
+
+static bool qp_surface_comms_start(painter_device_t device) {
+    return true;
+}
+
+static void qp_surface_comms_stop(painter_device_t device) {}
+
+static uint32_t qp_surface_comms_send(painter_device_t device, const void *data, uint32_t byte_count) {
+    return byte_count;
+}
+
+static const struct painter_comms_vtable_t surface_comms_vtable = {
+    .comms_init  = qp_surface_comms_init,
+    .comms_start = qp_surface_comms_start,
+    .comms_stop  = qp_surface_comms_stop,
+    .comms_send  = qp_surface_comms_send,
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void increment_dirty(surface_painter_device_t *surface, uint16_t l, uint16_t t, uint16_t r, uint16_t b) {
+    surface_dirty_data_t *dirty = &surface->dirty;
+    if (!dirty->is_dirty) {
+        dirty->is_dirty = true;
+        dirty->l        = l;
+        dirty->t        = t;
+        dirty->r        = r;
+        dirty->b        = b;
+        return;
+    }
+
+    dirty->l = QP_MIN(dirty->l, l);
+    dirty->t = QP_MIN(dirty->t, t);
+    dirty->r = QP_MAX(dirty->r, r);
+    dirty->b = QP_MAX(dirty->b, b);
+}
+
+static void mark_entire_surface_dirty(surface_painter_device_t *surface) {
+    increment_dirty(surface, 0, 0, surface->base.panel_width - 1, surface->base.panel_height - 1);
+}
+
+surface_painter_device_t *qp_surface_allocate(const struct surface_painter_driver_vtable_t *vtable, uint16_t panel_width, uint16_t panel_height, uint8_t bits_per_pixel, void *buffer) {
+    if (!buffer || panel_width == 0 || panel_height == 0) {
+        return NULL;
+    }
+
+    for (uint32_t i = 0; i < SURFACE_NUM_DEVICES; ++i) {
+        surface_painter_device_t *driver = &surface_drivers[i];
+        if (!driver->base.driver_vtable) {
+            driver->base.driver_vtable         = (const struct painter_driver_vtable_t *)vtable;
+            driver->base.comms_vtable          = &surface_comms_vtable;
+            driver->base.native_bits_per_pixel = bits_per_pixel;
+            driver->base.panel_width           = panel_width;
+            driver->base.panel_height          = panel_height;
+            driver->base.rotation              = QP_ROTATION_0;
+            driver->base.offset_x              = 0;
+            driver->base.offset_y              = 0;
+            driver->buffer                     = (uint8_t *)buffer;
+            driver->palette                    = NULL;
+            driver->dirty.is_dirty             = false;
+            return driver;
+        }
+    }
+    return NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter API implementations
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Initialisation -- the framebuffer is unrotated, rotate the target panel instead
+bool qp_surface_init(painter_device_t device, painter_rotation_t rotation) {
+    if (rotation != QP_ROTATION_0) {
+        qp_dprintf("qp_surface_init: fail (surfaces cannot be rotated)\n");
+        return false;
+    }
+
+    return qp_surface_clear(device);
+}
+
+// Power control
+bool qp_surface_power(painter_device_t device, bool power_on) {
+    // No-op, as there's no physical panel.
+    return true;
+}
+
+// Screen clear
+bool qp_surface_clear(painter_device_t device) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+    memset(surface->buffer, 0, SURFACE_REQUIRED_BUFFER_BYTE_SIZE(surface->base.panel_width, surface->base.panel_height, surface->base.native_bits_per_pixel));
+    mark_entire_surface_dirty(surface);
+    return true;
+}
+
+// Screen flush
+bool qp_surface_flush(painter_device_t device) {
+    // No-op, the surface is pushed to its target with qp_surface_draw().
+    return true;
+}
+
+// Viewport to draw to
+bool qp_surface_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+
+    surface->viewport_l = left;
+    surface->viewport_t = top;
+    surface->viewport_r = right;
+    surface->viewport_b = bottom;
+    surface->pixdata_x  = left;
+    surface->pixdata_y  = top;
+    return true;
+}
+
+// Stream pixel data to the current write position in the framebuffer, row by row
+bool qp_surface_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    surface_painter_device_t *                    surface = (surface_painter_device_t *)device;
+    const struct surface_painter_driver_vtable_t *vtable  = (const struct surface_painter_driver_vtable_t *)surface->base.driver_vtable;
+
+    uint32_t index = 0;
+    while (index < native_pixel_count && surface->pixdata_y <= surface->viewport_b) {
+        uint16_t x   = surface->pixdata_x;
+        uint16_t y   = surface->pixdata_y;
+        uint32_t run = QP_MIN(native_pixel_count - index, (uint32_t)(surface->viewport_r - x + 1));
+
+        // Anything falling outside the surface is consumed but dropped
+        if (y < surface->base.panel_height && x < surface->base.panel_width) {
+            uint16_t visible = QP_MIN(run, (uint32_t)(surface->base.panel_width - x));
+            vtable->write_run(device, x, y, pixel_data, index, visible);
+            increment_dirty(surface, x, y, x + visible - 1, y);
+        }
+
+        index += run;
+        if (x + run > surface->viewport_r) {
+            surface->pixdata_x = surface->viewport_l;
+            surface->pixdata_y++;
+        } else {
+            surface->pixdata_x = x + run;
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter surface helpers
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool qp_surface_draw(painter_device_t surface, painter_device_t target, uint16_t x, uint16_t y, bool entire_surface) {
+    qp_dprintf("qp_surface_draw: entry\n");
+    surface_painter_device_t *                    surface_driver = (surface_painter_device_t *)surface;
+    struct painter_driver_t *                     target_driver  = (struct painter_driver_t *)target;
+    const struct surface_painter_driver_vtable_t *vtable         = (const struct surface_painter_driver_vtable_t *)surface_driver->base.driver_vtable;
+
+    if (!surface_driver->base.validate_ok || !target_driver->validate_ok) {
+        qp_dprintf("qp_surface_draw: fail (validation_ok == false)\n");
+        return false;
+    }
+
+    if (surface_driver->base.comms_vtable != &surface_comms_vtable) {
+        qp_dprintf("qp_surface_draw: fail (source is not a surface)\n");
+        return false;
+    }
+
+    if (entire_surface) {
+        mark_entire_surface_dirty(surface_driver);
+    }
+
+    surface_dirty_data_t *dirty = &surface_driver->dirty;
+    if (!dirty->is_dirty) {
+        qp_dprintf("qp_surface_draw: ok (nothing to draw)\n");
+        return true;
+    }
+
+    if (!qp_comms_start(target)) {
+        qp_dprintf("qp_surface_draw: fail (could not start comms)\n");
+        return false;
+    }
+
+    // One viewport for the whole dirty region, then stream it out
+    bool ret = target_driver->driver_vtable->viewport(target, x + dirty->l, y + dirty->t, x + dirty->r, y + dirty->b) && vtable->target_pixdata(surface, target, dirty->l, dirty->t, dirty->r, dirty->b);
+    qp_comms_stop(target);
+
+    if (ret) {
+        dirty->is_dirty = false;
+    }
+
+    qp_dprintf("qp_surface_draw: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
@@ -0,0 +1,174 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "color.h"
+#include "qp_internal.h"
+#include "qp_draw.h"
+#include "qp_surface.h"
+#include "qp_surface_internal.h"
+
+// Indexed surfaces pack their pixels LSB-first, in the same layout as QGF images
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Framebuffer access
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static inline uint8_t get_packed_pixel(const uint8_t *buffer, uint8_t bits_per_pixel, uint32_t index) {
+    uint32_t bit  = index * bits_per_pixel;
+    uint8_t  mask = (1 << bits_per_pixel) - 1;
+    return (buffer[bit / 8] >> (bit % 8)) & mask;
+}
+
+static inline void set_packed_pixel(uint8_t *buffer, uint8_t bits_per_pixel, uint32_t index, uint8_t value) {
+    uint32_t bit   = index * bits_per_pixel;
+    uint8_t  mask  = ((1 << bits_per_pixel) - 1) << (bit % 8);
+    buffer[bit / 8] = (buffer[bit / 8] & ~mask) | ((value << (bit % 8)) & mask);
+}
+
+static void qp_surface_write_run_indexed(painter_device_t device, uint16_t x, uint16_t y, const void *pixel_data, uint32_t index, uint16_t count) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+    uint8_t                   bpp     = surface->base.native_bits_per_pixel;
+    uint32_t                  offset  = (uint32_t)y * surface->base.panel_width + x;
+
+    // Whole bytes can be copied straight across if both sides are byte-aligned
+    if (bpp == 8) {
+        memcpy(&surface->buffer[offset], &((const uint8_t *)pixel_data)[index], count);
+        return;
+    }
+
+    for (uint16_t i = 0; i < count; ++i) {
+        set_packed_pixel(surface->buffer, bpp, offset + i, get_packed_pixel((const uint8_t *)pixel_data, bpp, index + i));
+    }
+}
+
+static bool qp_surface_target_pixdata_indexed(painter_device_t device, painter_device_t target, uint16_t l, uint16_t t, uint16_t r, uint16_t b) {
+    surface_painter_device_t *surface       = (surface_painter_device_t *)device;
+    struct painter_driver_t * target_driver = (struct painter_driver_t *)target;
+    uint8_t                   bpp           = surface->base.native_bits_per_pixel;
+    uint16_t                  entries       = 1 << bpp;
+
+    // Convert the surface palette into the target's native format, reusing the global lookup table
+    for (uint16_t i = 0; i < entries; ++i) {
+        if (surface->palette) {
+            qp_internal_global_pixel_lookup_table[i].hsv888.h = surface->palette[i].h;
+            qp_internal_global_pixel_lookup_table[i].hsv888.s = surface->palette[i].s;
+            qp_internal_global_pixel_lookup_table[i].hsv888.v = surface->palette[i].v;
+        } else {
+            qp_internal_global_pixel_lookup_table[i].hsv888.h = 0;
+            qp_internal_global_pixel_lookup_table[i].hsv888.s = 0;
+            qp_internal_global_pixel_lookup_table[i].hsv888.v = i * 255 / (entries - 1);
+        }
+    }
+    qp_internal_invalidate_palette();
+    target_driver->driver_vtable->palette_convert(target, entries, qp_internal_global_pixel_lookup_table);
+
+    // Expand the indices into native pixels, one pixdata buffer at a time
+    uint8_t  indices[QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE];
+    uint32_t chunk = QP_MIN(qp_internal_num_pixels_in_buffer(target), sizeof(indices));
+    uint32_t count = 0;
+    for (uint16_t y = t; y <= b; ++y) {
+        uint32_t offset = (uint32_t)y * surface->base.panel_width;
+        for (uint16_t x = l; x <= r; ++x) {
+            indices[count++] = get_packed_pixel(surface->buffer, bpp, offset + x);
+            if (count == chunk || (x == r && y == b)) {
+                target_driver->driver_vtable->append_pixels(target, qp_internal_global_pixdata_buffer, qp_internal_global_pixel_lookup_table, 0, count, indices);
+                if (!target_driver->driver_vtable->pixdata(target, qp_internal_global_pixdata_buffer, count)) {
+                    return false;
+                }
+                count = 0;
+            }
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Convert supplied palette entries into their native equivalents
+
+static uint8_t closest_palette_index(surface_painter_device_t *surface, uint8_t hue, uint8_t sat, uint8_t val) {
+    uint16_t entries = 1 << surface->base.native_bits_per_pixel;
+    if (!surface->palette) {
+        return val >> (8 - surface->base.native_bits_per_pixel);
+    }
+
+    RGB      rgb           = hsv_to_rgb_nocie((HSV){hue, sat, val});
+    uint8_t  best          = 0;
+    uint32_t best_distance = UINT32_MAX;
+    for (uint16_t i = 0; i < entries; ++i) {
+        RGB      entry    = hsv_to_rgb_nocie(surface->palette[i]);
+        int16_t  dr       = (int16_t)rgb.r - entry.r;
+        int16_t  dg       = (int16_t)rgb.g - entry.g;
+        int16_t  db       = (int16_t)rgb.b - entry.b;
+        uint32_t distance = (uint32_t)(dr * dr) + (uint32_t)(dg * dg) + (uint32_t)(db * db);
+        if (distance < best_distance) {
+            best          = i;
+            best_distance = distance;
+        }
+    }
+    return best;
+}
+
+static bool qp_surface_palette_convert_indexed(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+    for (int16_t i = 0; i < palette_size; ++i) {
+        palette[i].palette_idx = closest_palette_index(surface, palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Append pixels to the target location, keyed by the pixel index
+
+static bool qp_surface_append_pixels_indexed(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        set_packed_pixel(target_buffer, surface->base.native_bits_per_pixel, pixel_offset + i, palette[palette_indices[i]].palette_idx);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver vtable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const struct surface_painter_driver_vtable_t indexed_surface_driver_vtable = {
+    .base =
+        {
+            .init            = qp_surface_init,
+            .power           = qp_surface_power,
+            .clear           = qp_surface_clear,
+            .flush           = qp_surface_flush,
+            .pixdata         = qp_surface_pixdata,
+            .viewport        = qp_surface_viewport,
+            .palette_convert = qp_surface_palette_convert_indexed,
+            .append_pixels   = qp_surface_append_pixels_indexed,
+        },
+    .write_run      = qp_surface_write_run_indexed,
+    .target_pixdata = qp_surface_target_pixdata_indexed,
+};
+
+// Factory function for creating a handle to a palette-based surface
+painter_device_t qp_palette_surface_make_device(uint16_t panel_width, uint16_t panel_height, uint8_t bits_per_pixel, void *buffer, const HSV *palette) {
+    switch (bits_per_pixel) {
+        case 1:
+        case 2:
+        case 4:
+#if QUANTUM_PAINTER_SUPPORTS_256_PALETTE
+        case 8:
+#endif
+            break;
+        default:
+            return NULL;
+    }
+
+    surface_painter_device_t *driver = qp_surface_allocate(&indexed_surface_driver_vtable, panel_width, panel_height, bits_per_pixel, buffer);
+    if (driver) {
+        driver->palette = palette;
+    }
+    return (painter_device_t)driver;
+}
+
+// Factory function for creating a handle to a monochrome surface
+painter_device_t qp_mono_surface_make_device(uint16_t panel_width, uint16_t panel_height, void *buffer) {
+    return qp_palette_surface_make_device(panel_width, panel_height, 1, buffer, NULL);
+}
@@ -0,0 +1,65 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "color.h"
+#include "qp_internal.h"
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Common surface implementation
+
+// Area of the surface drawn to since it was last pushed to a target
+typedef struct surface_dirty_data_t {
+    bool     is_dirty;
+    uint16_t l;
+    uint16_t t;
+    uint16_t r;
+    uint16_t b;
+} surface_dirty_data_t;
+
+// Copies `count` native pixels starting at pixel `index` of `pixel_data` into the framebuffer at x/y, within a single row
+typedef void (*surface_write_run_func)(painter_device_t device, uint16_t x, uint16_t y, const void *pixel_data, uint32_t index, uint16_t count);
+
+// Transmits the given region of the surface to the target, whose viewport has already been set
+typedef bool (*surface_target_pixdata_func)(painter_device_t device, painter_device_t target, uint16_t l, uint16_t t, uint16_t r, uint16_t b);
+
+// Driver vtable with extras
+struct surface_painter_driver_vtable_t {
+    struct painter_driver_vtable_t base; // must be first, so it can be cast to/from the painter_driver_vtable_t* type
+
+    surface_write_run_func      write_run;
+    surface_target_pixdata_func target_pixdata;
+};
+
+// Device definition
+typedef struct surface_painter_device_t {
+    struct painter_driver_t base; // must be first, so it can be cast to/from the painter_device_t* type
+
+    uint8_t *            buffer;
+    surface_dirty_data_t dirty;
+
+    // Current write window, and the next location to be written within it
+    uint16_t viewport_l;
+    uint16_t viewport_t;
+    uint16_t viewport_r;
+    uint16_t viewport_b;
+    uint16_t pixdata_x;
+    uint16_t pixdata_y;
+
+    // Palette-based surfaces only, NULL for grayscale
+    const HSV *palette;
+} surface_painter_device_t;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Forward declarations for injecting into concrete driver vtables
+
+bool qp_surface_init(painter_device_t device, painter_rotation_t rotation);
+bool qp_surface_power(painter_device_t device, bool power_on);
+bool qp_surface_clear(painter_device_t device);
+bool qp_surface_flush(painter_device_t device);
+bool qp_surface_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom);
+bool qp_surface_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count);
+
+// Claims a free surface slot, or returns NULL if there are none left
+surface_painter_device_t *qp_surface_allocate(const struct surface_painter_driver_vtable_t *vtable, uint16_t panel_width, uint16_t panel_height, uint8_t bits_per_pixel, void *buffer);
@@ -0,0 +1,118 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "color.h"
+#include "qp_internal.h"
+#include "qp_draw.h"
+#include "qp_surface.h"
+#include "qp_surface_internal.h"
+
+// Pixels are stored byte-swapped, matching what RGB565 panels expect on the wire
+#define BYTE_SWAP(x) (((((uint16_t)(x)) >> 8) & 0x00FF) | ((((uint16_t)(x)) << 8) & 0xFF00))
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Framebuffer access
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void qp_surface_write_run_rgb565(painter_device_t device, uint16_t x, uint16_t y, const void *pixel_data, uint32_t index, uint16_t count) {
+    surface_painter_device_t *surface = (surface_painter_device_t *)device;
+    uint32_t                  offset  = (uint32_t)y * surface->base.panel_width + x;
+    memcpy(&surface->buffer[offset * 2], &((const uint8_t *)pixel_data)[index * 2], count * 2);
+}
+
+static bool qp_surface_target_pixdata_rgb565(painter_device_t device, painter_device_t target, uint16_t l, uint16_t t, uint16_t r, uint16_t b) {
+    surface_painter_device_t *surface       = (surface_painter_device_t *)device;
+    struct painter_driver_t * target_driver = (struct painter_driver_t *)target;
+    const uint8_t *           pixels        = surface->buffer;
+    const uint16_t            width         = surface->base.panel_width;
+
+    // The framebuffer is sent as-is, so the target has to share the native format
+    if (target_driver->native_bits_per_pixel != 16) {
+        qp_dprintf("qp_surface_draw: fail (target is not 16bpp)\n");
+        return false;
+    }
+
+    // Full-width regions are contiguous in the framebuffer, and go out in a single transfer
+    if (l == 0 && r == width - 1) {
+        return target_driver->driver_vtable->pixdata(target, &pixels[(uint32_t)t * width * 2], (uint32_t)width * (b - t + 1));
+    }
+
+    // Rows at least as wide as the pixdata buffer are streamed straight from the framebuffer
+    const uint16_t row      = r - l + 1;
+    const uint32_t capacity = qp_internal_num_pixels_in_buffer(target);
+    if (row >= capacity) {
+        for (uint16_t y = t; y <= b; ++y) {
+            if (!target_driver->driver_vtable->pixdata(target, &pixels[((uint32_t)y * width + l) * 2], row)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Narrower rows are packed back to back into the pixdata buffer, so that each transfer carries as many as fit
+    uint32_t count = 0;
+    for (uint16_t y = t; y <= b; ++y) {
+        uint16_t x = l;
+        while (x <= r) {
+            uint32_t span = QP_MIN((uint32_t)(r - x + 1), capacity - count);
+            memcpy(&qp_internal_global_pixdata_buffer[count * 2], &pixels[((uint32_t)y * width + x) * 2], span * 2);
+            count += span;
+            x += span;
+            if (count == capacity || (x > r && y == b)) {
+                if (!target_driver->driver_vtable->pixdata(target, qp_internal_global_pixdata_buffer, count)) {
+                    return false;
+                }
+                count = 0;
+            }
+        }
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Convert supplied palette entries into their native equivalents
+
+static bool qp_surface_palette_convert_rgb565(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    for (int16_t i = 0; i < palette_size; ++i) {
+        RGB      rgb      = hsv_to_rgb_nocie((HSV){palette[i].hsv888.h, palette[i].hsv888.s, palette[i].hsv888.v});
+        uint16_t rgb565   = (((uint16_t)rgb.r) >> 3) << 11 | (((uint16_t)rgb.g) >> 2) << 5 | (((uint16_t)rgb.b) >> 3);
+        palette[i].rgb565 = BYTE_SWAP(rgb565);
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Append pixels to the target location, keyed by the pixel index
+
+static bool qp_surface_append_pixels_rgb565(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    uint16_t *buf = (uint16_t *)target_buffer;
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        buf[pixel_offset + i] = palette[palette_indices[i]].rgb565;
+    }
+    return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Driver vtable
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+const struct surface_painter_driver_vtable_t rgb565_surface_driver_vtable = {
+    .base =
+        {
+            .init            = qp_surface_init,
+            .power           = qp_surface_power,
+            .clear           = qp_surface_clear,
+            .flush           = qp_surface_flush,
+            .pixdata         = qp_surface_pixdata,
+            .viewport        = qp_surface_viewport,
+            .palette_convert = qp_surface_palette_convert_rgb565,
+            .append_pixels   = qp_surface_append_pixels_rgb565,
+        },
+    .write_run      = qp_surface_write_run_rgb565,
+    .target_pixdata = qp_surface_target_pixdata_rgb565,
+};
+
+// Factory function for creating a handle to an RGB565 surface
+painter_device_t qp_rgb565_surface_make_device(uint16_t panel_width, uint16_t panel_height, void *buffer) {
+    return (painter_device_t)qp_surface_allocate(&rgb565_surface_driver_vtable, panel_width, panel_height, 16, buffer);
+}
@@ -28,6 +28,22 @@ void soft_serial_target_init(void);
 
 bool soft_serial_transaction(int sstd_index);
 
+#if defined(SPLIT_TRANSPORT_ASYNC)
+typedef enum serial_transaction_status_t {
+    SERIAL_TRANSACTION_IDLE,
+    SERIAL_TRANSACTION_PENDING,
+    SERIAL_TRANSACTION_SUCCESS,
+    SERIAL_TRANSACTION_FAILED,
+} serial_transaction_status_t;
+
+// hands the transaction to the transport thread, returns false if one is still in flight
+bool soft_serial_transaction_start(int sstd_index);
+// returns the status of the last started transaction without blocking
+serial_transaction_status_t soft_serial_transaction_poll(void);
+// suspends the calling thread until the last started transaction completes
+serial_transaction_status_t soft_serial_transaction_wait(void);
+#endif
+
 #ifdef SERIAL_DEBUG
 #    include <debug.h>
 #    include <print.h>
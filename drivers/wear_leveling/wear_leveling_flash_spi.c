@@ -41,6 +41,20 @@ bool backing_store_erase(void) {
     return ret;
 }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+bool backing_store_erase_page(uint32_t address) {
+    _Static_assert((WEAR_LEVELING_BACKING_PAGE_SIZE) % (EXTERNAL_FLASH_SECTOR_SIZE) == 0, "Page size must be a multiple of EXTERNAL_FLASH_SECTOR_SIZE");
+
+    uint32_t offset = (WEAR_LEVELING_EXTERNAL_FLASH_BLOCK_OFFSET) * (EXTERNAL_FLASH_BLOCK_SIZE) + address;
+    for (uint32_t i = 0; i < (WEAR_LEVELING_BACKING_PAGE_SIZE); i += (EXTERNAL_FLASH_SECTOR_SIZE)) {
+        if (flash_erase_sector(offset + i) != FLASH_STATUS_SUCCESS) {
+            return false;
+        }
+    }
+    return true;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return backing_store_write_bulk(address, &value, 1);
 }
@@ -32,3 +32,8 @@
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
 #    define WEAR_LEVELING_LOGICAL_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
 #endif // WEAR_LEVELING_LOGICAL_SIZE
+
+// Erase a sector at a time when consolidating incrementally
+#ifndef WEAR_LEVELING_BACKING_PAGE_SIZE
+#    define WEAR_LEVELING_BACKING_PAGE_SIZE (EXTERNAL_FLASH_SECTOR_SIZE)
+#endif // WEAR_LEVELING_BACKING_PAGE_SIZE
@@ -90,6 +90,45 @@
 
 static uint8_t i2c_address;
 
+#ifdef I2C_ASYNC_ENABLE
+/**
+ * Asynchronous transmits are handed to a worker thread, which sleeps while
+ * the peripheral (and DMA, where available) moves the bytes. Only one can be
+ * in flight; every blocking call waits for it first so the bus is never
+ * shared mid-transfer. i2c_stop() is the exception, as the worker thread
+ * itself uses it to recover from errors.
+ */
+static BSEMAPHORE_DECL(i2c_async_start, true);
+static BSEMAPHORE_DECL(i2c_async_done, true);
+static volatile bool         i2c_async_pending = false;
+static volatile i2c_status_t i2c_async_status  = I2C_STATUS_SUCCESS;
+static struct {
+    const uint8_t* data;
+    uint16_t       length;
+    uint16_t       timeout;
+} i2c_async_request;
+
+static i2c_status_t i2c_epilogue(const msg_t status);
+
+static THD_WORKING_AREA(waI2CAsyncThread, 256);
+static THD_FUNCTION(I2CAsyncThread, arg) {
+    (void)arg;
+    chRegSetThreadName("i2c_async");
+
+    while (true) {
+        chBSemWait(&i2c_async_start);
+        msg_t status      = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), i2c_async_request.data, i2c_async_request.length, 0, 0, TIME_MS2I(i2c_async_request.timeout));
+        i2c_async_status  = i2c_epilogue(status);
+        i2c_async_pending = false;
+        chBSemSignal(&i2c_async_done);
+    }
+}
+
+#    define I2C_ASYNC_BARRIER() i2c_async_wait()
+#else
+#    define I2C_ASYNC_BARRIER()
+#endif
+
 static const I2CConfig i2cconfig = {
 #if defined(USE_I2CV1_CONTRIB)
     I2C1_CLOCK_SPEED,
@@ -149,12 +188,14 @@ __attribute__((weak)) void i2c_init(void) {
 }
 
 i2c_status_t i2c_start(uint8_t address) {
+    I2C_ASYNC_BARRIER();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     return I2C_STATUS_SUCCESS;
 }
 
 i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, 0, 0, TIME_MS2I(timeout));
@@ -162,6 +203,7 @@ i2c_status_t i2c_transmit(uint8_t address, const uint8_t* data, uint16_t length,
 }
 
 i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = address;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterReceiveTimeout(&I2C_DRIVER, (i2c_address >> 1), data, length, TIME_MS2I(timeout));
@@ -169,6 +211,7 @@ i2c_status_t i2c_receive(uint8_t address, uint8_t* data, uint16_t length, uint16
 }
 
 i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -183,6 +226,7 @@ i2c_status_t i2c_writeReg(uint8_t devaddr, uint8_t regaddr, const uint8_t* data,
 }
 
 i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
 
@@ -198,6 +242,7 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 }
 
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     msg_t status = i2cMasterTransmitTimeout(&I2C_DRIVER, (i2c_address >> 1), &regaddr, 1, data, length, TIME_MS2I(timeout));
@@ -205,6 +250,7 @@ i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16
 }
 
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout) {
+    I2C_ASYNC_BARRIER();
     i2c_address = devaddr;
     i2cStart(&I2C_DRIVER, &i2cconfig);
     uint8_t register_packet[2] = {regaddr >> 8, regaddr & 0xFF};
@@ -215,3 +261,50 @@ i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uin
 void i2c_stop(void) {
     i2cStop(&I2C_DRIVER);
 }
+
+#ifdef I2C_ASYNC_ENABLE
+/**
+ * @brief Starts transmitting in the background and returns immediately. The
+ * data buffer belongs to the I2C driver until the transfer has completed.
+ * Any previous asynchronous transfer is waited upon first; call
+ * i2c_async_wait() beforehand if its outcome matters.
+ *
+ * @return i2c_status_t I2C_STATUS_SUCCESS once the transfer has been started.
+ */
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout) {
+    static thread_t* thread = NULL;
+    if (!thread) {
+        thread = chThdCreateStatic(waI2CAsyncThread, sizeof(waI2CAsyncThread), HIGHPRIO, I2CAsyncThread, NULL);
+    }
+
+    i2c_async_wait();
+
+    i2c_address = address;
+    i2cStart(&I2C_DRIVER, &i2cconfig);
+
+    i2c_async_request.data    = data;
+    i2c_async_request.length  = length;
+    i2c_async_request.timeout = timeout;
+    chBSemReset(&i2c_async_done, true);
+    i2c_async_pending = true;
+    chBSemSignal(&i2c_async_start);
+
+    return I2C_STATUS_SUCCESS;
+}
+
+bool i2c_async_busy(void) {
+    return i2c_async_pending;
+}
+
+/**
+ * @brief Blocks until any asynchronous transfer has completed.
+ *
+ * @return i2c_status_t the outcome of the most recent asynchronous transfer.
+ */
+i2c_status_t i2c_async_wait(void) {
+    while (i2c_async_pending) {
+        chBSemWait(&i2c_async_done);
+    }
+    return i2c_async_status;
+}
+#endif
@@ -25,6 +25,7 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 
 typedef int16_t i2c_status_t;
 
@@ -41,3 +42,9 @@ i2c_status_t i2c_writeReg16(uint8_t devaddr, uint16_t regaddr, const uint8_t* da
 i2c_status_t i2c_readReg(uint8_t devaddr, uint8_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 i2c_status_t i2c_readReg16(uint8_t devaddr, uint16_t regaddr, uint8_t* data, uint16_t length, uint16_t timeout);
 void         i2c_stop(void);
+
+#ifdef I2C_ASYNC_ENABLE
+i2c_status_t i2c_transmit_async(uint8_t address, const uint8_t* data, uint16_t length, uint16_t timeout);
+bool         i2c_async_busy(void);
+i2c_status_t i2c_async_wait(void);
+#endif
@@ -12,6 +12,47 @@
 static inline bool initiate_transaction(uint8_t transaction_id);
 static inline bool react_to_transaction(void);
 
+#if defined(SPLIT_TRANSACTIONS_BATCHED)
+#    define transaction_variable_length(transaction) ((transaction)->variable_length)
+#    define variable_buffer_length(buffer) split_batch_frame_length(buffer)
+#else
+#    define transaction_variable_length(transaction) false
+#    define variable_buffer_length(buffer) ((buffer)[0])
+#endif
+
+/**
+ * @brief Send a transaction buffer, variable length buffers only send as
+ * many bytes as their first byte says.
+ */
+static inline bool send_transaction_buffer(const uint8_t* buffer, uint8_t size, bool variable_length) {
+    if (variable_length) {
+        const uint8_t length = variable_buffer_length(buffer);
+        if (unlikely(length == 0 || length > size)) {
+            return false;
+        }
+        size = length;
+    }
+    return serial_transport_send(buffer, size);
+}
+
+/**
+ * @brief Receive a transaction buffer, variable length buffers are received
+ * up to the length given by their first byte.
+ */
+static inline bool receive_transaction_buffer(uint8_t* buffer, uint8_t size, bool variable_length) {
+    if (variable_length) {
+        if (unlikely(!serial_transport_receive(buffer, 1))) {
+            return false;
+        }
+        const uint8_t length = variable_buffer_length(buffer);
+        if (unlikely(length == 0 || length > size)) {
+            return false;
+        }
+        return length == 1 || serial_transport_receive(buffer + 1, length - 1);
+    }
+    return serial_transport_receive(buffer, size);
+}
+
 /**
  * @brief This thread runs on the slave and responds to transactions initiated
  * by the master.
@@ -40,11 +81,40 @@ void soft_serial_target_init(void) {
     chThdCreateStatic(waSlaveThread, sizeof(waSlaveThread), HIGHPRIO, SlaveThread, NULL);
 }
 
+#if defined(SPLIT_TRANSPORT_ASYNC)
+static BSEMAPHORE_DECL(transaction_start, true);
+static BSEMAPHORE_DECL(transaction_done, true);
+static volatile uint8_t                     transaction_index;
+static volatile serial_transaction_status_t transaction_status = SERIAL_TRANSACTION_IDLE;
+
+/**
+ * @brief This thread runs on the master and carries out the transactions
+ * queued by soft_serial_transaction_start(), so that the main loop keeps
+ * running while the bytes are on the wire.
+ */
+static THD_WORKING_AREA(waMasterThread, 512);
+static THD_FUNCTION(MasterThread, arg) {
+    (void)arg;
+    chRegSetThreadName("split_protocol_master");
+
+    while (true) {
+        chBSemWait(&transaction_start);
+        transaction_status = soft_serial_transaction(transaction_index) ? SERIAL_TRANSACTION_SUCCESS : SERIAL_TRANSACTION_FAILED;
+        chBSemSignal(&transaction_done);
+    }
+}
+#endif
+
 /**
  * @brief Master specific initializations.
  */
 void soft_serial_initiator_init(void) {
     serial_transport_driver_master_init();
+
+#if defined(SPLIT_TRANSPORT_ASYNC)
+    /* Start transport thread. */
+    chThdCreateStatic(waMasterThread, sizeof(waMasterThread), HIGHPRIO, MasterThread, NULL);
+#endif
 }
 
 /**
@@ -75,7 +145,7 @@ static inline bool react_to_transaction(void) {
 
     /* Receive transaction buffer from the master. If this transaction requires it.*/
     if (transaction->initiator2target_buffer_size) {
-        if (unlikely(!serial_transport_receive(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
+        if (unlikely(!receive_transaction_buffer(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size, transaction_variable_length(transaction)))) {
             return false;
         }
     }
@@ -87,7 +157,7 @@ static inline bool react_to_transaction(void) {
 
     /* Send transaction buffer to the master. If this transaction requires it. */
     if (transaction->target2initiator_buffer_size) {
-        if (unlikely(!serial_transport_send(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
+        if (unlikely(!send_transaction_buffer(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size, transaction_variable_length(transaction)))) {
             return false;
         }
     }
@@ -113,6 +183,46 @@ bool soft_serial_transaction(int index) {
     return result;
 }
 
+#if defined(SPLIT_TRANSPORT_ASYNC)
+/**
+ * @brief Queue a transaction from the master half to the slave half, the
+ * transaction buffers belong to the transport thread until it completes.
+ *
+ * @param index Transaction Table index of the transaction to start.
+ * @return bool false if the previous transaction is still in flight.
+ */
+bool soft_serial_transaction_start(int index) {
+    if (unlikely(transaction_status == SERIAL_TRANSACTION_PENDING)) {
+        return false;
+    }
+
+    chBSemReset(&transaction_done, true);
+    transaction_index  = (uint8_t)index;
+    transaction_status = SERIAL_TRANSACTION_PENDING;
+    chBSemSignal(&transaction_start);
+
+    return true;
+}
+
+/**
+ * @brief Status of the last queued transaction, without blocking.
+ */
+serial_transaction_status_t soft_serial_transaction_poll(void) {
+    return transaction_status;
+}
+
+/**
+ * @brief Suspend the calling thread until the last queued transaction completes.
+ */
+serial_transaction_status_t soft_serial_transaction_wait(void) {
+    if (transaction_status == SERIAL_TRANSACTION_PENDING) {
+        chBSemWait(&transaction_done);
+    }
+
+    return transaction_status;
+}
+#endif
+
 /**
  * @brief Initiate transaction to slave half.
  */
@@ -146,7 +256,7 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     /* Send transaction buffer to the slave. If this transaction requires it. */
     if (transaction->initiator2target_buffer_size) {
-        if (unlikely(!serial_transport_send(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size))) {
+        if (unlikely(!send_transaction_buffer(split_trans_initiator2target_buffer(transaction), transaction->initiator2target_buffer_size, transaction_variable_length(transaction)))) {
             serial_dprintf("SPLIT: sending buffer failed\n");
             return false;
         }
@@ -154,7 +264,7 @@ static inline bool initiate_transaction(uint8_t transaction_id) {
 
     /* Receive transaction buffer from the slave. If this transaction requires it. */
     if (transaction->target2initiator_buffer_size) {
-        if (unlikely(!serial_transport_receive(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size))) {
+        if (unlikely(!receive_transaction_buffer(split_trans_target2initiator_buffer(transaction), transaction->target2initiator_buffer_size, transaction_variable_length(transaction)))) {
             serial_dprintf("SPLIT: receiving buffer failed\n");
             return false;
         }
@@ -65,3 +65,7 @@
 #ifndef WEAR_LEVELING_LOGICAL_SIZE
 #    define WEAR_LEVELING_LOGICAL_SIZE 1024
 #endif
+
+#ifndef WEAR_LEVELING_BACKING_PAGE_SIZE
+#    define WEAR_LEVELING_BACKING_PAGE_SIZE (WEAR_LEVELING_LEGACY_EMULATION_PAGE_SIZE)
+#endif
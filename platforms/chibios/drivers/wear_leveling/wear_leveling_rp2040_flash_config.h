@@ -30,3 +30,8 @@
 #ifndef WEAR_LEVELING_RP2040_FLASH_BASE
 #    define WEAR_LEVELING_RP2040_FLASH_BASE ((WEAR_LEVELING_RP2040_FLASH_SIZE) - (WEAR_LEVELING_BACKING_SIZE))
 #endif
+
+// Erase a sector at a time when consolidating incrementally
+#ifndef WEAR_LEVELING_BACKING_PAGE_SIZE
+#    define WEAR_LEVELING_BACKING_PAGE_SIZE (FLASH_SECTOR_SIZE)
+#endif // WEAR_LEVELING_BACKING_PAGE_SIZE
@@ -0,0 +1,216 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "eeprom_driver.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* Driver backend, counting what actually gets written */
+
+#define MOCK_EEPROM_SIZE EEPROM_SIZE
+
+static uint8_t  mock_eeprom[MOCK_EEPROM_SIZE];
+static uint32_t mock_write_count;
+
+extern "C" void eeprom_driver_init(void) {}
+
+extern "C" void eeprom_driver_erase(void) {
+    memset(mock_eeprom, 0, sizeof(mock_eeprom));
+}
+
+extern "C" void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    memcpy(buf, &mock_eeprom[(uintptr_t)addr], len);
+}
+
+extern "C" void eeprom_write_block(const void *buf, void *addr, size_t len) {
+    memcpy(&mock_eeprom[(uintptr_t)addr], buf, len);
+    mock_write_count++;
+}
+
+#define ADDR8(a) ((uint8_t *)(uintptr_t)(a))
+#define ADDR16(a) ((uint16_t *)(uintptr_t)(a))
+#define ADDR32(a) ((uint32_t *)(uintptr_t)(a))
+
+class EepromWriteBehind : public testing::Test {
+   protected:
+    eeprom_write_behind_stats_t baseline;
+
+    void SetUp() override {
+        eeprom_driver_flush();
+        eeprom_driver_erase();
+        set_time(0);
+        mock_write_count = 0;
+        eeprom_driver_get_write_behind_stats(&baseline);
+    }
+
+    uint32_t bytes_written() {
+        eeprom_write_behind_stats_t stats;
+        eeprom_driver_get_write_behind_stats(&stats);
+        return stats.written - baseline.written;
+    }
+
+    uint32_t bytes_requested() {
+        eeprom_write_behind_stats_t stats;
+        eeprom_driver_get_write_behind_stats(&stats);
+        return stats.requested - baseline.requested;
+    }
+};
+
+TEST_F(EepromWriteBehind, RepeatedUpdatesCoalesce) {
+    for (uint32_t i = 1; i <= 10; i++) {
+        eeprom_update_dword(ADDR32(8), i);
+        advance_time(10);
+        eeprom_driver_task();
+    }
+    EXPECT_EQ(mock_write_count, 0);
+
+    advance_time(EEPROM_WRITE_BEHIND_TIMEOUT);
+    eeprom_driver_task();
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(mock_eeprom[8], 10);
+    EXPECT_EQ(bytes_requested(), 40);
+    EXPECT_EQ(bytes_written(), 4);
+}
+
+TEST_F(EepromWriteBehind, QuietPeriodRestartsOnEveryWrite) {
+    eeprom_update_byte(ADDR8(0), 1);
+    advance_time(EEPROM_WRITE_BEHIND_TIMEOUT - 1);
+    eeprom_update_byte(ADDR8(0), 2);
+    advance_time(EEPROM_WRITE_BEHIND_TIMEOUT - 1);
+    eeprom_driver_task();
+    EXPECT_EQ(mock_write_count, 0);
+
+    advance_time(1);
+    eeprom_driver_task();
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(mock_eeprom[0], 2);
+}
+
+TEST_F(EepromWriteBehind, ReadsSeePendingWrites) {
+    mock_eeprom[4] = 0x11;
+    eeprom_update_word(ADDR16(5), 0xBEEF);
+    EXPECT_EQ(mock_eeprom[5], 0);
+    EXPECT_EQ(eeprom_read_byte(ADDR8(4)), 0x11);
+    EXPECT_EQ(eeprom_read_word(ADDR16(5)), 0xBEEF);
+    EXPECT_EQ(eeprom_read_dword(ADDR32(4)), 0x00BEEF11);
+}
+
+TEST_F(EepromWriteBehind, RevertedValueIsNotWritten) {
+    mock_eeprom[3] = 7;
+    eeprom_update_byte(ADDR8(3), 8);
+    eeprom_update_byte(ADDR8(3), 7);
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 0);
+    EXPECT_EQ(bytes_written(), 0);
+}
+
+TEST_F(EepromWriteBehind, AdjacentWritesMerge) {
+    eeprom_update_byte(ADDR8(11), 0xBB);
+    eeprom_update_byte(ADDR8(10), 0xAA);
+    eeprom_update_word(ADDR16(12), 0xDDCC);
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(bytes_written(), 4);
+    EXPECT_EQ(mock_eeprom[10], 0xAA);
+    EXPECT_EQ(mock_eeprom[11], 0xBB);
+    EXPECT_EQ(mock_eeprom[12], 0xCC);
+    EXPECT_EQ(mock_eeprom[13], 0xDD);
+}
+
+TEST_F(EepromWriteBehind, FullBufferMakesRoom) {
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        eeprom_update_byte(ADDR8(i * 16), i + 1);
+    }
+    EXPECT_EQ(mock_write_count, 0);
+
+    eeprom_update_byte(ADDR8(63), 0xFF);
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(mock_eeprom[0], 1);
+
+    eeprom_driver_flush();
+    for (uint8_t i = 0; i < EEPROM_WRITE_BEHIND_ENTRIES; i++) {
+        EXPECT_EQ(mock_eeprom[i * 16], i + 1);
+    }
+    EXPECT_EQ(mock_eeprom[63], 0xFF);
+}
+
+TEST_F(EepromWriteBehind, LargeWritesGoStraightThrough) {
+    uint8_t block[EEPROM_WRITE_BEHIND_ENTRY_SIZE * 2];
+    memset(block, 0x5A, sizeof(block));
+
+    eeprom_update_byte(ADDR8(2), 0x01);     // covered by the block, dropped
+    eeprom_update_word(ADDR16(15), 0x0302); // straddles the end of the block, written first
+    eeprom_update_block(block, ADDR8(0), sizeof(block));
+    EXPECT_EQ(mock_write_count, 2);
+    EXPECT_EQ(mock_eeprom[2], 0x5A);
+    EXPECT_EQ(mock_eeprom[15], 0x5A);
+    EXPECT_EQ(mock_eeprom[16], 0x03);
+
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 2);
+}
+
+TEST_F(EepromWriteBehind, OverlappingWritesMerge) {
+    eeprom_update_dword(ADDR32(20), 0x44332211);
+    eeprom_update_dword(ADDR32(22), 0x88776655);
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(bytes_written(), 6);
+    EXPECT_EQ(eeprom_read_word(ADDR16(20)), 0x2211);
+    EXPECT_EQ(eeprom_read_dword(ADDR32(22)), 0x88776655);
+}
+
+TEST_F(EepromWriteBehind, UnmergeableOverlapIsWrittenFirst) {
+    uint8_t block[EEPROM_WRITE_BEHIND_ENTRY_SIZE];
+    memset(block, 0xA5, sizeof(block));
+
+    eeprom_update_dword(ADDR32(40), 0x44332211);
+    eeprom_update_dword(ADDR32(40 + EEPROM_WRITE_BEHIND_ENTRY_SIZE - 2), 0x88776655);
+    // Merges with the second entry, but would grow the first one too large
+    eeprom_update_block(block, ADDR8(42), sizeof(block));
+    EXPECT_EQ(mock_write_count, 1);
+    EXPECT_EQ(eeprom_read_word(ADDR16(40)), 0x2211);
+
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 2);
+    EXPECT_EQ(mock_eeprom[40], 0x11);
+    EXPECT_EQ(mock_eeprom[41], 0x22);
+    EXPECT_EQ(memcmp(&mock_eeprom[42], block, sizeof(block)), 0);
+}
+
+TEST_F(EepromWriteBehind, DiscardDropsPendingWrites) {
+    eeprom_update_dword(ADDR32(8), 0x12345678);
+    eeprom_update_byte(ADDR8(30), 0x42);
+    EXPECT_EQ(eeprom_read_dword(ADDR32(8)), 0x12345678);
+
+    eeprom_driver_discard();
+    EXPECT_EQ(eeprom_read_dword(ADDR32(8)), 0);
+    EXPECT_EQ(eeprom_read_byte(ADDR8(30)), 0);
+
+    // Nothing is left to land on the erased contents later
+    eeprom_driver_erase();
+    advance_time(EEPROM_WRITE_BEHIND_TIMEOUT);
+    eeprom_driver_task();
+    eeprom_driver_flush();
+    EXPECT_EQ(mock_write_count, 0);
+    EXPECT_EQ(bytes_written(), 0);
+}
@@ -23,3 +23,18 @@ eeprom_stm32_SRC := \
 	$(PLATFORM_PATH)/chibios/drivers/eeprom/eeprom_stm32.c
 eeprom_stm32_tiny_SRC := $(eeprom_stm32_SRC)
 eeprom_stm32_large_SRC := $(eeprom_stm32_SRC)
+
+eeprom_write_behind_DEFS := \
+	-DEEPROM_CUSTOM \
+	-DEEPROM_SIZE=64 \
+	-DEEPROM_WRITE_BEHIND \
+	-DEEPROM_WRITE_BEHIND_ENTRIES=2 \
+	-DEEPROM_WRITE_BEHIND_ENTRY_SIZE=8 \
+	-DEEPROM_WRITE_BEHIND_TIMEOUT=100 \
+	-DNO_DEBUG
+eeprom_write_behind_INC := \
+	$(TOP_DIR)/drivers/eeprom
+eeprom_write_behind_SRC := \
+	$(TOP_DIR)/drivers/eeprom/eeprom_driver.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/eeprom_write_behind_tests.cpp \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c
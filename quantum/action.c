@@ -36,6 +36,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "action.h"
 #include "wait.h"
 #include "keycode_config.h"
+#include "latency_trace.h"
 
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
@@ -77,6 +78,7 @@ __attribute__((weak)) bool pre_process_record_quantum(keyrecord_t *record) {
  */
 void action_exec(keyevent_t event) {
     if (!IS_NOEVENT(event)) {
+        latency_trace_mark(LATENCY_TRACE_STAGE_ACTION);
         dprint("\n---- action_exec: start -----\n");
         dprint("EVENT: ");
         debug_event(event);
@@ -895,7 +897,7 @@ __attribute__((weak)) void register_code(uint8_t code) {
             // Force a new key press if the key is already pressed
             // without this, keys with the same keycode, but different
             // modifiers will be reported incorrectly, see issue #1708
-            if (is_key_pressed(keyboard_report, code)) {
+            if (is_key_held(code)) {
                 del_key(code);
                 send_keyboard_report();
             }
@@ -17,6 +17,136 @@
  */
 layer_state_t default_layer_state = 0;
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+/** \brief layer resolution cache
+ *
+ * Topmost non-transparent layer for every key, under the layer mask the cache was last brought up to date with.
+ * Updated incrementally whenever the layer mask changes, so that presses don't have to walk the layers.
+ */
+#    ifdef ENCODER_MAP_ENABLE
+#        define LAYER_RESOLUTION_CACHE_ENTRIES ((MATRIX_ROWS * MATRIX_COLS) + (NUM_ENCODERS * 2))
+#    else
+#        define LAYER_RESOLUTION_CACHE_ENTRIES (MATRIX_ROWS * MATRIX_COLS)
+#    endif // ENCODER_MAP_ENABLE
+
+static uint8_t       layer_resolution_cache[LAYER_RESOLUTION_CACHE_ENTRIES];
+static layer_state_t layer_resolution_cache_layers = 0;
+static bool          layer_resolution_cache_valid  = false;
+
+/** \brief layer resolution cache entry
+ *
+ * Maps a key position to its cache entry, returning false for positions that aren't cached
+ */
+static bool layer_resolution_cache_entry(keypos_t key, uint16_t *entry) {
+    if (key.row < MATRIX_ROWS && key.col < MATRIX_COLS) {
+        *entry = (uint16_t)(key.row * MATRIX_COLS) + key.col;
+        return true;
+    }
+#    ifdef ENCODER_MAP_ENABLE
+    else if ((key.row == KEYLOC_ENCODER_CW || key.row == KEYLOC_ENCODER_CCW) && key.col < NUM_ENCODERS) {
+        *entry = (MATRIX_ROWS * MATRIX_COLS) + (key.col * 2) + (key.row == KEYLOC_ENCODER_CW ? 0 : 1);
+        return true;
+    }
+#    endif // ENCODER_MAP_ENABLE
+    return false;
+}
+
+/** \brief layer resolution cache key
+ *
+ * Maps a cache entry back to its key position
+ */
+static keypos_t layer_resolution_cache_key(uint16_t entry) {
+#    ifdef ENCODER_MAP_ENABLE
+    if (entry >= MATRIX_ROWS * MATRIX_COLS) {
+        entry -= MATRIX_ROWS * MATRIX_COLS;
+        return (keypos_t){.row = (entry % 2) ? KEYLOC_ENCODER_CCW : KEYLOC_ENCODER_CW, .col = entry / 2};
+    }
+#    endif // ENCODER_MAP_ENABLE
+    return (keypos_t){.row = entry / MATRIX_COLS, .col = entry % MATRIX_COLS};
+}
+
+/** \brief layer resolution cache find
+ *
+ * Returns the topmost layer in the given mask with a non-transparent action for the key, or -1 if there isn't one
+ */
+static int8_t layer_resolution_cache_find(keypos_t key, layer_state_t layers) {
+    for (int8_t i = MAX_LAYER - 1; i >= 0; i--) {
+        if (layers & ((layer_state_t)1 << i)) {
+            if (action_for_key(i, key).code != ACTION_TRANSPARENT) {
+                return i;
+            }
+        }
+    }
+    return -1;
+}
+
+/** \brief layer resolution cache sync
+ *
+ * Brings the cache up to date with the current layer mask. Only layers which were switched on above a key's cached
+ * layer can change its resolution, unless the cached layer itself was switched off, in which case the key is resolved
+ * again from the top.
+ */
+static void layer_resolution_cache_sync(void) {
+    layer_state_t layers = layer_state | default_layer_state;
+
+    if (!layer_resolution_cache_valid) {
+        for (uint16_t entry = 0; entry < LAYER_RESOLUTION_CACHE_ENTRIES; entry++) {
+            int8_t layer                  = layer_resolution_cache_find(layer_resolution_cache_key(entry), layers);
+            layer_resolution_cache[entry] = layer < 0 ? 0 : layer;
+        }
+        layer_resolution_cache_valid = true;
+    } else if (layers != layer_resolution_cache_layers) {
+        layer_state_t added = layers & ~layer_resolution_cache_layers;
+        for (uint16_t entry = 0; entry < LAYER_RESOLUTION_CACHE_ENTRIES; entry++) {
+            uint8_t cached = layer_resolution_cache[entry];
+            if (!(layers & ((layer_state_t)1 << cached))) {
+                int8_t layer                  = layer_resolution_cache_find(layer_resolution_cache_key(entry), layers);
+                layer_resolution_cache[entry] = layer < 0 ? 0 : layer;
+            } else if (added & ~(((layer_state_t)2 << cached) - 1)) {
+                int8_t layer = layer_resolution_cache_find(layer_resolution_cache_key(entry), added & ~(((layer_state_t)2 << cached) - 1));
+                if (layer >= 0) {
+                    layer_resolution_cache[entry] = layer;
+                }
+            }
+        }
+    }
+    layer_resolution_cache_layers = layers;
+}
+
+/** \brief layer resolution cache layers changed
+ *
+ * Keeps an already populated cache in step with layer changes. An invalidated cache is left for the next lookup.
+ */
+static void layer_resolution_cache_layers_changed(void) {
+    if (layer_resolution_cache_valid) {
+        layer_resolution_cache_sync();
+    }
+}
+
+/** \brief layer resolution cache invalidate
+ *
+ * Discards the whole cache, to be rebuilt on the next lookup. Needed whenever the keymap changes underneath it.
+ */
+void layer_resolution_cache_invalidate(void) {
+    layer_resolution_cache_valid = false;
+}
+
+/** \brief layer resolution cache refresh key
+ *
+ * Resolves a single key again, after its keycode has been changed on any layer
+ */
+void layer_resolution_cache_refresh_key(keypos_t key) {
+    uint16_t entry;
+    if (layer_resolution_cache_valid && layer_resolution_cache_entry(key, &entry)) {
+        layer_resolution_cache_sync();
+        int8_t layer                  = layer_resolution_cache_find(key, layer_resolution_cache_layers);
+        layer_resolution_cache[entry] = layer < 0 ? 0 : layer;
+    }
+}
+#else
+#    define layer_resolution_cache_layers_changed()
+#endif
+
 /** \brief Default Layer State Set At user Level
  *
  * Run user code on default layer state change
@@ -45,6 +175,7 @@ static void default_layer_state_set(layer_state_t state) {
     default_layer_state = state;
     default_layer_debug();
     debug("\n");
+    layer_resolution_cache_layers_changed();
 #ifdef STRICT_LAYER_RELEASE
     clear_keyboard_but_mods(); // To avoid stuck keys
 #else
@@ -125,6 +256,7 @@ void layer_state_set(layer_state_t state) {
     layer_state = state;
     layer_debug();
     dprintln();
+    layer_resolution_cache_layers_changed();
 #    ifdef STRICT_LAYER_RELEASE
     clear_keyboard_but_mods(); // To avoid stuck keys
 #    else
@@ -328,6 +460,14 @@ action_t store_or_get_action(bool pressed, keypos_t key) {
  */
 uint8_t layer_switch_get_layer(keypos_t key) {
 #ifndef NO_ACTION_LAYER
+#    ifdef LAYER_RESOLUTION_CACHE
+    uint16_t entry;
+    if (layer_resolution_cache_entry(key, &entry)) {
+        layer_resolution_cache_sync();
+        return layer_resolution_cache[entry];
+    }
+#    endif // LAYER_RESOLUTION_CACHE
+
     action_t action;
     action.code = ACTION_TRANSPARENT;
 
@@ -132,6 +132,14 @@ layer_state_t layer_state_set_kb(layer_state_t state);
 #    define layer_state_set_user(state) (void)state
 #endif
 
+#if !defined(NO_ACTION_LAYER) && defined(LAYER_RESOLUTION_CACHE)
+void layer_resolution_cache_invalidate(void);
+void layer_resolution_cache_refresh_key(keypos_t key);
+#else
+#    define layer_resolution_cache_invalidate()
+#    define layer_resolution_cache_refresh_key(key) (void)key
+#endif
+
 /* pressed actions cache */
 #if !defined(NO_ACTION_LAYER) && !defined(STRICT_LAYER_RELEASE)
 
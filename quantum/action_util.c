@@ -36,9 +36,40 @@ static uint8_t suppressed_mods    = 0;
 // report_keyboard_t keyboard_report = {};
 report_keyboard_t *keyboard_report = &(report_keyboard_t){};
 
-extern inline void add_key(uint8_t key);
-extern inline void del_key(uint8_t key);
-extern inline void clear_keys(void);
+// The keys held down, which keyboard_report is built from whenever it is sent
+static key_bitmap_t key_bitmap;
+
+/** \brief Add key
+ *
+ * Marks the key as held, to be reported on the next send_keyboard_report()
+ */
+void add_key(uint8_t key) {
+    key_bitmap_add(&key_bitmap, key);
+}
+
+/** \brief Del key
+ *
+ * Marks the key as released, to be reported on the next send_keyboard_report()
+ */
+void del_key(uint8_t key) {
+    key_bitmap_del(&key_bitmap, key);
+}
+
+/** \brief Clear keys
+ *
+ * Releases every key, leaving the modifiers alone
+ */
+void clear_keys(void) {
+    key_bitmap_clear(&key_bitmap);
+}
+
+/** \brief Is key held
+ *
+ * Whether the key is held down, whether or not that has been reported yet
+ */
+bool is_key_held(uint8_t key) {
+    return key_bitmap_has(&key_bitmap, key);
+}
 
 #ifndef NO_ACTION_ONESHOT
 static uint8_t oneshot_mods        = 0;
@@ -245,6 +276,8 @@ bool is_oneshot_enabled(void) {
  * FIXME: needs doc
  */
 void send_keyboard_report(void) {
+    key_bitmap_build_report(&key_bitmap, keyboard_report);
+
     keyboard_report->mods = real_mods;
     keyboard_report->mods |= weak_mods;
 
@@ -53,6 +53,7 @@ __attribute__((weak)) void bootmagic_lite(void) {
 
     if (matrix_get_row(row) & (1 << col)) {
         bootmagic_lite_reset_eeprom();
+        eeconfig_flush();
 
         // Jump to bootloader.
         bootloader_jump();
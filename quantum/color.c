@@ -18,94 +18,94 @@
 #include "led_tables.h"
 #include "progmem.h"
 
-RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
-    RGB      rgb;
-    uint8_t  region, remainder, p, q, t;
-    uint16_t h, s, v;
+// clang-format off
 
-    if (hsv.s == 0) {
-#ifdef USE_CIE1931_CURVE
-        if (use_cie) {
-            rgb.r = rgb.g = rgb.b = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-        } else {
-            rgb.r = hsv.v;
-            rgb.g = hsv.v;
-            rgb.b = hsv.v;
-        }
-#else
-        rgb.r = hsv.v;
-        rgb.g = hsv.v;
-        rgb.b = hsv.v;
-#endif
-        return rgb;
-    }
+/* The hue wheel is split into six segments. Within each, one channel holds the value, one the floor
+ * and the third ramps between them. For every hue, this is how far the ramping channel is from the
+ * value at full saturation, i.e. the remainder within its segment, counted from the value end. */
+static const uint8_t PROGMEM hue_ramp[256] = {
+    255, 249, 243, 237, 231, 225, 219, 213, 207, 201, 195, 189, 183, 177, 171, 165,
+    159, 153, 147, 141, 135, 129, 123, 117, 111, 105,  99,  93,  87,  81,  75,  69,
+     63,  57,  51,  45,  39,  33,  27,  21,  15,   9,   3,   3,   9,  15,  21,  27,
+     33,  39,  45,  51,  57,  63,  69,  75,  81,  87,  93,  99, 105, 111, 117, 123,
+    129, 135, 141, 147, 153, 159, 165, 171, 177, 183, 189, 195, 201, 207, 213, 219,
+    225, 231, 237, 243, 249, 255, 249, 243, 237, 231, 225, 219, 213, 207, 201, 195,
+    189, 183, 177, 171, 165, 159, 153, 147, 141, 135, 129, 123, 117, 111, 105,  99,
+     93,  87,  81,  75,  69,  63,  57,  51,  45,  39,  33,  27,  21,  15,   9,   3,
+      3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63,  69,  75,  81,  87,  93,
+     99, 105, 111, 117, 123, 129, 135, 141, 147, 153, 159, 165, 171, 177, 183, 189,
+    195, 201, 207, 213, 219, 225, 231, 237, 243, 249, 255, 249, 243, 237, 231, 225,
+    219, 213, 207, 201, 195, 189, 183, 177, 171, 165, 159, 153, 147, 141, 135, 129,
+    123, 117, 111, 105,  99,  93,  87,  81,  75,  69,  63,  57,  51,  45,  39,  33,
+     27,  21,  15,   9,   3,   3,   9,  15,  21,  27,  33,  39,  45,  51,  57,  63,
+     69,  75,  81,  87,  93,  99, 105, 111, 117, 123, 129, 135, 141, 147, 153, 159,
+    165, 171, 177, 183, 189, 195, 201, 207, 213, 219, 225, 231, 237, 243, 249, 255,
+};
 
-    h = hsv.h;
-    s = hsv.s;
-#ifdef USE_CIE1931_CURVE
-    if (use_cie) {
-        v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
-    } else {
-        v = hsv.v;
-    }
-#else
-    v = hsv.v;
-#endif
+/* Which of the value (0), ramp (1) and floor (2) drives red, green and blue in each segment, the
+ * seventh is the last hue, which wraps around to the first segment */
+static const uint8_t PROGMEM hue_segment_layout[7][3] = {
+    {0, 1, 2}, {1, 0, 2}, {2, 0, 1}, {2, 1, 0}, {1, 2, 0}, {0, 2, 1}, {0, 1, 2},
+};
 
-    region    = h * 6 / 255;
-    remainder = (h * 2 - region * 85) * 3;
+// clang-format on
 
-    p = (v * (255 - s)) >> 8;
-    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
-    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+__attribute__((always_inline)) static inline void hsv_to_rgb_kernel(RGB *rgb, uint8_t h, uint8_t s, uint8_t v) {
+    uint8_t  channel[3];
+    uint16_t h6;
 
-    switch (region) {
-        case 6:
-        case 0:
-            rgb.r = v;
-            rgb.g = t;
-            rgb.b = p;
-            break;
-        case 1:
-            rgb.r = q;
-            rgb.g = v;
-            rgb.b = p;
-            break;
-        case 2:
-            rgb.r = p;
-            rgb.g = v;
-            rgb.b = t;
-            break;
-        case 3:
-            rgb.r = p;
-            rgb.g = q;
-            rgb.b = v;
-            break;
-        case 4:
-            rgb.r = t;
-            rgb.g = p;
-            rgb.b = v;
-            break;
-        default:
-            rgb.r = v;
-            rgb.g = p;
-            rgb.b = q;
-            break;
+    if (s == 0) {
+        rgb->r = v;
+        rgb->g = v;
+        rgb->b = v;
+        return;
     }
 
+    // Same as h * 6 / 255 for every hue, without the division
+    h6                    = h * 6;
+    const uint8_t *layout = hue_segment_layout[(h6 + (h6 >> 8) + 1) >> 8];
+    channel[0]            = v;
+    channel[1]            = (v * (255 - ((s * pgm_read_byte(&hue_ramp[h])) >> 8))) >> 8;
+    channel[2]            = (v * (255 - s)) >> 8;
+
+    rgb->r = channel[pgm_read_byte(&layout[0])];
+    rgb->g = channel[pgm_read_byte(&layout[1])];
+    rgb->b = channel[pgm_read_byte(&layout[2])];
+}
+
+RGB hsv_to_rgb_impl(HSV hsv, bool use_cie) {
+    RGB rgb;
+#ifdef USE_CIE1931_CURVE
+    if (use_cie) {
+        hsv.v = pgm_read_byte(&CIE1931_CURVE[hsv.v]);
+    }
+#endif
+    hsv_to_rgb_kernel(&rgb, hsv.h, hsv.s, hsv.v);
     return rgb;
 }
 
-RGB hsv_to_rgb(HSV hsv) {
 #ifdef USE_CIE1931_CURVE
-    return hsv_to_rgb_impl(hsv, true);
+#    define hsv_to_rgb_value(v) pgm_read_byte(&CIE1931_CURVE[v])
 #else
-    return hsv_to_rgb_impl(hsv, false);
+#    define hsv_to_rgb_value(v) (v)
 #endif
+
+RGB hsv_to_rgb(HSV hsv) {
+    RGB rgb;
+    hsv_to_rgb_kernel(&rgb, hsv.h, hsv.s, hsv_to_rgb_value(hsv.v));
+    return rgb;
 }
 
 RGB hsv_to_rgb_nocie(HSV hsv) {
-    return hsv_to_rgb_impl(hsv, false);
+    RGB rgb;
+    hsv_to_rgb_kernel(&rgb, hsv.h, hsv.s, hsv.v);
+    return rgb;
+}
+
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        hsv_to_rgb_kernel(&rgb[i], hsv[i].h, hsv[i].s, hsv_to_rgb_value(hsv[i].v));
+    }
 }
 
 #ifdef RGBW
@@ -145,6 +145,8 @@ typedef struct PACKED {
 
 RGB hsv_to_rgb(HSV hsv);
 RGB hsv_to_rgb_nocie(HSV hsv);
+/* Same as hsv_to_rgb() for each of `count` colours, without the per-call overhead */
+void hsv_to_rgb_batch(const HSV *hsv, RGB *rgb, uint8_t count);
 #ifdef RGBW
 void convert_rgb_to_rgbw(LED_TYPE *led);
 #endif
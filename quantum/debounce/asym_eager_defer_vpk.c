@@ -0,0 +1,142 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Asymmetric per-key algorithm, the same as asym_eager_defer_pk but using vertical counters.
+After pressing a key, it immediately changes state, and no further inputs are accepted
+until DEBOUNCE milliseconds have occurred. Releasing a key is only pushed when no state
+changes have occured for DEBOUNCE milliseconds.
+*/
+
+#include "matrix.h"
+#include "timer.h"
+#include "quantum.h"
+#include <string.h>
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif
+
+// Maximum debounce: 127ms
+#if DEBOUNCE > 127
+#    undef DEBOUNCE
+#    define DEBOUNCE 127
+#endif
+
+#if DEBOUNCE > 0
+#    include "vertical_counter.h"
+
+static debounce_counter_row_t debounce_counters[MATRIX_ROWS];
+// Whether each key's counter was started by a key-down
+static matrix_row_t debounce_pressed[MATRIX_ROWS];
+static fast_timer_t last_time;
+static bool         counters_need_update;
+static bool         matrix_need_update;
+static bool         cooked_changed;
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time);
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows);
+
+// we use num_rows rather than MATRIX_ROWS to support split keyboards
+void debounce_init(uint8_t num_rows) {
+    memset(debounce_counters, 0, sizeof(debounce_counters));
+    memset(debounce_pressed, 0, sizeof(debounce_pressed));
+}
+
+void debounce_free(void) {}
+
+bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool updated_last = false;
+    cooked_changed    = false;
+
+    if (counters_need_update) {
+        fast_timer_t now          = timer_read_fast();
+        fast_timer_t elapsed_time = TIMER_DIFF_FAST(now, last_time);
+
+        last_time    = now;
+        updated_last = true;
+        if (elapsed_time > UINT8_MAX) {
+            elapsed_time = UINT8_MAX;
+        }
+
+        if (elapsed_time > 0) {
+            update_debounce_counters_and_transfer_if_expired(raw, cooked, num_rows, elapsed_time);
+        }
+    }
+
+    if (changed || matrix_need_update) {
+        if (!updated_last) {
+            last_time = timer_read_fast();
+        }
+
+        transfer_matrix_values(raw, cooked, num_rows);
+    }
+
+    return cooked_changed;
+}
+
+static void update_debounce_counters_and_transfer_if_expired(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed_time) {
+    counters_need_update = false;
+    matrix_need_update   = false;
+
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t expired = debounce_counters_elapse(&debounce_counters[row], elapsed_time);
+
+        if (expired & debounce_pressed[row]) {
+            // key-down: eager
+            matrix_need_update = true;
+        }
+
+        // key-up: defer
+        matrix_row_t released = expired & ~debounce_pressed[row];
+        if (released) {
+            matrix_row_t cooked_next = (cooked[row] & ~released) | (raw[row] & released);
+            cooked_changed |= cooked_next ^ cooked[row];
+            cooked[row] = cooked_next;
+        }
+
+        if (debounce_counters_active(&debounce_counters[row])) {
+            counters_need_update = true;
+        }
+    }
+}
+
+static void transfer_matrix_values(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows) {
+    for (uint8_t row = 0; row < num_rows; row++) {
+        matrix_row_t delta  = raw[row] ^ cooked[row];
+        matrix_row_t active = debounce_counters_active(&debounce_counters[row]);
+        matrix_row_t start  = delta & ~active;
+
+        if (start) {
+            debounce_pressed[row] = (debounce_pressed[row] & ~start) | (raw[row] & start);
+            debounce_counters_start(&debounce_counters[row], start);
+            counters_need_update = true;
+
+            // key-down: eager
+            if (raw[row] & start) {
+                cooked[row] ^= raw[row] & start;
+                cooked_changed = true;
+            }
+        }
+
+        // key-up: defer
+        debounce_counters_stop(&debounce_counters[row], active & ~delta & ~debounce_pressed[row]);
+    }
+}
+
+#else
+#    include "none.c"
+#endif
@@ -4,4 +4,7 @@ TEST_LIST += \
 	debounce_sym_defer_pr \
 	debounce_sym_eager_pk \
 	debounce_sym_eager_pr \
-	debounce_asym_eager_defer_pk
+	debounce_asym_eager_defer_pk \
+	debounce_sym_defer_vpk \
+	debounce_sym_eager_vpk \
+	debounce_asym_eager_defer_vpk
@@ -0,0 +1,108 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+Vertical counters, shared by the *_vpk debounce algorithms.
+Bit b of every key's counter in a row is stored in bits[b], at the key's column,
+so a whole row of counters is started, stopped or counted down with a few bitwise
+operations on matrix_row_t instead of one loop iteration per key.
+A counter holds the milliseconds left before it elapses, or zero when it is idle.
+*/
+
+#pragma once
+
+#include "matrix.h"
+
+#if DEBOUNCE < 2
+#    define DEBOUNCE_COUNTER_BITS 1
+#elif DEBOUNCE < 4
+#    define DEBOUNCE_COUNTER_BITS 2
+#elif DEBOUNCE < 8
+#    define DEBOUNCE_COUNTER_BITS 3
+#elif DEBOUNCE < 16
+#    define DEBOUNCE_COUNTER_BITS 4
+#elif DEBOUNCE < 32
+#    define DEBOUNCE_COUNTER_BITS 5
+#elif DEBOUNCE < 64
+#    define DEBOUNCE_COUNTER_BITS 6
+#elif DEBOUNCE < 128
+#    define DEBOUNCE_COUNTER_BITS 7
+#else
+#    define DEBOUNCE_COUNTER_BITS 8
+#endif
+
+typedef struct {
+    matrix_row_t bits[DEBOUNCE_COUNTER_BITS];
+} debounce_counter_row_t;
+
+// Keys with a counter that has not elapsed yet
+static inline matrix_row_t debounce_counters_active(const debounce_counter_row_t *counters) {
+    matrix_row_t active = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        active |= counters->bits[b];
+    }
+    return active;
+}
+
+static inline void debounce_counters_stop(debounce_counter_row_t *counters, matrix_row_t keys) {
+    for (uint8_t b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        counters->bits[b] &= ~keys;
+    }
+}
+
+// (Re)start the counters of the given keys at DEBOUNCE
+static inline void debounce_counters_start(debounce_counter_row_t *counters, matrix_row_t keys) {
+    for (uint8_t b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        if (DEBOUNCE & (1 << b)) {
+            counters->bits[b] |= keys;
+        } else {
+            counters->bits[b] &= ~keys;
+        }
+    }
+}
+
+// Count down every active counter in the row, returning the keys whose counter elapsed
+static inline matrix_row_t debounce_counters_elapse(debounce_counter_row_t *counters, uint8_t elapsed_time) {
+    matrix_row_t active = debounce_counters_active(counters);
+
+    if (!active) {
+        return 0;
+    }
+    // No counter holds more than DEBOUNCE, and this also keeps elapsed_time within the counter width
+    if (elapsed_time >= DEBOUNCE) {
+        debounce_counters_stop(counters, active);
+        return active;
+    }
+
+    // Ripple-borrow subtraction, one bit-plane at a time; lanes that borrow out of the top bit went below zero
+    matrix_row_t remaining = 0;
+    matrix_row_t borrow    = 0;
+    for (uint8_t b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        matrix_row_t subtrahend = (elapsed_time & (1 << b)) ? ~(matrix_row_t)0 : 0;
+        matrix_row_t minuend    = counters->bits[b];
+
+        counters->bits[b] = minuend ^ subtrahend ^ borrow;
+        borrow            = (~minuend & (subtrahend | borrow)) | (subtrahend & borrow);
+        remaining |= counters->bits[b];
+    }
+
+    // Idle counters wrapped around too, so only keep the ones that are still counting
+    remaining &= active & ~borrow;
+    for (uint8_t b = 0; b < DEBOUNCE_COUNTER_BITS; b++) {
+        counters->bits[b] &= remaining;
+    }
+    return active & ~remaining;
+}
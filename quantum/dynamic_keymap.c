@@ -20,6 +20,10 @@
 #include "quantum.h" // for send_string()
 #include "dynamic_keymap.h"
 
+#if defined(EEPROM_DRIVER) && defined(EEPROM_WRITE_BEHIND)
+#    include "eeprom_driver.h"
+#endif
+
 #ifdef VIA_ENABLE
 #    include "via.h" // for VIA_EEPROM_CONFIG_END
 #    define DYNAMIC_KEYMAP_EEPROM_START (VIA_EEPROM_CONFIG_END)
@@ -98,6 +102,38 @@ _Static_assert((DYNAMIC_KEYMAP_EEPROM_MAX_ADDR) - (DYNAMIC_KEYMAP_MACRO_EEPROM_A
 #    define DYNAMIC_KEYMAP_MACRO_DELAY TAP_CODE_DELAY
 #endif
 
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+// RAM mirror of the keymaps in EEPROM, so that keycode lookups in the key event path
+// don't go out to the EEPROM driver. Loaded on first use, and written through on every change.
+static uint16_t dynamic_keymap_cache[DYNAMIC_KEYMAP_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+#    ifdef ENCODER_MAP_ENABLE
+static uint16_t dynamic_keymap_encoder_cache[DYNAMIC_KEYMAP_LAYER_COUNT][NUM_ENCODERS][2];
+#    endif // ENCODER_MAP_ENABLE
+static bool dynamic_keymap_cache_loaded = false;
+
+static void dynamic_keymap_cache_load_block(uint16_t *cache, const void *address, uint16_t count) {
+    // Read in one go, then convert from the big endian layout in place
+#    if defined(EEPROM_DRIVER) && defined(EEPROM_WRITE_BEHIND)
+    // The block read goes straight to the driver, so it must not be holding back any keycodes
+    eeprom_driver_flush();
+#    endif
+    eeprom_read_block(cache, address, count * 2);
+    for (uint16_t i = 0; i < count; i++) {
+        uint8_t *bytes = (uint8_t *)&cache[i];
+        cache[i]       = (bytes[0] << 8) | bytes[1];
+    }
+}
+
+static inline void dynamic_keymap_cache_load(void) {
+    if (dynamic_keymap_cache_loaded) return;
+    dynamic_keymap_cache_load_block(&dynamic_keymap_cache[0][0][0], (void *)DYNAMIC_KEYMAP_EEPROM_ADDR, DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS);
+#    ifdef ENCODER_MAP_ENABLE
+    dynamic_keymap_cache_load_block(&dynamic_keymap_encoder_cache[0][0][0], (void *)DYNAMIC_KEYMAP_ENCODER_EEPROM_ADDR, DYNAMIC_KEYMAP_LAYER_COUNT * NUM_ENCODERS * 2);
+#    endif // ENCODER_MAP_ENABLE
+    dynamic_keymap_cache_loaded = true;
+}
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
+
 uint8_t dynamic_keymap_get_layer_count(void) {
     return DYNAMIC_KEYMAP_LAYER_COUNT;
 }
@@ -109,19 +145,30 @@ void *dynamic_keymap_key_to_eeprom_address(uint8_t layer, uint8_t row, uint8_t c
 
 uint16_t dynamic_keymap_get_keycode(uint8_t layer, uint8_t row, uint8_t column) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return KC_NO;
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    return dynamic_keymap_cache[layer][row][column];
+#else
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = eeprom_read_byte(address) << 8;
     keycode |= eeprom_read_byte(address + 1);
     return keycode;
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
 }
 
 void dynamic_keymap_set_keycode(uint8_t layer, uint8_t row, uint8_t column, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || row >= MATRIX_ROWS || column >= MATRIX_COLS) return;
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    dynamic_keymap_cache[layer][row][column] = keycode;
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
     void *address = dynamic_keymap_key_to_eeprom_address(layer, row, column);
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address, (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + 1, (uint8_t)(keycode & 0xFF));
+    keypos_t key = {.row = row, .col = column};
+    layer_resolution_cache_refresh_key(key);
 }
 
 #ifdef ENCODER_MAP_ENABLE
@@ -131,23 +178,36 @@ void *dynamic_keymap_encoder_to_eeprom_address(uint8_t layer, uint8_t encoder_id
 
 uint16_t dynamic_keymap_get_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return KC_NO;
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    return dynamic_keymap_encoder_cache[layer][encoder_id][clockwise ? 0 : 1];
+#    else
     void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
     // Big endian, so we can read/write EEPROM directly from host if we want
     uint16_t keycode = ((uint16_t)eeprom_read_byte(address + (clockwise ? 0 : 2))) << 8;
     keycode |= eeprom_read_byte(address + (clockwise ? 0 : 2) + 1);
     return keycode;
+#    endif // DYNAMIC_KEYMAP_RAM_CACHE
 }
 
 void dynamic_keymap_set_encoder(uint8_t layer, uint8_t encoder_id, bool clockwise, uint16_t keycode) {
     if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || encoder_id >= NUM_ENCODERS) return;
+#    ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    dynamic_keymap_encoder_cache[layer][encoder_id][clockwise ? 0 : 1] = keycode;
+#    endif // DYNAMIC_KEYMAP_RAM_CACHE
     void *address = dynamic_keymap_encoder_to_eeprom_address(layer, encoder_id);
     // Big endian, so we can read/write EEPROM directly from host if we want
     eeprom_update_byte(address + (clockwise ? 0 : 2), (uint8_t)(keycode >> 8));
     eeprom_update_byte(address + (clockwise ? 0 : 2) + 1, (uint8_t)(keycode & 0xFF));
+    keypos_t key = {.row = clockwise ? KEYLOC_ENCODER_CW : KEYLOC_ENCODER_CCW, .col = encoder_id};
+    layer_resolution_cache_refresh_key(key);
 }
 #endif // ENCODER_MAP_ENABLE
 
 void dynamic_keymap_reset(void) {
+    // Everything changes, so resolve layers from scratch rather than key by key
+    layer_resolution_cache_invalidate();
     // Reset the keymaps in EEPROM to what is in flash.
     for (int layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
         for (int row = 0; row < MATRIX_ROWS; row++) {
@@ -175,11 +235,20 @@ void dynamic_keymap_reset(void) {
 
 void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   source                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    void *   source                     = ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset;
     uint8_t *target                     = data;
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    uint16_t *keycodes = &dynamic_keymap_cache[0][0][0];
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+            uint16_t keycode = keycodes[(offset + i) / 2];
+            *target          = ((offset + i) % 2) ? (keycode & 0xFF) : (keycode >> 8);
+#else
             *target = eeprom_read_byte(source);
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
         } else {
             *target = 0x00;
         }
@@ -190,10 +259,19 @@ void dynamic_keymap_get_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
 
 void dynamic_keymap_set_buffer(uint16_t offset, uint16_t size, uint8_t *data) {
     uint16_t dynamic_keymap_eeprom_size = DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2;
-    void *   target                     = (void *)(DYNAMIC_KEYMAP_EEPROM_ADDR + offset);
+    void *   target                     = ((void *)DYNAMIC_KEYMAP_EEPROM_ADDR) + offset;
     uint8_t *source                     = data;
+    layer_resolution_cache_invalidate();
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    dynamic_keymap_cache_load();
+    uint16_t *keycodes = &dynamic_keymap_cache[0][0][0];
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
     for (uint16_t i = 0; i < size; i++) {
         if (offset + i < dynamic_keymap_eeprom_size) {
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+            uint16_t *keycode = &keycodes[(offset + i) / 2];
+            *keycode          = ((offset + i) % 2) ? ((*keycode & 0xFF00) | *source) : ((*keycode & 0x00FF) | (*source << 8));
+#endif // DYNAMIC_KEYMAP_RAM_CACHE
             eeprom_update_byte(target, *source);
         }
         source++;
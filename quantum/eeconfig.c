@@ -39,6 +39,10 @@ __attribute__((weak)) void eeconfig_init_kb(void) {
  */
 void eeconfig_init_quantum(void) {
 #if defined(EEPROM_DRIVER)
+#    if defined(EEPROM_WRITE_BEHIND)
+    // Anything still pending would be erased straight away, or written on top of the erased contents later
+    eeprom_driver_discard();
+#    endif
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER);
@@ -98,11 +102,26 @@ void eeconfig_enable(void) {
  */
 void eeconfig_disable(void) {
 #if defined(EEPROM_DRIVER)
+#    if defined(EEPROM_WRITE_BEHIND)
+    // Anything still pending would be erased straight away, or written on top of the erased contents later
+    eeprom_driver_discard();
+#    endif
     eeprom_driver_erase();
 #endif
     eeprom_update_word(EECONFIG_MAGIC, EECONFIG_MAGIC_NUMBER_OFF);
 }
 
+/** \brief eeconfig flush
+ *
+ * Writes out anything the EEPROM driver is still holding back, before the
+ * keyboard resets, jumps to the bootloader or may lose power.
+ */
+void eeconfig_flush(void) {
+#if defined(EEPROM_DRIVER) && defined(EEPROM_WRITE_BEHIND)
+    eeprom_driver_flush();
+#endif
+}
+
 /** \brief eeconfig is enabled
  *
  * FIXME: needs doc
@@ -85,6 +85,8 @@ void eeconfig_enable(void);
 
 void eeconfig_disable(void);
 
+void eeconfig_flush(void);
+
 uint8_t eeconfig_read_debug(void);
 void    eeconfig_update_debug(uint8_t val);
 
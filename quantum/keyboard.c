@@ -33,6 +33,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "sendchar.h"
 #include "eeconfig.h"
 #include "action_layer.h"
+#include "latency_trace.h"
 #ifdef BACKLIGHT_ENABLE
 #    include "backlight.h"
 #endif
@@ -90,6 +91,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef EEPROM_DRIVER
 #    include "eeprom_driver.h"
 #endif
+#if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION)
+#    include "wear_leveling.h"
+#endif
 #if defined(CRC_ENABLE)
 #    include "crc.h"
 #endif
@@ -116,6 +120,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #ifdef CAPS_WORD_ENABLE
 #    include "caps_word.h"
 #endif
+#include "task_scheduler.h"
 
 static uint32_t last_input_modification_time = 0;
 uint32_t        last_input_activity_time(void) {
@@ -152,24 +157,47 @@ void last_encoder_activity_trigger(void) {
 static uint32_t matrix_timer           = 0;
 static uint32_t matrix_scan_count      = 0;
 static uint32_t last_matrix_scan_count = 0;
+#    if defined(MATRIX_IDLE_SCAN_ENABLE)
+static uint32_t matrix_full_scan_count      = 0;
+static uint32_t last_matrix_full_scan_count = 0;
+#    endif
 
 void matrix_scan_perf_task(void) {
     matrix_scan_count++;
+#    if defined(MATRIX_IDLE_SCAN_ENABLE)
+    if (!matrix_idle_scan_skipped()) {
+        matrix_full_scan_count++;
+    }
+#    endif
 
     uint32_t timer_now = timer_read32();
     if (TIMER_DIFF_32(timer_now, matrix_timer) >= 1000) {
 #    if defined(CONSOLE_ENABLE)
+#        if defined(MATRIX_IDLE_SCAN_ENABLE)
+        dprintf("matrix scan frequency: %lu, full scans: %lu (%lu%%)\n", matrix_scan_count, matrix_full_scan_count, matrix_full_scan_count * 100 / matrix_scan_count);
+#        else
         dprintf("matrix scan frequency: %lu\n", matrix_scan_count);
+#        endif
 #    endif
         last_matrix_scan_count = matrix_scan_count;
         matrix_timer           = timer_now;
         matrix_scan_count      = 0;
+#    if defined(MATRIX_IDLE_SCAN_ENABLE)
+        last_matrix_full_scan_count = matrix_full_scan_count;
+        matrix_full_scan_count      = 0;
+#    endif
     }
 }
 
 uint32_t get_matrix_scan_rate(void) {
     return last_matrix_scan_count;
 }
+
+#    if defined(MATRIX_IDLE_SCAN_ENABLE)
+uint32_t get_matrix_full_scan_rate(void) {
+    return last_matrix_full_scan_count;
+}
+#    endif
 #else
 #    define matrix_scan_perf_task()
 #endif
@@ -475,6 +503,8 @@ static bool matrix_task(void) {
         return matrix_changed;
     }
 
+    latency_trace_mark(LATENCY_TRACE_STAGE_DEBOUNCE);
+
     if (debug_config.matrix) {
         matrix_print();
     }
@@ -581,103 +611,184 @@ void quantum_task(void) {
 #ifdef SECURE_ENABLE
     secure_task();
 #endif
-}
-
-/** \brief Main task that is repeatedly called as fast as possible. */
-void keyboard_task(void) {
-    const bool matrix_changed = matrix_task();
-    if (matrix_changed) {
-        last_matrix_activity_trigger();
-    }
 
-    quantum_task();
+#if defined(SEND_STRING_ENABLE) && defined(SEND_STRING_ASYNC_ENABLE)
+    send_string_task();
+#endif
+}
 
-#if defined(RGBLIGHT_ENABLE)
-    rgblight_task();
+#ifndef LIGHTING_TASK_PERIOD
+#    define LIGHTING_TASK_PERIOD 0
+#endif
+#ifndef DISPLAY_TASK_PERIOD
+#    define DISPLAY_TASK_PERIOD 0
 #endif
 
-#ifdef LED_MATRIX_ENABLE
-    led_matrix_task();
+// Display tasks may be postponed, so input activity is latched until they run
+#if defined(OLED_ENABLE) && OLED_TIMEOUT > 0
+static bool oled_wake_pending = false;
 #endif
-#ifdef RGB_MATRIX_ENABLE
-    rgb_matrix_task();
+#if defined(ST7565_ENABLE) && ST7565_TIMEOUT > 0
+static bool st7565_wake_pending = false;
 #endif
 
-#if defined(BACKLIGHT_ENABLE)
-#    if defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS)
-    backlight_task();
-#    endif
+static void display_wake_trigger(void) {
+#if defined(OLED_ENABLE) && OLED_TIMEOUT > 0
+    oled_wake_pending = true;
+#endif
+#if defined(ST7565_ENABLE) && ST7565_TIMEOUT > 0
+    st7565_wake_pending = true;
 #endif
+}
+
+static void matrix_scan_task(void) {
+    if (matrix_task()) {
+        last_matrix_activity_trigger();
+        display_wake_trigger();
+    }
+}
 
 #ifdef ENCODER_ENABLE
-    const bool encoders_changed = encoder_read();
-    if (encoders_changed) {
+static void encoder_task(void) {
+    if (encoder_read()) {
         last_encoder_activity_trigger();
+        display_wake_trigger();
     }
+}
 #endif
 
 #ifdef OLED_ENABLE
+static void oled_display_task(void) {
     oled_task();
 #    if OLED_TIMEOUT > 0
     // Wake up oled if user is using those fabulous keys or spinning those encoders!
-#        ifdef ENCODER_ENABLE
-    if (matrix_changed || encoders_changed) oled_on();
-#        else
-    if (matrix_changed) oled_on();
-#        endif
+    if (oled_wake_pending) {
+        oled_wake_pending = false;
+        oled_on();
+    }
 #    endif
+}
 #endif
 
 #ifdef ST7565_ENABLE
+static void st7565_display_task(void) {
     st7565_task();
 #    if ST7565_TIMEOUT > 0
     // Wake up display if user is using those fabulous keys or spinning those encoders!
-#        ifdef ENCODER_ENABLE
-    if (matrix_changed || encoders_changed) st7565_on();
-#        else
-    if (matrix_changed) st7565_on();
-#        endif
+    if (st7565_wake_pending) {
+        st7565_wake_pending = false;
+        st7565_on();
+    }
 #    endif
+}
 #endif
 
-#ifdef MOUSEKEY_ENABLE
-    // mousekey repeat & acceleration
-    mousekey_task();
+#ifdef VELOCIKEY_ENABLE
+static void velocikey_task(void) {
+    if (velocikey_enabled()) {
+        velocikey_decelerate();
+    }
+}
 #endif
 
-#ifdef PS2_MOUSE_ENABLE
-    ps2_mouse_task();
+#if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION)
+static void wear_leveling_consolidation_task(void) {
+    wear_leveling_task();
+}
 #endif
 
+/* Matrix scanning and anything producing HID reports runs every loop, while
+ * lighting and display updates are postponed when the loop is over budget.
+ * Without TASK_SCHEDULER_ENABLE every task simply runs in order on each loop. */
+const task_scheduler_task_t keyboard_tasks[] = {
+    TASK_SCHEDULER_TASK(matrix_scan_task, 0, TASK_PRIORITY_REALTIME),
+    TASK_SCHEDULER_TASK(quantum_task, 0, TASK_PRIORITY_REALTIME),
+#if defined(RGBLIGHT_ENABLE)
+    TASK_SCHEDULER_TASK(rgblight_task, LIGHTING_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#ifdef LED_MATRIX_ENABLE
+    TASK_SCHEDULER_TASK(led_matrix_task, LIGHTING_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#ifdef RGB_MATRIX_ENABLE
+    TASK_SCHEDULER_TASK(rgb_matrix_task, LIGHTING_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#if defined(BACKLIGHT_ENABLE) && (defined(BACKLIGHT_PIN) || defined(BACKLIGHT_PINS))
+    TASK_SCHEDULER_TASK(backlight_task, LIGHTING_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#ifdef ENCODER_ENABLE
+    TASK_SCHEDULER_TASK(encoder_task, 0, TASK_PRIORITY_REALTIME),
+#endif
+#ifdef OLED_ENABLE
+    TASK_SCHEDULER_TASK(oled_display_task, DISPLAY_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#ifdef ST7565_ENABLE
+    TASK_SCHEDULER_TASK(st7565_display_task, DISPLAY_TASK_PERIOD, TASK_PRIORITY_BULK),
+#endif
+#ifdef MOUSEKEY_ENABLE
+    TASK_SCHEDULER_TASK(mousekey_task, 0, TASK_PRIORITY_REALTIME),
+#endif
+#ifdef PS2_MOUSE_ENABLE
+    TASK_SCHEDULER_TASK(ps2_mouse_task, 0, TASK_PRIORITY_REALTIME),
+#endif
 #ifdef POINTING_DEVICE_ENABLE
-    pointing_device_task();
+    TASK_SCHEDULER_TASK(pointing_device_task, 0, TASK_PRIORITY_REALTIME),
 #endif
-
 #ifdef MIDI_ENABLE
-    midi_task();
+    TASK_SCHEDULER_TASK(midi_task, 0, TASK_PRIORITY_NORMAL),
 #endif
-
 #ifdef VELOCIKEY_ENABLE
-    if (velocikey_enabled()) {
-        velocikey_decelerate();
-    }
+    TASK_SCHEDULER_TASK(velocikey_task, 0, TASK_PRIORITY_NORMAL),
 #endif
-
 #ifdef JOYSTICK_ENABLE
-    joystick_task();
+    TASK_SCHEDULER_TASK(joystick_task, 0, TASK_PRIORITY_REALTIME),
 #endif
-
 #ifdef DIGITIZER_ENABLE
-    digitizer_task();
+    TASK_SCHEDULER_TASK(digitizer_task, 0, TASK_PRIORITY_REALTIME),
 #endif
-
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    programmable_button_send();
+    TASK_SCHEDULER_TASK(programmable_button_send, 0, TASK_PRIORITY_REALTIME),
 #endif
-
 #ifdef BLUETOOTH_BLUEFRUIT_LE
-    bluefruit_le_task();
+    TASK_SCHEDULER_TASK(bluefruit_le_task, 0, TASK_PRIORITY_REALTIME),
+#endif
+#if defined(EEPROM_DRIVER) && defined(EEPROM_WRITE_BEHIND)
+    TASK_SCHEDULER_TASK(eeprom_driver_task, 0, TASK_PRIORITY_BULK),
+#endif
+#if defined(WEAR_LEVELING_ENABLE) && defined(WEAR_LEVELING_INCREMENTAL_CONSOLIDATION)
+    TASK_SCHEDULER_TASK(wear_leveling_consolidation_task, 0, TASK_PRIORITY_BULK),
 #endif
+#ifdef LATENCY_TRACE_ENABLE
+    TASK_SCHEDULER_TASK(latency_trace_task, 0, TASK_PRIORITY_BULK),
+#endif
+    TASK_SCHEDULER_TASK(led_task, 0, TASK_PRIORITY_NORMAL),
+};
+const uint8_t keyboard_task_count = ARRAY_SIZE(keyboard_tasks);
+
+#ifdef TASK_SCHEDULER_ENABLE
+task_scheduler_stats_t keyboard_task_stats[ARRAY_SIZE(keyboard_tasks)];
 
-    led_task();
+#    if defined(DEBUG_TASK_SCHEDULER)
+static void task_scheduler_perf_task(void) {
+    static uint32_t stats_timer = 0;
+    if (timer_elapsed32(stats_timer) >= 1000) {
+        task_scheduler_print_stats();
+        task_scheduler_reset_stats();
+        stats_timer = timer_read32();
+    }
+}
+#    else
+#        define task_scheduler_perf_task()
+#    endif
+#endif
+
+/** \brief Main task that is repeatedly called as fast as possible. */
+void keyboard_task(void) {
+#ifdef TASK_SCHEDULER_ENABLE
+    task_scheduler_run(keyboard_tasks, keyboard_task_stats, keyboard_task_count);
+    task_scheduler_perf_task();
+#else
+    for (uint8_t i = 0; i < keyboard_task_count; i++) {
+        keyboard_tasks[i].task();
+    }
+#endif
 }
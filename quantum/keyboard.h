@@ -118,6 +118,9 @@ uint32_t last_encoder_activity_time(void);    // Timestamp of the last encoder a
 uint32_t last_encoder_activity_elapsed(void); // Number of milliseconds since the last encoder activity
 
 uint32_t get_matrix_scan_rate(void);
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+uint32_t get_matrix_full_scan_rate(void);
+#endif
 
 #ifdef __cplusplus
 }
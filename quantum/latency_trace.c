@@ -0,0 +1,268 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "latency_trace.h"
+#include "timer.h"
+#include "print.h"
+#include "debug.h"
+#include <string.h>
+
+#ifdef PROTOCOL_CHIBIOS
+#    include <ch.h>
+#endif
+
+/* One key event is traced at a time: it starts when the matrix changes and ends once its
+ * keyboard report has gone IN, or on timeout. Changes while a trace is running are not traced. */
+
+#if defined(PROTOCOL_CHIBIOS) && PORT_SUPPORTS_RT == TRUE
+// The realtime counter is the DWT cycle counter on cores that have one
+typedef rtcnt_t latency_trace_ticks_t;
+#    define LATENCY_TRACE_NOW() chSysGetRealtimeCounterX()
+#    define LATENCY_TRACE_TICKS_TO_US(ticks) RTC2US(REALTIME_COUNTER_CLOCK, ticks)
+#else
+typedef fast_timer_t latency_trace_ticks_t;
+#    define LATENCY_TRACE_NOW() timer_read_fast()
+#    define LATENCY_TRACE_TICKS_TO_US(ticks) ((uint32_t)(ticks)*1000)
+#endif
+
+// Only the ChibiOS driver says when a keyboard report has actually gone IN; elsewhere a trace ends at the report
+#ifdef PROTOCOL_CHIBIOS
+#    define LATENCY_TRACE_USB_STAGE
+#endif
+
+static struct {
+    uint8_t               sequence; // identifies the trace to the USB interrupt, never 0 while running
+    uint8_t               stages;
+    uint16_t              started_ms;
+    latency_trace_ticks_t ticks[LATENCY_TRACE_STAGE_COUNT];
+} trace;
+
+// Handed between the main loop and the USB interrupt without locking: the interrupt only writes
+// usb_ticks and usb_sequence once per trace, and only for the trace that sent a report
+static volatile uint8_t               report_sequence;
+static volatile uint8_t               usb_sequence;
+static volatile latency_trace_ticks_t usb_ticks;
+
+static uint16_t               histograms[LATENCY_TRACE_STAGE_COUNT][LATENCY_TRACE_HISTOGRAM_BUCKETS];
+static uint16_t               max_us[LATENCY_TRACE_STAGE_COUNT];
+static latency_trace_sample_t samples[LATENCY_TRACE_RING_SIZE];
+static uint8_t                samples_head;
+static uint8_t                samples_count;
+static bool                   samples_new;
+
+static uint8_t bucket_for(uint16_t us) {
+    if (us < 2) {
+        return us;
+    }
+    uint8_t msb = 15;
+    while (!(us & (1U << msb))) {
+        msb--;
+    }
+    return msb * 2 + ((us >> (msb - 1)) & 1);
+}
+
+uint16_t latency_trace_bucket_floor(uint8_t bucket) {
+    if (bucket < 2) {
+        return bucket;
+    }
+    uint8_t msb = bucket / 2;
+    return (1U << msb) | ((uint16_t)(bucket & 1) << (msb - 1));
+}
+
+static void record(latency_trace_stage_t stage, uint16_t us) {
+    uint16_t *histogram = histograms[stage];
+    uint8_t   bucket    = bucket_for(us);
+
+    // Halve the whole histogram rather than let one bucket saturate, so the shape is kept
+    if (histogram[bucket] == UINT16_MAX) {
+        for (uint8_t i = 0; i < LATENCY_TRACE_HISTOGRAM_BUCKETS; i++) {
+            histogram[i] = (histogram[i] + 1) / 2;
+        }
+    }
+    histogram[bucket]++;
+    if (us > max_us[stage]) {
+        max_us[stage] = us;
+    }
+}
+
+static void trace_close(void) {
+    latency_trace_sample_t *sample = &samples[samples_head];
+
+    report_sequence = 0;
+    if (usb_sequence == trace.sequence) {
+        trace.ticks[LATENCY_TRACE_STAGE_USB] = usb_ticks;
+        trace.stages |= 1 << LATENCY_TRACE_STAGE_USB;
+    }
+
+    // The first stage reached is the start of the trace
+    latency_trace_ticks_t start = 0;
+    for (uint8_t stage = 0; stage < LATENCY_TRACE_STAGE_COUNT; stage++) {
+        if (trace.stages & (1 << stage)) {
+            start = trace.ticks[stage];
+            break;
+        }
+    }
+
+    sample->stages = trace.stages;
+    for (uint8_t stage = 0; stage < LATENCY_TRACE_STAGE_COUNT; stage++) {
+        sample->time_us[stage] = 0;
+        if (trace.stages & (1 << stage)) {
+            uint32_t us            = LATENCY_TRACE_TICKS_TO_US((latency_trace_ticks_t)(trace.ticks[stage] - start));
+            sample->time_us[stage] = us > UINT16_MAX ? UINT16_MAX : us;
+            record(stage, sample->time_us[stage]);
+        }
+    }
+
+    samples_head = (samples_head + 1) % LATENCY_TRACE_RING_SIZE;
+    if (samples_count < LATENCY_TRACE_RING_SIZE) {
+        samples_count++;
+    }
+    samples_new  = true;
+    trace.stages = 0;
+}
+
+void latency_trace_mark(latency_trace_stage_t stage) {
+    latency_trace_ticks_t now = LATENCY_TRACE_NOW();
+
+    if (stage == LATENCY_TRACE_STAGE_USB) {
+        // Called from the USB interrupt, so only the first report completion after the trace's report counts
+        uint8_t sequence = report_sequence;
+        if (sequence && usb_sequence != sequence) {
+            usb_ticks    = now;
+            usb_sequence = sequence;
+        }
+        return;
+    }
+
+    if (!trace.stages) {
+        if (stage > LATENCY_TRACE_STAGE_DEBOUNCE) {
+            return;
+        }
+        if (++trace.sequence == 0) {
+            trace.sequence = 1;
+        }
+        // Nothing can complete in the interrupt while no report is outstanding
+        usb_sequence     = 0;
+        trace.started_ms = timer_read();
+    }
+
+    if (trace.stages & (1 << stage)) {
+        return;
+    }
+    trace.ticks[stage] = now;
+    trace.stages |= 1 << stage;
+    if (stage == LATENCY_TRACE_STAGE_REPORT) {
+        report_sequence = trace.sequence;
+    }
+}
+
+void latency_trace_task(void) {
+    if (trace.stages) {
+#ifdef LATENCY_TRACE_USB_STAGE
+        bool done = usb_sequence == trace.sequence;
+#else
+        bool done = trace.stages & (1 << LATENCY_TRACE_STAGE_REPORT);
+#endif
+        if (done || timer_elapsed(trace.started_ms) >= LATENCY_TRACE_TIMEOUT) {
+            trace_close();
+        }
+    }
+
+#if LATENCY_TRACE_PRINT_INTERVAL > 0
+    static uint32_t last_print = 0;
+    if (samples_new && timer_elapsed32(last_print) >= LATENCY_TRACE_PRINT_INTERVAL) {
+        last_print = timer_read32();
+        if (debug_enable) {
+            latency_trace_print();
+        }
+    }
+#endif
+}
+
+void latency_trace_clear(void) {
+    report_sequence = 0;
+    trace.stages    = 0;
+    memset(histograms, 0, sizeof(histograms));
+    memset(max_us, 0, sizeof(max_us));
+    samples_head  = 0;
+    samples_count = 0;
+    samples_new   = false;
+}
+
+static uint16_t percentile(const uint16_t *histogram, uint32_t count, uint8_t percent, uint16_t max) {
+    uint32_t target = (count * percent + 99) / 100;
+    uint32_t seen   = 0;
+
+    for (uint8_t bucket = 0; bucket < LATENCY_TRACE_HISTOGRAM_BUCKETS; bucket++) {
+        seen += histogram[bucket];
+        if (seen >= target) {
+            // Report the top of the bucket, but never more than has actually been seen
+            uint16_t ceiling = bucket + 1 < LATENCY_TRACE_HISTOGRAM_BUCKETS ? latency_trace_bucket_floor(bucket + 1) - 1 : UINT16_MAX;
+            return ceiling < max ? ceiling : max;
+        }
+    }
+    return max;
+}
+
+void latency_trace_get_stats(latency_trace_stage_t stage, latency_trace_stats_t *stats) {
+    const uint16_t *histogram = histograms[stage];
+    uint32_t        count     = 0;
+
+    for (uint8_t bucket = 0; bucket < LATENCY_TRACE_HISTOGRAM_BUCKETS; bucket++) {
+        count += histogram[bucket];
+    }
+
+    stats->count  = count > UINT16_MAX ? UINT16_MAX : count;
+    stats->max_us = max_us[stage];
+    stats->p50_us = count ? percentile(histogram, count, 50, max_us[stage]) : 0;
+    stats->p99_us = count ? percentile(histogram, count, 99, max_us[stage]) : 0;
+}
+
+const uint16_t *latency_trace_get_histogram(latency_trace_stage_t stage) {
+    return histograms[stage];
+}
+
+uint8_t latency_trace_get_samples(latency_trace_sample_t *out, uint8_t count) {
+    uint8_t copied = 0;
+    uint8_t index  = samples_head;
+
+    while (copied < count && copied < samples_count) {
+        index = (index + LATENCY_TRACE_RING_SIZE - 1) % LATENCY_TRACE_RING_SIZE;
+        memcpy(&out[copied++], &samples[index], sizeof(latency_trace_sample_t));
+    }
+    return copied;
+}
+
+void latency_trace_print(void) {
+    static const char *const stage_names[LATENCY_TRACE_STAGE_COUNT] = {"raw", "debounce", "action", "report", "usb"};
+
+    samples_new = false;
+    for (uint8_t stage = LATENCY_TRACE_STAGE_DEBOUNCE; stage < LATENCY_TRACE_STAGE_COUNT; stage++) {
+        latency_trace_stats_t stats;
+        latency_trace_get_stats(stage, &stats);
+        if (!stats.count) {
+            continue;
+        }
+
+        uprintf("latency %-8s n=%u p50=%uus p99=%uus max=%uus |", stage_names[stage], stats.count, stats.p50_us, stats.p99_us, stats.max_us);
+        for (uint8_t bucket = 0; bucket < LATENCY_TRACE_HISTOGRAM_BUCKETS; bucket++) {
+            if (histograms[stage][bucket]) {
+                uprintf(" %u:%u", latency_trace_bucket_floor(bucket), histograms[stage][bucket]);
+            }
+        }
+        uprintf("\n");
+    }
+}
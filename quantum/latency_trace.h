@@ -0,0 +1,98 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Points along the path from a switch changing state to the host receiving the report.
+ * Latencies are measured from the first stage a key event was seen at. */
+typedef enum {
+    LATENCY_TRACE_STAGE_RAW,      // raw matrix changed
+    LATENCY_TRACE_STAGE_DEBOUNCE, // debounced matrix changed
+    LATENCY_TRACE_STAGE_ACTION,   // key event handed to action_exec
+    LATENCY_TRACE_STAGE_REPORT,   // keyboard report sent to the host driver
+    LATENCY_TRACE_STAGE_USB,      // keyboard report made it IN
+    LATENCY_TRACE_STAGE_COUNT,
+} latency_trace_stage_t;
+
+#ifdef LATENCY_TRACE_ENABLE
+
+// Completed traces kept for reading back individually
+#    ifndef LATENCY_TRACE_RING_SIZE
+#        define LATENCY_TRACE_RING_SIZE 16
+#    endif
+
+// A trace that has not made it to the host after this many milliseconds is closed with the stages it reached
+#    ifndef LATENCY_TRACE_TIMEOUT
+#        define LATENCY_TRACE_TIMEOUT 100
+#    endif
+
+// How often to print the summary to the console, in milliseconds; 0 to only print it on request
+#    ifndef LATENCY_TRACE_PRINT_INTERVAL
+#        define LATENCY_TRACE_PRINT_INTERVAL 10000
+#    endif
+
+// Two buckets per power of two, covering 0 to 65535us
+#    define LATENCY_TRACE_HISTOGRAM_BUCKETS 32
+
+typedef struct {
+    uint8_t  stages;                             // bit per stage that was reached
+    uint16_t time_us[LATENCY_TRACE_STAGE_COUNT]; // time from the start of the trace
+} latency_trace_sample_t;
+
+typedef struct {
+    uint16_t count;
+    uint16_t p50_us;
+    uint16_t p99_us;
+    uint16_t max_us;
+} latency_trace_stats_t;
+
+/**
+ * \brief Record that the key event currently being traced reached a stage.
+ *
+ * The raw and debounce stages start a new trace if none is in progress; the others are
+ * only recorded for a trace that is. Safe to call for the USB stage from an interrupt.
+ */
+void latency_trace_mark(latency_trace_stage_t stage);
+
+/** \brief Close finished traces and print the periodic summary. Called from the main loop. */
+void latency_trace_task(void);
+
+void latency_trace_clear(void);
+
+/** \brief Percentiles of the latency to the given stage, rounded up to the histogram bucket. */
+void latency_trace_get_stats(latency_trace_stage_t stage, latency_trace_stats_t *stats);
+
+/** \brief Bucket counts of the latency to the given stage, LATENCY_TRACE_HISTOGRAM_BUCKETS long. */
+const uint16_t *latency_trace_get_histogram(latency_trace_stage_t stage);
+
+/** \brief Lowest latency in microseconds that falls into the given histogram bucket. */
+uint16_t latency_trace_bucket_floor(uint8_t bucket);
+
+/** \brief Copy out up to count of the most recent traces, newest first, returning how many were copied. */
+uint8_t latency_trace_get_samples(latency_trace_sample_t *samples, uint8_t count);
+
+/** \brief Print the per-stage summary and histograms to the console. */
+void latency_trace_print(void);
+
+#else
+
+#    define latency_trace_mark(stage)
+#    define latency_trace_task()
+
+#endif
@@ -20,6 +20,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "latency_trace.h"
 #include "quantum.h"
 #ifdef SPLIT_KEYBOARD
 #    include "split_common/split_util.h"
@@ -309,6 +310,176 @@ void matrix_init(void) {
     matrix_init_quantum();
 }
 
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+#    ifndef MATRIX_IDLE_SCAN_INTERVAL
+#        define MATRIX_IDLE_SCAN_INTERVAL 10
+#    endif
+
+static bool          idle_armed        = false;
+static bool          idle_unsupported  = false;
+static bool          idle_scan_skipped = false;
+static volatile bool idle_woken        = false;
+static uint16_t      idle_scan_timer   = 0;
+
+void matrix_idle_wakeup(void) {
+    idle_woken = true;
+}
+
+bool matrix_idle_scan_skipped(void) {
+    return idle_scan_skipped;
+}
+
+#    if defined(PROTOCOL_CHIBIOS)
+static void idle_wake_callback(void *arg) {
+    matrix_idle_wakeup();
+}
+
+__attribute__((weak)) bool matrix_idle_wake_pin_enable(pin_t pin) {
+    palEnableLineEvent(pin, PAL_EVENT_MODE_FALLING_EDGE);
+    palSetLineCallback(pin, idle_wake_callback, NULL);
+    return true;
+}
+
+__attribute__((weak)) void matrix_idle_wake_pin_disable(pin_t pin) {
+    palDisableLineEvent(pin);
+}
+#    elif defined(__AVR__) && defined(PCMSK0) && defined(PINB_ADDRESS)
+#        include <avr/interrupt.h>
+
+// Only PCINT0 is handled, which covers PORTB on the USB AVRs. The other PCINT groups map to
+// different pins on each part, so a wake pin anywhere else keeps the matrix scanning.
+__attribute__((weak)) bool matrix_idle_wake_pin_enable(pin_t pin) {
+    if ((pin >> PORT_SHIFTER) != PINB_ADDRESS) {
+        return false;
+    }
+    PCMSK0 |= _BV(pin & 0xF);
+    PCICR |= _BV(PCIE0);
+    return true;
+}
+
+__attribute__((weak)) void matrix_idle_wake_pin_disable(pin_t pin) {
+    if ((pin >> PORT_SHIFTER) == PINB_ADDRESS) {
+        PCMSK0 &= ~_BV(pin & 0xF);
+        if (!PCMSK0) {
+            PCICR &= ~_BV(PCIE0);
+        }
+    }
+}
+
+ISR(PCINT0_vect) {
+    matrix_idle_wakeup();
+}
+#    else
+// No pin interrupts available, the matrix keeps scanning unless the keyboard provides them.
+__attribute__((weak)) bool matrix_idle_wake_pin_enable(pin_t pin) {
+    return false;
+}
+__attribute__((weak)) void matrix_idle_wake_pin_disable(pin_t pin) {}
+#    endif
+
+#    if defined(DIRECT_PINS)
+#        define IDLE_WAKE_PIN_COUNT (ROWS_PER_HAND * MATRIX_COLS)
+#        define IDLE_WAKE_PIN(i) (direct_pins[(i) / MATRIX_COLS][(i) % MATRIX_COLS])
+#        define idle_select_all()
+#        define idle_unselect_all()
+#    elif defined(MATRIX_ROW_PINS) && defined(MATRIX_COL_PINS)
+#        if (DIODE_DIRECTION == COL2ROW)
+#            define IDLE_WAKE_PIN_COUNT (MATRIX_COLS)
+#            define IDLE_WAKE_PIN(i) (col_pins[i])
+#            define IDLE_LINE_COUNT (ROWS_PER_HAND)
+#            define idle_select_line(i) select_row(i)
+#            define idle_unselect_all() unselect_rows()
+#        else
+#            define IDLE_WAKE_PIN_COUNT (ROWS_PER_HAND)
+#            define IDLE_WAKE_PIN(i) (row_pins[i])
+#            define IDLE_LINE_COUNT (MATRIX_COLS)
+#            define idle_select_line(i) select_col(i)
+#            define idle_unselect_all() unselect_cols()
+#        endif
+
+static void idle_select_all(void) {
+    for (uint8_t i = 0; i < IDLE_LINE_COUNT; i++) {
+        idle_select_line(i);
+    }
+}
+#    else
+#        error MATRIX_IDLE_SCAN_ENABLE requires DIRECT_PINS or MATRIX_ROW_PINS and MATRIX_COL_PINS
+#    endif
+
+static void matrix_idle_disarm(void);
+
+/* Drives every row (or column) active so that any key press pulls one of the
+ * wake pins low, then arms the wake pins as edge interrupts. */
+static void matrix_idle_arm(void) {
+    idle_woken = false;
+    idle_select_all();
+    matrix_output_select_delay();
+
+    bool key_down = false;
+    for (uint16_t i = 0; i < IDLE_WAKE_PIN_COUNT; i++) {
+        pin_t pin = IDLE_WAKE_PIN(i);
+        if (pin != NO_PIN) {
+            // A key on a pin that cannot wake the matrix would only be seen by the idle scan
+            // floor, so keep scanning every pass instead.
+            if (!matrix_idle_wake_pin_enable(pin)) {
+                idle_unsupported = true;
+                matrix_idle_disarm();
+                return;
+            }
+            key_down |= !readPin(pin);
+        }
+    }
+
+    // Catch a key pressed between the last scan and the interrupts being armed.
+    if (key_down) {
+        idle_woken = true;
+    }
+
+    idle_armed      = true;
+    idle_scan_timer = timer_read();
+}
+
+static void matrix_idle_disarm(void) {
+    for (uint16_t i = 0; i < IDLE_WAKE_PIN_COUNT; i++) {
+        pin_t pin = IDLE_WAKE_PIN(i);
+        if (pin != NO_PIN) {
+            matrix_idle_wake_pin_disable(pin);
+        }
+    }
+
+    idle_unselect_all();
+    matrix_output_unselect_delay(0, true);
+    idle_armed = false;
+}
+
+/* Returns true if reading the pins can be skipped for this scan. */
+static bool matrix_idle_skip_scan(void) {
+    if (!idle_armed) {
+        return false;
+    }
+    if (!idle_woken && timer_elapsed(idle_scan_timer) < MATRIX_IDLE_SCAN_INTERVAL) {
+        return true;
+    }
+    matrix_idle_disarm();
+    return false;
+}
+
+/* Goes idle once no key is pressed, raw or debounced, on this half. */
+static void matrix_idle_update(void) {
+    if (idle_armed || idle_unsupported) {
+        return;
+    }
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+#    ifdef SPLIT_KEYBOARD
+        if (raw_matrix[row] || matrix[thisHand + row]) return;
+#    else
+        if (raw_matrix[row] || matrix[row]) return;
+#    endif
+    }
+    matrix_idle_arm();
+}
+#endif
+
 #ifdef SPLIT_KEYBOARD
 // Fallback implementation for keyboards not using the standard split_util.c
 __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
@@ -320,21 +491,31 @@ __attribute__((weak)) bool transport_master_if_connected(matrix_row_t master_mat
 uint8_t matrix_scan(void) {
     matrix_row_t curr_matrix[MATRIX_ROWS] = {0};
 
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+    // While idle nothing is pressed, so the empty matrix is the current state
+    idle_scan_skipped = matrix_idle_skip_scan();
+    if (!idle_scan_skipped)
+#endif
+    {
 #if defined(DIRECT_PINS) || (DIODE_DIRECTION == COL2ROW)
-    // Set row, read cols
-    for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
-        matrix_read_cols_on_row(curr_matrix, current_row);
-    }
+        // Set row, read cols
+        for (uint8_t current_row = 0; current_row < ROWS_PER_HAND; current_row++) {
+            matrix_read_cols_on_row(curr_matrix, current_row);
+        }
 #elif (DIODE_DIRECTION == ROW2COL)
-    // Set col, read rows
-    matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
-    for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
-        matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
-    }
+        // Set col, read rows
+        matrix_row_t row_shifter = MATRIX_ROW_SHIFTER;
+        for (uint8_t current_col = 0; current_col < MATRIX_COLS; current_col++, row_shifter <<= 1) {
+            matrix_read_rows_on_col(curr_matrix, current_col, row_shifter);
+        }
 #endif
+    }
 
     bool changed = memcmp(raw_matrix, curr_matrix, sizeof(curr_matrix)) != 0;
-    if (changed) memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
+    if (changed) {
+        memcpy(raw_matrix, curr_matrix, sizeof(curr_matrix));
+        latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+    }
 
 #ifdef SPLIT_KEYBOARD
     changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
@@ -342,5 +523,9 @@ uint8_t matrix_scan(void) {
     changed = debounce(raw_matrix, matrix, ROWS_PER_HAND, changed);
     matrix_scan_quantum();
 #endif
+
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+    matrix_idle_update();
+#endif
     return (uint8_t)changed;
 }
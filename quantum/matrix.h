@@ -19,6 +19,9 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 
 #include <stdint.h>
 #include <stdbool.h>
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+#    include "gpio.h"
+#endif
 
 #if (MATRIX_COLS <= 8)
 typedef uint8_t matrix_row_t;
@@ -58,6 +61,16 @@ void matrix_output_unselect_delay(uint8_t line, bool key_pressed);
 /* only for backwards compatibility. delay between changing matrix pin state and reading values */
 void matrix_io_delay(void);
 
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+/* wake the matrix from idle scanning, safe to call from interrupt context */
+void matrix_idle_wakeup(void);
+/* whether the last scan skipped reading the pins while idle */
+bool matrix_idle_scan_skipped(void);
+/* arm a matrix input pin to call matrix_idle_wakeup() on a falling edge, false if it cannot */
+bool matrix_idle_wake_pin_enable(pin_t pin);
+void matrix_idle_wake_pin_disable(pin_t pin);
+#endif
+
 /* power control */
 void matrix_power_up(void);
 void matrix_power_down(void);
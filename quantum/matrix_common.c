@@ -1,6 +1,7 @@
 #include "quantum.h"
 #include "matrix.h"
 #include "debounce.h"
+#include "latency_trace.h"
 #include "wait.h"
 #include "print.h"
 #include "debug.h"
@@ -133,6 +134,13 @@ __attribute__((weak)) void matrix_output_unselect_delay(uint8_t line, bool key_p
     matrix_io_delay();
 }
 
+#ifdef MATRIX_IDLE_SCAN_ENABLE
+// Only the default matrix implements idle scanning, custom matrices always scan
+__attribute__((weak)) bool matrix_idle_scan_skipped(void) {
+    return false;
+}
+#endif
+
 // CUSTOM MATRIX 'LITE'
 __attribute__((weak)) void matrix_init_custom(void) {}
 __attribute__((weak)) bool matrix_scan_custom(matrix_row_t current_matrix[]) {
@@ -167,6 +175,9 @@ __attribute__((weak)) void matrix_init(void) {
 
 __attribute__((weak)) uint8_t matrix_scan(void) {
     bool changed = matrix_scan_custom(raw_matrix);
+    if (changed) {
+        latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+    }
 
 #ifdef SPLIT_KEYBOARD
     changed = debounce(raw_matrix, matrix + thisHand, ROWS_PER_HAND, changed) | matrix_post_scan();
@@ -56,6 +56,23 @@
 #    define QUANTUM_PAINTER_PIXDATA_BUFFER_SIZE 32
 #endif
 
+#ifndef QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES
+/**
+ * @def This controls the number of decoded glyphs that Quantum Painter keeps in RAM, in the native pixel format of the
+ *      device they were drawn to. Text redrawn with the same font and colors is then sent straight from the cache,
+ *      without reading or decoding the font. Each entry requires \ref QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE bytes of
+ *      RAM plus a few bytes of metadata. Defaults to 0, which disables the cache.
+ */
+#    define QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES 0
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES
+
+#ifndef QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE
+/**
+ * @def This controls the maximum size in bytes of a glyph held in the glyph cache. Larger glyphs are drawn uncached.
+ */
+#    define QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE 256
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE
+
 #ifndef QUANTUM_PAINTER_SUPPORTS_256_PALETTE
 /**
  * @def This controls whether 256-color palettes are supported. This has relatively hefty requirements on RAM -- at
@@ -100,6 +117,16 @@ typedef struct painter_font_desc_t {
     uint8_t line_height; ///< The number of pixels in height for each line
 } painter_font_desc_t;
 
+/**
+ * @typedef A string pre-rendered in a device's native pixel format by \ref qp_drawtext_prerender_recolor, which can
+ *          be drawn repeatedly with \ref qp_drawtext_run.
+ */
+typedef struct painter_text_run_t {
+    uint16_t    width;
+    uint16_t    height;
+    const void *pixels;
+} painter_text_run_t;
+
 /**
  * @typedef A handle to a Quantum Painter font.
  */
@@ -429,9 +456,62 @@ int16_t qp_drawtext(painter_device_t device, uint16_t x, uint16_t y, painter_fon
  */
 int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg);
 
+/**
+ * Measures the number of bytes required to pre-render the supplied string for the given device.
+ *
+ * @param device[in] the handle of the device the string will be drawn to
+ * @param font[in] the handle of the font
+ * @param str[in] the string to measure
+ * @return the buffer size required by \ref qp_drawtext_prerender_recolor
+ */
+uint32_t qp_drawtext_prerender_size(painter_device_t device, painter_font_handle_t font, const char *str);
+
+/**
+ * Renders text into a buffer in the device's native pixel format, so that it can later be drawn with a single
+ * transfer using \ref qp_drawtext_run. Nothing is sent to the device.
+ *
+ * @param device[in] the handle of the device the string will be drawn to
+ * @param font[in] the handle of the font
+ * @param str[in] the string to render
+ * @param hue_fg[in] the foreground hue to use, with 0-360 mapped to 0-255
+ * @param sat_fg[in] the foreground saturation to use, with 0-100% mapped to 0-255
+ * @param val_fg[in] the foreground value to use, with 0-100% mapped to 0-255
+ * @param hue_bg[in] the background hue to use, with 0-360 mapped to 0-255
+ * @param sat_bg[in] the background saturation to use, with 0-100% mapped to 0-255
+ * @param val_bg[in] the background value to use, with 0-100% mapped to 0-255
+ * @param buffer[in] the buffer to render into, which must remain valid while the run is in use
+ * @param buffer_size[in] the size of the buffer, see \ref qp_drawtext_prerender_size
+ * @param run[out] the pre-rendered run
+ * @return the width (in pixels) of the rendered string, or 0 on failure
+ */
+int16_t qp_drawtext_prerender_recolor(painter_device_t device, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg, void *buffer, uint32_t buffer_size, painter_text_run_t *run);
+
+/**
+ * Draws text pre-rendered by \ref qp_drawtext_prerender_recolor.
+ *
+ * @param device[in] the handle of the device to draw to, which must be the device the run was rendered for
+ * @param x[in] the x-location of the left side of the text
+ * @param y[in] the y-location of the top side of the text
+ * @param run[in] the pre-rendered run
+ * @return whether the draw operation completed successfully
+ */
+bool qp_drawtext_run(painter_device_t device, uint16_t x, uint16_t y, const painter_text_run_t *run);
+
+/**
+ * Retrieves the number of glyphs drawn from the glyph cache, and the number that had to be decoded from the font.
+ *
+ * @param hits[out] the number of glyphs drawn from the cache
+ * @param misses[out] the number of glyphs decoded from the font
+ */
+void qp_get_glyph_cache_stats(uint32_t *hits, uint32_t *misses);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter Drivers
 
+#ifdef QUANTUM_PAINTER_SURFACE_ENABLE
+#    include "qp_surface.h"
+#endif // QUANTUM_PAINTER_SURFACE_ENABLE
+
 #ifdef QUANTUM_PAINTER_ILI9163_ENABLE
 #    include "qp_ili9163.h"
 #endif // QUANTUM_PAINTER_ILI9163_ENABLE
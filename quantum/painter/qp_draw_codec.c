@@ -5,6 +5,11 @@
 #include "qp_draw.h"
 #include "qp_comms.h"
 
+// Bulk decoding is only possible when the byte source and pixel sink are known, these are checked by identity
+static inline int16_t qp_drawimage_byte_uncompressed_decoder(void* cb_arg);
+static inline int16_t qp_drawimage_byte_rle_decoder(void* cb_arg);
+static bool           qp_internal_decode_palette_bulk(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, struct qp_internal_byte_input_state* input_state, bool rle, qp_pixel_t* palette, struct qp_internal_pixel_output_state* output_state);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Palette / Monochrome-format decoder
 
@@ -28,6 +33,15 @@ bool qp_internal_bpp_capable(uint8_t bits_per_pixel) {
 }
 
 bool qp_internal_decode_palette(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, qp_internal_byte_input_callback input_callback, void* input_arg, qp_pixel_t* palette, qp_internal_pixel_output_callback output_callback, void* output_arg) {
+    // Memory-backed images streamed straight to the pixdata buffer skip the per-byte/per-pixel callbacks entirely
+    if (output_callback == qp_internal_pixel_appender && (input_callback == qp_drawimage_byte_uncompressed_decoder || input_callback == qp_drawimage_byte_rle_decoder)) {
+        struct qp_internal_byte_input_state* input_state = (struct qp_internal_byte_input_state*)input_arg;
+        int32_t                              available;
+        if (qp_memory_stream_remaining(input_state->src_stream, &available) != NULL) {
+            return qp_internal_decode_palette_bulk(device, pixel_count, bits_per_pixel, input_state, input_callback == qp_drawimage_byte_rle_decoder, palette, (struct qp_internal_pixel_output_state*)output_arg);
+        }
+    }
+
     const uint8_t pixel_bitmask    = (1 << bits_per_pixel) - 1;
     const uint8_t pixels_per_byte  = 8 / bits_per_pixel;
     uint32_t      remaining_pixels = pixel_count; // don't try to derive from byte_count, we may not use an entire byte
@@ -140,3 +154,236 @@ qp_internal_byte_input_callback qp_internal_prepare_input_state(struct qp_intern
             return NULL;
     }
 }
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Bulk decode -- unpacks whole words of packed pixels at a time, and hands them to the driver in batches
+
+// Number of palette indices unpacked before handing them to the driver's append_pixels
+#define QP_BULK_DECODE_BATCH_SIZE 64
+
+struct qp_internal_bulk_decode_state {
+    struct painter_driver_t*               driver;
+    struct qp_internal_pixel_output_state* output_state;
+    qp_pixel_t*                            palette;
+    uint32_t                               remaining_pixels;
+    uint8_t                                bits_per_pixel;
+    uint8_t                                pixels_per_byte;
+    uint8_t                                pixel_bitmask;
+    uint8_t                                count;
+    uint8_t                                capacity;
+    uint8_t                                indices[QP_BULK_DECODE_BATCH_SIZE];
+};
+
+static void qp_internal_bulk_update_capacity(struct qp_internal_bulk_decode_state* state) {
+    // Never let a batch straddle a pixdata transmission
+    uint32_t space  = state->output_state->max_pixels - state->output_state->pixel_write_pos;
+    state->capacity = space < QP_BULK_DECODE_BATCH_SIZE ? space : QP_BULK_DECODE_BATCH_SIZE;
+}
+
+static bool qp_internal_bulk_flush(struct qp_internal_bulk_decode_state* state) {
+    struct qp_internal_pixel_output_state* output_state = state->output_state;
+    if (state->count == 0) {
+        return true;
+    }
+
+    if (!state->driver->driver_vtable->append_pixels(output_state->device, qp_internal_global_pixdata_buffer, state->palette, output_state->pixel_write_pos, state->count, state->indices)) {
+        return false;
+    }
+    output_state->pixel_write_pos += state->count;
+    state->count = 0;
+
+    // If we've hit the transmit limit, send out the entire buffer and reset the write position
+    if (output_state->pixel_write_pos == output_state->max_pixels) {
+        if (!state->driver->driver_vtable->pixdata(output_state->device, qp_internal_global_pixdata_buffer, output_state->pixel_write_pos)) {
+            return false;
+        }
+        output_state->pixel_write_pos = 0;
+    }
+
+    qp_internal_bulk_update_capacity(state);
+    return true;
+}
+
+// Constant bits_per_pixel lets the compiler unroll a specialised kernel per bpp
+static inline void qp_internal_bulk_unpack_word(uint8_t* indices, uint32_t word, const uint8_t bits_per_pixel) {
+    const uint8_t pixel_bitmask = (1 << bits_per_pixel) - 1;
+    for (uint8_t i = 0; i < 32 / bits_per_pixel; ++i) {
+        indices[i] = word & pixel_bitmask;
+        word >>= bits_per_pixel;
+    }
+}
+
+static bool qp_internal_bulk_emit_bytes(struct qp_internal_bulk_decode_state* state, const uint8_t* src, uint32_t byte_count) {
+    const uint8_t word_pixels = 32 / state->bits_per_pixel;
+    while (byte_count > 0 && state->remaining_pixels > 0) {
+        if (state->count == state->capacity && !qp_internal_bulk_flush(state)) {
+            return false;
+        }
+
+        uint32_t space = state->capacity - state->count;
+
+        // 8bpp data is already a list of palette indices
+        if (state->bits_per_pixel == 8) {
+            uint32_t n = QP_MIN(QP_MIN(byte_count, space), state->remaining_pixels);
+            memcpy(&state->indices[state->count], src, n);
+            state->count += n;
+            state->remaining_pixels -= n;
+            src += n;
+            byte_count -= n;
+            continue;
+        }
+
+        // Unpack a full 32-bit word of packed pixels whenever there's enough input, output space, and pixels left
+        if (byte_count >= 4 && space >= word_pixels && state->remaining_pixels >= word_pixels) {
+            uint32_t word = ((uint32_t)src[0]) | ((uint32_t)src[1] << 8) | ((uint32_t)src[2] << 16) | ((uint32_t)src[3] << 24);
+            switch (state->bits_per_pixel) {
+                case 1:
+                    qp_internal_bulk_unpack_word(&state->indices[state->count], word, 1);
+                    break;
+                case 2:
+                    qp_internal_bulk_unpack_word(&state->indices[state->count], word, 2);
+                    break;
+                case 4:
+                    qp_internal_bulk_unpack_word(&state->indices[state->count], word, 4);
+                    break;
+                default:
+                    return false;
+            }
+            state->count += word_pixels;
+            state->remaining_pixels -= word_pixels;
+            src += 4;
+            byte_count -= 4;
+            continue;
+        }
+
+        // Leftovers go a byte at a time; the final byte may only be partially used
+        uint8_t byteval     = *src++;
+        uint8_t loop_pixels = state->remaining_pixels < state->pixels_per_byte ? state->remaining_pixels : state->pixels_per_byte;
+        for (uint8_t q = 0; q < loop_pixels; ++q) {
+            if (state->count == state->capacity && !qp_internal_bulk_flush(state)) {
+                return false;
+            }
+            state->indices[state->count++] = byteval & state->pixel_bitmask;
+            byteval >>= state->bits_per_pixel;
+        }
+        state->remaining_pixels -= loop_pixels;
+        byte_count--;
+    }
+    return true;
+}
+
+static bool qp_internal_bulk_emit_repeat(struct qp_internal_bulk_decode_state* state, uint8_t byteval, uint32_t byte_count) {
+    // Unpack the repeated byte once, its pixels then repeat with a period of pixels_per_byte
+    uint8_t pattern[8];
+    bool    uniform = true;
+    for (uint8_t q = 0; q < state->pixels_per_byte; ++q) {
+        pattern[q] = (byteval >> (q * state->bits_per_pixel)) & state->pixel_bitmask;
+        uniform &= pattern[q] == pattern[0];
+    }
+
+    uint32_t pixels = QP_MIN(byte_count * state->pixels_per_byte, state->remaining_pixels);
+    uint8_t  phase  = 0;
+    state->remaining_pixels -= pixels;
+    while (pixels > 0) {
+        if (state->count == state->capacity && !qp_internal_bulk_flush(state)) {
+            return false;
+        }
+
+        uint8_t n = QP_MIN(pixels, (uint32_t)(state->capacity - state->count));
+        if (uniform) {
+            memset(&state->indices[state->count], pattern[0], n);
+        } else {
+            for (uint8_t i = 0; i < n; ++i) {
+                state->indices[state->count + i] = pattern[phase];
+                phase                            = (phase + 1) & (state->pixels_per_byte - 1);
+            }
+        }
+        state->count += n;
+        pixels -= n;
+    }
+    return true;
+}
+
+static bool qp_internal_decode_palette_bulk(painter_device_t device, uint32_t pixel_count, uint8_t bits_per_pixel, struct qp_internal_byte_input_state* input_state, bool rle, qp_pixel_t* palette, struct qp_internal_pixel_output_state* output_state) {
+    struct qp_internal_bulk_decode_state state = {
+        .driver           = (struct painter_driver_t*)device,
+        .output_state     = output_state,
+        .palette          = palette,
+        .remaining_pixels = pixel_count,
+        .bits_per_pixel   = bits_per_pixel,
+        .pixels_per_byte  = 8 / bits_per_pixel,
+        .pixel_bitmask    = (1 << bits_per_pixel) - 1,
+        .count            = 0,
+    };
+    qp_internal_bulk_update_capacity(&state);
+
+    int32_t        available;
+    int32_t        position = 0;
+    const uint8_t* src      = qp_memory_stream_remaining(input_state->src_stream, &available);
+
+    if (!rle) {
+        uint32_t byte_count = (pixel_count + state.pixels_per_byte - 1) / state.pixels_per_byte;
+        if ((int32_t)byte_count > available) {
+            qp_dprintf("qp_internal_decode_palette: fail (image data truncated)\n");
+            return false;
+        }
+        if (!qp_internal_bulk_emit_bytes(&state, src, byte_count)) {
+            return false;
+        }
+        position = byte_count;
+        if (byte_count > 0) {
+            input_state->curr = src[byte_count - 1];
+        }
+    } else {
+        // Mirrors qp_drawimage_byte_rle_decoder, including its lookahead of the next byte in non-repeating runs, so that
+        // the input state is left exactly as the callback path would leave it
+        while (state.remaining_pixels > 0) {
+            if (input_state->rle.mode == MARKER_BYTE) {
+                if (position + 2 > available) {
+                    qp_dprintf("qp_internal_decode_palette: fail (image data truncated)\n");
+                    return false;
+                }
+                uint8_t c = src[position++];
+                if (c >= 128) {
+                    input_state->rle.mode   = NON_REPEATING_RUN;
+                    input_state->rle.remain = c - 127;
+                } else {
+                    input_state->rle.mode   = REPEATING_RUN;
+                    input_state->rle.remain = c;
+                }
+                input_state->curr = src[position++];
+            }
+
+            uint32_t bytes_needed = (state.remaining_pixels + state.pixels_per_byte - 1) / state.pixels_per_byte;
+            uint8_t  n            = QP_MIN((uint32_t)input_state->rle.remain, bytes_needed);
+            if (input_state->rle.mode == REPEATING_RUN) {
+                if (!qp_internal_bulk_emit_repeat(&state, (uint8_t)input_state->curr, n)) {
+                    return false;
+                }
+                input_state->rle.remain -= n;
+            } else if (n > 0) {
+                // The first byte of the run has already been read, the rest come straight from the stream
+                uint8_t first = (uint8_t)input_state->curr;
+                if (position + (n - 1) > available) {
+                    qp_dprintf("qp_internal_decode_palette: fail (image data truncated)\n");
+                    return false;
+                }
+                if (!qp_internal_bulk_emit_bytes(&state, &first, 1) || !qp_internal_bulk_emit_bytes(&state, &src[position], n - 1)) {
+                    return false;
+                }
+                position += n - 1;
+                input_state->rle.remain -= n;
+                if (input_state->rle.remain > 0) {
+                    input_state->curr = position < available ? src[position++] : STREAM_EOF;
+                }
+            }
+
+            if (input_state->rle.remain == 0) {
+                input_state->rle.mode = MARKER_BYTE;
+            }
+        }
+    }
+
+    qp_stream_seek(input_state->src_stream, position, SEEK_CUR);
+    return qp_internal_bulk_flush(&state);
+}
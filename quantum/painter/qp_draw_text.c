@@ -35,6 +35,71 @@ typedef struct qff_font_handle_t {
 
 static qff_font_handle_t font_descriptors[QUANTUM_PAINTER_NUM_FONTS] = {0};
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Glyph cache
+
+static uint32_t glyph_cache_hits   = 0;
+static uint32_t glyph_cache_misses = 0;
+
+#if QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+// Decoded glyph in the native pixel format of the device it was drawn to, unused if font is NULL
+typedef struct qp_glyph_cache_entry_t {
+    painter_device_t   device;
+    qff_font_handle_t *font;
+    uint32_t           code_point;
+    qp_pixel_t         fg_hsv888;
+    qp_pixel_t         bg_hsv888;
+    uint32_t           last_used;
+    uint8_t            width;
+    __attribute__((__aligned__(4))) uint8_t data[QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE];
+} qp_glyph_cache_entry_t;
+
+static qp_glyph_cache_entry_t glyph_cache[QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES] = {0};
+static uint32_t               glyph_cache_clock                                = 0;
+
+static qp_glyph_cache_entry_t *qp_glyph_cache_find(painter_device_t device, qff_font_handle_t *qff_font, uint32_t code_point, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888) {
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES; ++i) {
+        qp_glyph_cache_entry_t *entry = &glyph_cache[i];
+        if (entry->font == qff_font && entry->code_point == code_point && entry->device == device && entry->fg_hsv888.dummy == fg_hsv888.dummy && entry->bg_hsv888.dummy == bg_hsv888.dummy) {
+            entry->last_used = ++glyph_cache_clock;
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+// Hands out the least recently used entry, already keyed for the new glyph
+static qp_glyph_cache_entry_t *qp_glyph_cache_claim(painter_device_t device, qff_font_handle_t *qff_font, uint32_t code_point, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, uint8_t width) {
+    qp_glyph_cache_entry_t *entry = &glyph_cache[0];
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES; ++i) {
+        if (!glyph_cache[i].font) {
+            entry = &glyph_cache[i];
+            break;
+        }
+        if (glyph_cache[i].last_used < entry->last_used) {
+            entry = &glyph_cache[i];
+        }
+    }
+
+    entry->device     = device;
+    entry->font       = qff_font;
+    entry->code_point = code_point;
+    entry->fg_hsv888  = fg_hsv888;
+    entry->bg_hsv888  = bg_hsv888;
+    entry->width      = width;
+    entry->last_used  = ++glyph_cache_clock;
+    return entry;
+}
+
+static void qp_glyph_cache_purge_font(qff_font_handle_t *qff_font) {
+    for (int i = 0; i < QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES; ++i) {
+        if (glyph_cache[i].font == qff_font) {
+            glyph_cache[i].font = NULL;
+        }
+    }
+}
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quantum Painter External API: qp_load_font_mem
 
@@ -132,6 +197,11 @@ bool qp_close_font(painter_font_handle_t font) {
     }
 #endif // QUANTUM_PAINTER_LOAD_FONTS_TO_RAM
 
+#if QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+    // The slot may be reused by another font, so drop any glyphs decoded from this one
+    qp_glyph_cache_purge_font(qff_font);
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+
     // Free up this font for use elsewhere.
     qff_font->validate_ok = false;
     return true;
@@ -141,7 +211,7 @@ bool qp_close_font(painter_font_handle_t font) {
 // Helpers
 
 // Callback to be invoked for each codepoint detected in the UTF8 input string
-typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg);
+typedef bool (*code_point_handler)(qff_font_handle_t *qff_font, uint32_t code_point, void *cb_arg);
 
 // Helper that sets up the palette (if required) and returns the offset in the stream that the data starts
 static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device, qff_font_handle_t *qff_font, qp_pixel_t fg_hsv888, qp_pixel_t bg_hsv888, uint32_t *data_offset) {
@@ -185,7 +255,6 @@ static inline bool qp_drawtext_prepare_font_for_render(painter_device_t device,
         // Convert the palette to native format
         if (!driver->driver_vtable->palette_convert(device, palette_entries, qp_internal_global_pixel_lookup_table)) {
             qp_dprintf("qp_drawtext_recolor: fail (could not convert pixels to native)\n");
-            qp_comms_stop(device);
             return false;
         }
     }
@@ -272,7 +341,8 @@ static inline bool qp_drawtext_prepare_glyph_for_render(qff_font_handle_t *qff_f
     return false;
 }
 
-// Function to iterate over each UTF8 codepoint, invoking the callback for each decoded glyph
+// Function to iterate over each UTF8 codepoint, invoking the callback for each decoded code point.
+// Handlers locate the glyph themselves, so that cached glyphs don't need to touch the font stream.
 static inline bool qp_iterate_code_points(qff_font_handle_t *qff_font, const char *str, code_point_handler handler, void *cb_arg) {
     while (*str) {
         int32_t code_point = 0;
@@ -282,13 +352,7 @@ static inline bool qp_iterate_code_points(qff_font_handle_t *qff_font, const cha
             return false;
         }
 
-        uint8_t width;
-        if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &width)) {
-            qp_dprintf("Failed to prepare glyph for rendering.\n");
-            return false;
-        }
-
-        if (!handler(qff_font, code_point, width, qff_font->base.line_height, cb_arg)) {
+        if (!handler(qff_font, code_point, cb_arg)) {
             qp_dprintf("Failed to execute glyph handler.\n");
             return false;
         }
@@ -296,6 +360,36 @@ static inline bool qp_iterate_code_points(qff_font_handle_t *qff_font, const cha
     return true;
 }
 
+// Output state for decoding glyphs into a native pixel buffer, rather than straight to the device
+struct qp_drawtext_buffer_output_state {
+    painter_device_t device;
+    uint8_t *        buffer;
+    uint16_t         stride; // width of the buffer, in pixels
+    uint16_t         xpos;   // column of the buffer the glyph starts at
+    uint8_t          glyph_width;
+    uint32_t         pixel_pos;
+};
+
+static bool qp_drawtext_buffer_appender(qp_pixel_t *palette, uint8_t index, void *cb_arg) {
+    struct qp_drawtext_buffer_output_state *state  = (struct qp_drawtext_buffer_output_state *)cb_arg;
+    struct painter_driver_t *               driver = (struct painter_driver_t *)state->device;
+
+    uint32_t offset = (state->pixel_pos / state->glyph_width) * state->stride + state->xpos + (state->pixel_pos % state->glyph_width);
+    state->pixel_pos++;
+    return driver->driver_vtable->append_pixels(state->device, state->buffer, palette, offset, 1, &index);
+}
+
+// Decodes the glyph the font stream is positioned at into a native pixel buffer
+static bool qp_drawtext_decode_glyph_to_buffer(painter_device_t device, qff_font_handle_t *qff_font, qp_internal_byte_input_callback input_callback, struct qp_internal_byte_input_state *input_state, uint8_t width, uint8_t *buffer, uint16_t stride, uint16_t xpos) {
+    struct qp_drawtext_buffer_output_state output_state = {.device = device, .buffer = buffer, .stride = stride, .xpos = xpos, .glyph_width = width, .pixel_pos = 0};
+
+    // Reset the input state's RLE mode -- the stream should already be correctly positioned
+    input_state->rle.mode = MARKER_BYTE; // ignored if not using RLE
+
+    uint32_t pixel_count = ((uint32_t)width) * qff_font->base.line_height;
+    return qp_internal_decode_palette(device, pixel_count, qff_font->bpp, input_callback, input_state, qp_internal_global_pixel_lookup_table, qp_drawtext_buffer_appender, &output_state);
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // String width calculation
 
@@ -305,9 +399,15 @@ struct code_point_iter_calcwidth_state {
 };
 
 // Codepoint handler callback: width calc
-static inline bool qp_font_code_point_handler_calcwidth(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg) {
+static inline bool qp_font_code_point_handler_calcwidth(qff_font_handle_t *qff_font, uint32_t code_point, void *cb_arg) {
     struct code_point_iter_calcwidth_state *state = (struct code_point_iter_calcwidth_state *)cb_arg;
 
+    uint8_t width;
+    if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &width)) {
+        qp_dprintf("Failed to prepare glyph for rendering.\n");
+        return false;
+    }
+
     // Increment the overall width by this glyph's width
     state->width += width;
 
@@ -322,17 +422,70 @@ struct code_point_iter_drawglyph_state {
     painter_device_t                       device;
     int16_t                                xpos;
     int16_t                                ypos;
+    qp_pixel_t                             fg_hsv888;
+    qp_pixel_t                             bg_hsv888;
+    bool                                   font_prepared;
     qp_internal_byte_input_callback        input_callback;
     struct qp_internal_byte_input_state *  input_state;
     struct qp_internal_pixel_output_state *output_state;
 };
 
+// Sets up the palette on first use, so that strings served entirely from the glyph cache skip it
+static inline bool qp_drawtext_ensure_font_prepared(qff_font_handle_t *qff_font, struct code_point_iter_drawglyph_state *state) {
+    uint32_t data_offset;
+    if (!state->font_prepared && !qp_drawtext_prepare_font_for_render(state->device, qff_font, state->fg_hsv888, state->bg_hsv888, &data_offset)) {
+        qp_dprintf("Failed to prepare font for rendering.\n");
+        return false;
+    }
+    state->font_prepared = true;
+    return true;
+}
+
 // Codepoint handler callback: drawing
-static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_font, uint32_t code_point, uint8_t width, uint8_t height, void *cb_arg) {
+static inline bool qp_font_code_point_handler_drawglyph(qff_font_handle_t *qff_font, uint32_t code_point, void *cb_arg) {
     struct code_point_iter_drawglyph_state *state  = (struct code_point_iter_drawglyph_state *)cb_arg;
     struct painter_driver_t *               driver = (struct painter_driver_t *)state->device;
+    uint8_t                                 height = qff_font->base.line_height;
+    uint8_t                                 width;
+
+#if QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+    // Cached glyphs go out in a single transfer, without touching the font
+    qp_glyph_cache_entry_t *entry = qp_glyph_cache_find(state->device, qff_font, code_point, state->fg_hsv888, state->bg_hsv888);
+    if (entry) {
+        glyph_cache_hits++;
+        width = entry->width;
+        driver->driver_vtable->viewport(state->device, state->xpos, state->ypos, state->xpos + width - 1, state->ypos + height - 1);
+        state->xpos += width;
+        return driver->driver_vtable->pixdata(state->device, entry->data, ((uint32_t)width) * height);
+    }
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+    glyph_cache_misses++;
+
+    if (!qp_drawtext_ensure_font_prepared(qff_font, state)) {
+        return false;
+    }
+
+    if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &width)) {
+        qp_dprintf("Failed to prepare glyph for rendering.\n");
+        return false;
+    }
+
+#if QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+    // Decode into the cache if it fits, then send it from there
+    if (((uint32_t)width * height * driver->native_bits_per_pixel + 7) / 8 <= QUANTUM_PAINTER_GLYPH_CACHE_ENTRY_SIZE) {
+        entry = qp_glyph_cache_claim(state->device, qff_font, code_point, state->fg_hsv888, state->bg_hsv888, width);
+        if (!qp_drawtext_decode_glyph_to_buffer(state->device, qff_font, state->input_callback, state->input_state, width, entry->data, width, 0)) {
+            entry->font = NULL;
+            return false;
+        }
 
-    // Reset the input state's RLE mode -- the stream should already be correctly positioned by qp_iterate_code_points()
+        driver->driver_vtable->viewport(state->device, state->xpos, state->ypos, state->xpos + width - 1, state->ypos + height - 1);
+        state->xpos += width;
+        return driver->driver_vtable->pixdata(state->device, entry->data, ((uint32_t)width) * height);
+    }
+#endif // QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES > 0
+
+    // Reset the input state's RLE mode -- the stream should already be correctly positioned by qp_drawtext_prepare_glyph_for_render()
     state->input_state->rle.mode = MARKER_BYTE; // ignored if not using RLE
 
     // Reset the output state
@@ -415,30 +568,151 @@ int16_t qp_drawtext_recolor(painter_device_t device, uint16_t x, uint16_t y, pai
     // Set up the pixel output state
     struct qp_internal_pixel_output_state output_state = {.device = device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(device)};
 
-    // Set up the codepoint iteration state
+    // Set up the codepoint iteration state, the palette is prepared on the first glyph that isn't cached
     struct code_point_iter_drawglyph_state state = {// Common
-                                                    .device = device,
-                                                    .xpos   = x,
-                                                    .ypos   = y,
+                                                    .device        = device,
+                                                    .xpos          = x,
+                                                    .ypos          = y,
+                                                    .fg_hsv888     = {.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}},
+                                                    .bg_hsv888     = {.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}},
+                                                    .font_prepared = false,
                                                     // Input
                                                     .input_callback = input_callback,
                                                     .input_state    = &input_state,
                                                     // Output
                                                     .output_state = &output_state};
 
+    // Iterate the codepoints with the drawglyph callback
+    bool ret = qp_iterate_code_points(qff_font, str, qp_font_code_point_handler_drawglyph, &state);
+
+    qp_dprintf("qp_drawtext_recolor: %s\n", ret ? "ok" : "fail");
+    qp_comms_stop(device);
+    return ret ? (state.xpos - x) : 0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_drawtext_prerender_size
+
+uint32_t qp_drawtext_prerender_size(painter_device_t device, painter_font_handle_t font, const char *str) {
+    struct painter_driver_t *driver   = (struct painter_driver_t *)device;
+    qff_font_handle_t *      qff_font = (qff_font_handle_t *)font;
+    if (!qff_font->validate_ok) {
+        qp_dprintf("qp_drawtext_prerender_size: fail (invalid font)\n");
+        return 0;
+    }
+
+    uint32_t width = (uint32_t)qp_textwidth(font, str);
+    return (width * qff_font->base.line_height * driver->native_bits_per_pixel + 7) / 8;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_drawtext_prerender_recolor
+
+// Callback state
+struct code_point_iter_prerender_state {
+    painter_device_t                     device;
+    uint8_t *                            buffer;
+    uint16_t                             stride;
+    uint16_t                             xpos;
+    qp_internal_byte_input_callback      input_callback;
+    struct qp_internal_byte_input_state *input_state;
+};
+
+// Codepoint handler callback: render into the run buffer
+static inline bool qp_font_code_point_handler_prerender(qff_font_handle_t *qff_font, uint32_t code_point, void *cb_arg) {
+    struct code_point_iter_prerender_state *state = (struct code_point_iter_prerender_state *)cb_arg;
+
+    uint8_t width;
+    if (!qp_drawtext_prepare_glyph_for_render(qff_font, code_point, &width)) {
+        qp_dprintf("Failed to prepare glyph for rendering.\n");
+        return false;
+    }
+
+    bool ret = qp_drawtext_decode_glyph_to_buffer(state->device, qff_font, state->input_callback, state->input_state, width, state->buffer, state->stride, state->xpos);
+    state->xpos += width;
+    return ret;
+}
+
+int16_t qp_drawtext_prerender_recolor(painter_device_t device, painter_font_handle_t font, const char *str, uint8_t hue_fg, uint8_t sat_fg, uint8_t val_fg, uint8_t hue_bg, uint8_t sat_bg, uint8_t val_bg, void *buffer, uint32_t buffer_size, painter_text_run_t *run) {
+    qp_dprintf("qp_drawtext_prerender_recolor: entry\n");
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    if (!driver->validate_ok) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (validation_ok == false)\n");
+        return 0;
+    }
+
+    qff_font_handle_t *qff_font = (qff_font_handle_t *)font;
+    if (!qff_font->validate_ok) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (invalid font)\n");
+        return 0;
+    }
+
+    int16_t width = qp_textwidth(font, str);
+    if (width <= 0 || qp_drawtext_prerender_size(device, font, str) > buffer_size) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (empty string, or buffer too small)\n");
+        return 0;
+    }
+
+    // Set up the byte input state and input callback
+    struct qp_internal_byte_input_state input_state    = {.device = device, .src_stream = &qff_font->stream};
+    qp_internal_byte_input_callback     input_callback = qp_internal_prepare_input_state(&input_state, qff_font->compression_scheme);
+    if (input_callback == NULL) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (invalid font compression scheme)\n");
+        return 0;
+    }
+
     qp_pixel_t fg_hsv888 = {.hsv888 = {.h = hue_fg, .s = sat_fg, .v = val_fg}};
     qp_pixel_t bg_hsv888 = {.hsv888 = {.h = hue_bg, .s = sat_bg, .v = val_bg}};
     uint32_t   data_offset;
-    if (!qp_drawtext_prepare_font_for_render(driver, qff_font, fg_hsv888, bg_hsv888, &data_offset)) {
-        qp_dprintf("qp_drawtext_recolor: fail (failed to prepare font for rendering)\n");
-        qp_comms_stop(device);
+    if (!qp_drawtext_prepare_font_for_render(device, qff_font, fg_hsv888, bg_hsv888, &data_offset)) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (failed to prepare font for rendering)\n");
+        return 0;
+    }
+
+    // Nothing is sent to the device, glyphs are decoded side by side into the caller's buffer
+    struct code_point_iter_prerender_state state = {.device = device, .buffer = (uint8_t *)buffer, .stride = width, .xpos = 0, .input_callback = input_callback, .input_state = &input_state};
+    if (!qp_iterate_code_points(qff_font, str, qp_font_code_point_handler_prerender, &state)) {
+        qp_dprintf("qp_drawtext_prerender_recolor: fail (could not render glyphs)\n");
+        return 0;
+    }
+
+    run->width  = width;
+    run->height = qff_font->base.line_height;
+    run->pixels = buffer;
+    qp_dprintf("qp_drawtext_prerender_recolor: ok\n");
+    return width;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_drawtext_run
+
+bool qp_drawtext_run(painter_device_t device, uint16_t x, uint16_t y, const painter_text_run_t *run) {
+    qp_dprintf("qp_drawtext_run: entry\n");
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    if (!driver->validate_ok) {
+        qp_dprintf("qp_drawtext_run: fail (validation_ok == false)\n");
         return false;
     }
 
-    // Iterate the codepoints with the drawglyph callback
-    bool ret = qp_iterate_code_points(qff_font, str, qp_font_code_point_handler_drawglyph, &state);
+    if (!qp_comms_start(device)) {
+        qp_dprintf("qp_drawtext_run: fail (could not start comms)\n");
+        return false;
+    }
 
-    qp_dprintf("qp_drawtext_recolor: %s\n", ret ? "ok" : "fail");
+    bool ret = driver->driver_vtable->viewport(device, x, y, x + run->width - 1, y + run->height - 1) && driver->driver_vtable->pixdata(device, run->pixels, ((uint32_t)run->width) * run->height);
     qp_comms_stop(device);
-    return ret ? (state.xpos - x) : 0;
+    qp_dprintf("qp_drawtext_run: %s\n", ret ? "ok" : "fail");
+    return ret;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Quantum Painter External API: qp_get_glyph_cache_stats
+
+void qp_get_glyph_cache_stats(uint32_t *hits, uint32_t *misses) {
+    if (hits) {
+        *hits = glyph_cache_hits;
+    }
+    if (misses) {
+        *misses = glyph_cache_misses;
+    }
 }
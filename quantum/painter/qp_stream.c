@@ -122,6 +122,15 @@ qp_memory_stream_t qp_make_memory_stream(void *buffer, int32_t length) {
     return stream;
 }
 
+const uint8_t *qp_memory_stream_remaining(qp_stream_t *stream, int32_t *available) {
+    if (stream->get != mem_get) {
+        return NULL;
+    }
+    qp_memory_stream_t *s = (qp_memory_stream_t *)stream;
+    *available            = s->length - s->position;
+    return &s->buffer[s->position];
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // FILE streams
 
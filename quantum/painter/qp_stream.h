@@ -67,6 +67,9 @@ typedef struct qp_memory_stream_t {
 
 qp_memory_stream_t qp_make_memory_stream(void *buffer, int32_t length);
 
+// Direct access to the unread portion of a memory stream, for bulk consumers -- returns NULL if the stream isn't memory-backed
+const uint8_t *qp_memory_stream_remaining(qp_stream_t *stream, int32_t *available);
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // FILE streams
 
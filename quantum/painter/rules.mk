@@ -3,7 +3,7 @@ QUANTUM_PAINTER_DRIVERS ?=
 QUANTUM_PAINTER_ANIMATIONS_ENABLE ?= yes
 
 # The list of permissible drivers that can be listed in QUANTUM_PAINTER_DRIVERS
-VALID_QUANTUM_PAINTER_DRIVERS := ili9163_spi ili9341_spi ili9488_spi st7789_spi st7735_spi gc9a01_spi ssd1351_spi
+VALID_QUANTUM_PAINTER_DRIVERS := surface ili9163_spi ili9341_spi ili9488_spi st7789_spi st7735_spi gc9a01_spi ssd1351_spi
 
 #-------------------------------------------------------------------------------
 
@@ -15,6 +15,7 @@ SRC += \
     $(QUANTUM_DIR)/color.c \
     $(QUANTUM_DIR)/painter/qp.c \
     $(QUANTUM_DIR)/painter/qp_stream.c \
+    $(QUANTUM_DIR)/painter/qp_comms.c \
     $(QUANTUM_DIR)/painter/qgf.c \
     $(QUANTUM_DIR)/painter/qff.c \
     $(QUANTUM_DIR)/painter/qp_draw_core.c \
@@ -40,6 +41,14 @@ define handle_quantum_painter_driver
     ifeq ($$(filter $$(strip $$(CURRENT_PAINTER_DRIVER)),$$(VALID_QUANTUM_PAINTER_DRIVERS)),)
         $$(error "$$(CURRENT_PAINTER_DRIVER)" is not a valid Quantum Painter driver)
 
+    else ifeq ($$(strip $$(CURRENT_PAINTER_DRIVER)),surface)
+        OPT_DEFS += -DQUANTUM_PAINTER_SURFACE_ENABLE
+        COMMON_VPATH += $(DRIVER_PATH)/painter/generic
+        SRC += \
+            $(DRIVER_PATH)/painter/generic/qp_surface_common.c \
+            $(DRIVER_PATH)/painter/generic/qp_surface_rgb565.c \
+            $(DRIVER_PATH)/painter/generic/qp_surface_indexed.c
+
     else ifeq ($$(strip $$(CURRENT_PAINTER_DRIVER)),ili9163_spi)
         QUANTUM_PAINTER_NEEDS_COMMS_SPI := yes
         QUANTUM_PAINTER_NEEDS_COMMS_SPI_DC_RESET := yes
@@ -129,7 +138,6 @@ ifeq ($(strip $(QUANTUM_PAINTER_NEEDS_COMMS_SPI)), yes)
     QUANTUM_LIB_SRC += spi_master.c
     VPATH += $(DRIVER_PATH)/painter/comms
     SRC += \
-        $(QUANTUM_DIR)/painter/qp_comms.c \
         $(DRIVER_PATH)/painter/comms/qp_comms_spi.c
 
     ifeq ($(strip $(QUANTUM_PAINTER_NEEDS_COMMS_SPI_DC_RESET)), yes)
@@ -0,0 +1,81 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "capture_device.hpp"
+
+std::vector<uint8_t>                  captured_pixels;
+std::vector<uint32_t>                 captured_transfers;
+std::vector<std::array<uint16_t, 4>> captured_viewports;
+
+bool capture_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count) {
+    const uint8_t *pixels = (const uint8_t *)pixel_data;
+    uint32_t       bytes  = native_pixel_count * ((struct painter_driver_t *)device)->native_bits_per_pixel / 8;
+    captured_pixels.insert(captured_pixels.end(), pixels, pixels + bytes);
+    captured_transfers.push_back(native_pixel_count);
+    return true;
+}
+
+void capture_reset(void) {
+    captured_pixels.clear();
+    captured_transfers.clear();
+    captured_viewports.clear();
+}
+
+static bool capture_viewport(painter_device_t device, uint16_t left, uint16_t top, uint16_t right, uint16_t bottom) {
+    captured_viewports.push_back({left, top, right, bottom});
+    return true;
+}
+
+// Folds the whole colour into the native value, so that a glyph drawn in the wrong colour shows up in the output
+static bool capture_palette_convert(painter_device_t device, int16_t palette_size, qp_pixel_t *palette) {
+    for (int16_t i = 0; i < palette_size; ++i) {
+        uint8_t native         = (uint8_t)(palette[i].hsv888.h * 31 + palette[i].hsv888.s * 7 + palette[i].hsv888.v);
+        palette[i].palette_idx = native;
+    }
+    return true;
+}
+
+static bool capture_append_pixels(painter_device_t device, uint8_t *target_buffer, qp_pixel_t *palette, uint32_t pixel_offset, uint32_t pixel_count, uint8_t *palette_indices) {
+    for (uint32_t i = 0; i < pixel_count; ++i) {
+        target_buffer[pixel_offset + i] = palette[palette_indices[i]].palette_idx;
+    }
+    return true;
+}
+
+static bool capture_comms_start(painter_device_t device) {
+    return true;
+}
+
+static void capture_comms_stop(painter_device_t device) {}
+
+static const struct painter_driver_vtable_t capture_vtable = {
+    .viewport        = capture_viewport,
+    .pixdata         = capture_pixdata,
+    .palette_convert = capture_palette_convert,
+    .append_pixels   = capture_append_pixels,
+};
+
+static const struct painter_comms_vtable_t capture_comms_vtable = {
+    .comms_start = capture_comms_start,
+    .comms_stop  = capture_comms_stop,
+};
+
+struct painter_driver_t capture_device = {
+    .driver_vtable         = &capture_vtable,
+    .comms_vtable          = &capture_comms_vtable,
+    .validate_ok           = true,
+    .native_bits_per_pixel = 8,
+};
@@ -0,0 +1,41 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// The painter headers use C11 static assertions
+#define _Static_assert static_assert
+
+extern "C" {
+#include "qp_internal.h"
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Capturing device -- 8bpp native pixels, recording every viewport and everything sent via pixdata. Copies with a wider
+// native_bits_per_pixel capture the raw bytes of whatever is pushed to them.
+
+extern std::vector<uint8_t>                  captured_pixels;
+extern std::vector<uint32_t>                 captured_transfers;
+extern std::vector<std::array<uint16_t, 4>> captured_viewports;
+
+extern struct painter_driver_t capture_device;
+
+bool capture_pixdata(painter_device_t device, const void *pixel_data, uint32_t native_pixel_count);
+void capture_reset(void);
@@ -0,0 +1,244 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "capture_device.hpp"
+
+extern "C" {
+#include "qp_draw.h"
+#include "qp_stream.h"
+#include "qgf.h"
+#include "djinn.qgf.h"
+#include "lock-caps-ON.qgf.h"
+#include "lock-num-ON.qgf.h"
+#include "lock-scrl-ON.qgf.h"
+}
+
+// Number of times each sample image is decoded when measuring throughput
+#define BENCHMARK_ITERATIONS 2000
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+
+// Wrapping the appender hides it from the bulk decoder, forcing the per-pixel callback path
+static bool forwarding_appender(qp_pixel_t *palette, uint8_t index, void *cb_arg) {
+    return qp_internal_pixel_appender(palette, index, cb_arg);
+}
+
+struct decoded_frame_t {
+    uint8_t               bpp;
+    painter_compression_t compression;
+    uint32_t              pixel_count;
+    qp_memory_stream_t    stream;
+};
+
+static bool open_qgf_frame(const uint8_t *data, uint32_t length, decoded_frame_t *frame) {
+    frame->stream = qp_make_memory_stream((void *)data, length);
+    uint16_t width, height, frame_count;
+    uint32_t total_bytes;
+    if (!qgf_validate_stream((qp_stream_t *)&frame->stream) || !qgf_read_graphics_descriptor((qp_stream_t *)&frame->stream, &width, &height, &frame_count, &total_bytes)) {
+        return false;
+    }
+
+    qgf_seek_to_frame_descriptor((qp_stream_t *)&frame->stream, 0);
+    qgf_frame_v1_t frame_descriptor;
+    bool           has_palette, is_delta;
+    uint16_t       delay;
+    if (qp_stream_read(&frame_descriptor, sizeof(qgf_frame_v1_t), 1, &frame->stream) != 1 || !qgf_parse_frame_descriptor(&frame_descriptor, &frame->bpp, &has_palette, &is_delta, &frame->compression, &delay)) {
+        return false;
+    }
+    if (has_palette || is_delta) {
+        return false;
+    }
+
+    qgf_data_v1_t data_descriptor;
+    frame->pixel_count = (uint32_t)width * height;
+    return qp_stream_read(&data_descriptor, sizeof(qgf_data_v1_t), 1, &frame->stream) == 1;
+}
+
+static void prepare_palette(void) {
+    // Scramble the native values so that any mix-up of palette indices shows up in the output
+    for (size_t i = 0; i < sizeof(qp_internal_global_pixel_lookup_table) / sizeof(qp_pixel_t); ++i) {
+        qp_internal_global_pixel_lookup_table[i].palette_idx = (uint8_t)(i * 37 + 11);
+    }
+}
+
+// Decodes the frame in `pieces` separate calls sharing the same input state, as glyph rendering does. Each piece bar the
+// last is a whole number of bytes, as any partially-used byte is discarded at the end of a call.
+static bool decode(decoded_frame_t &frame, bool use_callbacks, uint32_t pieces = 1) {
+    struct qp_internal_byte_input_state   input_state    = {.device = &capture_device, .src_stream = (qp_stream_t *)&frame.stream};
+    qp_internal_byte_input_callback       input_callback = qp_internal_prepare_input_state(&input_state, frame.compression);
+    struct qp_internal_pixel_output_state output_state   = {.device = &capture_device, .pixel_write_pos = 0, .max_pixels = qp_internal_num_pixels_in_buffer(&capture_device)};
+
+    uint32_t remaining = frame.pixel_count;
+    for (uint32_t piece = 0; piece < pieces; ++piece) {
+        uint32_t count = piece == pieces - 1 ? remaining : (frame.pixel_count / pieces) & ~7u;
+        if (!qp_internal_decode_palette(&capture_device, count, frame.bpp, input_callback, &input_state, qp_internal_global_pixel_lookup_table, use_callbacks ? forwarding_appender : qp_internal_pixel_appender, &output_state)) {
+            return false;
+        }
+        remaining -= count;
+    }
+
+    if (output_state.pixel_write_pos > 0) {
+        capture_pixdata(&capture_device, qp_internal_global_pixdata_buffer, output_state.pixel_write_pos);
+    }
+    return true;
+}
+
+static std::vector<uint8_t> rle_compress(const std::vector<uint8_t> &input) {
+    std::vector<uint8_t> output;
+    size_t               i = 0;
+    while (i < input.size()) {
+        size_t repeat = 1;
+        while (i + repeat < input.size() && repeat < 127 && input[i + repeat] == input[i]) {
+            repeat++;
+        }
+        if (repeat >= 2) {
+            output.push_back((uint8_t)repeat);
+            output.push_back(input[i]);
+            i += repeat;
+            continue;
+        }
+
+        size_t literal = 1;
+        while (i + literal < input.size() && literal < 128 && !(i + literal + 1 < input.size() && input[i + literal] == input[i + literal + 1])) {
+            literal++;
+        }
+        output.push_back((uint8_t)(127 + literal));
+        output.insert(output.end(), input.begin() + i, input.begin() + i + literal);
+        i += literal;
+    }
+    return output;
+}
+
+// Packed pixel data with a mix of long runs and noise, so both RLE run kinds show up
+static std::vector<uint8_t> make_packed_data(size_t length, uint32_t seed) {
+    std::mt19937         rng(seed);
+    std::vector<uint8_t> data;
+    while (data.size() < length) {
+        uint8_t value = (uint8_t)rng();
+        size_t  run   = (rng() % 4 == 0) ? 2 + rng() % 200 : 1;
+        for (size_t i = 0; i < run && data.size() < length; ++i) {
+            data.push_back(rng() % 2 ? value : (uint8_t)rng());
+            if (run > 1) {
+                data.back() = value;
+            }
+        }
+    }
+    return data;
+}
+
+class PainterDecode : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        prepare_palette();
+        reset();
+    }
+
+    void reset() {
+        capture_reset();
+    }
+
+    void expect_paths_match(const decoded_frame_t &frame, uint32_t pieces = 1) {
+        reset();
+        decoded_frame_t callback_frame = frame;
+        ASSERT_TRUE(decode(callback_frame, true, pieces));
+        std::vector<uint8_t>  callback_pixels    = captured_pixels;
+        std::vector<uint32_t> callback_transfers = captured_transfers;
+
+        reset();
+        decoded_frame_t bulk_frame = frame;
+        ASSERT_TRUE(decode(bulk_frame, false, pieces));
+        EXPECT_EQ(callback_pixels.size(), frame.pixel_count);
+        EXPECT_EQ(captured_pixels, callback_pixels);
+        EXPECT_EQ(captured_transfers, callback_transfers);
+
+        // Both paths must leave the stream in the same place, so that subsequent reads carry on correctly
+        EXPECT_EQ(bulk_frame.stream.position, callback_frame.stream.position);
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Equivalence with the callback path
+
+TEST_F(PainterDecode, SampleImagesMatchCallbackPath) {
+    const struct {
+        const uint8_t *data;
+        uint32_t       length;
+    } samples[] = {
+        {gfx_djinn, gfx_djinn_length},
+        {gfx_lock_caps_ON, gfx_lock_caps_ON_length},
+        {gfx_lock_num_ON, gfx_lock_num_ON_length},
+        {gfx_lock_scrl_ON, gfx_lock_scrl_ON_length},
+    };
+
+    for (auto &sample : samples) {
+        decoded_frame_t frame;
+        ASSERT_TRUE(open_qgf_frame(sample.data, sample.length, &frame));
+        expect_paths_match(frame);
+        expect_paths_match(frame, 3);
+    }
+}
+
+TEST_F(PainterDecode, SyntheticDataMatchesCallbackPath) {
+    for (uint8_t bpp : {1, 2, 4, 8}) {
+        uint32_t             pixel_count = 999; // deliberately not a multiple of the pixels per byte or word
+        std::vector<uint8_t> raw         = make_packed_data((pixel_count * bpp + 7) / 8, bpp);
+        std::vector<uint8_t> rle         = rle_compress(raw);
+
+        for (uint32_t pieces : {1, 2, 7}) {
+            decoded_frame_t frame = {.bpp = bpp, .compression = IMAGE_UNCOMPRESSED, .pixel_count = pixel_count, .stream = qp_make_memory_stream(raw.data(), raw.size())};
+            SCOPED_TRACE("uncompressed " + std::to_string(bpp) + "bpp, " + std::to_string(pieces) + " piece(s)");
+            expect_paths_match(frame, pieces);
+
+            frame = {.bpp = bpp, .compression = IMAGE_COMPRESSED_RLE, .pixel_count = pixel_count, .stream = qp_make_memory_stream(rle.data(), rle.size())};
+            SCOPED_TRACE("rle " + std::to_string(bpp) + "bpp, " + std::to_string(pieces) + " piece(s)");
+            expect_paths_match(frame, pieces);
+        }
+    }
+}
+
+TEST_F(PainterDecode, TruncatedDataFails) {
+    std::vector<uint8_t> raw   = make_packed_data(16, 1);
+    decoded_frame_t      frame = {.bpp = 4, .compression = IMAGE_UNCOMPRESSED, .pixel_count = 64, .stream = qp_make_memory_stream(raw.data(), raw.size())};
+    EXPECT_FALSE(decode(frame, false));
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Throughput
+
+TEST_F(PainterDecode, Benchmark) {
+    decoded_frame_t frame;
+    ASSERT_TRUE(open_qgf_frame(gfx_djinn, gfx_djinn_length, &frame));
+
+    for (bool use_callbacks : {true, false}) {
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < BENCHMARK_ITERATIONS; ++i) {
+            reset();
+            decoded_frame_t iteration = frame;
+            ASSERT_TRUE(decode(iteration, use_callbacks));
+        }
+        auto   elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double rate    = (double)frame.pixel_count * BENCHMARK_ITERATIONS / elapsed;
+        std::printf("djinn.qgf (%dbpp, %s): %s decoder %.1f Mpixels/sec\n", (int)frame.bpp, frame.compression == IMAGE_COMPRESSED_RLE ? "RLE" : "uncompressed", use_callbacks ? "callback" : "bulk", rate / 1e6);
+    }
+}
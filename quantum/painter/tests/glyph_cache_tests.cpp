@@ -0,0 +1,124 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "capture_device.hpp"
+
+extern "C" {
+#include "thintel15.qff.h"
+}
+
+static_assert(QUANTUM_PAINTER_GLYPH_CACHE_ENTRIES == 4, "The eviction tests assume a four entry cache");
+
+class PainterGlyphCache : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        font = qp_load_font_mem(font_thintel15);
+        ASSERT_NE(font, nullptr);
+        capture_reset();
+    }
+
+    void TearDown() override {
+        qp_close_font(font);
+    }
+
+    // Draws the string, returning the number of glyphs served from the cache and decoded from the font
+    void draw(const char *str, uint32_t *hits, uint32_t *misses, uint8_t hue_fg = 0, uint8_t val_bg = 0) {
+        uint32_t hits_before, misses_before;
+        qp_get_glyph_cache_stats(&hits_before, &misses_before);
+        capture_reset();
+        EXPECT_GT(qp_drawtext_recolor(&capture_device, 10, 20, font, str, hue_fg, 255, 255, 0, 0, val_bg), 0);
+        qp_get_glyph_cache_stats(hits, misses);
+        *hits -= hits_before;
+        *misses -= misses_before;
+    }
+
+    painter_font_handle_t font;
+};
+
+TEST_F(PainterGlyphCache, HitMatchesMiss) {
+    uint32_t hits, misses;
+    draw("Qm!", &hits, &misses);
+    EXPECT_EQ(hits, 0u);
+    EXPECT_EQ(misses, 3u);
+    std::vector<uint8_t>                 miss_pixels    = captured_pixels;
+    std::vector<uint32_t>                miss_transfers = captured_transfers;
+    std::vector<std::array<uint16_t, 4>> miss_viewports = captured_viewports;
+
+    draw("Qm!", &hits, &misses);
+    EXPECT_EQ(hits, 3u);
+    EXPECT_EQ(misses, 0u);
+    EXPECT_EQ(captured_pixels, miss_pixels);
+    EXPECT_EQ(captured_transfers, miss_transfers);
+    EXPECT_EQ(captured_viewports, miss_viewports);
+}
+
+TEST_F(PainterGlyphCache, EvictsLeastRecentlyUsed) {
+    uint32_t hits, misses;
+    draw("abcd", &hits, &misses);
+    EXPECT_EQ(misses, 4u);
+
+    // Touching a, d and e leaves b as the oldest entry, then c once b is back
+    draw("ad", &hits, &misses);
+    EXPECT_EQ(hits, 2u);
+    draw("e", &hits, &misses);
+    EXPECT_EQ(misses, 1u);
+    draw("ade", &hits, &misses);
+    EXPECT_EQ(hits, 3u);
+    draw("b", &hits, &misses);
+    EXPECT_EQ(misses, 1u);
+    draw("c", &hits, &misses);
+    EXPECT_EQ(misses, 1u);
+    draw("ebc", &hits, &misses);
+    EXPECT_EQ(hits, 3u);
+    EXPECT_EQ(misses, 0u);
+}
+
+TEST_F(PainterGlyphCache, ColoursArePartOfTheKey) {
+    uint32_t hits, misses;
+    draw("a", &hits, &misses);
+    EXPECT_EQ(misses, 1u);
+    std::vector<uint8_t> original = captured_pixels;
+
+    draw("a", &hits, &misses, 100);
+    EXPECT_EQ(misses, 1u);
+    EXPECT_NE(captured_pixels, original);
+
+    draw("a", &hits, &misses, 0, 50);
+    EXPECT_EQ(misses, 1u);
+    EXPECT_NE(captured_pixels, original);
+
+    draw("a", &hits, &misses);
+    EXPECT_EQ(hits, 1u);
+    EXPECT_EQ(captured_pixels, original);
+}
+
+TEST_F(PainterGlyphCache, ClosingTheFontPurgesItsGlyphs) {
+    uint32_t hits, misses;
+    draw("ab", &hits, &misses);
+    EXPECT_EQ(misses, 2u);
+
+    // The freed slot is handed out again, a stale entry would match the reused handle
+    painter_font_handle_t closed = font;
+    qp_close_font(font);
+    font = qp_load_font_mem(font_thintel15);
+    ASSERT_EQ(font, closed);
+
+    draw("ab", &hits, &misses);
+    EXPECT_EQ(hits, 0u);
+    EXPECT_EQ(misses, 2u);
+}
@@ -0,0 +1,101 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+painter_decode_DEFS := \
+	-DMATRIX_ROWS=1 \
+	-DMATRIX_COLS=1 \
+	-DQUANTUM_PAINTER_ENABLE \
+	-DQUANTUM_PAINTER_SUPPORTS_256_PALETTE=1
+painter_decode_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/tests/capture_device.cpp \
+	$(QUANTUM_PATH)/painter/tests/decode_tests.cpp \
+	keyboards/tzarc/djinn/graphics/djinn.qgf.c \
+	keyboards/tzarc/djinn/graphics/lock-caps-ON.qgf.c \
+	keyboards/tzarc/djinn/graphics/lock-num-ON.qgf.c \
+	keyboards/tzarc/djinn/graphics/lock-scrl-ON.qgf.c
+painter_decode_INC := \
+	$(QUANTUM_PATH)/painter \
+	keyboards/tzarc/djinn/graphics
+
+painter_glyph_cache_DEFS := \
+	-DMATRIX_ROWS=1 \
+	-DMATRIX_COLS=1 \
+	-DQUANTUM_PAINTER_ENABLE \
+	-DQUANTUM_PAINTER_GLYPH_CACHE_ENTRIES=4
+painter_glyph_cache_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/unicode/utf8.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qff.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_draw_text.c \
+	$(QUANTUM_PATH)/painter/tests/capture_device.cpp \
+	$(QUANTUM_PATH)/painter/tests/glyph_cache_tests.cpp \
+	keyboards/tzarc/djinn/graphics/thintel15.qff.c
+painter_glyph_cache_INC := \
+	$(QUANTUM_PATH)/painter \
+	$(QUANTUM_PATH)/unicode \
+	keyboards/tzarc/djinn/graphics
+
+painter_text_run_DEFS := \
+	-DMATRIX_ROWS=1 \
+	-DMATRIX_COLS=1 \
+	-DQUANTUM_PAINTER_ENABLE
+painter_text_run_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/unicode/utf8.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qgf.c \
+	$(QUANTUM_PATH)/painter/qff.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(QUANTUM_PATH)/painter/qp_draw_codec.c \
+	$(QUANTUM_PATH)/painter/qp_draw_text.c \
+	$(QUANTUM_PATH)/painter/tests/capture_device.cpp \
+	$(QUANTUM_PATH)/painter/tests/text_run_tests.cpp \
+	keyboards/tzarc/djinn/graphics/thintel15.qff.c
+painter_text_run_INC := \
+	$(QUANTUM_PATH)/painter \
+	$(QUANTUM_PATH)/unicode \
+	keyboards/tzarc/djinn/graphics
+
+painter_surface_DEFS := \
+	-DMATRIX_ROWS=1 \
+	-DMATRIX_COLS=1 \
+	-DQUANTUM_PAINTER_ENABLE \
+	-DQUANTUM_PAINTER_SURFACE_ENABLE \
+	-DSURFACE_NUM_DEVICES=2
+painter_surface_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/painter/qp_stream.c \
+	$(QUANTUM_PATH)/painter/qp_comms.c \
+	$(QUANTUM_PATH)/painter/qp_draw_core.c \
+	$(DRIVER_PATH)/painter/generic/qp_surface_common.c \
+	$(DRIVER_PATH)/painter/generic/qp_surface_rgb565.c \
+	$(DRIVER_PATH)/painter/generic/qp_surface_indexed.c \
+	$(QUANTUM_PATH)/painter/tests/capture_device.cpp \
+	$(QUANTUM_PATH)/painter/tests/surface_tests.cpp
+painter_surface_INC := \
+	$(QUANTUM_PATH)/painter \
+	$(DRIVER_PATH)/painter/generic
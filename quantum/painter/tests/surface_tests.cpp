@@ -0,0 +1,193 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "capture_device.hpp"
+
+extern "C" {
+#include "qp_draw.h"
+#include "qp_surface.h"
+}
+
+#define SURFACE_WIDTH 20
+#define SURFACE_HEIGHT 10
+#define MONO_WIDTH 8
+#define MONO_HEIGHT 4
+
+// Where the surface is drawn on the target
+#define TARGET_X 100
+#define TARGET_Y 50
+
+static uint8_t          rgb565_buffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(SURFACE_WIDTH, SURFACE_HEIGHT, 16)];
+static uint8_t          mono_buffer[SURFACE_REQUIRED_BUFFER_BYTE_SIZE(MONO_WIDTH, MONO_HEIGHT, 1)];
+static painter_device_t rgb565_surface;
+static painter_device_t mono_surface;
+
+// RGB565 surfaces can only be pushed to 16bpp panels
+static struct painter_driver_t capture_device_16bpp;
+
+// Initialises the surface the way qp_init() would, leaving it blank with nothing left to draw
+static void surface_reset(painter_device_t device) {
+    struct painter_driver_t *driver = (struct painter_driver_t *)device;
+    driver->validate_ok             = true;
+    ASSERT_TRUE(driver->driver_vtable->init(device, QP_ROTATION_0));
+    ASSERT_TRUE(qp_surface_draw(device, device == rgb565_surface ? (painter_device_t)&capture_device_16bpp : (painter_device_t)&capture_device, 0, 0, false));
+}
+
+class PainterSurface : public ::testing::Test {
+   protected:
+    static void SetUpTestSuite() {
+        capture_device_16bpp                       = capture_device;
+        capture_device_16bpp.native_bits_per_pixel = 16;
+        // Surfaces cannot be released, so each one is made once for the whole suite
+        rgb565_surface = qp_rgb565_surface_make_device(SURFACE_WIDTH, SURFACE_HEIGHT, rgb565_buffer);
+        mono_surface   = qp_mono_surface_make_device(MONO_WIDTH, MONO_HEIGHT, mono_buffer);
+    }
+
+    void SetUp() override {
+        ASSERT_NE(rgb565_surface, nullptr);
+        ASSERT_NE(mono_surface, nullptr);
+        // Converted colors are cached by their parameters alone, whichever device they were converted for
+        qp_internal_invalidate_palette();
+        surface_reset(rgb565_surface);
+        surface_reset(mono_surface);
+        capture_reset();
+    }
+
+    // The framebuffer bytes of the given region, row by row, as a 16bpp target should receive them
+    std::vector<uint8_t> rgb565_region(uint16_t l, uint16_t t, uint16_t r, uint16_t b) {
+        std::vector<uint8_t> bytes;
+        for (uint16_t y = t; y <= b; ++y) {
+            const uint8_t *row = &rgb565_buffer[((uint32_t)y * SURFACE_WIDTH + l) * 2];
+            bytes.insert(bytes.end(), row, row + (r - l + 1) * 2);
+        }
+        return bytes;
+    }
+};
+
+TEST_F(PainterSurface, NothingDrawnSendsNothing) {
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, TARGET_X, TARGET_Y, false));
+    EXPECT_TRUE(captured_viewports.empty());
+    EXPECT_TRUE(captured_transfers.empty());
+}
+
+TEST_F(PainterSurface, DirtyRegionCoversEverythingDrawn) {
+    EXPECT_TRUE(qp_rect(rgb565_surface, 2, 3, 5, 4, 0, 255, 255, true));
+    EXPECT_TRUE(qp_setpixel(rgb565_surface, 9, 1, 0, 255, 255));
+
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, TARGET_X, TARGET_Y, false));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{TARGET_X + 2, TARGET_Y + 1, TARGET_X + 9, TARGET_Y + 4}));
+    EXPECT_EQ(captured_pixels, rgb565_region(2, 1, 9, 4));
+
+    // Pure red, byte-swapped for the wire
+    const uint8_t *red = &captured_pixels[((3 - 1) * 8 + 0) * 2];
+    EXPECT_EQ(red[0], 0xF8);
+    EXPECT_EQ(red[1], 0x00);
+
+    // Pushing again without drawing anything sends nothing
+    capture_reset();
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, TARGET_X, TARGET_Y, false));
+    EXPECT_TRUE(captured_viewports.empty());
+}
+
+TEST_F(PainterSurface, DrawingOffTheEdgeIsClipped) {
+    EXPECT_TRUE(qp_rect(rgb565_surface, 17, 8, 25, 12, 85, 255, 255, true));
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, 0, 0, false));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{17, 8, SURFACE_WIDTH - 1, SURFACE_HEIGHT - 1}));
+    EXPECT_EQ(captured_pixels, rgb565_region(17, 8, SURFACE_WIDTH - 1, SURFACE_HEIGHT - 1));
+}
+
+TEST_F(PainterSurface, EntireSurfaceIsOneTransfer) {
+    EXPECT_TRUE(qp_setpixel(rgb565_surface, 4, 4, 170, 255, 255));
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, TARGET_X, TARGET_Y, true));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{TARGET_X, TARGET_Y, TARGET_X + SURFACE_WIDTH - 1, TARGET_Y + SURFACE_HEIGHT - 1}));
+    EXPECT_EQ(captured_transfers, (std::vector<uint32_t>{SURFACE_WIDTH * SURFACE_HEIGHT}));
+    EXPECT_EQ(captured_pixels, rgb565_region(0, 0, SURFACE_WIDTH - 1, SURFACE_HEIGHT - 1));
+}
+
+TEST_F(PainterSurface, FullWidthRegionIsOneTransfer) {
+    EXPECT_TRUE(qp_rect(rgb565_surface, 0, 2, SURFACE_WIDTH - 1, 4, 43, 255, 255, true));
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, 0, 0, false));
+    EXPECT_EQ(captured_transfers, (std::vector<uint32_t>{SURFACE_WIDTH * 3}));
+    EXPECT_EQ(captured_pixels, rgb565_region(0, 2, SURFACE_WIDTH - 1, 4));
+}
+
+TEST_F(PainterSurface, NarrowRowsArePackedTogether) {
+    const uint32_t capacity = qp_internal_num_pixels_in_buffer(&capture_device_16bpp);
+    // A different color on every pixel, so that misplaced rows show up
+    for (uint16_t y = 1; y <= 7; ++y) {
+        for (uint16_t x = 3; x <= 7; ++x) {
+            EXPECT_TRUE(qp_setpixel(rgb565_surface, x, y, x * 20 + y * 3, 255, 255));
+        }
+    }
+
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, TARGET_X, TARGET_Y, false));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_pixels, rgb565_region(3, 1, 7, 7));
+
+    // Rows are split across transfers wherever the pixdata buffer fills up
+    uint32_t total = 0;
+    for (size_t i = 0; i < captured_transfers.size(); ++i) {
+        total += captured_transfers[i];
+        if (i + 1 < captured_transfers.size()) {
+            EXPECT_EQ(captured_transfers[i], capacity);
+        }
+    }
+    EXPECT_EQ(total, 5u * 7u);
+    EXPECT_EQ(captured_transfers.size(), (5u * 7u + capacity - 1) / capacity);
+}
+
+TEST_F(PainterSurface, WideRowsAreSentStraightFromTheFramebuffer) {
+    const uint32_t capacity = qp_internal_num_pixels_in_buffer(&capture_device_16bpp);
+    ASSERT_LT(capacity + 1, (uint32_t)SURFACE_WIDTH);
+    EXPECT_TRUE(qp_rect(rgb565_surface, 1, 5, capacity + 1, 6, 200, 255, 255, true));
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, 0, 0, false));
+    EXPECT_EQ(captured_transfers, (std::vector<uint32_t>{capacity + 1, capacity + 1}));
+    EXPECT_EQ(captured_pixels, rgb565_region(1, 5, capacity + 1, 6));
+}
+
+TEST_F(PainterSurface, RGB565NeedsA16bppTarget) {
+    EXPECT_TRUE(qp_setpixel(rgb565_surface, 1, 1, 0, 255, 255));
+    EXPECT_FALSE(qp_surface_draw(rgb565_surface, &capture_device, 0, 0, false));
+
+    // The region is still pending after a failed push
+    capture_reset();
+    EXPECT_TRUE(qp_surface_draw(rgb565_surface, &capture_device_16bpp, 0, 0, false));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{1, 1, 1, 1}));
+}
+
+TEST_F(PainterSurface, MonoSurfaceExpandsToTheTargetFormat) {
+    EXPECT_TRUE(qp_rect(mono_surface, 1, 1, 2, 2, 0, 0, 255, true));
+    EXPECT_TRUE(qp_surface_draw(mono_surface, &capture_device, TARGET_X, TARGET_Y, false));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{TARGET_X + 1, TARGET_Y + 1, TARGET_X + 2, TARGET_Y + 2}));
+    EXPECT_EQ(captured_pixels, (std::vector<uint8_t>{255, 255, 255, 255}));
+
+    capture_reset();
+    EXPECT_TRUE(qp_surface_draw(mono_surface, &capture_device, TARGET_X, TARGET_Y, true));
+    ASSERT_EQ(captured_pixels.size(), (size_t)(MONO_WIDTH * MONO_HEIGHT));
+    for (uint16_t y = 0; y < MONO_HEIGHT; ++y) {
+        for (uint16_t x = 0; x < MONO_WIDTH; ++x) {
+            bool set = x >= 1 && x <= 2 && y >= 1 && y <= 2;
+            EXPECT_EQ(captured_pixels[y * MONO_WIDTH + x], set ? 255 : 0) << "at " << x << "," << y;
+        }
+    }
+}
@@ -0,0 +1,5 @@
+TEST_LIST += \
+	painter_decode \
+	painter_glyph_cache \
+	painter_text_run \
+	painter_surface
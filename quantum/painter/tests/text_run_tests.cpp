@@ -0,0 +1,146 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include "capture_device.hpp"
+
+extern "C" {
+#include "thintel15.qff.h"
+}
+
+#define TEXT "Qm!"
+#define TEXT_X 10
+#define TEXT_Y 20
+
+class PainterTextRun : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        font = qp_load_font_mem(font_thintel15);
+        ASSERT_NE(font, nullptr);
+        capture_reset();
+    }
+
+    void TearDown() override {
+        qp_close_font(font);
+    }
+
+    // Lays everything captured out on a canvas, each viewport taking as many pixels as it covers
+    std::vector<uint8_t> canvas(uint16_t left, uint16_t top, uint16_t width, uint16_t height) {
+        std::vector<uint8_t> pixels(width * height, 0);
+        size_t               next = 0;
+        for (const auto &viewport : captured_viewports) {
+            for (uint16_t y = viewport[1]; y <= viewport[3]; ++y) {
+                for (uint16_t x = viewport[0]; x <= viewport[2]; ++x) {
+                    EXPECT_LT(next, captured_pixels.size());
+                    EXPECT_TRUE(x >= left && x < left + width && y >= top && y < top + height);
+                    if (next < captured_pixels.size() && x >= left && x < left + width && y >= top && y < top + height) {
+                        pixels[(y - top) * width + (x - left)] = captured_pixels[next];
+                    }
+                    next++;
+                }
+            }
+        }
+        EXPECT_EQ(next, captured_pixels.size());
+        return pixels;
+    }
+
+    painter_font_handle_t font;
+};
+
+TEST_F(PainterTextRun, SizeCoversEveryPixel) {
+    uint32_t width = qp_textwidth(font, TEXT);
+    ASSERT_GT(width, 0u);
+    EXPECT_EQ(qp_drawtext_prerender_size(&capture_device, font, TEXT), width * font->line_height);
+
+    // Packed formats round up to whole bytes
+    struct painter_driver_t device_16bpp = capture_device;
+    device_16bpp.native_bits_per_pixel   = 16;
+    EXPECT_EQ(qp_drawtext_prerender_size(&device_16bpp, font, TEXT), width * font->line_height * 2);
+    struct painter_driver_t device_1bpp = capture_device;
+    device_1bpp.native_bits_per_pixel   = 1;
+    EXPECT_EQ(qp_drawtext_prerender_size(&device_1bpp, font, TEXT), (width * font->line_height + 7) / 8);
+
+    EXPECT_EQ(qp_drawtext_prerender_size(&capture_device, font, ""), 0u);
+}
+
+TEST_F(PainterTextRun, PrerenderSendsNothing) {
+    std::vector<uint8_t> buffer(qp_drawtext_prerender_size(&capture_device, font, TEXT));
+    painter_text_run_t   run;
+    int16_t              width = qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 0, 0, 0, buffer.data(), buffer.size(), &run);
+    EXPECT_EQ(width, qp_textwidth(font, TEXT));
+    EXPECT_EQ(run.width, width);
+    EXPECT_EQ(run.height, font->line_height);
+    EXPECT_EQ(run.pixels, buffer.data());
+    EXPECT_TRUE(captured_viewports.empty());
+    EXPECT_TRUE(captured_transfers.empty());
+}
+
+TEST_F(PainterTextRun, RunMatchesDirectDraw) {
+    int16_t width = qp_drawtext_recolor(&capture_device, TEXT_X, TEXT_Y, font, TEXT, 0, 255, 255, 85, 255, 128);
+    ASSERT_GT(width, 0);
+    std::vector<uint8_t> direct = canvas(TEXT_X, TEXT_Y, width, font->line_height);
+
+    std::vector<uint8_t> buffer(qp_drawtext_prerender_size(&capture_device, font, TEXT));
+    painter_text_run_t   run;
+    ASSERT_EQ(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 85, 255, 128, buffer.data(), buffer.size(), &run), width);
+    EXPECT_EQ(buffer, direct);
+
+    // The whole string goes out through one viewport and one transfer
+    capture_reset();
+    EXPECT_TRUE(qp_drawtext_run(&capture_device, TEXT_X, TEXT_Y, &run));
+    ASSERT_EQ(captured_viewports.size(), 1u);
+    EXPECT_EQ(captured_viewports[0], (std::array<uint16_t, 4>{TEXT_X, TEXT_Y, (uint16_t)(TEXT_X + width - 1), (uint16_t)(TEXT_Y + font->line_height - 1)}));
+    EXPECT_EQ(captured_transfers, (std::vector<uint32_t>{(uint32_t)width * font->line_height}));
+    EXPECT_EQ(captured_pixels, direct);
+}
+
+TEST_F(PainterTextRun, RunCanBeDrawnRepeatedly) {
+    std::vector<uint8_t> buffer(qp_drawtext_prerender_size(&capture_device, font, TEXT));
+    painter_text_run_t   run;
+    ASSERT_GT(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 0, 0, 0, buffer.data(), buffer.size(), &run), 0);
+
+    EXPECT_TRUE(qp_drawtext_run(&capture_device, 0, 0, &run));
+    EXPECT_TRUE(qp_drawtext_run(&capture_device, 30, 40, &run));
+    ASSERT_EQ(captured_viewports.size(), 2u);
+    EXPECT_EQ(captured_viewports[1], (std::array<uint16_t, 4>{30, 40, (uint16_t)(30 + run.width - 1), (uint16_t)(40 + run.height - 1)}));
+    std::vector<uint8_t> twice = buffer;
+    twice.insert(twice.end(), buffer.begin(), buffer.end());
+    EXPECT_EQ(captured_pixels, twice);
+}
+
+TEST_F(PainterTextRun, ColoursAreRenderedIn) {
+    std::vector<uint8_t> first(qp_drawtext_prerender_size(&capture_device, font, TEXT));
+    std::vector<uint8_t> second(first.size());
+    std::vector<uint8_t> again(first.size());
+    painter_text_run_t   run;
+    ASSERT_GT(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 0, 0, 0, first.data(), first.size(), &run), 0);
+    ASSERT_GT(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 100, 255, 255, 0, 0, 50, second.data(), second.size(), &run), 0);
+    ASSERT_GT(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 0, 0, 0, again.data(), again.size(), &run), 0);
+    EXPECT_NE(first, second);
+    EXPECT_EQ(first, again);
+}
+
+TEST_F(PainterTextRun, RejectsShortBuffersAndEmptyStrings) {
+    uint32_t             size = qp_drawtext_prerender_size(&capture_device, font, TEXT);
+    std::vector<uint8_t> buffer(size, 0xAA);
+    painter_text_run_t   run = {};
+
+    EXPECT_EQ(qp_drawtext_prerender_recolor(&capture_device, font, TEXT, 0, 255, 255, 0, 0, 0, buffer.data(), size - 1, &run), 0);
+    EXPECT_EQ(qp_drawtext_prerender_recolor(&capture_device, font, "", 0, 255, 255, 0, 0, 0, buffer.data(), size, &run), 0);
+    EXPECT_EQ(buffer, std::vector<uint8_t>(size, 0xAA));
+    EXPECT_EQ(run.pixels, nullptr);
+}
@@ -19,6 +19,13 @@
 #include "pointing_device.h"
 #include <string.h>
 #include "timer.h"
+#include "util.h"
+#ifdef POINTING_DEVICE_MOTION_PIN
+#    include "atomic_util.h"
+#endif
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    include "pointing_device_accel.h"
+#endif
 #ifdef MOUSEKEY_ENABLE
 #    include "mousekey.h"
 #endif
@@ -39,15 +46,52 @@
 report_mouse_t shared_mouse_report = {};
 uint16_t       shared_cpi          = 0;
 
+#    ifndef POINTING_DEVICE_SHARED_BACKLOG_REPORTS
+#        define POINTING_DEVICE_SHARED_BACKLOG_REPORTS 8
+#    endif
+#    define SHARED_XY_BACKLOG_MAX ((int16_t)MIN((int32_t)XY_REPORT_MAX * POINTING_DEVICE_SHARED_BACKLOG_REPORTS, INT16_MAX))
+#    define SHARED_HV_BACKLOG_MAX ((int16_t)MIN((int32_t)INT8_MAX * POINTING_DEVICE_SHARED_BACKLOG_REPORTS, INT16_MAX))
+
+// Motion is sent as the difference between what the other half has read and what has been reported so far
+static pointing_device_shared_motion_t shared_received = {};
+static pointing_device_shared_motion_t shared_reported = {};
+static bool                            shared_synced   = false; // shared_reported holds a starting point
+
 /**
  * @brief Sets the shared mouse report used be pointing device task
  *
+ * Replaces any motion from the other half that has not been sent yet.
+ *
  * NOTE : Only available when using SPLIT_POINTING_ENABLE
  *
  * @param[in] new_mouse_report report_mouse_t
  */
 void pointing_device_set_shared_report(report_mouse_t new_mouse_report) {
-    shared_mouse_report = new_mouse_report;
+    shared_received.buttons = new_mouse_report.buttons;
+    shared_reported.x       = shared_received.x - new_mouse_report.x;
+    shared_reported.y       = shared_received.y - new_mouse_report.y;
+    shared_reported.h       = shared_received.h - new_mouse_report.h;
+    shared_reported.v       = shared_received.v - new_mouse_report.v;
+}
+
+/**
+ * @brief Sets the running motion totals read from the other half
+ *
+ * Motion the other half read before the first totals arrived is dropped. Totals that are no
+ * longer synced come from a half that has been reset and counts from zero again, so they are
+ * taken as a new starting point. Missed reads on their own drop nothing, the next totals read
+ * still hold that motion.
+ *
+ * NOTE : Only available when using SPLIT_POINTING_ENABLE
+ *
+ * @param[in] motion pointing_device_shared_motion_t
+ */
+void pointing_device_set_shared_motion(const pointing_device_shared_motion_t *motion) {
+    if (!shared_synced || (shared_received.synced && !motion->synced)) {
+        shared_reported = *motion;
+        shared_synced   = true;
+    }
+    shared_received = *motion;
 }
 
 /**
@@ -73,6 +117,47 @@ uint16_t pointing_device_get_shared_cpi(void) {
 
 #endif // defined(SPLIT_POINTING_ENABLE)
 
+#ifdef POINTING_DEVICE_MOTION_PIN
+#    if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_MOTION_PIN_RIGHT)
+#        define POINTING_DEVICE_MOTION_PIN_THIS_SIDE (is_keyboard_left() ? POINTING_DEVICE_MOTION_PIN : POINTING_DEVICE_MOTION_PIN_RIGHT)
+#    else
+#        define POINTING_DEVICE_MOTION_PIN_THIS_SIDE POINTING_DEVICE_MOTION_PIN
+#    endif
+
+// Set from the motion pin interrupt where there is one, so that motion is read even if the pin has gone inactive since
+static volatile bool motion_pending = false;
+
+#    if defined(PAL_USE_CALLBACKS) && (PAL_USE_CALLBACKS == TRUE)
+static void motion_pin_callback(void *arg) {
+    motion_pending = true;
+}
+
+static void motion_pin_interrupt_enable(pin_t pin) {
+    palEnableLineEvent(pin, PAL_EVENT_MODE_FALLING_EDGE);
+    palSetLineCallback(pin, motion_pin_callback, NULL);
+}
+#    else
+// No pin interrupts available, the pin is only polled.
+static void motion_pin_interrupt_enable(pin_t pin) {}
+#    endif
+#endif
+
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+static const pointing_device_accel_point_t accel_curve[] = POINTING_DEVICE_ACCEL_CURVE;
+static pointing_device_accel_context_t     accel_local;
+#    if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+#        ifdef POINTING_DEVICE_ACCEL_CURVE_RIGHT
+static const pointing_device_accel_point_t accel_curve_right[] = POINTING_DEVICE_ACCEL_CURVE_RIGHT;
+#        else
+#            define accel_curve_right accel_curve
+#        endif
+static pointing_device_accel_context_t accel_shared;
+#    elif defined(SPLIT_POINTING_ENABLE)
+// Only one half has a sensor, whichever half it is on its motion ends up in the local report
+#        define accel_shared accel_local
+#    endif
+#endif
+
 static report_mouse_t local_mouse_report = {};
 
 extern const pointing_device_driver_t pointing_device_driver;
@@ -144,10 +229,25 @@ __attribute__((weak)) void pointing_device_init(void) {
     {
         pointing_device_driver.init();
 #ifdef POINTING_DEVICE_MOTION_PIN
-        setPinInputHigh(POINTING_DEVICE_MOTION_PIN);
+        setPinInputHigh(POINTING_DEVICE_MOTION_PIN_THIS_SIDE);
+        motion_pin_interrupt_enable(POINTING_DEVICE_MOTION_PIN_THIS_SIDE);
 #endif
     }
 
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
+    if (is_keyboard_left()) {
+        pointing_device_accel_init(&accel_local, accel_curve, ARRAY_SIZE(accel_curve));
+        pointing_device_accel_init(&accel_shared, accel_curve_right, ARRAY_SIZE(accel_curve_right));
+    } else {
+        pointing_device_accel_init(&accel_local, accel_curve_right, ARRAY_SIZE(accel_curve_right));
+        pointing_device_accel_init(&accel_shared, accel_curve, ARRAY_SIZE(accel_curve));
+    }
+#    else
+    pointing_device_accel_init(&accel_local, accel_curve, ARRAY_SIZE(accel_curve));
+#    endif
+#endif
+
     pointing_device_init_kb();
     pointing_device_init_user();
 }
@@ -172,6 +272,124 @@ __attribute__((weak)) void pointing_device_send(void) {
     memcpy(&old_report, &local_mouse_report, sizeof(local_mouse_report));
 }
 
+/**
+ * @brief Reports whether the sensor has motion to read
+ *
+ * Always true without a POINTING_DEVICE_MOTION_PIN. Clears any motion latched by the pin interrupt or
+ * pointing_device_set_motion_pending, so it should be followed by a read of the sensor.
+ *
+ * @return true if the sensor should be read
+ */
+bool pointing_device_motion_pending(void) {
+#ifdef POINTING_DEVICE_MOTION_PIN
+    bool pending;
+    // The pin interrupt may set it again between reading and clearing it
+    ATOMIC_BLOCK_FORCEON {
+        pending        = motion_pending;
+        motion_pending = false;
+    }
+    return pending || !readPin(POINTING_DEVICE_MOTION_PIN_THIS_SIDE);
+#else
+    return true;
+#endif
+}
+
+/**
+ * @brief Reads the sensor on the next task even if the motion pin is inactive
+ *
+ * For drivers that have read more motion than fits in one report.
+ */
+void pointing_device_set_motion_pending(void) {
+#ifdef POINTING_DEVICE_MOTION_PIN
+    motion_pending = true;
+#endif
+}
+
+#if defined(SPLIT_POINTING_ENABLE)
+/**
+ * @brief clamps int16_t to int8_t
+ *
+ * @param[in] int16_t value
+ * @return int8_t clamped value
+ */
+static inline int8_t pointing_device_hv_clamp(int16_t value) {
+    if (value < INT8_MIN) {
+        return INT8_MIN;
+    } else if (value > INT8_MAX) {
+        return INT8_MAX;
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief clamps int16_t to int8_t
+ *
+ * @param[in] clamp_range_t value
+ * @return mouse_xy_report_t clamped value
+ */
+static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
+    if (value < XY_REPORT_MIN) {
+        return XY_REPORT_MIN;
+    } else if (value > XY_REPORT_MAX) {
+        return XY_REPORT_MAX;
+    } else {
+        return value;
+    }
+}
+
+/**
+ * @brief Drops motion beyond the given backlog, so a burst is not replayed for long after it ended
+ *
+ * @param[in] received int16_t running total read from the other half
+ * @param[in] reported int16_t* running total reported so far
+ * @param[in] max int16_t largest backlog to keep
+ * @return int16_t the backlog
+ */
+static int16_t pointing_device_shared_backlog(int16_t received, int16_t *reported, int16_t max) {
+    int16_t backlog = received - *reported;
+
+    if (backlog > max) {
+        backlog = max;
+    } else if (backlog < -max) {
+        backlog = -max;
+    }
+    *reported = received - backlog;
+    return backlog;
+}
+
+/**
+ * @brief Takes the motion from the other half that has not been sent yet
+ *
+ * Anything beyond the range of one report is left for the next, up to POINTING_DEVICE_SHARED_BACKLOG_REPORTS reports.
+ * With POINTING_DEVICE_ACCEL_ENABLE all of it is scaled at once and carried by the accumulator instead.
+ *
+ * @return report_mouse_t
+ */
+static report_mouse_t pointing_device_take_shared_report(void) {
+    report_mouse_t report = {.buttons = shared_received.buttons};
+
+#    ifdef POINTING_DEVICE_ACCEL_ENABLE
+    // The whole backlog is scaled before anything clamps it, the accumulator carries what doesn't fit this report
+    int16_t x = pointing_device_shared_backlog(shared_received.x, &shared_reported.x, SHARED_XY_BACKLOG_MAX);
+    int16_t y = pointing_device_shared_backlog(shared_received.y, &shared_reported.y, SHARED_XY_BACKLOG_MAX);
+    report    = pointing_device_accel_apply_motion(&accel_shared, report, x, y);
+    shared_reported.x += x;
+    shared_reported.y += y;
+#    else
+    report.x = pointing_device_xy_clamp(pointing_device_shared_backlog(shared_received.x, &shared_reported.x, SHARED_XY_BACKLOG_MAX));
+    report.y = pointing_device_xy_clamp(pointing_device_shared_backlog(shared_received.y, &shared_reported.y, SHARED_XY_BACKLOG_MAX));
+    shared_reported.x += report.x;
+    shared_reported.y += report.y;
+#    endif
+    report.h = pointing_device_hv_clamp(pointing_device_shared_backlog(shared_received.h, &shared_reported.h, SHARED_HV_BACKLOG_MAX));
+    report.v = pointing_device_hv_clamp(pointing_device_shared_backlog(shared_received.v, &shared_reported.v, SHARED_HV_BACKLOG_MAX));
+    shared_reported.h += report.h;
+    shared_reported.v += report.v;
+    return report;
+}
+#endif // defined(SPLIT_POINTING_ENABLE)
+
 /**
  * @brief Adjust mouse report by any optional common pointing configuration defines
  *
@@ -232,28 +450,40 @@ __attribute__((weak)) void pointing_device_task(void) {
 #endif
 
     // Gather report info
-#ifdef POINTING_DEVICE_MOTION_PIN
-#    if defined(SPLIT_POINTING_ENABLE)
-#        error POINTING_DEVICE_MOTION_PIN not supported when sharing the pointing device report between sides.
-#    endif
-    if (!readPin(POINTING_DEVICE_MOTION_PIN))
-#endif
-
 #if defined(SPLIT_POINTING_ENABLE)
 #    if defined(POINTING_DEVICE_COMBINED)
-        static uint8_t old_buttons = 0;
+    static uint8_t old_buttons = 0;
     local_mouse_report.buttons = old_buttons;
-    local_mouse_report         = pointing_device_driver.get_report(local_mouse_report);
-    old_buttons                = local_mouse_report.buttons;
+    if (pointing_device_motion_pending()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
+    old_buttons         = local_mouse_report.buttons;
+    shared_mouse_report = pointing_device_take_shared_report();
 #    elif defined(POINTING_DEVICE_LEFT) || defined(POINTING_DEVICE_RIGHT)
-        local_mouse_report = POINTING_DEVICE_THIS_SIDE ? pointing_device_driver.get_report(local_mouse_report) : shared_mouse_report;
+    if (!(POINTING_DEVICE_THIS_SIDE)) {
+        local_mouse_report = pointing_device_take_shared_report();
+    } else if (pointing_device_motion_pending()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
 #    else
 #        error "You need to define the side(s) the pointing device is on. POINTING_DEVICE_COMBINED / POINTING_DEVICE_LEFT / POINTING_DEVICE_RIGHT"
 #    endif
 #else
-    local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    if (pointing_device_motion_pending()) {
+        local_mouse_report = pointing_device_driver.get_report(local_mouse_report);
+    }
 #endif // defined(SPLIT_POINTING_ENABLE)
 
+    // Scale this half's sensor motion too, the other half's was already scaled as it was taken
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+#    if defined(SPLIT_POINTING_ENABLE) && !defined(POINTING_DEVICE_COMBINED)
+    if (POINTING_DEVICE_THIS_SIDE)
+#    endif
+    {
+        local_mouse_report = pointing_device_accel_apply(&accel_local, local_mouse_report);
+    }
+#endif
+
     // allow kb to intercept and modify report
 #if defined(SPLIT_POINTING_ENABLE) && defined(POINTING_DEVICE_COMBINED)
     if (is_keyboard_left()) {
@@ -348,37 +578,6 @@ void pointing_device_set_cpi_on_side(bool left, uint16_t cpi) {
     }
 }
 
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] int16_t value
- * @return int8_t clamped value
- */
-static inline int8_t pointing_device_hv_clamp(int16_t value) {
-    if (value < INT8_MIN) {
-        return INT8_MIN;
-    } else if (value > INT8_MAX) {
-        return INT8_MAX;
-    } else {
-        return value;
-    }
-}
-
-/**
- * @brief clamps int16_t to int8_t
- *
- * @param[in] clamp_range_t value
- * @return mouse_xy_report_t clamped value
- */
-static inline mouse_xy_report_t pointing_device_xy_clamp(clamp_range_t value) {
-    if (value < XY_REPORT_MIN) {
-        return XY_REPORT_MIN;
-    } else if (value > XY_REPORT_MAX) {
-        return XY_REPORT_MAX;
-    } else {
-        return value;
-    }
-}
 /**
  * @brief combines 2 mouse reports and returns 2
  *
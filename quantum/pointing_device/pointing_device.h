@@ -93,6 +93,8 @@ report_mouse_t pointing_device_get_report(void);
 void           pointing_device_set_report(report_mouse_t mouse_report);
 uint16_t       pointing_device_get_cpi(void);
 void           pointing_device_set_cpi(uint16_t cpi);
+bool           pointing_device_motion_pending(void);
+void           pointing_device_set_motion_pending(void);
 
 void           pointing_device_init_kb(void);
 void           pointing_device_init_user(void);
@@ -102,7 +104,19 @@ uint8_t        pointing_device_handle_buttons(uint8_t buttons, bool pressed, poi
 report_mouse_t pointing_device_adjust_by_defines(report_mouse_t mouse_report);
 
 #if defined(SPLIT_POINTING_ENABLE)
+/* Running totals of the motion read from a half's sensor, wrapping, so that the other half
+ * can work out what it has not seen yet however often it reads them */
+typedef struct {
+    uint8_t buttons;
+    bool    synced; /* Echoes the master following these totals, a half that has been reset clears it */
+    int16_t x;
+    int16_t y;
+    int16_t h;
+    int16_t v;
+} pointing_device_shared_motion_t;
+
 void     pointing_device_set_shared_report(report_mouse_t report);
+void     pointing_device_set_shared_motion(const pointing_device_shared_motion_t *motion);
 uint16_t pointing_device_get_shared_cpi(void);
 #    if !defined(POINTING_DEVICE_TASK_THROTTLE_MS)
 #        define POINTING_DEVICE_TASK_THROTTLE_MS 1
@@ -0,0 +1,108 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "pointing_device_accel.h"
+#include "timer.h"
+
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+
+#    define CARRY_MAX ((int64_t)POINTING_DEVICE_ACCEL_CARRY_MAX << 16)
+
+void pointing_device_accel_init(pointing_device_accel_context_t* accel, const pointing_device_accel_point_t* curve, uint8_t curve_length) {
+    accel->curve        = curve;
+    accel->curve_length = curve_length;
+    accel->x            = 0;
+    accel->y            = 0;
+    accel->timer        = timer_read32();
+}
+
+int32_t pointing_device_accel_gain(const pointing_device_accel_context_t* accel, uint32_t speed) {
+    const pointing_device_accel_point_t* curve = accel->curve;
+
+    if (!accel->curve_length) {
+        return POINTING_DEVICE_ACCEL_GAIN(1.0);
+    }
+    if (speed <= (uint32_t)curve[0].speed << 16) {
+        return curve[0].gain;
+    }
+    for (uint8_t i = 1; i < accel->curve_length; i++) {
+        uint32_t upper = (uint32_t)curve[i].speed << 16;
+        if (speed < upper) {
+            uint32_t lower = (uint32_t)curve[i - 1].speed << 16;
+            return curve[i - 1].gain + (int32_t)((int64_t)(curve[i].gain - curve[i - 1].gain) * (speed - lower) / (upper - lower));
+        }
+    }
+    return curve[accel->curve_length - 1].gain;
+}
+
+static int32_t accel_carry(int32_t carried, int16_t delta, int32_t gain) {
+    int64_t total = carried + (int64_t)delta * gain;
+
+    if (total > CARRY_MAX) {
+        return CARRY_MAX;
+    } else if (total < -CARRY_MAX) {
+        return -CARRY_MAX;
+    }
+    return total;
+}
+
+void pointing_device_accel_add(pointing_device_accel_context_t* accel, int16_t dx, int16_t dy, uint16_t elapsed) {
+    if (!dx && !dy) {
+        return;
+    }
+
+    // Octagonal approximation of the distance moved, within 7% of the real one
+    uint32_t ax       = dx < 0 ? -(int32_t)dx : dx;
+    uint32_t ay       = dy < 0 ? -(int32_t)dy : dy;
+    uint32_t distance = ax > ay ? ax + ay * 3 / 8 : ay + ax * 3 / 8;
+    int32_t  gain     = pointing_device_accel_gain(accel, (distance << 16) / (elapsed ? elapsed : 1));
+
+    accel->x = accel_carry(accel->x, dx, gain);
+    accel->y = accel_carry(accel->y, dy, gain);
+}
+
+static mouse_xy_report_t accel_take_axis(int32_t* carried) {
+    // Division rounds towards zero, so what is left over keeps the direction of the motion
+    int32_t whole = *carried / 65536;
+
+    if (whole > XY_REPORT_MAX) {
+        whole = XY_REPORT_MAX;
+    } else if (whole < XY_REPORT_MIN) {
+        whole = XY_REPORT_MIN;
+    }
+    *carried -= whole * 65536;
+    return whole;
+}
+
+report_mouse_t pointing_device_accel_take(pointing_device_accel_context_t* accel, report_mouse_t mouse_report) {
+    mouse_report.x = accel_take_axis(&accel->x);
+    mouse_report.y = accel_take_axis(&accel->y);
+    return mouse_report;
+}
+
+report_mouse_t pointing_device_accel_apply_motion(pointing_device_accel_context_t* accel, report_mouse_t mouse_report, int16_t dx, int16_t dy) {
+    if (dx || dy) {
+        // Any gap longer than this is as slow as it gets, it must not wrap around to a short one
+        uint32_t elapsed = timer_elapsed32(accel->timer);
+        pointing_device_accel_add(accel, dx, dy, elapsed > UINT16_MAX ? UINT16_MAX : elapsed);
+        accel->timer = timer_read32();
+    }
+    return pointing_device_accel_take(accel, mouse_report);
+}
+
+report_mouse_t pointing_device_accel_apply(pointing_device_accel_context_t* accel, report_mouse_t mouse_report) {
+    return pointing_device_accel_apply_motion(accel, mouse_report, mouse_report.x, mouse_report.y);
+}
+#endif
@@ -0,0 +1,72 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <stdint.h>
+#include "pointing_device.h"
+
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+
+/* Q16.16 fixed point gain, from a constant such as 1.5 */
+#    define POINTING_DEVICE_ACCEL_GAIN(gain) ((int32_t)((gain)*65536.0 + 0.5))
+
+/* Motion left over after a report is kept up to this many counts, and dropped beyond */
+#    ifndef POINTING_DEVICE_ACCEL_CARRY_MAX
+#        ifdef MOUSE_EXTENDED_REPORT
+#            define POINTING_DEVICE_ACCEL_CARRY_MAX INT16_MAX
+#        else
+#            define POINTING_DEVICE_ACCEL_CARRY_MAX (XY_REPORT_MAX * 8)
+#        endif
+#    endif
+
+/* Sensor motion is multiplied by a gain that depends on how fast the sensor is moving,
+ * interpolated between the points of a curve that are either side of the current speed */
+#    ifndef POINTING_DEVICE_ACCEL_CURVE
+#        define POINTING_DEVICE_ACCEL_CURVE \
+            { {0, POINTING_DEVICE_ACCEL_GAIN(1.0)} }
+#    endif
+
+typedef struct {
+    uint16_t speed; /* Counts per millisecond this gain applies at, ascending along the curve */
+    int32_t  gain;  /* Q16.16 multiplier */
+} pointing_device_accel_point_t;
+
+typedef struct {
+    const pointing_device_accel_point_t* curve;
+    uint8_t                              curve_length;
+    int32_t                              x; /* Q16.16 motion not reported yet */
+    int32_t                              y;
+    uint32_t                             timer;
+} pointing_device_accel_context_t;
+
+/* Set the curve to use and forget any motion not reported yet */
+void pointing_device_accel_init(pointing_device_accel_context_t* accel, const pointing_device_accel_point_t* curve, uint8_t curve_length);
+
+/* Q16.16 gain for a Q16.16 speed in counts per millisecond */
+int32_t pointing_device_accel_gain(const pointing_device_accel_context_t* accel, uint32_t speed);
+
+/* Add scaled sensor motion to what is carried, elapsed being the milliseconds since the last motion */
+void pointing_device_accel_add(pointing_device_accel_context_t* accel, int16_t dx, int16_t dy, uint16_t elapsed);
+
+/* Replace the report's motion with as much of the carried motion as fits, keeping the remainder */
+report_mouse_t pointing_device_accel_take(pointing_device_accel_context_t* accel, report_mouse_t mouse_report);
+
+/* Scale dx, dy by the curve, timing them against the previous motion, and take the result into the report */
+report_mouse_t pointing_device_accel_apply_motion(pointing_device_accel_context_t* accel, report_mouse_t mouse_report, int16_t dx, int16_t dy);
+
+/* Scale the report's motion by the curve, timing it against the previous motion, and take the result */
+report_mouse_t pointing_device_accel_apply(pointing_device_accel_context_t* accel, report_mouse_t mouse_report);
+#endif
@@ -309,26 +309,46 @@ static uint16_t pmw33xx_get_cpi_wrapper(void) {
     return pmw33xx_get_cpi(0);
 }
 
+// Motion that doesn't fit in one report is sent in the following ones rather than clamped away, up to this many reports' worth
+#    ifndef PMW33XX_MOTION_BACKLOG_REPORTS
+#        define PMW33XX_MOTION_BACKLOG_REPORTS 8
+#    endif
+#    define PMW33XX_MOTION_BACKLOG_MAX ((int32_t)XY_REPORT_MAX * PMW33XX_MOTION_BACKLOG_REPORTS)
+
 report_mouse_t pmw33xx_get_report(report_mouse_t mouse_report) {
     pmw33xx_report_t report    = pmw33xx_read_burst(0);
     static bool      in_motion = false;
+    static int32_t   backlog_x = 0;
+    static int32_t   backlog_y = 0;
 
     if (report.motion.b.is_lifted) {
+        backlog_x = 0;
+        backlog_y = 0;
         return mouse_report;
     }
 
     if (!report.motion.b.is_motion) {
         in_motion = false;
-        return mouse_report;
+    } else {
+        if (!in_motion) {
+            in_motion = true;
+            pd_dprintf("PWM3360 (0): starting motion\n");
+        }
+        backlog_x = CONSTRAIN(backlog_x + report.delta_x, -PMW33XX_MOTION_BACKLOG_MAX, PMW33XX_MOTION_BACKLOG_MAX);
+        backlog_y = CONSTRAIN(backlog_y + report.delta_y, -PMW33XX_MOTION_BACKLOG_MAX, PMW33XX_MOTION_BACKLOG_MAX);
     }
 
-    if (!in_motion) {
-        in_motion = true;
-        pd_dprintf("PWM3360 (0): starting motion\n");
+    if (!backlog_x && !backlog_y) {
+        return mouse_report;
     }
 
-    mouse_report.x = CONSTRAIN_HID_XY(report.delta_x);
-    mouse_report.y = CONSTRAIN_HID_XY(report.delta_y);
+    mouse_report.x = CONSTRAIN_HID_XY(backlog_x);
+    mouse_report.y = CONSTRAIN_HID_XY(backlog_y);
+    backlog_x -= mouse_report.x;
+    backlog_y -= mouse_report.y;
+    if (backlog_x || backlog_y) {
+        pointing_device_set_motion_pending();
+    }
     return mouse_report;
 }
 
@@ -0,0 +1,207 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "pointing_device_accel.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+static const pointing_device_accel_point_t identity[] = {{0, POINTING_DEVICE_ACCEL_GAIN(1.0)}};
+static const pointing_device_accel_point_t quarter[]  = {{0, POINTING_DEVICE_ACCEL_GAIN(0.25)}};
+static const pointing_device_accel_point_t curve[]    = {
+    {2, POINTING_DEVICE_ACCEL_GAIN(0.5)},
+    {10, POINTING_DEVICE_ACCEL_GAIN(1.0)},
+    {40, POINTING_DEVICE_ACCEL_GAIN(2.5)},
+};
+
+class PointingDeviceAccel : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        rng = 12345;
+    }
+
+    void init(const pointing_device_accel_point_t* points, uint8_t length) {
+        pointing_device_accel_init(&accel, points, length);
+        sent_x = 0;
+        sent_y = 0;
+    }
+
+    /* Sends one sensor reading through and adds up what would have gone to the host */
+    void move(int16_t dx, int16_t dy, uint32_t ms = 1) {
+        advance_time(ms);
+        report_mouse_t report = {};
+        report.x              = dx;
+        report.y              = dy;
+        report                = pointing_device_accel_apply(&accel, report);
+        EXPECT_LE(report.x, XY_REPORT_MAX);
+        EXPECT_GE(report.x, XY_REPORT_MIN);
+        sent_x += report.x;
+        sent_y += report.y;
+    }
+
+    /* Keeps reporting without new motion until nothing whole is left */
+    void drain(void) {
+        for (int i = 0; i < 1000 && (accel.x / 65536 || accel.y / 65536); i++) {
+            move(0, 0);
+        }
+    }
+
+    /* Readings that fit in a report, the sensors' drivers clamp anything larger */
+    int16_t random_delta(int16_t range) {
+        rng       = rng * 1103515245 + 12345;
+        int32_t d = (int32_t)((rng >> 16) % (2 * range + 1)) - range;
+        return d > XY_REPORT_MAX ? XY_REPORT_MAX : (d < XY_REPORT_MIN ? XY_REPORT_MIN : d);
+    }
+
+    pointing_device_accel_context_t accel;
+    int64_t                         sent_x;
+    int64_t                         sent_y;
+    uint32_t                        rng;
+};
+
+TEST_F(PointingDeviceAccel, IdentityConservesDisplacement) {
+    int64_t total_x = 0, total_y = 0;
+
+    init(identity, 1);
+    for (int i = 0; i < 5000; i++) {
+        int16_t dx = random_delta(100);
+        int16_t dy = random_delta(100);
+        move(dx, dy);
+        total_x += dx;
+        total_y += dy;
+    }
+    drain();
+    EXPECT_EQ(sent_x, total_x);
+    EXPECT_EQ(sent_y, total_y);
+    EXPECT_EQ(accel.x, 0);
+    EXPECT_EQ(accel.y, 0);
+}
+
+TEST_F(PointingDeviceAccel, FractionalGainKeepsSubPixelMotion) {
+    init(quarter, 1);
+    for (int i = 0; i < 100; i++) {
+        move(1, -1);
+    }
+    EXPECT_EQ(sent_x, 25);
+    EXPECT_EQ(sent_y, -25);
+    EXPECT_EQ(accel.x, 0);
+    EXPECT_EQ(accel.y, 0);
+}
+
+TEST_F(PointingDeviceAccel, RemainderKeepsDirection) {
+    init(quarter, 1);
+    move(3, -3);
+    EXPECT_EQ(sent_x, 0);
+    EXPECT_EQ(sent_y, 0);
+    EXPECT_EQ(accel.x, POINTING_DEVICE_ACCEL_GAIN(0.75));
+    EXPECT_EQ(accel.y, -POINTING_DEVICE_ACCEL_GAIN(0.75));
+}
+
+TEST_F(PointingDeviceAccel, GainIsInterpolatedAlongTheCurve) {
+    init(curve, 3);
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 0), POINTING_DEVICE_ACCEL_GAIN(0.5));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 2 << 16), POINTING_DEVICE_ACCEL_GAIN(0.5));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 6 << 16), POINTING_DEVICE_ACCEL_GAIN(0.75));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 10 << 16), POINTING_DEVICE_ACCEL_GAIN(1.0));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 25 << 16), POINTING_DEVICE_ACCEL_GAIN(1.75));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 40 << 16), POINTING_DEVICE_ACCEL_GAIN(2.5));
+    EXPECT_EQ(pointing_device_accel_gain(&accel, 1000 << 16), POINTING_DEVICE_ACCEL_GAIN(2.5));
+}
+
+TEST_F(PointingDeviceAccel, FasterMotionIsScaledUp) {
+    init(curve, 3);
+    move(20, 0, 10);
+    EXPECT_EQ(sent_x, 10);
+    init(curve, 3);
+    move(20, 0, 1);
+    EXPECT_EQ(sent_x, 30);
+}
+
+TEST_F(PointingDeviceAccel, LongIdleIsNotMistakenForFastMotion) {
+    init(curve, 3);
+    move(20, 0, 10);
+    EXPECT_EQ(sent_x, 10);
+    // Just past what a 16 bit timer can tell apart from a single millisecond
+    move(40, 0, 65537);
+    EXPECT_EQ(sent_x, 30);
+}
+
+TEST_F(PointingDeviceAccel, CurveConservesScaledDisplacement) {
+    int64_t  expected_x = 0, expected_y = 0;
+    uint32_t elapsed = 0;
+
+    init(curve, 3);
+    for (int i = 0; i < 5000; i++) {
+        int16_t dx = random_delta(i % 500 < 250 ? 8 : 60);
+        int16_t dy = random_delta(i % 500 < 250 ? 8 : 60);
+        // Speed is measured from the last reading that had motion, one millisecond per reading
+        elapsed++;
+        if (dx || dy) {
+            uint32_t ax       = dx < 0 ? -dx : dx;
+            uint32_t ay       = dy < 0 ? -dy : dy;
+            uint32_t distance = ax > ay ? ax + ay * 3 / 8 : ay + ax * 3 / 8;
+            int32_t  gain     = pointing_device_accel_gain(&accel, (distance << 16) / elapsed);
+            expected_x += (int64_t)dx * gain;
+            expected_y += (int64_t)dy * gain;
+            elapsed = 0;
+        }
+        move(dx, dy);
+    }
+    drain();
+    EXPECT_EQ(sent_x * 65536 + accel.x, expected_x);
+    EXPECT_EQ(sent_y * 65536 + accel.y, expected_y);
+    EXPECT_LT(accel.x < 0 ? -accel.x : accel.x, 65536);
+    EXPECT_LT(accel.y < 0 ? -accel.y : accel.y, 65536);
+}
+
+TEST_F(PointingDeviceAccel, OverflowIsCarriedIntoLaterReports) {
+    static const pointing_device_accel_point_t fast[] = {{0, POINTING_DEVICE_ACCEL_GAIN(4.0)}};
+
+    init(fast, 1);
+    move(100, -100);
+    move(100, -100);
+    drain();
+    EXPECT_EQ(sent_x, 800);
+    EXPECT_EQ(sent_y, -800);
+}
+
+TEST_F(PointingDeviceAccel, CarryIsBounded) {
+    static const pointing_device_accel_point_t huge[] = {{0, POINTING_DEVICE_ACCEL_GAIN(1000.0)}};
+
+    init(huge, 1);
+    for (int i = 0; i < 100; i++) {
+        move(XY_REPORT_MAX, XY_REPORT_MIN);
+    }
+    EXPECT_LE(accel.x, (int32_t)POINTING_DEVICE_ACCEL_CARRY_MAX * 65536);
+    EXPECT_GE(accel.y, -(int32_t)POINTING_DEVICE_ACCEL_CARRY_MAX * 65536);
+    drain();
+    EXPECT_EQ(accel.x / 65536, 0);
+    EXPECT_EQ(accel.y / 65536, 0);
+}
+
+TEST_F(PointingDeviceAccel, NoMotionWithoutInput) {
+    init(curve, 3);
+    for (int i = 0; i < 10; i++) {
+        move(0, 0);
+    }
+    EXPECT_EQ(sent_x, 0);
+    EXPECT_EQ(sent_y, 0);
+}
@@ -0,0 +1,29 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+pointing_device_accel_DEFS := \
+	-DPOINTING_DEVICE_ACCEL_ENABLE
+pointing_device_accel_SRC := \
+	platforms/test/timer.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_accel.c \
+	$(QUANTUM_PATH)/pointing_device/tests/pointing_device_accel_tests.cpp
+pointing_device_accel_INC := \
+	$(QUANTUM_PATH)/pointing_device
+
+pointing_device_accel_extended_DEFS := \
+	$(pointing_device_accel_DEFS) \
+	-DMOUSE_EXTENDED_REPORT
+pointing_device_accel_extended_SRC := $(pointing_device_accel_SRC)
+pointing_device_accel_extended_INC := $(pointing_device_accel_INC)
@@ -14,6 +14,7 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stdlib.h>
 #include "print.h"
 #include "process_combo.h"
 #include "action_tapping.h"
@@ -88,6 +89,29 @@ static queued_combo_t combo_buffer[COMBO_BUFFER_LENGTH];
 
 #define INCREMENT_MOD(i) i = (i + 1) % COMBO_BUFFER_LENGTH
 
+#ifdef COMBO_KEYCODE_INDEX
+/* Reverse index from keycode to the combos containing it, sorted by keycode
+ * and then by combo index, so that a key event only has to visit the combos
+ * it is part of, in the same order as the linear scan would. */
+typedef struct {
+    uint16_t keycode;
+    uint16_t combo_index;
+    uint8_t  key_index;
+    uint8_t  key_count;
+} combo_index_entry_t;
+static combo_index_entry_t *combo_index         = NULL;
+static uint16_t             combo_index_size    = 0;
+static uint16_t             combo_index_len     = 0;
+static bool                 combo_index_invalid = true;
+
+/* Combos whose state was touched since the last clear_combos(), so that
+ * clearing does not have to visit every combo either. */
+#    define COMBO_TOUCHED_LENGTH (COMBO_KEY_BUFFER_LENGTH * 4)
+static uint16_t combo_touched[COMBO_TOUCHED_LENGTH];
+static uint8_t  combo_touched_size     = 0;
+static bool     combo_touched_overflow = false;
+#endif
+
 #ifndef EXTRA_SHORT_COMBOS
 /* flags are their own elements in combo_t struct. */
 #    define COMBO_ACTIVE(combo) (combo->active)
@@ -185,14 +209,55 @@ static inline uint16_t _get_combo_term(uint16_t combo_index, combo_t *combo) {
     return COMBO_TERM;
 }
 
+#ifdef COMBO_KEYCODE_INDEX
+static inline void touch_combo(uint16_t combo_index) {
+    if (combo_touched_overflow) {
+        return;
+    }
+    for (uint8_t i = 0; i < combo_touched_size; ++i) {
+        if (combo_touched[i] == combo_index) {
+            return;
+        }
+    }
+    if (combo_touched_size < COMBO_TOUCHED_LENGTH) {
+        combo_touched[combo_touched_size++] = combo_index;
+    } else {
+        combo_touched_overflow = true;
+    }
+}
+#endif
+
 void clear_combos(void) {
     uint16_t index = 0;
     longest_term   = 0;
+#ifdef COMBO_KEYCODE_INDEX
+    if (combo_index && !combo_touched_overflow) {
+        uint8_t kept = 0;
+        for (uint8_t i = 0; i < combo_touched_size; ++i) {
+            combo_t *combo = &key_combos[combo_touched[i]];
+            if (!COMBO_ACTIVE(combo)) {
+                RESET_COMBO_STATE(combo);
+            } else {
+                // keep tracking active combos until they have been released
+                combo_touched[kept++] = combo_touched[i];
+            }
+        }
+        combo_touched_size = kept;
+        return;
+    }
+    combo_touched_size     = 0;
+    combo_touched_overflow = false;
+#endif
     for (index = 0; index < COMBO_LEN; ++index) {
         combo_t *combo = &key_combos[index];
         if (!COMBO_ACTIVE(combo)) {
             RESET_COMBO_STATE(combo);
         }
+#ifdef COMBO_KEYCODE_INDEX
+        else {
+            touch_combo(index);
+        }
+#endif
     }
 }
 
@@ -250,7 +315,6 @@ static inline void dump_key_buffer(void) {
     key_buffer_next = key_buffer_size = 0;
 }
 
-#define NO_COMBO_KEYS_ARE_DOWN (0 == COMBO_STATE(combo))
 #define ALL_COMBO_KEYS_ARE_DOWN(state, key_count) (((1 << key_count) - 1) == state)
 #define ONLY_ONE_KEY_IS_DOWN(state) !(state & (state - 1))
 #define KEY_NOT_YET_RELEASED(state, key_index) ((1 << key_index) & state)
@@ -272,6 +336,89 @@ static inline void _find_key_index_and_count(const uint16_t *keys, uint16_t keyc
     }
 }
 
+#ifdef COMBO_KEYCODE_INDEX
+static int combo_index_entry_compare(const void *a, const void *b) {
+    const combo_index_entry_t *entry_a = a;
+    const combo_index_entry_t *entry_b = b;
+
+    if (entry_a->keycode != entry_b->keycode) {
+        return entry_a->keycode < entry_b->keycode ? -1 : 1;
+    }
+    if (entry_a->combo_index != entry_b->combo_index) {
+        return entry_a->combo_index < entry_b->combo_index ? -1 : 1;
+    }
+    return (int)entry_a->key_index - (int)entry_b->key_index;
+}
+
+static void build_combo_index(void) {
+    uint16_t entries = 0;
+
+    combo_index_invalid    = false;
+    combo_index_len        = COMBO_LEN;
+    combo_index_size       = 0;
+    combo_touched_overflow = true;
+
+    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+        uint8_t  key_count = 0;
+        uint16_t key_index = -1;
+        _find_key_index_and_count(key_combos[idx].keys, COMBO_END, &key_index, &key_count);
+        entries += key_count;
+    }
+
+    free(combo_index);
+    combo_index = malloc(entries * sizeof(combo_index_entry_t));
+    if (!combo_index) {
+        // Fall back to scanning every combo.
+        return;
+    }
+
+    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+        const uint16_t *keys      = key_combos[idx].keys;
+        uint8_t         key_count = 0;
+        uint16_t        key_index = -1;
+        _find_key_index_and_count(keys, COMBO_END, &key_index, &key_count);
+
+        for (uint8_t i = 0; i < key_count; ++i) {
+            combo_index[combo_index_size++] = (combo_index_entry_t){
+                .keycode     = pgm_read_word(&keys[i]),
+                .combo_index = idx,
+                .key_index   = i,
+                .key_count   = key_count,
+            };
+        }
+    }
+
+    qsort(combo_index, combo_index_size, sizeof(combo_index_entry_t), combo_index_entry_compare);
+
+    // A key listed twice in one combo only counts at its last position.
+    uint16_t unique = 0;
+    for (uint16_t i = 0; i < combo_index_size; ++i) {
+        if (unique > 0 && combo_index[unique - 1].keycode == combo_index[i].keycode && combo_index[unique - 1].combo_index == combo_index[i].combo_index) {
+            unique--;
+        }
+        combo_index[unique++] = combo_index[i];
+    }
+    combo_index_size = unique;
+}
+
+static uint16_t find_combo_index_start(uint16_t keycode) {
+    uint16_t low = 0, high = combo_index_size;
+    while (low < high) {
+        uint16_t mid = low + (high - low) / 2;
+        if (combo_index[mid].keycode < keycode) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void combo_invalidate_index(void) {
+    combo_index_invalid = true;
+}
+#endif
+
 void drop_combo_from_buffer(uint16_t combo_index) {
     /* Mark a combo as processed from the buffer. If the buffer is in the
      * beginning of the buffer, drop it.  */
@@ -407,15 +554,10 @@ static bool keys_pressed_in_order(uint16_t combo_index, combo_t *combo, uint16_t
 }
 #endif
 
-static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
-    uint8_t  key_count = 0;
-    uint16_t key_index = -1;
-    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
-
-    /* Continue processing if key isn't part of current combo. */
-    if (-1 == (int16_t)key_index) {
-        return false;
-    }
+static bool process_single_combo_key(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index, uint16_t key_index, uint8_t key_count) {
+#ifdef COMBO_KEYCODE_INDEX
+    touch_combo(combo_index);
+#endif
 
     bool key_is_part_of_combo = (!COMBO_DISABLED(combo) && is_combo_enabled()
 #if defined(COMBO_MUST_PRESS_IN_ORDER) || defined(COMBO_MUST_PRESS_IN_ORDER_PER_COMBO)
@@ -527,9 +669,21 @@ static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *
     return key_is_part_of_combo;
 }
 
+static bool process_single_combo(combo_t *combo, uint16_t keycode, keyrecord_t *record, uint16_t combo_index) {
+    uint8_t  key_count = 0;
+    uint16_t key_index = -1;
+    _find_key_index_and_count(combo->keys, keycode, &key_index, &key_count);
+
+    /* Continue processing if key isn't part of current combo. */
+    if (-1 == (int16_t)key_index) {
+        return false;
+    }
+
+    return process_single_combo_key(combo, keycode, record, combo_index, key_index, key_count);
+}
+
 bool process_combo(uint16_t keycode, keyrecord_t *record) {
-    bool is_combo_key          = false;
-    bool no_combo_keys_pressed = true;
+    bool is_combo_key = false;
 
     if (keycode == CMB_ON && record->event.pressed) {
         combo_enable();
@@ -551,10 +705,22 @@ bool process_combo(uint16_t keycode, keyrecord_t *record) {
     keycode = keymap_key_to_keycode(COMBO_ONLY_FROM_LAYER, record->event.key);
 #endif
 
-    for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
-        combo_t *combo = &key_combos[idx];
-        is_combo_key |= process_single_combo(combo, keycode, record, idx);
-        no_combo_keys_pressed = no_combo_keys_pressed && (NO_COMBO_KEYS_ARE_DOWN || COMBO_ACTIVE(combo) || COMBO_DISABLED(combo));
+#ifdef COMBO_KEYCODE_INDEX
+    if (combo_index_invalid || combo_index_len != COMBO_LEN) {
+        build_combo_index();
+    }
+
+    if (combo_index) {
+        for (uint16_t i = find_combo_index_start(keycode); i < combo_index_size && combo_index[i].keycode == keycode; ++i) {
+            combo_index_entry_t *entry = &combo_index[i];
+            is_combo_key |= process_single_combo_key(&key_combos[entry->combo_index], keycode, record, entry->combo_index, entry->key_index, entry->key_count);
+        }
+    } else
+#endif
+    {
+        for (uint16_t idx = 0; idx < COMBO_LEN; ++idx) {
+            is_combo_key |= process_single_combo(&key_combos[idx], keycode, record, idx);
+        }
     }
 
     if (record->event.pressed && is_combo_key) {
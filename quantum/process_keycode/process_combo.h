@@ -37,6 +37,12 @@
 #    define COMBO_BUFFER_LENGTH 4
 #endif
 
+/* Index combos by keycode so that a key event only visits the combos
+ * containing it. Kept off on AVR, where the heap is too precious. */
+#if !defined(COMBO_NO_KEYCODE_INDEX) && !defined(__AVR__)
+#    define COMBO_KEYCODE_INDEX
+#endif
+
 typedef struct {
     const uint16_t *keys;
     uint16_t        keycode;
@@ -79,3 +85,7 @@ void combo_enable(void);
 void combo_disable(void);
 void combo_toggle(void);
 bool is_combo_enabled(void);
+
+#ifdef COMBO_KEYCODE_INDEX
+void combo_invalidate_index(void);
+#endif
@@ -154,6 +154,7 @@ void shutdown_quantum(void) {
 #ifdef HAPTIC_ENABLE
     haptic_shutdown();
 #endif
+    eeconfig_flush();
 }
 
 void reset_keyboard(void) {
@@ -360,6 +361,11 @@ bool process_record_quantum(keyrecord_t *record) {
                 }
 #endif
                 return false;
+#if defined(SEND_STRING_ENABLE) && defined(SEND_STRING_ASYNC_ENABLE)
+            case QK_SEND_STRING_CANCEL:
+                send_string_async_cancel();
+                return false;
+#endif
             case QK_CLEAR_EEPROM:
 #ifdef NO_RESET
                 eeconfig_init();
@@ -460,6 +466,7 @@ __attribute__((weak)) void shutdown_user() {}
 
 void suspend_power_down_quantum(void) {
     suspend_power_down_kb();
+    eeconfig_flush();
 #ifndef NO_SUSPEND_POWER_DOWN
 // Turn off backlight
 #    ifdef BACKLIGHT_ENABLE
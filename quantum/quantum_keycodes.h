@@ -611,6 +611,8 @@ enum quantum_keycodes {
 
     UNICODE_MODE_EMACS,
 
+    QK_SEND_STRING_CANCEL,
+
     // Start of custom keycode range for keyboards and keymaps - always leave at the end
     SAFE_RANGE
 };
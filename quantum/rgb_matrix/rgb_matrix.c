@@ -31,10 +31,83 @@ const led_point_t k_rgb_matrix_center = {112, 32};
 const led_point_t k_rgb_matrix_center = RGB_MATRIX_CENTER;
 #endif
 
-__attribute__((weak)) RGB rgb_matrix_hsv_to_rgb(HSV hsv) {
+RGB rgb_matrix_hsv_to_rgb_default(HSV hsv) {
     return hsv_to_rgb(hsv);
 }
 
+__attribute__((weak, alias("rgb_matrix_hsv_to_rgb_default"))) RGB rgb_matrix_hsv_to_rgb(HSV hsv);
+
+// Colours computed by the effect runners, waiting to be converted to RGB together
+typedef struct {
+    uint8_t count;
+    uint8_t index[RGB_MATRIX_HSV_BATCH_SIZE];
+    HSV     hsv[RGB_MATRIX_HSV_BATCH_SIZE];
+} rgb_matrix_hsv_batch_t;
+
+static void rgb_matrix_hsv_batch_flush(rgb_matrix_hsv_batch_t *batch) {
+    RGB rgb[RGB_MATRIX_HSV_BATCH_SIZE];
+
+    // Keyboards replacing rgb_matrix_hsv_to_rgb(), e.g. to limit brightness, still get every colour
+    if (rgb_matrix_hsv_to_rgb == rgb_matrix_hsv_to_rgb_default) {
+        hsv_to_rgb_batch(batch->hsv, rgb, batch->count);
+    } else {
+        for (uint8_t i = 0; i < batch->count; i++) {
+            rgb[i] = rgb_matrix_hsv_to_rgb(batch->hsv[i]);
+        }
+    }
+
+    for (uint8_t i = 0; i < batch->count; i++) {
+        rgb_matrix_set_color(batch->index[i], rgb[i].r, rgb[i].g, rgb[i].b);
+    }
+    batch->count = 0;
+}
+
+static inline void rgb_matrix_hsv_batch_set(rgb_matrix_hsv_batch_t *batch, uint8_t index, HSV hsv) {
+    batch->index[batch->count] = index;
+    batch->hsv[batch->count]   = hsv;
+    if (++batch->count == RGB_MATRIX_HSV_BATCH_SIZE) {
+        rgb_matrix_hsv_batch_flush(batch);
+    }
+}
+
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+// Distance and angle of every LED from the centre, worked out once as the LED config never changes
+static uint8_t led_distance[DRIVER_LED_TOTAL];
+static uint8_t led_angle[DRIVER_LED_TOTAL];
+#endif
+
+static inline uint8_t rgb_matrix_led_distance(uint8_t i) {
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    return led_distance[i];
+#else
+    int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+    int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+    return sqrt16(dx * dx + dy * dy);
+#endif
+}
+
+static inline uint8_t rgb_matrix_led_angle(uint8_t i) {
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    return led_angle[i];
+#else
+    int16_t dx = g_led_config.point[i].x - k_rgb_matrix_center.x;
+    int16_t dy = g_led_config.point[i].y - k_rgb_matrix_center.y;
+    return atan2_8(dy, dx);
+#endif
+}
+
+#ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
+// Most recent hit on each LED as an index into g_last_hit_tracker plus one, or zero for none
+_Static_assert(LED_HITS_TO_REMEMBER < 255, "LED_HITS_TO_REMEMBER must be less than 255");
+static uint8_t led_last_hit[DRIVER_LED_TOTAL];
+
+// Time since the LED was last hit, as far as g_last_hit_tracker remembers
+static inline uint16_t rgb_matrix_led_hit_tick(uint8_t i) {
+    uint8_t hit = led_last_hit[i];
+    return hit ? g_last_hit_tracker.tick[hit - 1] : UINT16_MAX;
+}
+#endif // RGB_MATRIX_KEYREACTIVE_ENABLED
+
 // Generic effect runners
 #include "rgb_matrix_runners.inc"
 
@@ -335,6 +408,10 @@ static void rgb_task_start(void) {
     g_rgb_timer = rgb_timer_buffer;
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker = last_hit_buffer;
+    memset(led_last_hit, 0, sizeof(led_last_hit));
+    for (uint8_t i = 0; i < g_last_hit_tracker.count; i++) {
+        led_last_hit[g_last_hit_tracker.index[i]] = i + 1;
+    }
 #endif // RGB_MATRIX_KEYREACTIVE_ENABLED
 
     // next task
@@ -480,6 +557,15 @@ __attribute__((weak)) void rgb_matrix_indicators_advanced_user(uint8_t led_min,
 void rgb_matrix_init(void) {
     rgb_matrix_driver.init();
 
+#ifdef RGB_MATRIX_GEOMETRY_CACHE
+    for (uint8_t i = 0; i < DRIVER_LED_TOTAL; i++) {
+        int16_t dx      = g_led_config.point[i].x - k_rgb_matrix_center.x;
+        int16_t dy      = g_led_config.point[i].y - k_rgb_matrix_center.y;
+        led_distance[i] = sqrt16(dx * dx + dy * dy);
+        led_angle[i]    = atan2_8(dy, dx);
+    }
+#endif
+
 #ifdef RGB_MATRIX_KEYREACTIVE_ENABLED
     g_last_hit_tracker.count = 0;
     for (uint8_t i = 0; i < LED_HITS_TO_REMEMBER; ++i) {
@@ -322,3 +322,204 @@ void send_string_with_delay_P(const char *string, uint8_t interval) {
     }
 }
 #endif
+
+#ifdef SEND_STRING_ASYNC_ENABLE
+#    ifndef SEND_STRING_ASYNC_QUEUE_SIZE
+#        define SEND_STRING_ASYNC_QUEUE_SIZE 4
+#    endif
+
+typedef struct {
+    const char *string;
+    uint8_t     interval;
+    bool        progmem;
+} send_string_async_entry_t;
+
+static send_string_async_entry_t send_string_async_queue[SEND_STRING_ASYNC_QUEUE_SIZE];
+static uint8_t                   send_string_async_queue_head  = 0;
+static uint8_t                   send_string_async_queue_count = 0;
+
+// Playback state for the string at the head of the queue
+static const char *send_string_async_next      = NULL;
+static uint32_t    send_string_async_wait_time = 0;
+static uint16_t    send_string_async_wait_ms   = 0;
+static uint8_t     send_string_async_release   = KC_NO; // Key to release on the next step
+static uint8_t     send_string_async_mods      = 0;     // Weak mods to drop along with it
+static bool        send_string_async_dead      = false; // Space to tap once released, for dead keys
+
+// Keys held down with SS_DOWN, so that cancelling doesn't leave them stuck
+static uint8_t send_string_async_held[256 / 8];
+
+static char send_string_async_read(const char *p) {
+    return send_string_async_queue[send_string_async_queue_head].progmem ? pgm_read_byte(p) : *p;
+}
+
+static void send_string_async_wait(uint16_t ms) {
+    send_string_async_wait_time = timer_read32();
+    send_string_async_wait_ms   = ms;
+}
+
+static void send_string_async_press(uint8_t keycode, uint8_t mods, bool dead) {
+    if (keycode == KC_NO) {
+        return;
+    }
+
+    // Modifiers go out in the same report as the key, rather than one report each
+    add_weak_mods(mods);
+    register_code(keycode);
+    send_string_async_release = keycode;
+    send_string_async_mods    = mods;
+    send_string_async_dead    = dead;
+    send_string_async_wait(TAP_CODE_DELAY);
+}
+
+static void send_string_async_release_key(void) {
+    del_weak_mods(send_string_async_mods);
+    unregister_code(send_string_async_release);
+    send_string_async_release = KC_NO;
+    send_string_async_mods    = 0;
+}
+
+static void send_string_async_set_held(uint8_t keycode, bool held) {
+    if (held) {
+        send_string_async_held[keycode / 8] |= 1 << (keycode % 8);
+    } else {
+        send_string_async_held[keycode / 8] &= ~(1 << (keycode % 8));
+    }
+}
+
+static void send_string_async_dequeue(void) {
+    send_string_async_queue_head = (send_string_async_queue_head + 1) % SEND_STRING_ASYNC_QUEUE_SIZE;
+    send_string_async_queue_count--;
+    send_string_async_next = send_string_async_queue_count ? send_string_async_queue[send_string_async_queue_head].string : NULL;
+}
+
+static bool send_string_async_enqueue(const char *string, uint8_t interval, bool progmem) {
+    if (send_string_async_queue_count >= SEND_STRING_ASYNC_QUEUE_SIZE) {
+        return false;
+    }
+
+    uint8_t index                           = (send_string_async_queue_head + send_string_async_queue_count) % SEND_STRING_ASYNC_QUEUE_SIZE;
+    send_string_async_queue[index].string   = string;
+    send_string_async_queue[index].interval = interval;
+    send_string_async_queue[index].progmem  = progmem;
+    if (send_string_async_queue_count++ == 0) {
+        send_string_async_next = string;
+    }
+    return true;
+}
+
+bool send_string_async(const char *string) {
+    return send_string_async_enqueue(string, 0, false);
+}
+
+bool send_string_async_with_delay(const char *string, uint8_t interval) {
+    return send_string_async_enqueue(string, interval, false);
+}
+
+#    if defined(__AVR__)
+bool send_string_async_P(const char *string) {
+    return send_string_async_enqueue(string, 0, true);
+}
+
+bool send_string_async_with_delay_P(const char *string, uint8_t interval) {
+    return send_string_async_enqueue(string, interval, true);
+}
+#    endif
+
+bool send_string_async_active(void) {
+    return send_string_async_queue_count > 0 || send_string_async_release != KC_NO;
+}
+
+void send_string_async_cancel(void) {
+    if (send_string_async_release != KC_NO) {
+        send_string_async_release_key();
+    }
+    for (uint16_t keycode = 0; keycode < 256; keycode++) {
+        if (send_string_async_held[keycode / 8] & (1 << (keycode % 8))) {
+            unregister_code(keycode);
+        }
+    }
+    memset(send_string_async_held, 0, sizeof(send_string_async_held));
+
+    send_string_async_queue_count = 0;
+    send_string_async_next        = NULL;
+    send_string_async_dead        = false;
+    send_string_async_wait_ms     = 0;
+}
+
+/** \brief Advances queued strings by at most one keyboard report.
+ *
+ * Called from the main loop. Each step waits for the previous report to have been taken by the host, so typing runs
+ * at the rate the host polls for reports without ever blocking the loop.
+ */
+void send_string_task(void) {
+    if (!send_string_async_active() || (send_string_async_wait_ms && timer_elapsed32(send_string_async_wait_time) < send_string_async_wait_ms)) {
+        return;
+    }
+    send_string_async_wait_ms = 0;
+
+    if (!host_keyboard_ready()) {
+        return;
+    }
+
+    uint8_t interval = send_string_async_queue_count ? send_string_async_queue[send_string_async_queue_head].interval : 0;
+
+    // Finish off the key typed in the previous step
+    if (send_string_async_release != KC_NO) {
+        send_string_async_release_key();
+        if (!send_string_async_dead) {
+            send_string_async_wait(interval);
+        }
+        return;
+    }
+
+    // Dead keys need a space typed after them to produce the character on its own
+    if (send_string_async_dead) {
+        send_string_async_dead = false;
+        send_string_async_press(KC_SPACE, 0, false);
+        return;
+    }
+
+    char ascii_code = send_string_async_read(send_string_async_next);
+    if (!ascii_code) {
+        send_string_async_dequeue();
+        return;
+    }
+
+    if (ascii_code == SS_QMK_PREFIX) {
+        ascii_code      = send_string_async_read(++send_string_async_next);
+        uint8_t keycode = send_string_async_read(++send_string_async_next);
+        if (ascii_code == SS_TAP_CODE) {
+            send_string_async_press(keycode, 0, false);
+        } else if (ascii_code == SS_DOWN_CODE) {
+            register_code(keycode);
+            send_string_async_set_held(keycode, true);
+            send_string_async_wait(interval);
+        } else if (ascii_code == SS_UP_CODE) {
+            unregister_code(keycode);
+            send_string_async_set_held(keycode, false);
+            send_string_async_wait(interval);
+        } else if (ascii_code == SS_DELAY_CODE) {
+            uint16_t ms = 0;
+            while (isdigit(keycode)) {
+                ms *= 10;
+                ms += keycode - '0';
+                keycode = send_string_async_read(++send_string_async_next);
+            }
+            send_string_async_wait(ms);
+        }
+    } else {
+#    if defined(AUDIO_ENABLE) && defined(SENDSTRING_BELL)
+        if (ascii_code == '\a') { // BEL
+            PLAY_SONG(bell_song);
+            ++send_string_async_next;
+            return;
+        }
+#    endif
+        uint8_t keycode = pgm_read_byte(&ascii_to_keycode_lut[(uint8_t)ascii_code]);
+        uint8_t mods    = (PGM_LOADBIT(ascii_to_shift_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_LEFT_SHIFT) : 0) | (PGM_LOADBIT(ascii_to_altgr_lut, (uint8_t)ascii_code) ? MOD_BIT(KC_RIGHT_ALT) : 0);
+        send_string_async_press(keycode, mods, PGM_LOADBIT(ascii_to_dead_lut, (uint8_t)ascii_code));
+    }
+    ++send_string_async_next;
+}
+#endif
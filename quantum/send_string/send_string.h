@@ -21,6 +21,7 @@
  * \{
  */
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "progmem.h"
@@ -149,4 +150,78 @@ void send_string_with_delay_P(const char *string, uint8_t interval);
  */
 #define SEND_STRING_DELAY(string, interval) send_string_with_delay_P(PSTR(string), interval)
 
+#if defined(SEND_STRING_ASYNC_ENABLE) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a string of ASCII characters to be typed out in the background.
+ *
+ * The string is typed one keyboard report at a time from the main loop, so matrix scanning and everything else keep
+ * running while it types. The string is not copied, and must stay valid until it has been typed out.
+ *
+ * \param string The string to type out.
+ *
+ * \return false if the queue is full and the string was dropped.
+ */
+bool send_string_async(const char *string);
+
+/**
+ * \brief Queue a string of ASCII characters to be typed out in the background, with a delay between each character.
+ *
+ * \param string The string to type out.
+ * \param interval The amount of time, in milliseconds, to wait before typing the next character.
+ *
+ * \return false if the queue is full and the string was dropped.
+ */
+bool send_string_async_with_delay(const char *string, uint8_t interval);
+
+#    if defined(__AVR__) || defined(__DOXYGEN__)
+/**
+ * \brief Queue a PROGMEM string of ASCII characters to be typed out in the background.
+ *
+ * On ARM devices, this function is simply an alias for send_string_async(string).
+ *
+ * \param string The string to type out.
+ *
+ * \return false if the queue is full and the string was dropped.
+ */
+bool send_string_async_P(const char *string);
+
+/**
+ * \brief Queue a PROGMEM string of ASCII characters to be typed out in the background, with a delay between each character.
+ *
+ * On ARM devices, this function is simply an alias for send_string_async_with_delay(string, interval).
+ *
+ * \param string The string to type out.
+ * \param interval The amount of time, in milliseconds, to wait before typing the next character.
+ *
+ * \return false if the queue is full and the string was dropped.
+ */
+bool send_string_async_with_delay_P(const char *string, uint8_t interval);
+#    else
+#        define send_string_async_P(string) send_string_async_with_delay(string, 0)
+#        define send_string_async_with_delay_P(string, interval) send_string_async_with_delay(string, interval)
+#    endif
+
+/**
+ * \brief Whether any queued strings are still being typed out.
+ */
+bool send_string_async_active(void);
+
+/**
+ * \brief Stop typing, dropping every queued string and releasing any keys they were holding down.
+ */
+void send_string_async_cancel(void);
+
+void send_string_task(void);
+
+/**
+ * \brief Shortcut macro for send_string_async_with_delay_P(PSTR(string), 0).
+ */
+#    define SEND_STRING_ASYNC(string) send_string_async_with_delay_P(PSTR(string), 0)
+
+/**
+ * \brief Shortcut macro for send_string_async_with_delay_P(PSTR(string), interval).
+ */
+#    define SEND_STRING_ASYNC_DELAY(string, interval) send_string_async_with_delay_P(PSTR(string), interval)
+#endif
+
 /** \} */
@@ -0,0 +1,214 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "loopback_transport.h"
+#include "timer.h"
+#include "transactions.h"
+#include "transport.h"
+#include "encoder.h"
+
+_Static_assert(sizeof(((loopback_state_t *)NULL)->encoders) == NUM_ENCODERS_MAX_PER_SIDE, "Encoder state does not match config.h");
+
+// Both halves live in this process, the master half owns split_shmem and the
+// slave half's memory and keyboard state are swapped in while it runs.
+static split_shared_memory_t master_memory;
+static split_shared_memory_t slave_memory;
+split_shared_memory_t *const split_shmem = &master_memory;
+
+static loopback_state_t master_state;
+static loopback_state_t slave_state;
+loopback_state_t *const  loopback_state = &master_state;
+
+layer_state_t layer_state;
+layer_state_t default_layer_state;
+
+loopback_stats_t loopback_stats;
+
+static uint16_t drop_interval = 0;
+static uint16_t drop_counter  = 0;
+static int8_t   drop_id       = -1;
+
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+#    define transaction_variable_length(trans) ((trans)->variable_length)
+#    define variable_buffer_length(buffer) split_batch_frame_length(buffer)
+#else
+#    define transaction_variable_length(trans) false
+#    define variable_buffer_length(buffer) ((buffer)[0])
+#endif
+
+bool is_transport_connected(void) {
+    return true;
+}
+
+uint32_t sync_timer_read32(void) {
+    return timer_read32();
+}
+
+void sync_timer_update(uint32_t time) {}
+
+void encoder_state_raw(uint8_t *slave_state) {
+    memcpy(slave_state, loopback_state->encoders, sizeof(loopback_state->encoders));
+}
+
+void encoder_update_raw(uint8_t *slave_state) {
+    memcpy(loopback_state->encoders, slave_state, sizeof(loopback_state->encoders));
+}
+
+uint8_t host_keyboard_leds(void) {
+    return loopback_state->leds;
+}
+
+void set_split_host_keyboard_leds(uint8_t led_state) {
+    loopback_state->leds = led_state;
+}
+
+uint8_t get_mods(void) {
+    return loopback_state->mods;
+}
+
+void set_mods(uint8_t mods) {
+    loopback_state->mods = mods;
+}
+
+uint8_t get_weak_mods(void) {
+    return loopback_state->weak_mods;
+}
+
+void set_weak_mods(uint8_t mods) {
+    loopback_state->weak_mods = mods;
+}
+
+uint8_t get_oneshot_mods(void) {
+    return loopback_state->oneshot_mods;
+}
+
+void set_oneshot_mods(uint8_t mods) {
+    loopback_state->oneshot_mods = mods;
+}
+
+uint8_t get_current_wpm(void) {
+    return loopback_state->wpm;
+}
+
+void set_current_wpm(uint8_t wpm) {
+    loopback_state->wpm = wpm;
+}
+
+static void swap_halves(void) {
+    split_shared_memory_t temp = master_memory;
+    master_memory              = slave_memory;
+    slave_memory               = temp;
+
+    master_state.layer_state         = layer_state;
+    master_state.default_layer_state = default_layer_state;
+    loopback_state_t state           = master_state;
+    master_state                     = slave_state;
+    slave_state                      = state;
+    layer_state                      = master_state.layer_state;
+    default_layer_state              = master_state.default_layer_state;
+}
+
+static uint8_t wire_length(const uint8_t *buffer, uint8_t size, bool variable_length) {
+    return variable_length ? variable_buffer_length(buffer) : size;
+}
+
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (initiator2target_length > 0) {
+        size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, len);
+    }
+
+    loopback_stats.transactions++;
+    loopback_stats.bytes += 2;
+
+    if (trans->initiator2target_buffer_size) {
+        uint8_t len = wire_length(split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size, transaction_variable_length(trans));
+        memcpy((uint8_t *)&slave_memory + trans->initiator2target_offset, split_trans_initiator2target_buffer(trans), len);
+        loopback_stats.bytes += len;
+    }
+
+    uint8_t reply[sizeof(split_shared_memory_t)];
+    uint8_t reply_length = 0;
+    swap_halves();
+    if (trans->slave_callback) {
+        trans->slave_callback(trans->initiator2target_buffer_size, split_trans_initiator2target_buffer(trans), trans->target2initiator_buffer_size, split_trans_target2initiator_buffer(trans));
+    }
+    if (trans->target2initiator_buffer_size) {
+        reply_length = wire_length(split_trans_target2initiator_buffer(trans), trans->target2initiator_buffer_size, transaction_variable_length(trans));
+        memcpy(reply, split_trans_target2initiator_buffer(trans), reply_length);
+    }
+    swap_halves();
+
+    if ((drop_interval && ++drop_counter >= drop_interval) || id == drop_id) {
+        drop_counter = 0;
+        loopback_stats.dropped++;
+        return false;
+    }
+
+    memcpy(split_trans_target2initiator_buffer(trans), reply, reply_length);
+    loopback_stats.bytes += reply_length;
+
+    if (target2initiator_length > 0) {
+        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+    }
+    return true;
+}
+
+#ifdef SPLIT_TRANSPORT_ASYNC
+// Transactions complete before returning, the same as on I2C
+bool transport_execute_transaction_async(transport_future_t *future, int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    future->id                      = id;
+    future->target2initiator_buf    = target2initiator_buf;
+    future->target2initiator_length = target2initiator_length;
+    future->status                  = transport_execute_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length) ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+    if (future->callback) {
+        future->callback(future);
+    }
+    return true;
+}
+
+transport_status_t transport_poll(transport_future_t *future) {
+    return future->status;
+}
+
+transport_status_t transport_wait(transport_future_t *future) {
+    return future->status;
+}
+#endif // SPLIT_TRANSPORT_ASYNC
+
+bool loopback_master_scan(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return transactions_master(master_matrix, slave_matrix);
+}
+
+void loopback_slave_scan(matrix_row_t slave_matrix[]) {
+    matrix_row_t master_matrix[(MATRIX_ROWS) / 2] = {0};
+
+    swap_halves();
+    transactions_slave(master_matrix, slave_matrix);
+    swap_halves();
+}
+
+void loopback_drop_every(uint16_t interval) {
+    drop_interval = interval;
+    drop_counter  = 0;
+}
+
+void loopback_reset_slave(void) {
+    memset(&slave_memory, 0, sizeof(slave_memory));
+}
+
+void loopback_drop_id(int8_t id) {
+    drop_id = id;
+}
+
+loopback_state_t *loopback_slave_state(void) {
+    return &slave_state;
+}
+
+void loopback_reset_stats(void) {
+    memset(&loopback_stats, 0, sizeof(loopback_stats));
+}
@@ -0,0 +1,68 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "action_layer.h"
+#include "matrix.h"
+
+/**
+ * The keyboard state the transactions sync, held separately for each half.
+ */
+typedef struct loopback_state_t {
+    layer_state_t layer_state;
+    layer_state_t default_layer_state;
+    uint8_t       leds;
+    uint8_t       mods;
+    uint8_t       weak_mods;
+    uint8_t       oneshot_mods;
+    uint8_t       wpm;
+    uint8_t       encoders[2]; // one per encoder in config.h
+    bool          left;
+} loopback_state_t;
+
+// The state of whichever half is running, which is the master outside of transactions
+extern loopback_state_t *const loopback_state;
+
+typedef struct loopback_stats_t {
+    uint32_t transactions;
+    uint32_t bytes; // including the two handshake bytes of every transaction
+    uint32_t dropped;
+} loopback_stats_t;
+
+extern loopback_stats_t loopback_stats;
+
+/**
+ * Runs the master side of a scan, returning false if the slave could not be reached.
+ */
+bool loopback_master_scan(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
+
+/**
+ * Runs the slave side of a scan against the slave's own copy of the shared memory.
+ */
+void loopback_slave_scan(matrix_row_t slave_matrix[]);
+
+/**
+ * Loses the reply of every nth transaction after the slave has processed it, 0 to disable.
+ */
+void loopback_drop_every(uint16_t interval);
+
+/**
+ * Loses the reply of every transaction with the given id after the slave has processed it, -1 to disable.
+ */
+void loopback_drop_id(int8_t id);
+
+/**
+ * Clears the slave's shared memory, as a reset of the slave half would.
+ */
+void loopback_reset_slave(void);
+
+/**
+ * The keyboard state of the slave half, as left by its last scan.
+ */
+loopback_state_t *loopback_slave_state(void);
+
+void loopback_reset_stats(void);
@@ -0,0 +1,225 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+// The split headers use C11 static assertions
+#define _Static_assert static_assert
+
+extern "C" {
+#include "loopback_transport.h"
+#include "pointing_device.h"
+#include "timer.h"
+#include "transaction_id_define.h"
+
+void advance_time(uint32_t ms);
+}
+
+#define SLAVE_ROWS ((MATRIX_ROWS) / 2)
+
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+// The totals only travel inside the batch frame
+#    define POINTING_DATA_TRANSACTION EXCHANGE_BATCH_FRAME
+#else
+#    define POINTING_DATA_TRANSACTION GET_POINTING_DATA
+#endif
+
+// The slave's sensor, on the right half, moves and the master reports its motion
+static report_mouse_t sensor;
+static int32_t        host_x;
+static int32_t        host_y;
+
+static void     sensor_init(void) {}
+static uint16_t sensor_get_cpi(void) {
+    return 0;
+}
+static void           sensor_set_cpi(uint16_t cpi) {}
+static report_mouse_t sensor_get_report(report_mouse_t mouse_report) {
+    // The master's own sensor, with POINTING_DEVICE_COMBINED, stays still
+    if (loopback_state->left) {
+        return mouse_report;
+    }
+    mouse_report = sensor;
+    memset(&sensor, 0, sizeof(sensor));
+    return mouse_report;
+}
+
+extern "C" {
+extern const pointing_device_driver_t pointing_device_driver = {
+    .init       = sensor_init,
+    .get_report = sensor_get_report,
+    .set_cpi    = sensor_set_cpi,
+    .get_cpi    = sensor_get_cpi,
+};
+
+bool is_keyboard_left(void) {
+    return loopback_state->left;
+}
+
+bool is_keyboard_master(void) {
+    return loopback_state->left;
+}
+
+bool has_mouse_report_changed(report_mouse_t *new_report, report_mouse_t *old_report) {
+    return memcmp(new_report, old_report, sizeof(report_mouse_t)) != 0;
+}
+
+void host_mouse_send(report_mouse_t *report) {
+    host_x += report->x;
+    host_y += report->y;
+}
+}
+
+class SplitPointing : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        loopback_drop_every(0);
+        loopback_drop_id(-1);
+        loopback_state->left         = true;
+        loopback_slave_state()->left = false;
+        memset(&sensor, 0, sizeof(sensor));
+        pointing_device_init();
+        // Settle whatever an earlier test left behind, then count from here
+        for (int i = 0; i < 20; i++) {
+            scan();
+        }
+        host_x = 0;
+        host_y = 0;
+    }
+
+    // One scan of both halves followed by the master's pointing task, with the slave's sensor having moved by dx, dy
+    bool scan(int8_t dx = 0, int8_t dy = 0, bool report = true) {
+        matrix_row_t master_matrix[SLAVE_ROWS] = {0};
+        matrix_row_t slave_matrix[SLAVE_ROWS]  = {0};
+
+        advance_time(POINTING_DEVICE_TASK_THROTTLE_MS);
+        sensor.x += dx;
+        sensor.y += dy;
+        loopback_slave_scan(slave_matrix);
+        bool okay = loopback_master_scan(master_matrix, slave_matrix);
+        if (report) {
+            pointing_device_task();
+        }
+        return okay;
+    }
+
+    // Reports until the master has sent everything it holds
+    void drain(void) {
+        loopback_drop_every(0);
+        loopback_drop_id(-1);
+        for (int i = 0; i < 40; i++) {
+            scan();
+        }
+    }
+};
+
+TEST_F(SplitPointing, MotionArrivesWhenNothingIsDropped) {
+    for (int i = 0; i < 50; i++) {
+        EXPECT_TRUE(scan(5, -3));
+    }
+    drain();
+    EXPECT_EQ(host_x, 250);
+    EXPECT_EQ(host_y, -150);
+}
+
+TEST_F(SplitPointing, DroppedReadsDelayMotionWithoutLosingIt) {
+    EXPECT_TRUE(scan(10, 10));
+    // The totals never make it back, while the rest of the link keeps working
+    loopback_drop_id(POINTING_DATA_TRANSACTION);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_FALSE(scan(7, 0));
+    }
+    EXPECT_EQ(host_x, 10);
+
+    drain();
+    EXPECT_EQ(host_x, 80);
+    EXPECT_EQ(host_y, 10);
+}
+
+TEST_F(SplitPointing, NoisyLinkLosesNoMotion) {
+    loopback_drop_every(3);
+    for (int i = 0; i < 50; i++) {
+        scan(5, -3);
+    }
+    drain();
+    EXPECT_EQ(host_x, 250);
+    EXPECT_EQ(host_y, -150);
+}
+
+TEST_F(SplitPointing, MotionMissedWhileUnreachableArrivesLater) {
+    EXPECT_TRUE(scan(10, 10));
+    // Every reply lost, the slave keeps reading its sensor
+    loopback_drop_every(1);
+    for (int i = 0; i < 10; i++) {
+        EXPECT_FALSE(scan(7, 0));
+    }
+    EXPECT_EQ(host_x, 10);
+
+    drain();
+    EXPECT_EQ(host_x, 80);
+    EXPECT_EQ(host_y, 10);
+}
+
+TEST_F(SplitPointing, ResetHalfIsNotReplayedAsMotion) {
+    for (int i = 0; i < 20; i++) {
+        scan(25, -25);
+    }
+    drain();
+    EXPECT_EQ(host_x, 500);
+    EXPECT_EQ(host_y, -500);
+
+    // The slave's totals start from zero again, which must not be sent as motion back the other way
+    loopback_reset_slave();
+    scan();
+    drain();
+    EXPECT_EQ(host_x, 500);
+    EXPECT_EQ(host_y, -500);
+
+    for (int i = 0; i < 10; i++) {
+        scan(3, 4);
+    }
+    drain();
+    EXPECT_EQ(host_x, 530);
+    EXPECT_EQ(host_y, -460);
+}
+
+TEST_F(SplitPointing, BacklogIsBounded) {
+    // The master keeps reading the slave but falls behind on reports
+    for (int i = 0; i < 20; i++) {
+        scan(XY_REPORT_MAX, 0, false);
+    }
+    drain();
+    // The default POINTING_DEVICE_SHARED_BACKLOG_REPORTS
+    EXPECT_EQ(host_x, XY_REPORT_MAX * 8);
+    EXPECT_EQ(host_y, 0);
+}
+
+#ifdef POINTING_DEVICE_ACCEL_ENABLE
+TEST_F(SplitPointing, BacklogIsScaledBeforeClamping) {
+    EXPECT_TRUE(scan(1, 0));
+    loopback_drop_id(POINTING_DATA_TRANSACTION);
+    scan(XY_REPORT_MAX, 0);
+    scan(XY_REPORT_MAX, 0);
+    loopback_drop_id(-1);
+    // Three reports' worth in three milliseconds is fast enough for twice the motion, as long as none of it is clamped first
+    EXPECT_TRUE(scan(XY_REPORT_MAX, 0));
+    drain();
+    EXPECT_EQ(host_x, 1 + 2 * 3 * XY_REPORT_MAX);
+    EXPECT_EQ(host_y, 0);
+}
+#endif
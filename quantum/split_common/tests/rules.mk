@@ -0,0 +1,70 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+SPLIT_TRANSACTIONS_COMMON_DEFS := -DSPLIT_KEYBOARD -DENCODER_ENABLE -DWPM_ENABLE
+
+SPLIT_TRANSACTIONS_COMMON_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/split_common/transaction_batch.c \
+	$(QUANTUM_PATH)/split_common/tests/loopback_transport.c \
+	$(QUANTUM_PATH)/split_common/tests/transactions_tests.cpp
+
+split_transactions_DEFS := $(SPLIT_TRANSACTIONS_COMMON_DEFS)
+split_transactions_INC := $(QUANTUM_PATH)/split_common
+split_transactions_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transactions_SRC := $(SPLIT_TRANSACTIONS_COMMON_SRC)
+
+split_transactions_batched_DEFS := $(SPLIT_TRANSACTIONS_COMMON_DEFS) -DSPLIT_TRANSACTIONS_BATCHED -DSERIAL_DRIVER_USART
+split_transactions_batched_INC := $(QUANTUM_PATH)/split_common
+split_transactions_batched_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transactions_batched_SRC := $(SPLIT_TRANSACTIONS_COMMON_SRC)
+
+split_transactions_async_DEFS := $(SPLIT_TRANSACTIONS_COMMON_DEFS) -DSPLIT_TRANSPORT_ASYNC -DSERIAL_DRIVER_USART
+split_transactions_async_INC := $(QUANTUM_PATH)/split_common
+split_transactions_async_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transactions_async_SRC := $(SPLIT_TRANSACTIONS_COMMON_SRC)
+
+split_transport_async_DEFS := -DSPLIT_KEYBOARD -DSPLIT_TRANSPORT_ASYNC -DSERIAL_DRIVER_USART
+split_transport_async_INC := $(QUANTUM_PATH)/split_common $(DRIVER_PATH)
+split_transport_async_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transport_async_SRC := \
+	$(QUANTUM_PATH)/split_common/transport.c \
+	$(QUANTUM_PATH)/split_common/tests/transport_async_tests.cpp
+
+split_transactions_pointing_DEFS := $(SPLIT_TRANSACTIONS_COMMON_DEFS) -DMOUSE_ENABLE -DPOINTING_DEVICE_ENABLE -DSPLIT_POINTING_ENABLE -DPOINTING_DEVICE_RIGHT
+split_transactions_pointing_INC := $(QUANTUM_PATH)/split_common $(QUANTUM_PATH)/pointing_device
+split_transactions_pointing_CONFIG := $(QUANTUM_PATH)/split_common/tests/config.h
+split_transactions_pointing_SRC := \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/crc.c \
+	$(QUANTUM_PATH)/split_common/transactions.c \
+	$(QUANTUM_PATH)/split_common/transaction_batch.c \
+	$(QUANTUM_PATH)/split_common/tests/loopback_transport.c \
+	$(QUANTUM_PATH)/pointing_device/pointing_device.c \
+	$(QUANTUM_PATH)/split_common/tests/pointing_tests.cpp
+
+split_transactions_pointing_batched_DEFS := $(split_transactions_pointing_DEFS) -DSPLIT_TRANSACTIONS_BATCHED -DSERIAL_DRIVER_USART
+split_transactions_pointing_batched_INC := $(split_transactions_pointing_INC)
+split_transactions_pointing_batched_CONFIG := $(split_transactions_pointing_CONFIG)
+split_transactions_pointing_batched_SRC := $(split_transactions_pointing_SRC)
+
+split_transactions_pointing_accel_DEFS := $(SPLIT_TRANSACTIONS_COMMON_DEFS) -DMOUSE_ENABLE -DPOINTING_DEVICE_ENABLE -DSPLIT_POINTING_ENABLE -DPOINTING_DEVICE_COMBINED -DPOINTING_DEVICE_ACCEL_ENABLE
+split_transactions_pointing_accel_INC := $(split_transactions_pointing_INC)
+split_transactions_pointing_accel_CONFIG := $(QUANTUM_PATH)/split_common/tests/config_pointing_accel.h
+split_transactions_pointing_accel_SRC := \
+	$(split_transactions_pointing_SRC) \
+	$(QUANTUM_PATH)/pointing_device/pointing_device_accel.c
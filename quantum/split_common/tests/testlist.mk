@@ -0,0 +1,8 @@
+TEST_LIST += \
+	split_transactions \
+	split_transactions_batched \
+	split_transactions_async \
+	split_transport_async \
+	split_transactions_pointing \
+	split_transactions_pointing_batched \
+	split_transactions_pointing_accel
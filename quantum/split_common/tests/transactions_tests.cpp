@@ -0,0 +1,211 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+#include <iostream>
+
+extern "C" {
+#include "loopback_transport.h"
+#include "timer.h"
+#include "transaction_batch.h"
+
+void advance_time(uint32_t ms);
+}
+
+#define SLAVE_ROWS ((MATRIX_ROWS) / 2)
+
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+#    define TRANSPORT_MODE "batched"
+#elif defined(SPLIT_TRANSPORT_ASYNC)
+#    define TRANSPORT_MODE "unbatched, async"
+#else
+#    define TRANSPORT_MODE "unbatched"
+#endif
+
+#if defined(SPLIT_TRANSPORT_ASYNC) && !defined(SPLIT_TRANSACTIONS_BATCHED)
+// The slave matrix checksum is read at the end of the previous scan, so changes show up a scan later
+#    define SCANS_TO_SYNC 2
+#else
+#    define SCANS_TO_SYNC 1
+#endif
+
+// USART split at 460800 baud, 8N1
+#define WIRE_BAUD 460800
+#define WIRE_BITS_PER_BYTE 10
+// Assumed fixed cost of every transaction on top of its bytes: waking the slave thread and turning the line around
+#define WIRE_TRANSACTION_OVERHEAD_US 40
+
+class SplitTransactions : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        loopback_drop_every(0);
+        loopback_reset_stats();
+    }
+
+    bool scan() {
+        advance_time(1);
+        loopback_slave_scan(slave_side);
+        return loopback_master_scan(master_side, received);
+    }
+
+    // Scans until a change on the slave has reached the master
+    bool sync() {
+        bool okay = true;
+        for (int i = 0; i < SCANS_TO_SYNC; i++) {
+            okay &= scan();
+        }
+        return okay;
+    }
+
+    bool in_sync() {
+        return memcmp(slave_side, received, sizeof(received)) == 0;
+    }
+
+    matrix_row_t master_side[SLAVE_ROWS] = {0};
+    matrix_row_t slave_side[SLAVE_ROWS]  = {0};
+    matrix_row_t received[SLAVE_ROWS]    = {0};
+};
+
+TEST_F(SplitTransactions, SlaveMatrixReachesMaster) {
+    slave_side[0] = 0x01;
+    slave_side[3] = 0x80;
+    EXPECT_TRUE(sync());
+    EXPECT_TRUE(in_sync());
+
+    slave_side[0] = 0;
+    EXPECT_TRUE(sync());
+    EXPECT_TRUE(in_sync());
+}
+
+TEST_F(SplitTransactions, RecoversFromLostReplies) {
+    loopback_drop_every(3);
+    for (int i = 0; i < 500; i++) {
+        slave_side[i % SLAVE_ROWS] ^= 1 << (i % MATRIX_COLS);
+        if (sync()) {
+            EXPECT_TRUE(in_sync()) << "scan " << i;
+        }
+    }
+    EXPECT_GT(loopback_stats.dropped, 0u);
+
+    loopback_drop_every(0);
+    EXPECT_TRUE(sync());
+    EXPECT_TRUE(in_sync());
+}
+
+// Compare the output of the unbatched and batched test runs to see the difference.
+TEST_F(SplitTransactions, Benchmark) {
+    const int scans = 10000;
+    for (int i = 0; i < scans; i++) {
+        // A key changes state every eighth scan, the rest of the state far less often
+        if (i % 8 == 0) {
+            slave_side[(i / 8) % SLAVE_ROWS] ^= 1 << ((i / 8) % MATRIX_COLS);
+        }
+        if (i % 50 == 0) {
+            loopback_state->mods ^= 0x02;
+        }
+        if (i % 100 == 0) {
+            loopback_slave_state()->encoders[0]++;
+            loopback_state->wpm = i / 100;
+        }
+        if (i % 500 == 0) {
+            layer_state ^= 0x02;
+        }
+        ASSERT_TRUE(scan());
+    }
+    EXPECT_TRUE(in_sync());
+    EXPECT_EQ(loopback_slave_state()->layer_state, layer_state);
+    EXPECT_EQ(loopback_slave_state()->mods, loopback_state->mods);
+    EXPECT_EQ(loopback_slave_state()->encoders[0], loopback_state->encoders[0]);
+
+    double transactions = (double)loopback_stats.transactions / scans;
+    double bytes        = (double)loopback_stats.bytes / scans;
+    double wire_us      = bytes * WIRE_BITS_PER_BYTE * 1000000 / WIRE_BAUD;
+    double total_us     = wire_us + transactions * WIRE_TRANSACTION_OVERHEAD_US;
+    std::cout << "[ BENCHMARK] " << TRANSPORT_MODE << ": " << transactions << " transactions/scan, " << bytes << " bytes/scan, " << wire_us << "us/scan on the wire, " << total_us << "us/scan with " << WIRE_TRANSACTION_OVERHEAD_US << "us per transaction" << std::endl;
+    RecordProperty("bytes_per_scan_x100", static_cast<int>(bytes * 100));
+    RecordProperty("transactions_per_scan_x100", static_cast<int>(transactions * 100));
+}
+
+static int16_t record_size(uint8_t id) {
+    return id < 8 ? id : -1;
+}
+
+TEST(SplitBatchFrame, EmptyFramesAreJustTheHeader) {
+    uint8_t frame[8];
+    split_batch_frame_begin(frame, true);
+    split_batch_frame_end(frame);
+    EXPECT_EQ(split_batch_frame_length(frame), SPLIT_BATCH_HEADER_SIZE);
+    EXPECT_TRUE(split_batch_frame_valid(frame, sizeof(frame)));
+    EXPECT_TRUE(split_batch_frame_sequence(frame));
+
+    // A single flipped sequence bit is caught without a CRC
+    frame[0] ^= 0x40;
+    EXPECT_FALSE(split_batch_frame_valid(frame, sizeof(frame)));
+}
+
+TEST(SplitBatchFrame, RejectsCorruptFrames) {
+    uint8_t frame[32];
+    uint8_t data[4] = {1, 2, 3, 4};
+    split_batch_frame_begin(frame, false);
+    EXPECT_TRUE(split_batch_frame_add(frame, sizeof(frame), 4, data, sizeof(data)));
+    EXPECT_TRUE(split_batch_frame_add(frame, sizeof(frame), 0, NULL, 0));
+    split_batch_frame_end(frame);
+    EXPECT_EQ(split_batch_frame_length(frame), SPLIT_BATCH_HEADER_SIZE + 2 * SPLIT_BATCH_RECORD_HEADER_SIZE + sizeof(data) + 1);
+    EXPECT_TRUE(split_batch_frame_valid(frame, sizeof(frame)));
+    EXPECT_FALSE(split_batch_frame_sequence(frame));
+
+    uint8_t              position = SPLIT_BATCH_HEADER_SIZE;
+    split_batch_record_t record;
+    EXPECT_TRUE(split_batch_frame_next(frame, &position, &record, record_size));
+    EXPECT_EQ(record.id, 4);
+    EXPECT_EQ(record.length, sizeof(data));
+    EXPECT_EQ(memcmp(record.payload, data, sizeof(data)), 0);
+    EXPECT_TRUE(split_batch_frame_next(frame, &position, &record, record_size));
+    EXPECT_EQ(record.id, 0);
+    EXPECT_EQ(record.length, 0);
+    EXPECT_FALSE(split_batch_frame_next(frame, &position, &record, record_size));
+    EXPECT_TRUE(split_batch_frame_done(frame, position));
+
+    frame[SPLIT_BATCH_HEADER_SIZE + 3] ^= 0x01;
+    EXPECT_FALSE(split_batch_frame_valid(frame, sizeof(frame)));
+}
+
+TEST(SplitBatchFrame, StopsAtUnknownRecords) {
+    uint8_t frame[32];
+    uint8_t data[2] = {1, 2};
+    split_batch_frame_begin(frame, false);
+    EXPECT_TRUE(split_batch_frame_add(frame, sizeof(frame), 2, data, sizeof(data)));
+    EXPECT_TRUE(split_batch_frame_add(frame, sizeof(frame), 9, data, sizeof(data)));
+    split_batch_frame_end(frame);
+    EXPECT_TRUE(split_batch_frame_valid(frame, sizeof(frame)));
+
+    uint8_t              position = SPLIT_BATCH_HEADER_SIZE;
+    split_batch_record_t record;
+    EXPECT_TRUE(split_batch_frame_next(frame, &position, &record, record_size));
+    EXPECT_FALSE(split_batch_frame_next(frame, &position, &record, record_size));
+    EXPECT_FALSE(split_batch_frame_done(frame, position));
+}
+
+TEST(SplitBatchFrame, RecordsThatDoNotFitAreRefused) {
+    uint8_t frame[12];
+    uint8_t data[10] = {0};
+    split_batch_frame_begin(frame, false);
+    EXPECT_FALSE(split_batch_frame_add(frame, sizeof(frame), 1, data, sizeof(data)));
+    EXPECT_EQ(split_batch_frame_length(frame), SPLIT_BATCH_HEADER_SIZE);
+    EXPECT_TRUE(split_batch_frame_add(frame, sizeof(frame), 1, data, sizeof(data) - 1));
+}
@@ -0,0 +1,201 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstddef>
+#include <cstring>
+
+// The split headers use C11 static assertions
+#define _Static_assert static_assert
+
+extern "C" {
+#include "serial.h"
+#include "transactions.h"
+#include "transport.h"
+}
+
+// Stands in for the serial transport thread, transactions only complete when the test says so
+// or when the caller waits on them
+struct fake_serial_t {
+    serial_transaction_status_t status;
+    int                         index;
+    bool                        result;
+    int                         started;
+};
+
+static fake_serial_t fake_serial;
+
+extern "C" {
+split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS];
+
+bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    return true;
+}
+
+void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {}
+
+void soft_serial_initiator_init(void) {}
+
+void soft_serial_target_init(void) {}
+
+bool soft_serial_transaction(int index) {
+    return false;
+}
+
+bool soft_serial_transaction_start(int index) {
+    if (fake_serial.status == SERIAL_TRANSACTION_PENDING) {
+        return false;
+    }
+    fake_serial.status = SERIAL_TRANSACTION_PENDING;
+    fake_serial.index  = index;
+    fake_serial.started++;
+    return true;
+}
+
+serial_transaction_status_t soft_serial_transaction_poll(void) {
+    return fake_serial.status;
+}
+
+serial_transaction_status_t soft_serial_transaction_wait(void) {
+    if (fake_serial.status == SERIAL_TRANSACTION_PENDING) {
+        fake_serial.status = fake_serial.result ? SERIAL_TRANSACTION_SUCCESS : SERIAL_TRANSACTION_FAILED;
+    }
+    return fake_serial.status;
+}
+}
+
+// The reply the slave would send for GET_SLAVE_MATRIX_CHECKSUM
+#define SLAVE_CHECKSUM 0x5A
+
+static int                 callbacks;
+static transport_future_t *callback_future;
+
+static void count_callback(transport_future_t *future) {
+    callbacks++;
+    callback_future = future;
+}
+
+class SplitTransportAsync : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        memset(&fake_serial, 0, sizeof(fake_serial));
+        fake_serial.result = true;
+        memset(split_transaction_table, 0, sizeof(split_transaction_table));
+        memset(split_shmem, 0, sizeof(*split_shmem));
+        callbacks       = 0;
+        callback_future = NULL;
+
+        split_transaction_table[GET_SLAVE_MATRIX_CHECKSUM].target2initiator_buffer_size = sizeof(split_shmem->smatrix.checksum);
+        split_transaction_table[GET_SLAVE_MATRIX_CHECKSUM].target2initiator_offset      = offsetof(split_shared_memory_t, smatrix.checksum);
+        split_transaction_table[GET_SLAVE_MATRIX_DATA].target2initiator_buffer_size     = sizeof(split_shmem->smatrix.matrix);
+        split_transaction_table[GET_SLAVE_MATRIX_DATA].target2initiator_offset          = offsetof(split_shared_memory_t, smatrix.matrix);
+    }
+
+    // Completes the transaction on the transport thread, as if the slave had replied
+    void complete(bool success) {
+        if (success) {
+            split_shmem->smatrix.checksum = SLAVE_CHECKSUM;
+        }
+        fake_serial.status = success ? SERIAL_TRANSACTION_SUCCESS : SERIAL_TRANSACTION_FAILED;
+    }
+
+    uint8_t checksum = 0;
+};
+
+TEST_F(SplitTransportAsync, PollResolvesOnceComplete) {
+    transport_future_t future = {.callback = count_callback};
+    EXPECT_TRUE(transport_execute_transaction_async(&future, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+    EXPECT_EQ(fake_serial.index, GET_SLAVE_MATRIX_CHECKSUM);
+    EXPECT_EQ(transport_poll(&future), TRANSPORT_PENDING);
+    EXPECT_EQ(transport_poll(&future), TRANSPORT_PENDING);
+    EXPECT_EQ(callbacks, 0);
+
+    complete(true);
+    EXPECT_EQ(transport_poll(&future), TRANSPORT_SUCCESS);
+    EXPECT_EQ(checksum, SLAVE_CHECKSUM);
+    EXPECT_EQ(callbacks, 1);
+    EXPECT_EQ(callback_future, &future);
+
+    // A resolved future keeps its result and does not run its callback again
+    EXPECT_EQ(transport_poll(&future), TRANSPORT_SUCCESS);
+    EXPECT_EQ(transport_wait(&future), TRANSPORT_SUCCESS);
+    EXPECT_EQ(callbacks, 1);
+}
+
+TEST_F(SplitTransportAsync, WaitBlocksUntilComplete) {
+    transport_future_t future = {.callback = count_callback};
+    EXPECT_TRUE(transport_execute_transaction_async(&future, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+    split_shmem->smatrix.checksum = SLAVE_CHECKSUM;
+    EXPECT_EQ(transport_wait(&future), TRANSPORT_SUCCESS);
+    EXPECT_EQ(checksum, SLAVE_CHECKSUM);
+    EXPECT_EQ(callbacks, 1);
+}
+
+TEST_F(SplitTransportAsync, FailureLeavesTheReplyAlone) {
+    transport_future_t future = {.callback = count_callback};
+    EXPECT_TRUE(transport_execute_transaction_async(&future, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+    split_shmem->smatrix.checksum = SLAVE_CHECKSUM;
+    complete(false);
+    EXPECT_EQ(transport_poll(&future), TRANSPORT_FAILED);
+    EXPECT_EQ(checksum, 0);
+    EXPECT_EQ(callbacks, 1);
+}
+
+TEST_F(SplitTransportAsync, OnlyOneTransactionInFlight) {
+    transport_future_t first  = {.callback = count_callback};
+    transport_future_t second = {.callback = NULL};
+    EXPECT_TRUE(transport_execute_transaction_async(&first, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+
+    second.status = TRANSPORT_SUCCESS;
+    EXPECT_FALSE(transport_execute_transaction_async(&second, GET_SLAVE_MATRIX_DATA, NULL, 0, NULL, 0));
+    EXPECT_EQ(transport_poll(&second), TRANSPORT_FAILED);
+    EXPECT_EQ(fake_serial.started, 1);
+
+    // Starting the next transaction collects the one that finished in the meantime
+    complete(true);
+    EXPECT_TRUE(transport_execute_transaction_async(&second, GET_SLAVE_MATRIX_DATA, NULL, 0, NULL, 0));
+    EXPECT_EQ(callbacks, 1);
+    EXPECT_EQ(first.status, TRANSPORT_SUCCESS);
+    EXPECT_EQ(checksum, SLAVE_CHECKSUM);
+    EXPECT_EQ(transport_poll(&second), TRANSPORT_PENDING);
+    EXPECT_EQ(fake_serial.index, GET_SLAVE_MATRIX_DATA);
+    EXPECT_EQ(transport_wait(&second), TRANSPORT_SUCCESS);
+}
+
+TEST_F(SplitTransportAsync, BlockingCallsWaitBehindInFlight) {
+    transport_future_t future = {.callback = count_callback};
+    EXPECT_TRUE(transport_execute_transaction_async(&future, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+    split_shmem->smatrix.checksum = SLAVE_CHECKSUM;
+
+    matrix_row_t matrix[(MATRIX_ROWS) / 2];
+    EXPECT_TRUE(transport_execute_transaction(GET_SLAVE_MATRIX_DATA, NULL, 0, matrix, sizeof(matrix)));
+    EXPECT_EQ(future.status, TRANSPORT_SUCCESS);
+    EXPECT_EQ(checksum, SLAVE_CHECKSUM);
+    EXPECT_EQ(callbacks, 1);
+    EXPECT_EQ(fake_serial.started, 2);
+    EXPECT_EQ(fake_serial.index, GET_SLAVE_MATRIX_DATA);
+}
+
+TEST_F(SplitTransportAsync, FailedStartResolvesTheFuture) {
+    transport_future_t future = {.callback = count_callback};
+    // The transport thread is still busy with a transaction this side does not know about
+    fake_serial.status = SERIAL_TRANSACTION_PENDING;
+    EXPECT_FALSE(transport_execute_transaction_async(&future, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &checksum, sizeof(checksum)));
+    EXPECT_EQ(transport_wait(&future), TRANSPORT_FAILED);
+    EXPECT_EQ(callbacks, 0);
+    fake_serial.status = SERIAL_TRANSACTION_IDLE;
+}
@@ -0,0 +1,84 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+
+#include "crc.h"
+#include "transaction_batch.h"
+
+static void frame_set_length(uint8_t *frame, uint8_t length) {
+    frame[0] = (frame[0] & SPLIT_BATCH_SEQUENCE_MASK) | length;
+}
+
+static uint8_t frame_records_end(const uint8_t *frame) {
+    const uint8_t length = split_batch_frame_length(frame);
+    return length > SPLIT_BATCH_HEADER_SIZE ? length - 1 : length;
+}
+
+void split_batch_frame_begin(uint8_t *frame, bool sequence) {
+    frame[0] = (sequence ? SPLIT_BATCH_SEQUENCE_MASK : 0) | SPLIT_BATCH_HEADER_SIZE;
+}
+
+bool split_batch_frame_add(uint8_t *frame, uint8_t capacity, uint8_t id, const void *data, uint8_t size) {
+    const uint8_t position = split_batch_frame_length(frame);
+    if (capacity > SPLIT_BATCH_FRAME_MAX) {
+        capacity = SPLIT_BATCH_FRAME_MAX;
+    }
+    // Keep one byte spare for the CRC
+    if ((uint16_t)position + SPLIT_BATCH_RECORD_HEADER_SIZE + size + 1 > capacity) {
+        return false;
+    }
+    frame[position] = id;
+    if (size) {
+        memcpy(&frame[position + SPLIT_BATCH_RECORD_HEADER_SIZE], data, size);
+    }
+    frame_set_length(frame, position + SPLIT_BATCH_RECORD_HEADER_SIZE + size);
+    return true;
+}
+
+void split_batch_frame_end(uint8_t *frame) {
+    const uint8_t length = split_batch_frame_length(frame);
+    if (length == SPLIT_BATCH_HEADER_SIZE) {
+        return;
+    }
+    frame_set_length(frame, length + 1);
+    frame[length] = crc8(frame, length);
+}
+
+bool split_batch_frame_valid(const uint8_t *frame, uint8_t capacity) {
+    const uint8_t length   = split_batch_frame_length(frame);
+    const uint8_t sequence = frame[0] & SPLIT_BATCH_SEQUENCE_MASK;
+    if (length == 0 || length > capacity || (sequence != 0 && sequence != SPLIT_BATCH_SEQUENCE_MASK)) {
+        return false;
+    }
+    if (length == SPLIT_BATCH_HEADER_SIZE) {
+        return true;
+    }
+    // Anything with a CRC holds at least one record header
+    if (length < SPLIT_BATCH_HEADER_SIZE + SPLIT_BATCH_RECORD_HEADER_SIZE + 1) {
+        return false;
+    }
+    return crc8(frame, length - 1) == frame[length - 1];
+}
+
+bool split_batch_frame_next(const uint8_t *frame, uint8_t *position, split_batch_record_t *record, split_batch_record_size_t record_size) {
+    const uint8_t end = frame_records_end(frame);
+    if ((uint16_t)*position + SPLIT_BATCH_RECORD_HEADER_SIZE > end) {
+        return false;
+    }
+
+    const int16_t size = record_size(frame[*position]);
+    if (size < 0 || (uint16_t)*position + SPLIT_BATCH_RECORD_HEADER_SIZE + size > end) {
+        return false;
+    }
+
+    record->id      = frame[*position];
+    record->length  = size;
+    record->payload = &frame[*position + SPLIT_BATCH_RECORD_HEADER_SIZE];
+    *position += SPLIT_BATCH_RECORD_HEADER_SIZE + size;
+    return true;
+}
+
+bool split_batch_frame_done(const uint8_t *frame, uint8_t position) {
+    return position == frame_records_end(frame);
+}
@@ -0,0 +1,75 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * A batch frame carries several split transactions in one buffer:
+ *
+ *   [sequence | length] { [id][payload] } [crc8]
+ *
+ * The header holds the frame length, including the header and CRC, in its low six bits and
+ * a sequence bit, left to the caller, in both of its high bits. A frame without records is
+ * just the header, duplicating the sequence bit catches a single flipped bit in it without
+ * spending a CRC on every idle scan. Records hold a raw copy of the transaction buffer, their
+ * length is not sent as both sides know the buffer size for each id.
+ */
+
+#define SPLIT_BATCH_HEADER_SIZE 1
+#define SPLIT_BATCH_RECORD_HEADER_SIZE 1
+#define SPLIT_BATCH_LENGTH_MASK 0x3F
+#define SPLIT_BATCH_SEQUENCE_MASK 0xC0
+#define SPLIT_BATCH_FRAME_MAX SPLIT_BATCH_LENGTH_MASK
+
+#define split_batch_frame_length(frame) ((frame)[0] & SPLIT_BATCH_LENGTH_MASK)
+#define split_batch_frame_sequence(frame) (((frame)[0] & SPLIT_BATCH_SEQUENCE_MASK) != 0)
+
+typedef struct split_batch_record_t {
+    uint8_t        id;
+    uint8_t        length;
+    const uint8_t *payload;
+} split_batch_record_t;
+
+/**
+ * Returns the payload size of records with the given id, or a negative value for unknown ids.
+ */
+typedef int16_t (*split_batch_record_size_t)(uint8_t id);
+
+/**
+ * Starts a new frame, without any records.
+ */
+void split_batch_frame_begin(uint8_t *frame, bool sequence);
+
+/**
+ * Appends a raw copy of `data` to the frame.
+ *
+ * @return false if the record does not fit the frame capacity, the frame is left untouched
+ */
+bool split_batch_frame_add(uint8_t *frame, uint8_t capacity, uint8_t id, const void *data, uint8_t size);
+
+/**
+ * Finishes the frame by appending its CRC if it holds any records, the capacity passed to
+ * split_batch_frame_add() keeps room for it.
+ */
+void split_batch_frame_end(uint8_t *frame);
+
+/**
+ * Checks the header and CRC of a received frame.
+ */
+bool split_batch_frame_valid(const uint8_t *frame, uint8_t capacity);
+
+/**
+ * Reads the record at `position` and advances past it, `position` starts at SPLIT_BATCH_HEADER_SIZE.
+ *
+ * @return false once there are no more records, or the frame is malformed
+ */
+bool split_batch_frame_next(const uint8_t *frame, uint8_t *position, split_batch_record_t *record, split_batch_record_size_t record_size);
+
+/**
+ * Returns true if `position` was left at the end of the records by split_batch_frame_next(),
+ * rather than at a record it could not read.
+ */
+bool split_batch_frame_done(const uint8_t *frame, uint8_t position);
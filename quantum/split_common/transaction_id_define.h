@@ -82,8 +82,14 @@ enum serial_transaction_id {
     GET_POINTING_CHECKSUM,
     GET_POINTING_DATA,
     PUT_POINTING_CPI,
+    PUT_POINTING_SYNCED,
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+// Everything above is carried by the batch frame when batching is enabled
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+    EXCHANGE_BATCH_FRAME,
+#endif // SPLIT_TRANSACTIONS_BATCHED
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     PUT_RPC_INFO,
     PUT_RPC_REQ_DATA,
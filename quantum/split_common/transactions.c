@@ -43,8 +43,17 @@
     { 0, 0, sizeof_member(split_shared_memory_t, member), offsetof(split_shared_memory_t, member), cb }
 #define trans_target2initiator_initializer(member) trans_target2initiator_initializer_cb(member, NULL)
 
-#define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
-#define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+static bool batch_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
+#    define transport_write(id, data, length) batch_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) batch_execute_transaction(id, NULL, 0, data, length)
+// A write that does not fit an otherwise empty frame, next to a full frame request, would never be sent
+#    define batch_m2s_assert_fits(member) _Static_assert(SPLIT_BATCH_HEADER_SIZE + 2 * SPLIT_BATCH_RECORD_HEADER_SIZE + sizeof_member(split_shared_memory_t, member) + 1 <= SPLIT_TRANSACTIONS_BATCH_M2S_SIZE, "SPLIT_TRANSACTIONS_BATCH_M2S_SIZE too small for " #member)
+#else // SPLIT_TRANSACTIONS_BATCHED
+#    define transport_write(id, data, length) transport_execute_transaction(id, data, length, NULL, 0)
+#    define transport_read(id, data, length) transport_execute_transaction(id, NULL, 0, data, length)
+#    define batch_m2s_assert_fits(member)
+#endif // SPLIT_TRANSACTIONS_BATCHED
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 // Forward-declare the RPC callback handlers
@@ -83,10 +92,9 @@ static bool transaction_handler_master(matrix_row_t master_matrix[], matrix_row_
         split_shared_memory_unlock();                         \
     } while (0)
 
-inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
-    uint8_t curr_checksum;
-    bool    okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
-    if (okay && (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || curr_checksum != crc8(equiv_shmem, length))) {
+inline static bool read_if_checksum_differs(uint8_t curr_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
+    bool okay = true;
+    if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || curr_checksum != crc8(equiv_shmem, length)) {
         okay &= transport_read(trans_id_retrieve, destination, length);
         okay &= curr_checksum == crc8(equiv_shmem, length);
         if (okay) {
@@ -98,6 +106,16 @@ inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t tr
     return okay;
 }
 
+inline static bool read_if_checksum_mismatch(int8_t trans_id_checksum, int8_t trans_id_retrieve, uint32_t *last_update, void *destination, const void *equiv_shmem, size_t length) {
+    uint8_t curr_checksum;
+    bool    okay = transport_read(trans_id_checksum, &curr_checksum, sizeof(curr_checksum));
+    if (!okay) {
+        memcpy(destination, equiv_shmem, length);
+        return false;
+    }
+    return read_if_checksum_differs(curr_checksum, trans_id_retrieve, last_update, destination, equiv_shmem, length);
+}
+
 inline static bool send_if_condition(int8_t trans_id, uint32_t *last_update, bool condition, void *source, size_t length) {
     bool okay = true;
     if (timer_elapsed32(*last_update) >= FORCED_SYNC_THROTTLE_MS || condition) {
@@ -117,12 +135,38 @@ inline static bool send_if_data_mismatch(int8_t trans_id, uint32_t *last_update,
 ////////////////////////////////////////////////////
 // Slave matrix
 
+#if defined(SPLIT_TRANSPORT_ASYNC) && !defined(SPLIT_TRANSACTIONS_BATCHED)
+// The checksum for the next scan is read while the rest of the keyboard task runs, a change on
+// the slave is still picked up by the following scan at the latest
+static transport_future_t slave_matrix_prefetch = {.status = TRANSPORT_FAILED, .callback = NULL};
+static uint8_t            slave_matrix_prefetch_checksum;
+
+static void slave_matrix_prefetch_start(void) {
+    transport_execute_transaction_async(&slave_matrix_prefetch, GET_SLAVE_MATRIX_CHECKSUM, NULL, 0, &slave_matrix_prefetch_checksum, sizeof(slave_matrix_prefetch_checksum));
+}
+
+#    define TRANSACTIONS_SLAVE_MATRIX_PREFETCH() slave_matrix_prefetch_start()
+#else
+#    define TRANSACTIONS_SLAVE_MATRIX_PREFETCH()
+#endif
+
 static bool slave_matrix_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     static uint32_t     last_update                    = 0;
     static matrix_row_t last_matrix[(MATRIX_ROWS) / 2] = {0}; // last successfully-read matrix, so we can replicate if there are checksum errors
     matrix_row_t        temp_matrix[(MATRIX_ROWS) / 2];       // holding area while we test whether or not checksum is correct
 
+#if defined(SPLIT_TRANSPORT_ASYNC) && !defined(SPLIT_TRANSACTIONS_BATCHED)
+    // Use the checksum read at the end of the last scan, retries and failed reads fall back to a fresh one
+    bool okay = transport_wait(&slave_matrix_prefetch) == TRANSPORT_SUCCESS;
+    slave_matrix_prefetch.status = TRANSPORT_FAILED;
+    if (okay) {
+        okay = read_if_checksum_differs(slave_matrix_prefetch_checksum, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    } else {
+        okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+    }
+#else
     bool okay = read_if_checksum_mismatch(GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA, &last_update, temp_matrix, split_shmem->smatrix.matrix, sizeof(split_shmem->smatrix.matrix));
+#endif
     if (okay) {
         // Checksum matches the received data, save as the last matrix state
         memcpy(last_matrix, temp_matrix, sizeof(temp_matrix));
@@ -163,6 +207,7 @@ static void master_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_ro
 #    define TRANSACTIONS_MASTER_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(master_matrix)
 #    define TRANSACTIONS_MASTER_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(master_matrix)
 #    define TRANSACTIONS_MASTER_MATRIX_REGISTRATIONS [PUT_MASTER_MATRIX] = trans_initiator2target_initializer(mmatrix.matrix),
+batch_m2s_assert_fits(mmatrix.matrix);
 
 #else // SPLIT_TRANSPORT_MIRROR
 
@@ -241,6 +286,7 @@ static void sync_timer_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 #    define TRANSACTIONS_SYNC_TIMER_MASTER() TRANSACTION_HANDLER_MASTER(sync_timer)
 #    define TRANSACTIONS_SYNC_TIMER_SLAVE() TRANSACTION_HANDLER_SLAVE(sync_timer)
 #    define TRANSACTIONS_SYNC_TIMER_REGISTRATIONS [PUT_SYNC_TIMER] = trans_initiator2target_initializer(sync_timer),
+batch_m2s_assert_fits(sync_timer);
 
 #else // DISABLE_SYNC_TIMER
 
@@ -278,6 +324,8 @@ static void layer_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_
     [PUT_LAYER_STATE]         = trans_initiator2target_initializer(layers.layer_state), \
     [PUT_DEFAULT_LAYER_STATE] = trans_initiator2target_initializer(layers.default_layer_state),
 // clang-format on
+batch_m2s_assert_fits(layers.layer_state);
+batch_m2s_assert_fits(layers.default_layer_state);
 
 #else // !defined(NO_ACTION_LAYER) && defined(SPLIT_LAYER_STATE_ENABLE)
 
@@ -306,6 +354,7 @@ static void led_state_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 #    define TRANSACTIONS_LED_STATE_MASTER() TRANSACTION_HANDLER_MASTER(led_state)
 #    define TRANSACTIONS_LED_STATE_SLAVE() TRANSACTION_HANDLER_SLAVE(led_state)
 #    define TRANSACTIONS_LED_STATE_REGISTRATIONS [PUT_LED_STATE] = trans_initiator2target_initializer(led_state),
+batch_m2s_assert_fits(led_state);
 
 #else // SPLIT_LED_STATE_ENABLE
 
@@ -363,6 +412,7 @@ static void mods_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave
 #    define TRANSACTIONS_MODS_MASTER() TRANSACTION_HANDLER_MASTER(mods)
 #    define TRANSACTIONS_MODS_SLAVE() TRANSACTION_HANDLER_SLAVE(mods)
 #    define TRANSACTIONS_MODS_REGISTRATIONS [PUT_MODS] = trans_initiator2target_initializer(mods),
+batch_m2s_assert_fits(mods);
 
 #else // SPLIT_MODS_ENABLE
 
@@ -390,6 +440,7 @@ static void backlight_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 #    define TRANSACTIONS_BACKLIGHT_MASTER() TRANSACTION_HANDLER_MASTER(backlight)
 #    define TRANSACTIONS_BACKLIGHT_SLAVE() TRANSACTION_HANDLER_SLAVE(backlight)
 #    define TRANSACTIONS_BACKLIGHT_REGISTRATIONS [PUT_BACKLIGHT] = trans_initiator2target_initializer(backlight_level),
+batch_m2s_assert_fits(backlight_level);
 
 #else // BACKLIGHT_ENABLE
 
@@ -427,6 +478,7 @@ static void rgblight_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
 #    define TRANSACTIONS_RGBLIGHT_MASTER() TRANSACTION_HANDLER_MASTER(rgblight)
 #    define TRANSACTIONS_RGBLIGHT_SLAVE() TRANSACTION_HANDLER_SLAVE(rgblight)
 #    define TRANSACTIONS_RGBLIGHT_REGISTRATIONS [PUT_RGBLIGHT] = trans_initiator2target_initializer(rgblight_sync),
+batch_m2s_assert_fits(rgblight_sync);
 
 #else // defined(RGBLIGHT_ENABLE) && defined(RGBLIGHT_SPLIT)
 
@@ -457,6 +509,7 @@ static void led_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 #    define TRANSACTIONS_LED_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(led_matrix)
 #    define TRANSACTIONS_LED_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(led_matrix)
 #    define TRANSACTIONS_LED_MATRIX_REGISTRATIONS [PUT_LED_MATRIX] = trans_initiator2target_initializer(led_matrix_sync),
+batch_m2s_assert_fits(led_matrix_sync);
 
 #else // defined(LED_MATRIX_ENABLE) && defined(LED_MATRIX_SPLIT)
 
@@ -487,6 +540,7 @@ static void rgb_matrix_handlers_slave(matrix_row_t master_matrix[], matrix_row_t
 #    define TRANSACTIONS_RGB_MATRIX_MASTER() TRANSACTION_HANDLER_MASTER(rgb_matrix)
 #    define TRANSACTIONS_RGB_MATRIX_SLAVE() TRANSACTION_HANDLER_SLAVE(rgb_matrix)
 #    define TRANSACTIONS_RGB_MATRIX_REGISTRATIONS [PUT_RGB_MATRIX] = trans_initiator2target_initializer(rgb_matrix_sync),
+batch_m2s_assert_fits(rgb_matrix_sync);
 
 #else // defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_SPLIT)
 
@@ -514,6 +568,7 @@ static void wpm_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave_
 #    define TRANSACTIONS_WPM_MASTER() TRANSACTION_HANDLER_MASTER(wpm)
 #    define TRANSACTIONS_WPM_SLAVE() TRANSACTION_HANDLER_SLAVE(wpm)
 #    define TRANSACTIONS_WPM_REGISTRATIONS [PUT_WPM] = trans_initiator2target_initializer(current_wpm),
+batch_m2s_assert_fits(current_wpm);
 
 #else // defined(WPM_ENABLE) && defined(SPLIT_WPM_ENABLE)
 
@@ -545,6 +600,7 @@ static void oled_handlers_slave(matrix_row_t master_matrix[], matrix_row_t slave
 #    define TRANSACTIONS_OLED_MASTER() TRANSACTION_HANDLER_MASTER(oled)
 #    define TRANSACTIONS_OLED_SLAVE() TRANSACTION_HANDLER_SLAVE(oled)
 #    define TRANSACTIONS_OLED_REGISTRATIONS [PUT_OLED] = trans_initiator2target_initializer(current_oled_state),
+batch_m2s_assert_fits(current_oled_state);
 
 #else // defined(OLED_ENABLE) && defined(SPLIT_OLED_ENABLE)
 
@@ -576,6 +632,7 @@ static void st7565_handlers_slave(matrix_row_t master_matrix[], matrix_row_t sla
 #    define TRANSACTIONS_ST7565_MASTER() TRANSACTION_HANDLER_MASTER(st7565)
 #    define TRANSACTIONS_ST7565_SLAVE() TRANSACTION_HANDLER_SLAVE(st7565)
 #    define TRANSACTIONS_ST7565_REGISTRATIONS [PUT_ST7565] = trans_initiator2target_initializer(current_st7565_state),
+batch_m2s_assert_fits(current_st7565_state);
 
 #else // defined(ST7565_ENABLE) && defined(SPLIT_ST7565_ENABLE)
 
@@ -600,12 +657,19 @@ static bool pointing_handlers_master(matrix_row_t master_matrix[], matrix_row_t
         return true;
     }
 #    endif
-    static uint32_t last_update = 0;
-    static uint16_t last_cpi    = 0;
-    report_mouse_t  temp_state;
-    uint16_t        temp_cpi;
-    bool            okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.report, sizeof(temp_state));
-    if (okay) pointing_device_set_shared_report(temp_state);
+    static uint32_t                 last_update = 0;
+    static uint16_t                 last_cpi    = 0;
+    pointing_device_shared_motion_t temp_state;
+    uint16_t                        temp_cpi;
+    bool                            okay = read_if_checksum_mismatch(GET_POINTING_CHECKSUM, GET_POINTING_DATA, &last_update, &temp_state, &split_shmem->pointing.report, sizeof(temp_state));
+    if (okay) {
+        pointing_device_set_shared_motion(&temp_state);
+        // Tell a half that has been reset that its totals are followed again, so that another reset can be told apart
+        if (!temp_state.synced) {
+            split_shmem->pointing.synced = true;
+            okay                         = transport_write(PUT_POINTING_SYNCED, &split_shmem->pointing.synced, sizeof(split_shmem->pointing.synced));
+        }
+    }
     temp_cpi = pointing_device_get_shared_cpi();
     if (temp_cpi && memcmp(&last_cpi, &temp_cpi, sizeof(temp_cpi)) != 0) {
         memcpy(&split_shmem->pointing.cpi, &temp_cpi, sizeof(temp_cpi));
@@ -629,8 +693,10 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
         return;
     }
 #    endif
-    report_mouse_t temp_report;
-    uint16_t       temp_cpi;
+    // Totals keep counting up rather than being replaced, so the master sees every read even if it misses some updates
+    pointing_device_shared_motion_t *totals = &split_shmem->pointing.report;
+    report_mouse_t                   temp_report;
+    uint16_t                         temp_cpi;
 #    if (POINTING_DEVICE_TASK_THROTTLE_MS > 0)
     static uint32_t last_exec = 0;
     if (timer_elapsed32(last_exec) < POINTING_DEVICE_TASK_THROTTLE_MS) {
@@ -644,16 +710,26 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
             pointing_device_driver.set_cpi(split_shmem->pointing.cpi);
         }
     }
-    memset(&temp_report, 0, sizeof(temp_report));
-    temp_report = pointing_device_driver.get_report(temp_report);
-    memcpy(&split_shmem->pointing.report, &temp_report, sizeof(temp_report));
-    // Now update the checksum given that the pointing has been written to
-    split_shmem->pointing.checksum = crc8(&temp_report, sizeof(temp_report));
+    // Both start out cleared when this half is reset, until the master sees the totals and sets them again
+    totals->synced = split_shmem->pointing.synced;
+    if (pointing_device_motion_pending()) {
+        memset(&temp_report, 0, sizeof(temp_report));
+        temp_report     = pointing_device_driver.get_report(temp_report);
+        totals->buttons = temp_report.buttons;
+        totals->x += temp_report.x;
+        totals->y += temp_report.y;
+        totals->h += temp_report.h;
+        totals->v += temp_report.v;
+    }
+    // Now update the checksum given that the pointing may have been written to
+    split_shmem->pointing.checksum = crc8(totals, sizeof(*totals));
 }
 
 #    define TRANSACTIONS_POINTING_MASTER() TRANSACTION_HANDLER_MASTER(pointing)
 #    define TRANSACTIONS_POINTING_SLAVE() TRANSACTION_HANDLER_SLAVE(pointing)
-#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi),
+#    define TRANSACTIONS_POINTING_REGISTRATIONS [GET_POINTING_CHECKSUM] = trans_target2initiator_initializer(pointing.checksum), [GET_POINTING_DATA] = trans_target2initiator_initializer(pointing.report), [PUT_POINTING_CPI] = trans_initiator2target_initializer(pointing.cpi), [PUT_POINTING_SYNCED] = trans_initiator2target_initializer(pointing.synced),
+batch_m2s_assert_fits(pointing.cpi);
+batch_m2s_assert_fits(pointing.synced);
 
 #else // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
@@ -663,6 +739,214 @@ static void pointing_handlers_slave(matrix_row_t master_matrix[], matrix_row_t s
 
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+////////////////////////////////////////////////////
+// Batch frame
+
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+
+#    if defined(USE_I2C) || !(defined(SERIAL_DRIVER_USART) || defined(SERIAL_DRIVER_VENDOR))
+#        error "SPLIT_TRANSACTIONS_BATCHED requires SERIAL_DRIVER = usart or vendor"
+#    endif
+
+_Static_assert(sizeof_member(split_shared_memory_t, batch_m2s) <= SPLIT_BATCH_FRAME_MAX, "SPLIT_TRANSACTIONS_BATCH_M2S_SIZE too large");
+_Static_assert(sizeof_member(split_shared_memory_t, batch_s2m) <= SPLIT_BATCH_FRAME_MAX, "Slave-to-master batch frame too large");
+_Static_assert(EXCHANGE_BATCH_FRAME <= 32, "Batched transactions exceed the dirty mask");
+
+#    define is_batched_transaction(id) ((id) >= 0 && (id) < EXCHANGE_BATCH_FRAME)
+
+// A master-to-slave record without payload, asking the slave for a full frame
+#    define BATCH_REQUEST_FULL_FRAME EXCHANGE_BATCH_FRAME
+
+// Checksums only guard the data read in a separate transaction, the frame CRC already covers it
+static const struct {
+    int8_t checksum;
+    int8_t data;
+} batch_checksums[] = {
+    {GET_SLAVE_MATRIX_CHECKSUM, GET_SLAVE_MATRIX_DATA},
+#    ifdef ENCODER_ENABLE
+    {GET_ENCODERS_CHECKSUM, GET_ENCODERS_DATA},
+#    endif // ENCODER_ENABLE
+#    if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+    {GET_POINTING_CHECKSUM, GET_POINTING_DATA},
+#    endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+};
+
+static bool batch_is_checksum(int8_t id) {
+    for (uint8_t i = 0; i < ARRAY_SIZE(batch_checksums); i++) {
+        if (batch_checksums[i].checksum == id) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int16_t batch_m2s_record_size(uint8_t id) {
+    if (id == BATCH_REQUEST_FULL_FRAME) {
+        return 0;
+    }
+    if (!is_batched_transaction((int8_t)id) || !split_transaction_table[id].initiator2target_buffer_size) {
+        return -1;
+    }
+    return split_transaction_table[id].initiator2target_buffer_size;
+}
+
+static int16_t batch_s2m_record_size(uint8_t id) {
+    if (!is_batched_transaction((int8_t)id) || !split_transaction_table[id].target2initiator_buffer_size || batch_is_checksum(id)) {
+        return -1;
+    }
+    return split_transaction_table[id].target2initiator_buffer_size;
+}
+
+// The slave answers every frame with the inverse of the sequence bit the master sent, which names the
+// last slave frame the master applied. Seeing its own bit come back tells the slave the master holds
+// what it sent last, anything else means the master still holds the data it confirmed before that.
+static uint32_t batch_dirty       = 0;     // master-to-slave transactions waiting for the next frame
+static bool     batch_acknowledge = false; // sequence of the last slave frame applied on the master
+static bool     batch_synced      = false; // the master holds a full copy of the slave's data
+
+// Stages writes and serves reads from the shared memory, the wire is only touched by the batch frame itself
+static bool batch_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    if (!is_batched_transaction(id)) {
+        return transport_execute_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length);
+    }
+
+    split_transaction_desc_t *trans = &split_transaction_table[id];
+    if (initiator2target_length > 0) {
+        size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
+        memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, len);
+        batch_dirty |= (1UL << id);
+    }
+    if (target2initiator_length > 0) {
+        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
+        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+    }
+    return true;
+}
+
+static bool batch_handlers_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+    uint8_t *request = split_shmem->batch_m2s;
+    uint8_t *reply   = split_shmem->batch_s2m;
+    uint32_t sent    = 0;
+
+    split_batch_frame_begin(request, batch_acknowledge);
+    if (!batch_synced) {
+        split_batch_frame_add(request, sizeof(split_shmem->batch_m2s), BATCH_REQUEST_FULL_FRAME, NULL, 0);
+    }
+    for (int8_t id = 0; id < EXCHANGE_BATCH_FRAME; id++) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        // Anything that does not fit stays dirty for the next frame
+        if ((batch_dirty & (1UL << id)) && split_batch_frame_add(request, sizeof(split_shmem->batch_m2s), id, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size)) {
+            sent |= (1UL << id);
+        }
+    }
+    split_batch_frame_end(request);
+
+    // A slave that could not read our frame does not reply, never mistake the previous reply for one
+    reply[0] = 0;
+    if (!transport_execute_transaction(EXCHANGE_BATCH_FRAME, NULL, 0, NULL, 0)) {
+        return false;
+    }
+    if (!split_batch_frame_valid(reply, sizeof(split_shmem->batch_s2m))) {
+        return false;
+    }
+    batch_dirty &= ~sent;
+
+    uint8_t              position = SPLIT_BATCH_HEADER_SIZE;
+    split_batch_record_t record;
+    while (split_batch_frame_next(reply, &position, &record, batch_s2m_record_size)) {
+        memcpy(split_trans_target2initiator_buffer(&split_transaction_table[record.id]), record.payload, record.length);
+    }
+    // Part of the frame may have been applied already, only a full frame can bring us back in step
+    if (!split_batch_frame_done(reply, position)) {
+        batch_synced = false;
+        return false;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(batch_checksums); i++) {
+        split_transaction_desc_t *data = &split_transaction_table[batch_checksums[i].data];
+        *split_trans_target2initiator_buffer(&split_transaction_table[batch_checksums[i].checksum]) = crc8(split_trans_target2initiator_buffer(data), data->target2initiator_buffer_size);
+    }
+
+    batch_acknowledge = split_batch_frame_sequence(reply);
+    batch_synced      = true;
+    return true;
+}
+
+static void slave_batch_callback(uint8_t initiator2target_buffer_size, const void *initiator2target_buffer, uint8_t target2initiator_buffer_size, void *target2initiator_buffer) {
+    static bool     sequence        = false; // of the last frame sent
+    static bool     pending_valid   = false; // the last frame sent brings the master to `pending`
+    static bool     reference_valid = false; // the master holds `reference`
+    static uint8_t  reference[SPLIT_BATCH_S2M_SIZE];
+    static uint8_t  pending[SPLIT_BATCH_S2M_SIZE];
+    static uint32_t last_full_frame = 0;
+    const uint8_t * request         = initiator2target_buffer;
+    uint8_t *       reply           = target2initiator_buffer;
+
+    // An empty reply is not sent at all, the master keeps its changes and tries again
+    reply[0] = 0;
+    if (!split_batch_frame_valid(request, initiator2target_buffer_size)) {
+        return;
+    }
+
+    bool                 full     = false;
+    uint8_t              position = SPLIT_BATCH_HEADER_SIZE;
+    split_batch_record_t record;
+    while (split_batch_frame_next(request, &position, &record, batch_m2s_record_size)) {
+        if (record.id == BATCH_REQUEST_FULL_FRAME) {
+            full = true;
+            continue;
+        }
+        // Records are plain copies, applying one twice when the master resends it is harmless
+        memcpy(split_trans_initiator2target_buffer(&split_transaction_table[record.id]), record.payload, record.length);
+    }
+    if (!split_batch_frame_done(request, position)) {
+        return;
+    }
+
+    if (pending_valid && split_batch_frame_sequence(request) == sequence) {
+        memcpy(reference, pending, sizeof(reference));
+        reference_valid = true;
+    }
+
+    // Periodically send everything in full, same as the forced sync of the unbatched transactions
+    if (!reference_valid || timer_elapsed32(last_full_frame) >= FORCED_SYNC_THROTTLE_MS) {
+        full = true;
+    }
+    if (full) {
+        last_full_frame = timer_read32();
+    }
+
+    sequence = !split_batch_frame_sequence(request);
+    split_batch_frame_begin(reply, sequence);
+    uint8_t shadow = 0;
+    for (int8_t id = 0; id < EXCHANGE_BATCH_FRAME; id++) {
+        split_transaction_desc_t *trans = &split_transaction_table[id];
+        const uint8_t             size  = trans->target2initiator_buffer_size;
+        if (!size || batch_is_checksum(id)) {
+            continue;
+        }
+        // SPLIT_BATCH_S2M_SIZE leaves room for every member, so nothing is ever left out
+        const uint8_t *data = split_trans_target2initiator_buffer(trans);
+        if (full || memcmp(data, &reference[shadow], size) != 0) {
+            split_batch_frame_add(reply, target2initiator_buffer_size, id, data, size);
+        }
+        memcpy(&pending[shadow], data, size);
+        shadow += size;
+    }
+    split_batch_frame_end(reply);
+    pending_valid = true;
+}
+
+#    define TRANSACTIONS_BATCH_MASTER() TRANSACTION_HANDLER_MASTER(batch)
+#    define TRANSACTIONS_BATCH_REGISTRATIONS \
+        [EXCHANGE_BATCH_FRAME] = {sizeof_member(split_shared_memory_t, batch_m2s), offsetof(split_shared_memory_t, batch_m2s), sizeof_member(split_shared_memory_t, batch_s2m), offsetof(split_shared_memory_t, batch_s2m), slave_batch_callback, true},
+
+#else // SPLIT_TRANSACTIONS_BATCHED
+
+#    define TRANSACTIONS_BATCH_MASTER()
+#    define TRANSACTIONS_BATCH_REGISTRATIONS
+
+#endif // SPLIT_TRANSACTIONS_BATCHED
+
 ////////////////////////////////////////////////////
 
 split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
@@ -689,6 +973,7 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
     TRANSACTIONS_OLED_REGISTRATIONS
     TRANSACTIONS_ST7565_REGISTRATIONS
     TRANSACTIONS_POINTING_REGISTRATIONS
+    TRANSACTIONS_BATCH_REGISTRATIONS
 // clang-format on
 
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
@@ -700,6 +985,26 @@ split_transaction_desc_t split_transaction_table[NUM_TOTAL_TRANSACTIONS] = {
 };
 
 bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+    // Stage everything sent to the slave, exchange one frame, then pick up what the slave sent back
+    TRANSACTIONS_MASTER_MATRIX_MASTER();
+    TRANSACTIONS_SYNC_TIMER_MASTER();
+    TRANSACTIONS_LAYER_STATE_MASTER();
+    TRANSACTIONS_LED_STATE_MASTER();
+    TRANSACTIONS_MODS_MASTER();
+    TRANSACTIONS_BACKLIGHT_MASTER();
+    TRANSACTIONS_RGBLIGHT_MASTER();
+    TRANSACTIONS_LED_MATRIX_MASTER();
+    TRANSACTIONS_RGB_MATRIX_MASTER();
+    TRANSACTIONS_WPM_MASTER();
+    TRANSACTIONS_OLED_MASTER();
+    TRANSACTIONS_ST7565_MASTER();
+    TRANSACTIONS_BATCH_MASTER();
+    TRANSACTIONS_SLAVE_MATRIX_MASTER();
+    TRANSACTIONS_ENCODERS_MASTER();
+    TRANSACTIONS_POINTING_MASTER();
+    return true;
+#else  // SPLIT_TRANSACTIONS_BATCHED
     TRANSACTIONS_SLAVE_MATRIX_MASTER();
     TRANSACTIONS_MASTER_MATRIX_MASTER();
     TRANSACTIONS_ENCODERS_MASTER();
@@ -715,7 +1020,9 @@ bool transactions_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix
     TRANSACTIONS_OLED_MASTER();
     TRANSACTIONS_ST7565_MASTER();
     TRANSACTIONS_POINTING_MASTER();
+    TRANSACTIONS_SLAVE_MATRIX_PREFETCH();
     return true;
+#endif // SPLIT_TRANSACTIONS_BATCHED
 }
 
 void transactions_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
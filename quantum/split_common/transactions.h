@@ -32,6 +32,9 @@ typedef struct _split_transaction_desc_t {
     uint8_t          target2initiator_buffer_size;
     uint16_t         target2initiator_offset;
     slave_callback_t slave_callback;
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+    bool variable_length; // the first byte of each buffer holds the number of bytes to transfer
+#endif // SPLIT_TRANSACTIONS_BATCHED
 } split_transaction_desc_t;
 
 // Forward declaration for the split transactions
@@ -22,8 +22,33 @@
 #include "transaction_id_define.h"
 #include "atomic_util.h"
 
+static void transport_future_begin(transport_future_t *future, int8_t id, void *target2initiator_buf, uint16_t target2initiator_length) {
+    future->id                      = id;
+    future->status                  = TRANSPORT_PENDING;
+    future->target2initiator_buf    = target2initiator_buf;
+    future->target2initiator_length = target2initiator_length;
+}
+
+// Copies the reply out of the shared memory and hands the result to the caller
+static void transport_complete(transport_future_t *future, bool success) {
+    split_transaction_desc_t *trans = &split_transaction_table[future->id];
+    if (success && future->target2initiator_length > 0) {
+        size_t len = trans->target2initiator_buffer_size < future->target2initiator_length ? trans->target2initiator_buffer_size : future->target2initiator_length;
+        memcpy(future->target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+    }
+
+    future->status = success ? TRANSPORT_SUCCESS : TRANSPORT_FAILED;
+    if (future->callback) {
+        future->callback(future);
+    }
+}
+
 #ifdef USE_I2C
 
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+#        error "SPLIT_TRANSPORT_ASYNC requires SERIAL_DRIVER = usart or vendor"
+#    endif
+
 #    ifndef SLAVE_I2C_TIMEOUT
 #        define SLAVE_I2C_TIMEOUT 100
 #    endif // SLAVE_I2C_TIMEOUT
@@ -59,7 +84,7 @@ i2c_status_t transport_trigger_callback(int8_t id) {
     return i2c_writeReg(SLAVE_I2C_ADDRESS, trans->initiator2target_offset, split_trans_initiator2target_buffer(trans), trans->initiator2target_buffer_size, SLAVE_I2C_TIMEOUT);
 }
 
-bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+static bool transport_i2c_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, uint16_t target2initiator_length) {
     i2c_status_t              status;
     split_transaction_desc_t *trans = &split_transaction_table[id];
     if (initiator2target_length > 0) {
@@ -80,12 +105,26 @@ bool transport_execute_transaction(int8_t id, const void *initiator2target_buf,
         if ((status = i2c_readReg(SLAVE_I2C_ADDRESS, trans->target2initiator_offset, split_trans_target2initiator_buffer(trans), len, SLAVE_I2C_TIMEOUT)) < 0) {
             return false;
         }
-        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
     }
 
     return true;
 }
 
+// I2C transactions complete before returning, the future is resolved straight away
+bool transport_execute_transaction_async(transport_future_t *future, int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    transport_future_begin(future, id, target2initiator_buf, target2initiator_length);
+    transport_complete(future, transport_i2c_transaction(id, initiator2target_buf, initiator2target_length, target2initiator_length));
+    return true;
+}
+
+transport_status_t transport_poll(transport_future_t *future) {
+    return future->status;
+}
+
+transport_status_t transport_wait(transport_future_t *future) {
+    return future->status;
+}
+
 #else // USE_I2C
 
 #    include "serial.h"
@@ -100,27 +139,95 @@ void transport_slave_init(void) {
     soft_serial_target_init();
 }
 
-bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+#        if !defined(SERIAL_DRIVER_USART) && !defined(SERIAL_DRIVER_VENDOR)
+#            error "SPLIT_TRANSPORT_ASYNC requires SERIAL_DRIVER = usart or vendor"
+#        endif
+
+// The future of the transaction owned by the serial transport thread, if any
+static transport_future_t *in_flight = NULL;
+
+static void transport_settle(bool wait) {
+    if (!in_flight) {
+        return;
+    }
+
+    serial_transaction_status_t status = wait ? soft_serial_transaction_wait() : soft_serial_transaction_poll();
+    if (status == SERIAL_TRANSACTION_PENDING) {
+        return;
+    }
+
+    transport_future_t *future = in_flight;
+    in_flight                  = NULL;
+    transport_complete(future, status == SERIAL_TRANSACTION_SUCCESS);
+}
+#    endif // SPLIT_TRANSPORT_ASYNC
+
+bool transport_execute_transaction_async(transport_future_t *future, int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+    // The shared memory belongs to the transport thread until the previous transaction completes
+    transport_settle(false);
+    if (in_flight) {
+        future->status = TRANSPORT_FAILED;
+        return false;
+    }
+#    endif
+
     split_transaction_desc_t *trans = &split_transaction_table[id];
     if (initiator2target_length > 0) {
         size_t len = trans->initiator2target_buffer_size < initiator2target_length ? trans->initiator2target_buffer_size : initiator2target_length;
         memcpy(split_trans_initiator2target_buffer(trans), initiator2target_buf, len);
     }
 
-    if (!soft_serial_transaction(id)) {
+    transport_future_begin(future, id, target2initiator_buf, target2initiator_length);
+
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+    if (!soft_serial_transaction_start(id)) {
+        future->status = TRANSPORT_FAILED;
         return false;
     }
+    in_flight = future;
+#    else
+    transport_complete(future, soft_serial_transaction(id));
+#    endif
+    return true;
+}
 
-    if (target2initiator_length > 0) {
-        size_t len = trans->target2initiator_buffer_size < target2initiator_length ? trans->target2initiator_buffer_size : target2initiator_length;
-        memcpy(target2initiator_buf, split_trans_target2initiator_buffer(trans), len);
+transport_status_t transport_poll(transport_future_t *future) {
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+    if (future == in_flight) {
+        transport_settle(false);
     }
+#    endif
+    return future->status;
+}
 
-    return true;
+transport_status_t transport_wait(transport_future_t *future) {
+#    if defined(SPLIT_TRANSPORT_ASYNC)
+    if (future == in_flight) {
+        transport_settle(true);
+    }
+#    endif
+    return future->status;
 }
 
 #endif // USE_I2C
 
+bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length) {
+    transport_future_t future = {.callback = NULL};
+
+#if defined(SPLIT_TRANSPORT_ASYNC)
+    // Blocking callers queue up behind whatever is still on the wire
+    transport_settle(true);
+#endif
+
+    if (!transport_execute_transaction_async(&future, id, initiator2target_buf, initiator2target_length, target2initiator_buf, target2initiator_length)) {
+        return false;
+    }
+
+    return transport_wait(&future) == TRANSPORT_SUCCESS;
+}
+
 bool transport_master(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]) {
     return transactions_master(master_matrix, slave_matrix);
 }
@@ -31,6 +31,10 @@
 #    define RPC_S2M_BUFFER_SIZE 32
 #endif // RPC_S2M_BUFFER_SIZE
 
+#ifndef SPLIT_TRANSACTIONS_BATCH_M2S_SIZE
+#    define SPLIT_TRANSACTIONS_BATCH_M2S_SIZE 63
+#endif // SPLIT_TRANSACTIONS_BATCH_M2S_SIZE
+
 void transport_master_init(void);
 void transport_slave_init(void);
 
@@ -40,6 +44,35 @@ void transport_slave(matrix_row_t master_matrix[], matrix_row_t slave_matrix[]);
 
 bool transport_execute_transaction(int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
 
+typedef enum transport_status_t {
+    TRANSPORT_PENDING,
+    TRANSPORT_SUCCESS,
+    TRANSPORT_FAILED,
+} transport_status_t;
+
+typedef struct transport_future_t transport_future_t;
+
+/**
+ * The pending result of a transaction started by transport_execute_transaction_async().
+ *
+ * `callback` must be set, or NULL, before the transaction is started. Once the transaction
+ * completes the reply is copied into `target2initiator_buf` and `callback` runs in the caller's
+ * context, from transport_poll() or transport_wait(), or straight away on synchronous transports.
+ * The future has to stay valid until then.
+ */
+struct transport_future_t {
+    int8_t             id;
+    transport_status_t status;
+    void *             target2initiator_buf;
+    uint16_t           target2initiator_length;
+    void (*callback)(transport_future_t *future);
+};
+
+// returns false, with the future marked as failed, if the transaction could not be started, only one transaction can be in flight at a time
+bool               transport_execute_transaction_async(transport_future_t *future, int8_t id, const void *initiator2target_buf, uint16_t initiator2target_length, void *target2initiator_buf, uint16_t target2initiator_length);
+transport_status_t transport_poll(transport_future_t *future);
+transport_status_t transport_wait(transport_future_t *future);
+
 #ifdef ENCODER_ENABLE
 #    include "encoder.h"
 #endif // ENCODER_ENABLE
@@ -108,12 +141,31 @@ typedef struct _split_mods_sync_t {
 #if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 #    include "pointing_device.h"
 typedef struct _split_slave_pointing_sync_t {
-    uint8_t        checksum;
-    report_mouse_t report;
-    uint16_t       cpi;
+    uint8_t                         checksum;
+    pointing_device_shared_motion_t report;
+    uint16_t                        cpi;
+    bool                            synced;
 } split_slave_pointing_sync_t;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+#    include "transaction_batch.h"
+
+// Every slave-to-master member has to fit a single frame as a raw record, checksums are rebuilt on the master instead of being sent
+#    define SPLIT_BATCH_S2M_MATRIX_SIZE (SPLIT_BATCH_RECORD_HEADER_SIZE + sizeof(matrix_row_t) * ((MATRIX_ROWS) / 2))
+#    ifdef ENCODER_ENABLE
+#        define SPLIT_BATCH_S2M_ENCODERS_SIZE (SPLIT_BATCH_RECORD_HEADER_SIZE + NUM_ENCODERS_MAX_PER_SIDE)
+#    else
+#        define SPLIT_BATCH_S2M_ENCODERS_SIZE 0
+#    endif // ENCODER_ENABLE
+#    if defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+#        define SPLIT_BATCH_S2M_POINTING_SIZE (SPLIT_BATCH_RECORD_HEADER_SIZE + sizeof(pointing_device_shared_motion_t))
+#    else
+#        define SPLIT_BATCH_S2M_POINTING_SIZE 0
+#    endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
+#    define SPLIT_BATCH_S2M_SIZE (SPLIT_BATCH_HEADER_SIZE + SPLIT_BATCH_S2M_MATRIX_SIZE + SPLIT_BATCH_S2M_ENCODERS_SIZE + SPLIT_BATCH_S2M_POINTING_SIZE + 1)
+#endif // SPLIT_TRANSACTIONS_BATCHED
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
 typedef struct _rpc_sync_info_t {
     uint8_t checksum;
@@ -188,6 +240,11 @@ typedef struct _split_shared_memory_t {
     split_slave_pointing_sync_t pointing;
 #endif // defined(POINTING_DEVICE_ENABLE) && defined(SPLIT_POINTING_ENABLE)
 
+#ifdef SPLIT_TRANSACTIONS_BATCHED
+    uint8_t batch_m2s[SPLIT_TRANSACTIONS_BATCH_M2S_SIZE];
+    uint8_t batch_s2m[SPLIT_BATCH_S2M_SIZE];
+#endif // SPLIT_TRANSACTIONS_BATCHED
+
 #if defined(SPLIT_TRANSACTION_IDS_KB) || defined(SPLIT_TRANSACTION_IDS_USER)
     rpc_sync_info_t rpc_info;
     uint8_t         rpc_m2s_buffer[RPC_M2S_BUFFER_SIZE];
@@ -0,0 +1,121 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <string.h>
+#include "task_scheduler.h"
+#include "timer.h"
+#include "debug.h"
+#include "print.h"
+#if defined(RAW_ENABLE) && !defined(VIA_ENABLE)
+#    include "raw_hid.h"
+#endif
+
+#if defined(PROTOCOL_CHIBIOS)
+#    include <ch.h>
+// The system tick gives sub-millisecond resolution for task runtimes.
+typedef systime_t scheduler_time_t;
+#    define scheduler_time_read() chVTGetSystemTimeX()
+#    define scheduler_elapsed_us(start) ((uint32_t)TIME_I2US(chTimeDiffX((start), chVTGetSystemTimeX())))
+#else
+typedef uint32_t scheduler_time_t;
+#    define scheduler_time_read() timer_read32()
+#    define scheduler_elapsed_us(start) (timer_elapsed32(start) * 1000)
+#endif
+
+static uint32_t average_us(const task_scheduler_stats_t *stat) {
+    return stat->runs ? stat->total_us / stat->runs : 0;
+}
+
+// Task table owned by keyboard.c
+extern const task_scheduler_task_t keyboard_tasks[];
+extern task_scheduler_stats_t      keyboard_task_stats[];
+extern const uint8_t               keyboard_task_count;
+
+void task_scheduler_run(const task_scheduler_task_t *tasks, task_scheduler_stats_t *stats, uint8_t count) {
+    const scheduler_time_t loop_start = scheduler_time_read();
+    const uint32_t         now        = timer_read32();
+
+    for (uint8_t i = 0; i < count; i++) {
+        const task_scheduler_task_t *task  = &tasks[i];
+        task_scheduler_stats_t *     stat  = &stats[i];
+        const uint32_t               since = TIMER_DIFF_32(now, stat->last_run);
+
+        if (task->priority != TASK_PRIORITY_REALTIME && stat->runs && since < task->period_ms) {
+            continue;
+        }
+
+        // Bulk work only gets whatever is left of the loop budget, unless it has waited too long already
+        if (task->priority == TASK_PRIORITY_BULK && scheduler_elapsed_us(loop_start) >= TASK_SCHEDULER_BUDGET_US && since < (uint32_t)task->period_ms + TASK_SCHEDULER_MAX_POSTPONE_MS) {
+            stat->postponed++;
+            continue;
+        }
+
+        const scheduler_time_t start = scheduler_time_read();
+        task->task();
+        const uint32_t runtime = scheduler_elapsed_us(start);
+
+        stat->last_run = now;
+        stat->runs++;
+        stat->total_us += runtime;
+        if (runtime > stat->max_us) {
+            stat->max_us = runtime;
+        }
+    }
+}
+
+uint8_t task_scheduler_count(void) {
+    return keyboard_task_count;
+}
+
+const task_scheduler_task_t *task_scheduler_get_task(uint8_t index) {
+    return index < keyboard_task_count ? &keyboard_tasks[index] : NULL;
+}
+
+const task_scheduler_stats_t *task_scheduler_get_stats(uint8_t index) {
+    return index < keyboard_task_count ? &keyboard_task_stats[index] : NULL;
+}
+
+void task_scheduler_reset_stats(void) {
+    memset(keyboard_task_stats, 0, sizeof(task_scheduler_stats_t) * keyboard_task_count);
+}
+
+void task_scheduler_print_stats(void) {
+#ifdef CONSOLE_ENABLE
+    for (uint8_t i = 0; i < keyboard_task_count; i++) {
+        const task_scheduler_stats_t *stat = &keyboard_task_stats[i];
+        dprintf("%-20s runs: %lu avg: %luus max: %luus postponed: %lu\n", keyboard_tasks[i].name, stat->runs, average_us(stat), stat->max_us, stat->postponed);
+    }
+#endif
+}
+
+static void write_u32(uint8_t *data, uint32_t value) {
+    data[0] = value & 0xFF;
+    data[1] = (value >> 8) & 0xFF;
+    data[2] = (value >> 16) & 0xFF;
+    data[3] = (value >> 24) & 0xFF;
+}
+
+void task_scheduler_raw_hid_stats(uint8_t *data, uint8_t length) {
+    const uint8_t                 index = data[1];
+    const task_scheduler_stats_t *stat  = task_scheduler_get_stats(index);
+
+    data[2] = keyboard_task_count;
+    if (!stat || length < 19) {
+        return;
+    }
+
+    write_u32(&data[3], stat->runs);
+    write_u32(&data[7], average_us(stat));
+    write_u32(&data[11], stat->max_us);
+    write_u32(&data[15], stat->postponed);
+}
+
+#if defined(RAW_ENABLE) && !defined(VIA_ENABLE)
+// VIA answers the request itself, otherwise keyboards and keymaps that define their own handler take over
+__attribute__((weak)) void raw_hid_receive(uint8_t *data, uint8_t length) {
+    if (data[0] == TASK_SCHEDULER_RAW_HID_ID) {
+        task_scheduler_raw_hid_stats(data, length);
+        raw_hid_send(data, length);
+    }
+}
+#endif
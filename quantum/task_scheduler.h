@@ -0,0 +1,109 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @def The number of microseconds each main loop iteration may spend before bulk tasks are postponed.
+ */
+#ifndef TASK_SCHEDULER_BUDGET_US
+#    define TASK_SCHEDULER_BUDGET_US 1000
+#endif
+
+/**
+ * @def The number of milliseconds after which a postponed bulk task is run regardless of the remaining budget.
+ */
+#ifndef TASK_SCHEDULER_MAX_POSTPONE_MS
+#    define TASK_SCHEDULER_MAX_POSTPONE_MS 100
+#endif
+
+/**
+ * @enum The priority of a scheduled task.
+ */
+typedef enum task_priority_t {
+    TASK_PRIORITY_REALTIME, // runs every loop, ignoring the period
+    TASK_PRIORITY_NORMAL,   // runs once its period has elapsed
+    TASK_PRIORITY_BULK,     // runs once its period has elapsed and the loop has budget left
+} task_priority_t;
+
+/**
+ * @struct A task registered with the scheduler, only the function is kept without TASK_SCHEDULER_ENABLE.
+ */
+typedef struct task_scheduler_task_t {
+    void (*task)(void);
+#ifdef TASK_SCHEDULER_ENABLE
+    const char *    name;
+    uint16_t        period_ms;
+    task_priority_t priority;
+#endif
+} task_scheduler_task_t;
+
+/**
+ * @struct Runtime accounting for a scheduled task, all times are in microseconds.
+ */
+typedef struct task_scheduler_stats_t {
+    uint32_t last_run;
+    uint32_t runs;
+    uint32_t postponed;
+    uint64_t total_us; /* 32 bits would wrap after about 71 minutes of runtime */
+    uint32_t max_us;
+} task_scheduler_stats_t;
+
+#ifdef TASK_SCHEDULER_ENABLE
+#    define TASK_SCHEDULER_TASK(fn, period, prio) \
+        { .task = (fn), .name = #fn, .period_ms = (period), .priority = (prio) }
+#else
+#    define TASK_SCHEDULER_TASK(fn, period, prio) \
+        { .task = (fn) }
+#endif
+
+/**
+ * @def The raw HID command ID answered by task_scheduler_raw_hid_stats().
+ */
+#ifndef TASK_SCHEDULER_RAW_HID_ID
+#    define TASK_SCHEDULER_RAW_HID_ID 0x42
+#endif
+
+/**
+ * Runs one loop iteration of the supplied task table, in table order.
+ *
+ * @param tasks[in] the task table
+ * @param stats[in,out] the accounting for each task, same length as the task table
+ * @param count[in] the number of tasks
+ */
+void task_scheduler_run(const task_scheduler_task_t *tasks, task_scheduler_stats_t *stats, uint8_t count);
+
+/**
+ * Returns the number of tasks run by keyboard_task().
+ */
+uint8_t task_scheduler_count(void);
+
+/**
+ * Returns the task run by keyboard_task() at the given index, or NULL if out of range.
+ */
+const task_scheduler_task_t *task_scheduler_get_task(uint8_t index);
+
+/**
+ * Returns the accounting of the task run by keyboard_task() at the given index, or NULL if out of range.
+ */
+const task_scheduler_stats_t *task_scheduler_get_stats(uint8_t index);
+
+/**
+ * Clears the accounting of all tasks run by keyboard_task().
+ */
+void task_scheduler_reset_stats(void);
+
+/**
+ * Prints the accounting of all tasks run by keyboard_task() to the console.
+ */
+void task_scheduler_print_stats(void);
+
+/**
+ * Fills a raw HID response with the accounting of the task at data[1].
+ *
+ * The response holds the task index, the task count, then little-endian runs, average, maximum and postponed counts.
+ */
+void task_scheduler_raw_hid_stats(uint8_t *data, uint8_t length);
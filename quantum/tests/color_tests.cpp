@@ -0,0 +1,147 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+extern "C" {
+#include "color.h"
+#include "led_tables.h"
+}
+
+/* The conversion as it was before the divide was taken out, to check against.
+ * Kept out of line so that the benchmark times it as a call, like hsv_to_rgb() in color.c */
+__attribute__((noinline)) static RGB reference_hsv_to_rgb(HSV hsv) {
+    RGB      rgb;
+    uint8_t  region, remainder, p, q, t;
+    uint16_t h, s, v;
+
+#ifdef USE_CIE1931_CURVE
+    hsv.v = CIE1931_CURVE[hsv.v];
+#endif
+    if (hsv.s == 0) {
+        rgb.r = rgb.g = rgb.b = hsv.v;
+        return rgb;
+    }
+
+    h = hsv.h;
+    s = hsv.s;
+    v = hsv.v;
+
+    region    = h * 6 / 255;
+    remainder = (h * 2 - region * 85) * 3;
+
+    p = (v * (255 - s)) >> 8;
+    q = (v * (255 - ((s * remainder) >> 8))) >> 8;
+    t = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+    switch (region) {
+        case 6:
+        case 0:
+            rgb.r = v;
+            rgb.g = t;
+            rgb.b = p;
+            break;
+        case 1:
+            rgb.r = q;
+            rgb.g = v;
+            rgb.b = p;
+            break;
+        case 2:
+            rgb.r = p;
+            rgb.g = v;
+            rgb.b = t;
+            break;
+        case 3:
+            rgb.r = p;
+            rgb.g = q;
+            rgb.b = v;
+            break;
+        case 4:
+            rgb.r = t;
+            rgb.g = p;
+            rgb.b = v;
+            break;
+        default:
+            rgb.r = v;
+            rgb.g = p;
+            rgb.b = q;
+            break;
+    }
+    return rgb;
+}
+
+static std::vector<HSV> every_hsv_with_value(uint8_t v) {
+    std::vector<HSV> colours;
+    for (int h = 0; h < 256; h++) {
+        for (int s = 0; s < 256; s++) {
+            colours.push_back({(uint8_t)h, (uint8_t)s, v});
+        }
+    }
+    return colours;
+}
+
+TEST(Color, MatchesReferenceForEveryColour) {
+    for (int v = 0; v < 256; v++) {
+        std::vector<HSV> hsv = every_hsv_with_value(v);
+        std::vector<RGB> rgb(hsv.size());
+
+        // Odd batch sizes, to make sure nothing depends on the count
+        for (size_t i = 0; i < hsv.size(); i += 251) {
+            hsv_to_rgb_batch(&hsv[i], &rgb[i], std::min<size_t>(251, hsv.size() - i));
+        }
+
+        for (size_t i = 0; i < hsv.size(); i++) {
+            RGB expected = reference_hsv_to_rgb(hsv[i]);
+            RGB single   = hsv_to_rgb(hsv[i]);
+            ASSERT_TRUE(expected.r == single.r && expected.g == single.g && expected.b == single.b) << "h=" << (int)hsv[i].h << " s=" << (int)hsv[i].s << " v=" << v;
+            ASSERT_TRUE(expected.r == rgb[i].r && expected.g == rgb[i].g && expected.b == rgb[i].b) << "h=" << (int)hsv[i].h << " s=" << (int)hsv[i].s << " v=" << v;
+        }
+    }
+}
+
+/* Not a pass/fail test: prints the cost of each conversion path on the host */
+TEST(Color, Benchmark) {
+    using clock             = std::chrono::steady_clock;
+    const int        rounds = 64;
+    std::vector<HSV> hsv    = every_hsv_with_value(200);
+    std::vector<RGB> rgb(hsv.size());
+    volatile uint8_t sink = 0;
+
+    auto time_ns_per_led = [&](auto &&convert) {
+        auto start = clock::now();
+        for (int round = 0; round < rounds; round++) {
+            convert();
+            sink = sink + rgb[round].r;
+        }
+        return std::chrono::duration<double, std::nano>(clock::now() - start).count() / (rounds * hsv.size());
+    };
+
+    double reference = time_ns_per_led([&] {
+        for (size_t i = 0; i < hsv.size(); i++) rgb[i] = reference_hsv_to_rgb(hsv[i]);
+    });
+    double single = time_ns_per_led([&] {
+        for (size_t i = 0; i < hsv.size(); i++) rgb[i] = hsv_to_rgb(hsv[i]);
+    });
+    double batch = time_ns_per_led([&] {
+        for (size_t i = 0; i < hsv.size(); i += 255) hsv_to_rgb_batch(&hsv[i], &rgb[i], std::min<size_t>(255, hsv.size() - i));
+    });
+
+    printf("hsv_to_rgb: reference %.2f ns/LED, hsv_to_rgb() %.2f ns/LED, hsv_to_rgb_batch() %.2f ns/LED\n", reference, single, batch);
+}
@@ -0,0 +1,52 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+typedef uint8_t pin_t;
+
+#define MATRIX_ROWS 2
+#define MATRIX_COLS 3
+#define MATRIX_ROW_PINS \
+    { 0, 1 }
+#define MATRIX_COL_PINS \
+    { 2, 3, 4 }
+#define DIODE_DIRECTION COL2ROW
+
+#define MATRIX_IDLE_SCAN_ENABLE
+#define MATRIX_IDLE_SCAN_INTERVAL 10
+
+// The switches are simulated by matrix_idle_tests.cpp, there are no interrupts to mask
+#define IGNORE_ATOMIC_BLOCK
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+void mock_pin_input_high(pin_t pin);
+void mock_pin_output(pin_t pin);
+void mock_pin_write(pin_t pin, bool high);
+bool mock_pin_read(pin_t pin);
+#ifdef __cplusplus
+}
+#endif
+
+#define setPinInputHigh(pin) mock_pin_input_high(pin)
+#define setPinOutput(pin) mock_pin_output(pin)
+#define writePinLow(pin) mock_pin_write(pin, false)
+#define writePinHigh(pin) mock_pin_write(pin, true)
+#define readPin(pin) mock_pin_read(pin)
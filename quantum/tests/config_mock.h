@@ -0,0 +1,23 @@
+// Copyright 2022 QMK
+// SPDX-License-Identifier: GPL-2.0-or-later
+#pragma once
+
+#define MATRIX_ROWS 4
+#define MATRIX_COLS 10
+
+/* Encoders are only needed for their count, so "pins" are plain numbers. */
+#define ENCODERS_PAD_A \
+    { 0, 2 }
+#define ENCODERS_PAD_B \
+    { 1, 3 }
+
+/* The EEPROM is mocked by the tests themselves. */
+#define EEPROM_SIZE 1024
+
+/* The default ARRAY_SIZE relies on C-only builtins, which the C++ tests cannot use. */
+#ifdef __cplusplus
+#    define ARRAY_SIZE(array) (sizeof((array)) / sizeof((array)[0]))
+#endif
+
+#include <stdint.h>
+typedef uint8_t pin_t;
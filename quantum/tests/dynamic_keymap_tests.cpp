@@ -0,0 +1,208 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <cstring>
+
+extern "C" {
+#include "quantum.h"
+#include "dynamic_keymap.h"
+}
+
+// Dynamic keymaps start straight after the core EEPROM config when VIA is disabled
+#define KEYMAP_EEPROM_ADDR (EECONFIG_SIZE)
+#define KEYMAP_EEPROM_SIZE (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS * 2)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// EEPROM mock, counting every access that would turn into a transaction on an external EEPROM
+
+static uint8_t  eeprom[EEPROM_SIZE];
+static uint32_t eeprom_read_calls  = 0;
+static uint32_t eeprom_read_bytes  = 0;
+static uint32_t eeprom_write_calls = 0;
+
+extern "C" {
+uint8_t eeprom_read_byte(const uint8_t *addr) {
+    eeprom_read_calls++;
+    eeprom_read_bytes++;
+    return eeprom[(uintptr_t)addr];
+}
+
+void eeprom_read_block(void *buf, const void *addr, size_t len) {
+    eeprom_read_calls++;
+    eeprom_read_bytes += len;
+    memcpy(buf, &eeprom[(uintptr_t)addr], len);
+}
+
+void eeprom_update_byte(uint8_t *addr, uint8_t value) {
+    if (eeprom[(uintptr_t)addr] != value) {
+        eeprom_write_calls++;
+        eeprom[(uintptr_t)addr] = value;
+    }
+}
+
+// clang-format off
+const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
+    [0] = {
+        {KC_A, KC_B, KC_C, KC_D, KC_E, KC_F, KC_G, KC_H, KC_I, KC_J},
+        {KC_K, KC_L, KC_M, KC_N, KC_O, KC_P, KC_Q, KC_R, KC_S, KC_T},
+        {KC_U, KC_V, KC_W, KC_X, KC_Y, KC_Z, KC_1, KC_2, KC_3, KC_4},
+        {KC_5, KC_6, KC_7, KC_8, KC_9, KC_0, KC_ENT, KC_ESC, KC_BSPC, KC_TAB},
+    },
+};
+
+const uint16_t PROGMEM encoder_map[][NUM_ENCODERS][2] = {
+    [0] = {ENCODER_CCW_CW(KC_VOLD, KC_VOLU), ENCODER_CCW_CW(KC_PGDN, KC_PGUP)},
+};
+// clang-format on
+
+uint8_t keymap_layer_count(void) {
+    return sizeof(keymaps) / sizeof(keymaps[0]);
+}
+
+uint8_t encodermap_layer_count(void) {
+    return sizeof(encoder_map) / sizeof(encoder_map[0]);
+}
+
+void send_string_with_delay(const char *string, uint8_t interval) {}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Helpers
+
+// Resolves a key press the way layer_switch_get_layer() and action_for_key() do, falling through transparent layers
+static uint16_t resolve_key(layer_state_t state, keypos_t key) {
+    for (int8_t layer = MAX_LAYER - 1; layer >= 0; layer--) {
+        if (state & ((layer_state_t)1 << layer)) {
+            if (keymap_key_to_keycode(layer, key) != KC_TRANSPARENT) {
+                return keymap_key_to_keycode(layer, key);
+            }
+        }
+    }
+    return keymap_key_to_keycode(0, key);
+}
+
+static uint16_t eeprom_keycode(uint8_t layer, uint8_t row, uint8_t col) {
+    const uint8_t *p = &eeprom[KEYMAP_EEPROM_ADDR + ((layer * MATRIX_ROWS + row) * MATRIX_COLS + col) * 2];
+    return (p[0] << 8) | p[1];
+}
+
+static void reset_counters(void) {
+    eeprom_read_calls  = 0;
+    eeprom_read_bytes  = 0;
+    eeprom_write_calls = 0;
+}
+
+class DynamicKeymap : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        dynamic_keymap_reset();
+        reset_counters();
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Tests
+
+// Runs first, while the EEPROM still holds whatever was there before reset, so any mirror is populated from it
+TEST(DynamicKeymapLoad, LookupsReflectExistingEepromContents) {
+    eeprom[KEYMAP_EEPROM_ADDR + 0] = KC_Q >> 8;
+    eeprom[KEYMAP_EEPROM_ADDR + 1] = KC_Q & 0xFF;
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 0, 0), KC_Q);
+}
+
+TEST_F(DynamicKeymap, EepromAccessesPerKeyEvent) {
+    // Layers 1-3 transparent, so resolving a key on layer 3 falls all the way through to layer 0
+    keypos_t      key   = {.col = 3, .row = 2};
+    layer_state_t state = 0b1111;
+
+    reset_counters();
+    EXPECT_EQ(resolve_key(state, key), KC_X);
+    std::printf("Key event with %d layers active: %u EEPROM read transactions (%u bytes)\n", 4, (unsigned)eeprom_read_calls, (unsigned)eeprom_read_bytes);
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    EXPECT_EQ(eeprom_read_calls, 0);
+#else
+    // Two single-byte reads for each layer visited, plus the final lookup
+    EXPECT_EQ(eeprom_read_calls, (4 + 1) * 2);
+#endif
+
+    keypos_t encoder = {.col = 1, .row = KEYLOC_ENCODER_CW};
+    reset_counters();
+    EXPECT_EQ(resolve_key(state, encoder), KC_PGUP);
+    std::printf("Encoder event with %d layers active: %u EEPROM read transactions (%u bytes)\n", 4, (unsigned)eeprom_read_calls, (unsigned)eeprom_read_bytes);
+#ifdef DYNAMIC_KEYMAP_RAM_CACHE
+    EXPECT_EQ(eeprom_read_calls, 0);
+#else
+    EXPECT_EQ(eeprom_read_calls, (4 + 1) * 2);
+#endif
+}
+
+TEST_F(DynamicKeymap, SetKeycodeWritesThrough) {
+    dynamic_keymap_set_keycode(2, 1, 5, KC_LCTL);
+    EXPECT_EQ(dynamic_keymap_get_keycode(2, 1, 5), KC_LCTL);
+    EXPECT_EQ(eeprom_keycode(2, 1, 5), KC_LCTL);
+    EXPECT_EQ(resolve_key(0b0101, (keypos_t){.col = 5, .row = 1}), KC_LCTL);
+
+    // Unchanged keycodes leave the EEPROM alone
+    reset_counters();
+    dynamic_keymap_set_keycode(2, 1, 5, KC_LCTL);
+    EXPECT_EQ(eeprom_write_calls, 0);
+}
+
+TEST_F(DynamicKeymap, SetEncoderWritesThrough) {
+    dynamic_keymap_set_encoder(1, 0, false, KC_MPRV);
+    EXPECT_EQ(dynamic_keymap_get_encoder(1, 0, false), KC_MPRV);
+    EXPECT_EQ(dynamic_keymap_get_encoder(1, 0, true), KC_TRANSPARENT);
+    EXPECT_EQ(resolve_key(0b0011, (keypos_t){.col = 0, .row = KEYLOC_ENCODER_CCW}), KC_MPRV);
+    EXPECT_EQ(resolve_key(0b0011, (keypos_t){.col = 0, .row = KEYLOC_ENCODER_CW}), KC_VOLU);
+}
+
+TEST_F(DynamicKeymap, BufferMatchesKeycodes) {
+    // Odd offsets and sizes split keycodes across calls
+    uint8_t data[KEYMAP_EEPROM_SIZE];
+    for (uint16_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)(i * 7 + 3);
+    }
+    dynamic_keymap_set_buffer(0, 13, data);
+    dynamic_keymap_set_buffer(13, sizeof(data) - 13, &data[13]);
+
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                EXPECT_EQ(dynamic_keymap_get_keycode(layer, row, col), eeprom_keycode(layer, row, col));
+            }
+        }
+    }
+
+    uint8_t readback[KEYMAP_EEPROM_SIZE + 4];
+    dynamic_keymap_get_buffer(1, sizeof(readback), readback);
+    EXPECT_EQ(memcmp(readback, &data[1], sizeof(data) - 1), 0);
+    EXPECT_EQ(memcmp(&eeprom[KEYMAP_EEPROM_ADDR], data, sizeof(data)), 0);
+    // Past the end of the keymaps reads back as zero
+    for (uint16_t i = sizeof(data) - 1; i < sizeof(readback); i++) {
+        EXPECT_EQ(readback[i], 0);
+    }
+}
+
+TEST_F(DynamicKeymap, ResetRestoresDefaults) {
+    dynamic_keymap_set_keycode(0, 3, 9, KC_NO);
+    dynamic_keymap_reset();
+    EXPECT_EQ(dynamic_keymap_get_keycode(0, 3, 9), KC_TAB);
+    EXPECT_EQ(dynamic_keymap_get_keycode(1, 3, 9), KC_TRANSPARENT);
+    EXPECT_EQ(eeprom_keycode(0, 3, 9), KC_TAB);
+}
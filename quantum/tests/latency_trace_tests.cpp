@@ -0,0 +1,161 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+extern "C" {
+#include "latency_trace.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+/* The test timer counts milliseconds, so every latency here is a multiple of 1000us */
+
+class LatencyTrace : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        latency_trace_clear();
+    }
+
+    void key_event(uint32_t debounce_ms, uint32_t report_ms, uint32_t usb_ms) {
+        latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+        advance_time(debounce_ms);
+        latency_trace_mark(LATENCY_TRACE_STAGE_DEBOUNCE);
+        latency_trace_mark(LATENCY_TRACE_STAGE_ACTION);
+        advance_time(report_ms);
+        latency_trace_mark(LATENCY_TRACE_STAGE_REPORT);
+        latency_trace_task();
+        advance_time(usb_ms);
+        latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+        latency_trace_task();
+    }
+};
+
+TEST_F(LatencyTrace, RecordsEveryStage) {
+    key_event(5, 1, 2);
+
+    latency_trace_sample_t sample;
+    ASSERT_EQ(latency_trace_get_samples(&sample, 1), 1);
+    EXPECT_EQ(sample.stages, (1 << LATENCY_TRACE_STAGE_COUNT) - 1);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_RAW], 0);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_DEBOUNCE], 5000);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_ACTION], 5000);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_REPORT], 6000);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_USB], 8000);
+
+    latency_trace_stats_t stats;
+    latency_trace_get_stats(LATENCY_TRACE_STAGE_USB, &stats);
+    EXPECT_EQ(stats.count, 1);
+    EXPECT_EQ(stats.p50_us, 8000);
+    EXPECT_EQ(stats.p99_us, 8000);
+    EXPECT_EQ(stats.max_us, 8000);
+}
+
+TEST_F(LatencyTrace, LaterStagesDoNotStartATrace) {
+    latency_trace_mark(LATENCY_TRACE_STAGE_ACTION);
+    latency_trace_mark(LATENCY_TRACE_STAGE_REPORT);
+    latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+    advance_time(LATENCY_TRACE_TIMEOUT);
+    latency_trace_task();
+
+    latency_trace_sample_t sample;
+    EXPECT_EQ(latency_trace_get_samples(&sample, 1), 0);
+}
+
+TEST_F(LatencyTrace, BouncesKeepTheFirstTimestamp) {
+    latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+    advance_time(2);
+    latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+    advance_time(3);
+    latency_trace_mark(LATENCY_TRACE_STAGE_DEBOUNCE);
+    latency_trace_mark(LATENCY_TRACE_STAGE_REPORT);
+    latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+    latency_trace_task();
+
+    latency_trace_sample_t sample;
+    ASSERT_EQ(latency_trace_get_samples(&sample, 1), 1);
+    EXPECT_EQ(sample.time_us[LATENCY_TRACE_STAGE_DEBOUNCE], 5000);
+}
+
+TEST_F(LatencyTrace, UnfinishedTraceTimesOut) {
+    latency_trace_mark(LATENCY_TRACE_STAGE_RAW);
+    advance_time(LATENCY_TRACE_TIMEOUT - 1);
+    latency_trace_task();
+
+    latency_trace_sample_t sample;
+    EXPECT_EQ(latency_trace_get_samples(&sample, 1), 0);
+
+    advance_time(1);
+    latency_trace_task();
+    ASSERT_EQ(latency_trace_get_samples(&sample, 1), 1);
+    EXPECT_EQ(sample.stages, 1 << LATENCY_TRACE_STAGE_RAW);
+
+    // A report completing after the trace was given up on is not counted against the next one
+    latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+    latency_trace_mark(LATENCY_TRACE_STAGE_DEBOUNCE);
+    latency_trace_task();
+    EXPECT_EQ(latency_trace_get_samples(&sample, 1), 1);
+}
+
+TEST_F(LatencyTrace, PercentilesFollowTheHistogram) {
+    // 98 fast events and 2 slow ones
+    for (int i = 0; i < 98; i++) {
+        key_event(1, 0, 0);
+    }
+    key_event(40, 0, 0);
+    key_event(40, 0, 0);
+
+    latency_trace_stats_t stats;
+    latency_trace_get_stats(LATENCY_TRACE_STAGE_DEBOUNCE, &stats);
+    EXPECT_EQ(stats.count, 100);
+    // 1000us falls into the 768..1023 bucket, and percentiles report the top of their bucket
+    EXPECT_EQ(stats.p50_us, 1023);
+    EXPECT_EQ(stats.p99_us, 40000);
+    EXPECT_EQ(stats.max_us, 40000);
+
+    const uint16_t *histogram = latency_trace_get_histogram(LATENCY_TRACE_STAGE_DEBOUNCE);
+    uint32_t        total     = 0;
+    for (uint8_t bucket = 0; bucket < LATENCY_TRACE_HISTOGRAM_BUCKETS; bucket++) {
+        total += histogram[bucket];
+        if (histogram[bucket]) {
+            EXPECT_TRUE(latency_trace_bucket_floor(bucket) == 768 || latency_trace_bucket_floor(bucket) == 32768) << latency_trace_bucket_floor(bucket);
+        }
+    }
+    EXPECT_EQ(total, 100);
+}
+
+TEST_F(LatencyTrace, RingKeepsTheNewestSamples) {
+    for (uint32_t i = 1; i <= LATENCY_TRACE_RING_SIZE + 2; i++) {
+        key_event(i, 0, 0);
+    }
+
+    latency_trace_sample_t samples[LATENCY_TRACE_RING_SIZE + 2];
+    ASSERT_EQ(latency_trace_get_samples(samples, LATENCY_TRACE_RING_SIZE + 2), LATENCY_TRACE_RING_SIZE);
+    EXPECT_EQ(samples[0].time_us[LATENCY_TRACE_STAGE_DEBOUNCE], (LATENCY_TRACE_RING_SIZE + 2) * 1000);
+    EXPECT_EQ(samples[LATENCY_TRACE_RING_SIZE - 1].time_us[LATENCY_TRACE_STAGE_DEBOUNCE], 3000);
+}
+
+TEST_F(LatencyTrace, BucketsCoverTheRange) {
+    EXPECT_EQ(latency_trace_bucket_floor(0), 0);
+    EXPECT_EQ(latency_trace_bucket_floor(1), 1);
+    EXPECT_EQ(latency_trace_bucket_floor(2), 2);
+    EXPECT_EQ(latency_trace_bucket_floor(3), 3);
+    EXPECT_EQ(latency_trace_bucket_floor(4), 4);
+    EXPECT_EQ(latency_trace_bucket_floor(5), 6);
+    EXPECT_EQ(latency_trace_bucket_floor(LATENCY_TRACE_HISTOGRAM_BUCKETS - 1), 49152);
+}
@@ -0,0 +1,211 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <cstring>
+
+extern "C" {
+#include "matrix.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+#define PIN_COUNT 5
+#define ROW_PIN(row) (row)
+#define COL_PIN(col) (2 + (col))
+
+/* COL2ROW: rows are driven low one at a time, a pressed switch pulls its column low too */
+struct mock_pin_t {
+    bool output;
+    bool high;
+    bool wake_armed;
+};
+
+static mock_pin_t pins[PIN_COUNT];
+static bool       switches[MATRIX_ROWS][MATRIX_COLS];
+static int        pin_reads;
+static bool       wake_capable[PIN_COUNT];
+static bool       press_while_arming;
+
+extern "C" {
+matrix_row_t raw_matrix[MATRIX_ROWS];
+matrix_row_t matrix[MATRIX_ROWS];
+
+void mock_pin_input_high(pin_t pin) {
+    pins[pin].output = false;
+    pins[pin].high   = true;
+}
+
+void mock_pin_output(pin_t pin) {
+    pins[pin].output = true;
+}
+
+void mock_pin_write(pin_t pin, bool high) {
+    pins[pin].high = high;
+}
+
+static bool col_is_low(uint8_t col) {
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        if (switches[row][col] && pins[ROW_PIN(row)].output && !pins[ROW_PIN(row)].high) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool mock_pin_read(pin_t pin) {
+    pin_reads++;
+    if (pin >= COL_PIN(0)) {
+        return !col_is_low(pin - COL_PIN(0));
+    }
+    return pins[pin].high;
+}
+
+bool matrix_idle_wake_pin_enable(pin_t pin) {
+    if (!wake_capable[pin]) {
+        return false;
+    }
+    pins[pin].wake_armed = true;
+    return true;
+}
+
+void matrix_idle_wake_pin_disable(pin_t pin) {
+    pins[pin].wake_armed = false;
+}
+
+// Every row being driven at once only happens while arming
+void matrix_output_select_delay(void) {
+    if (press_while_arming && pins[ROW_PIN(0)].output && pins[ROW_PIN(1)].output) {
+        switches[0][1]     = true;
+        press_while_arming = false;
+    }
+}
+
+void matrix_output_unselect_delay(uint8_t line, bool key_pressed) {}
+void matrix_init_quantum(void) {}
+void matrix_scan_quantum(void) {}
+}
+
+class MatrixIdle : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        memset(pins, 0, sizeof(pins));
+        memset(switches, 0, sizeof(switches));
+        for (int i = 0; i < PIN_COUNT; i++) {
+            wake_capable[i] = true;
+        }
+        press_while_arming = false;
+        matrix_init();
+        // Leave whatever state an earlier test left the matrix in, and go idle from here
+        matrix_idle_wakeup();
+        matrix_scan();
+    }
+
+    /* Flips a switch, raising a wake edge if its column is armed and goes low */
+    void set_switch(uint8_t row, uint8_t col, bool pressed) {
+        bool was_low      = col_is_low(col);
+        switches[row][col] = pressed;
+        if (!was_low && col_is_low(col) && pins[COL_PIN(col)].wake_armed) {
+            matrix_idle_wakeup();
+        }
+    }
+
+    /* Scans once a millisecond, returns whether the pins were read */
+    bool scan(void) {
+        advance_time(1);
+        pin_reads = 0;
+        matrix_scan();
+        return !matrix_idle_scan_skipped();
+    }
+
+    bool wake_armed(void) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            if (!pins[COL_PIN(col)].wake_armed) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+TEST_F(MatrixIdle, GoesIdleWhenNothingIsHeld) {
+    EXPECT_TRUE(wake_armed());
+    // Every row is driven so that any switch can pull its column low
+    EXPECT_TRUE(pins[ROW_PIN(0)].output && !pins[ROW_PIN(0)].high);
+    EXPECT_TRUE(pins[ROW_PIN(1)].output && !pins[ROW_PIN(1)].high);
+
+    for (int i = 0; i < 5; i++) {
+        EXPECT_FALSE(scan());
+        EXPECT_EQ(pin_reads, 0);
+    }
+}
+
+TEST_F(MatrixIdle, WakeEdgeResumesScanning) {
+    EXPECT_FALSE(scan());
+
+    set_switch(1, 2, true);
+    EXPECT_TRUE(scan());
+    EXPECT_FALSE(wake_armed());
+    EXPECT_EQ(matrix[1], 1 << 2);
+
+    // Held keys are scanned every pass
+    for (int i = 0; i < 20; i++) {
+        EXPECT_TRUE(scan());
+    }
+    EXPECT_EQ(matrix[1], 1 << 2);
+
+    set_switch(1, 2, false);
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(matrix[1], 0);
+    EXPECT_TRUE(wake_armed());
+    EXPECT_FALSE(scan());
+}
+
+TEST_F(MatrixIdle, IdleScanFloor) {
+    for (int i = 1; i < MATRIX_IDLE_SCAN_INTERVAL; i++) {
+        EXPECT_FALSE(scan());
+    }
+    // A switch that never raised an edge is still seen at the floor
+    switches[0][0] = true;
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(matrix[0], 1);
+}
+
+TEST_F(MatrixIdle, KeyDownWhileArmingWakesStraightAway) {
+    // Pressed after the scan that found nothing, so only the arming sees it
+    matrix_idle_wakeup();
+    press_while_arming = true;
+    EXPECT_TRUE(scan());
+    EXPECT_TRUE(wake_armed());
+    EXPECT_EQ(matrix[0], 0);
+    EXPECT_TRUE(scan());
+    EXPECT_EQ(matrix[0], 1 << 1);
+}
+
+// Last, as the matrix gives up on idling for good
+TEST_F(MatrixIdle, PinWithoutWakeKeepsScanning) {
+    wake_capable[COL_PIN(1)] = false;
+    matrix_idle_wakeup();
+    for (int i = 0; i < 20; i++) {
+        EXPECT_TRUE(scan());
+        EXPECT_GT(pin_reads, 0);
+    }
+    EXPECT_FALSE(pins[COL_PIN(0)].wake_armed);
+    EXPECT_FALSE(pins[COL_PIN(2)].wake_armed);
+}
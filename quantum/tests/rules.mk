@@ -0,0 +1,46 @@
+# Copyright 2022 QMK
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 2 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+dynamic_keymap_DEFS := -DDYNAMIC_KEYMAP_ENABLE -DENCODER_ENABLE -DENCODER_MAP_ENABLE -DSEND_STRING_ENABLE -DEEPROM_CUSTOM
+dynamic_keymap_CONFIG := $(QUANTUM_PATH)/tests/config_mock.h
+dynamic_keymap_SRC := \
+	$(QUANTUM_PATH)/dynamic_keymap.c \
+	$(QUANTUM_PATH)/tests/dynamic_keymap_tests.cpp
+
+dynamic_keymap_cache_DEFS := $(dynamic_keymap_DEFS) -DDYNAMIC_KEYMAP_RAM_CACHE
+dynamic_keymap_cache_CONFIG := $(dynamic_keymap_CONFIG)
+dynamic_keymap_cache_SRC := $(dynamic_keymap_SRC)
+
+color_SRC := \
+	$(QUANTUM_PATH)/color.c \
+	$(QUANTUM_PATH)/tests/color_tests.cpp
+
+color_cie_DEFS := -DUSE_CIE1931_CURVE
+color_cie_SRC := \
+	$(color_SRC) \
+	$(QUANTUM_PATH)/led_tables.c
+
+latency_trace_DEFS := -DLATENCY_TRACE_ENABLE -DLATENCY_TRACE_USB_STAGE -DLATENCY_TRACE_PRINT_INTERVAL=0
+latency_trace_SRC := \
+	$(QUANTUM_PATH)/latency_trace.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/tests/latency_trace_tests.cpp
+
+matrix_idle_CONFIG := $(QUANTUM_PATH)/tests/config_matrix_idle.h
+matrix_idle_SRC := \
+	$(QUANTUM_PATH)/matrix.c \
+	$(QUANTUM_PATH)/debounce/none.c \
+	$(PLATFORM_PATH)/$(PLATFORM_KEY)/timer.c \
+	$(QUANTUM_PATH)/tests/matrix_idle_tests.cpp
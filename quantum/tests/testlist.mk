@@ -0,0 +1 @@
+TEST_LIST += dynamic_keymap dynamic_keymap_cache color color_cie latency_trace matrix_idle
@@ -51,6 +51,9 @@
 #include "eeprom.h"
 #include "version.h" // for QMK_BUILDDATE used in EEPROM magic
 #include "via_ensure_keycode.h"
+#ifdef TASK_SCHEDULER_ENABLE
+#    include "task_scheduler.h"
+#endif
 
 // Forward declare some helpers.
 #if defined(VIA_QMK_BACKLIGHT_ENABLE)
@@ -408,6 +411,12 @@ void raw_hid_receive(uint8_t *data, uint8_t length) {
             dynamic_keymap_set_encoder(command_data[0], command_data[1], command_data[2] != 0, (command_data[3] << 8) | command_data[4]);
             break;
         }
+#endif
+#ifdef TASK_SCHEDULER_ENABLE
+        case TASK_SCHEDULER_RAW_HID_ID: {
+            task_scheduler_raw_hid_stats(data, length);
+            break;
+        }
 #endif
         default: {
             // The command ID is not known
@@ -17,12 +17,14 @@ void MockBackingStore::reset_instance() {
     backing_erasure_count     = 0;
     backing_max_write_count   = 0;
     backing_total_write_count = 0;
+    backing_elapsed_ms        = 0;
 
-    backing_init_invoke_count   = 0;
-    backing_unlock_invoke_count = 0;
-    backing_erase_invoke_count  = 0;
-    backing_write_invoke_count  = 0;
-    backing_lock_invoke_count   = 0;
+    backing_init_invoke_count       = 0;
+    backing_unlock_invoke_count     = 0;
+    backing_erase_invoke_count      = 0;
+    backing_erase_page_invoke_count = 0;
+    backing_write_invoke_count      = 0;
+    backing_lock_invoke_count       = 0;
 
     init_success_callback   = [](std::uint64_t) { return true; };
     erase_success_callback  = [](std::uint64_t) { return true; };
@@ -75,6 +77,33 @@ bool MockBackingStore::erase(void) {
     return true;
 }
 
+bool MockBackingStore::erase_page(uint32_t address) {
+    ++backing_erase_page_invoke_count;
+
+#ifdef WEAR_LEVELING_BACKING_PAGE_SIZE
+    EXPECT_TRUE(address % WEAR_LEVELING_BACKING_PAGE_SIZE == 0) << "Supplied address was not aligned with the page size";
+    EXPECT_TRUE(address + WEAR_LEVELING_BACKING_PAGE_SIZE <= WEAR_LEVELING_BACKING_SIZE) << "Address would result of out-of-bounds access";
+    EXPECT_FALSE(is_locked()) << "Erase was attempted without being unlocked first";
+
+    backing_elapsed_ms += MOCK_PAGE_ERASE_TIME_MS::value;
+
+    // Erase each slot in the page
+    for (std::size_t i = address / BACKING_STORE_WRITE_SIZE; i < (address + WEAR_LEVELING_BACKING_PAGE_SIZE) / BACKING_STORE_WRITE_SIZE; ++i) {
+        // Drop out of erase early with failure if we need to, leaving the page partially erased
+        if (erase_success_callback && !erase_success_callback(backing_erase_page_invoke_count)) {
+            return false;
+        }
+
+        backing_storage[i].erase();
+    }
+
+    return true;
+#else
+    ADD_FAILURE() << "Page erase is only used with WEAR_LEVELING_BACKING_PAGE_SIZE set";
+    return false;
+#endif
+}
+
 bool MockBackingStore::write(uint32_t address, backing_store_int_t value) {
     ++backing_write_invoke_count;
 
@@ -141,6 +170,10 @@ extern "C" bool backing_store_erase(void) {
     return MockBackingStore::Instance().erase();
 }
 
+extern "C" bool backing_store_erase_page(uint32_t address) {
+    return MockBackingStore::Instance().erase_page(address);
+}
+
 extern "C" bool backing_store_write(uint32_t address, backing_store_int_t value) {
     return MockBackingStore::Instance().write(address, value);
 }
@@ -152,3 +185,7 @@ extern "C" bool backing_store_lock(void) {
 extern "C" bool backing_store_read(uint32_t address, backing_store_int_t* value) {
     return MockBackingStore::Instance().read(address, *value);
 }
+
+extern "C" uint32_t timer_read32(void) {
+    return MockBackingStore::Instance().elapsed_ms();
+}
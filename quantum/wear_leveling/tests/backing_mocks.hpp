@@ -21,6 +21,8 @@ using MOCK_WRITE_LOG_MAX_ENTRIES = std::integral_constant<std::size_t, 1024>;
 using BACKING_STORE_INTEGRAL_COMPLEMENT = std::integral_constant<backing_store_int_t, ((backing_store_int_t)(~(backing_store_int_t)0))>;
 // Total number of elements stored in the backing arrays
 using BACKING_STORE_ELEMENT_COUNT = std::integral_constant<std::size_t, (WEAR_LEVELING_BACKING_SIZE / sizeof(backing_store_int_t))>;
+// Simulated time taken to erase a page, roughly that of an STM32F303 -- nothing else advances the simulated clock
+using MOCK_PAGE_ERASE_TIME_MS = std::integral_constant<std::uint32_t, 20>;
 
 class MockBackingStoreElement {
    private:
@@ -87,6 +89,8 @@ class MockBackingStore {
     std::uint64_t backing_max_write_count;
     // The total number of writes to all elements of the backing store
     std::uint64_t backing_total_write_count;
+    // The simulated time, in milliseconds
+    std::uint32_t backing_elapsed_ms;
     // The write log for the backing store
     std::vector<MockBackingStoreLogEntry> write_log;
 
@@ -94,6 +98,7 @@ class MockBackingStore {
     std::uint64_t backing_init_invoke_count;
     std::uint64_t backing_unlock_invoke_count;
     std::uint64_t backing_erase_invoke_count;
+    std::uint64_t backing_erase_page_invoke_count;
     std::uint64_t backing_write_invoke_count;
     std::uint64_t backing_lock_invoke_count;
 
@@ -130,6 +135,9 @@ class MockBackingStore {
     std::uint64_t total_write_count() const {
         return backing_total_write_count;
     }
+    std::uint32_t elapsed_ms() const {
+        return backing_elapsed_ms;
+    }
 
     // The number of times each API was invoked
     std::uint64_t init_invoke_count() const {
@@ -141,6 +149,9 @@ class MockBackingStore {
     std::uint64_t erase_invoke_count() const {
         return backing_erase_invoke_count;
     }
+    std::uint64_t erase_page_invoke_count() const {
+        return backing_erase_page_invoke_count;
+    }
     std::uint64_t write_invoke_count() const {
         return backing_write_invoke_count;
     }
@@ -159,6 +170,7 @@ class MockBackingStore {
     bool init();
     bool unlock();
     bool erase();
+    bool erase_page(std::uint32_t address);
     bool write(std::uint32_t address, backing_store_int_t value);
     bool lock();
     bool read(std::uint32_t address, backing_store_int_t& value) const;
@@ -63,4 +63,18 @@ wear_leveling_8byte_SRC := \
 	$(wear_leveling_common_SRC) \
 	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_8byte.cpp
 wear_leveling_8byte_INC := \
-	$(wear_leveling_common_INC)
\ No newline at end of file
+	$(wear_leveling_common_INC)
+wear_leveling_incremental_DEFS := \
+	$(wear_leveling_common_DEFS) \
+	-DBACKING_STORE_WRITE_SIZE=2 \
+	-DWEAR_LEVELING_BACKING_SIZE=128 \
+	-DWEAR_LEVELING_LOGICAL_SIZE=16 \
+	-DWEAR_LEVELING_INCREMENTAL_CONSOLIDATION \
+	-DWEAR_LEVELING_BACKING_PAGE_SIZE=16 \
+	-DWEAR_LEVELING_CONSOLIDATION_STEP_SIZE=4
+wear_leveling_incremental_SRC := \
+	$(wear_leveling_common_SRC) \
+	$(QUANTUM_PATH)/wear_leveling/tests/wear_leveling_incremental.cpp
+wear_leveling_incremental_INC := \
+	$(wear_leveling_common_INC) \
+	$(PLATFORM_PATH)
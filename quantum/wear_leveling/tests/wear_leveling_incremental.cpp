@@ -0,0 +1,256 @@
+// Copyright 2022 Nick Brassel (@tzarc)
+// SPDX-License-Identifier: GPL-2.0-or-later
+#include <numeric>
+#include <vector>
+#include "gtest/gtest.h"
+#include "gmock/gmock.h"
+#include "backing_mocks.hpp"
+
+class WearLevelingIncremental : public ::testing::Test {
+   protected:
+    void SetUp() override {
+        MockBackingStore::Instance().reset_instance();
+        wear_leveling_init();
+    }
+};
+
+// All logical addresses are below 64, so every byte written takes a single write log entry, and a single backing store write
+using LOG_SLOTS = std::integral_constant<std::size_t, ((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)) / BACKING_STORE_WRITE_SIZE>;
+// Pages erased, chunks copied, then the commit
+using CONSOLIDATION_STEPS = std::integral_constant<std::size_t, (WEAR_LEVELING_BANK_SIZE / WEAR_LEVELING_BACKING_PAGE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE / WEAR_LEVELING_CONSOLIDATION_STEP_SIZE) + 1>;
+
+static std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> verify_data;
+
+static wear_leveling_status_t test_write(const uint32_t address, const void* value, size_t length) {
+    memcpy(&verify_data[address], value, length);
+    return wear_leveling_write(address, value, length);
+}
+
+static void fill_log(std::size_t entries) {
+    for (std::size_t i = 0; i < entries; ++i) {
+        uint8_t value = 0x30 + i;
+        EXPECT_EQ(test_write(i % WEAR_LEVELING_LOGICAL_SIZE, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    }
+}
+
+static void verify_readback(void) {
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+    EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+    EXPECT_EQ(readback, verify_data) << "Invalid readback";
+}
+
+/**
+ * This test verifies that nothing is consolidated in the background until the write log is half full.
+ */
+TEST_F(WearLevelingIncremental, NothingToDoUntilLogHalfFull) {
+    auto& inst = MockBackingStore::Instance();
+    verify_data.fill(0);
+
+    fill_log(LOG_SLOTS::value / 2 - 1);
+    EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+    EXPECT_EQ(inst.unlock_invoke_count(), LOG_SLOTS::value / 2 - 1) << "Task should not have touched the backing store";
+    EXPECT_EQ(inst.erase_page_invoke_count(), 0) << "Page erase should not have been invoked";
+}
+
+/**
+ * This test verifies that a background consolidation erases at most one page per step, serves reads from the cache
+ * throughout, and leaves the next write log entry in the other bank.
+ */
+TEST_F(WearLevelingIncremental, BackgroundConsolidation_OneStepAtATime) {
+    auto& inst = MockBackingStore::Instance();
+    verify_data.fill(0);
+
+    fill_log(LOG_SLOTS::value / 2);
+    for (std::size_t step = 1; step <= CONSOLIDATION_STEPS::value; ++step) {
+        std::uint64_t erases = inst.erase_page_invoke_count();
+        EXPECT_EQ(wear_leveling_task(), step == CONSOLIDATION_STEPS::value ? WEAR_LEVELING_CONSOLIDATED : WEAR_LEVELING_SUCCESS) << "Task returned incorrect status at step " << step;
+        EXPECT_LE(inst.erase_page_invoke_count(), erases + 1) << "More than one page erased at step " << step;
+        verify_readback();
+    }
+    EXPECT_EQ(inst.erase_invoke_count(), 0) << "Erase should not have been invoked";
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    EXPECT_EQ(stats.consolidations, 1) << "Invalid consolidation count";
+    EXPECT_EQ(stats.forced, 0) << "Invalid forced consolidation count";
+    EXPECT_EQ(stats.stall_max, MOCK_PAGE_ERASE_TIME_MS::value) << "Stall should have been limited to a single page erase";
+
+    // The next log entry goes into the other bank
+    uint8_t value = 0x55;
+    EXPECT_EQ(test_write(0x03, &value, sizeof(value)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_EQ((inst.log_end() - 1)->address, WEAR_LEVELING_BANK_SIZE + WEAR_LEVELING_LOG_START) << "Invalid write log address";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    verify_readback();
+}
+
+/**
+ * This test verifies that writes made part-way through a background consolidation end up in the other bank, whether or
+ * not the data they touch has already been copied across.
+ */
+TEST_F(WearLevelingIncremental, WritesDuringConsolidation_Persist) {
+    verify_data.fill(0);
+
+    fill_log(LOG_SLOTS::value / 2);
+
+    // Erase the other bank, and copy the first half of the cache across
+    const std::size_t steps = (WEAR_LEVELING_BANK_SIZE / WEAR_LEVELING_BACKING_PAGE_SIZE) + (WEAR_LEVELING_LOGICAL_SIZE / WEAR_LEVELING_CONSOLIDATION_STEP_SIZE) / 2;
+    for (std::size_t step = 0; step < steps; ++step) {
+        EXPECT_EQ(wear_leveling_task(), WEAR_LEVELING_SUCCESS) << "Task returned incorrect status";
+    }
+
+    uint8_t copied     = 0x66;
+    uint8_t not_copied = 0x77;
+    EXPECT_EQ(test_write(0x02, &copied, sizeof(copied)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+    EXPECT_EQ(test_write(WEAR_LEVELING_LOGICAL_SIZE - 2, &not_copied, sizeof(not_copied)), WEAR_LEVELING_SUCCESS) << "Write returned incorrect status";
+
+    wear_leveling_status_t status;
+    while ((status = wear_leveling_task()) == WEAR_LEVELING_SUCCESS) {
+    }
+    EXPECT_EQ(status, WEAR_LEVELING_CONSOLIDATED) << "Task returned incorrect status";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    verify_readback();
+}
+
+/**
+ * This test verifies that if the write log fills up without the background task running, consolidation completes
+ * in-line, and that the longer stall is reported.
+ */
+TEST_F(WearLevelingIncremental, LogFullWithoutTask_ConsolidatesInline) {
+    auto& inst = MockBackingStore::Instance();
+    verify_data.fill(0);
+
+    fill_log(LOG_SLOTS::value - 1);
+    uint8_t value = 0x44;
+    EXPECT_EQ(test_write(0x0F, &value, sizeof(value)), WEAR_LEVELING_CONSOLIDATED) << "Write returned incorrect status";
+    EXPECT_EQ(inst.erase_invoke_count(), 0) << "Erase should not have been invoked";
+
+    wear_leveling_stats_t stats;
+    wear_leveling_get_stats(&stats);
+    EXPECT_EQ(stats.consolidations, 0) << "Invalid consolidation count";
+    EXPECT_EQ(stats.forced, 1) << "Invalid forced consolidation count";
+    EXPECT_EQ(stats.stall_max, MOCK_PAGE_ERASE_TIME_MS::value * (WEAR_LEVELING_BANK_SIZE / WEAR_LEVELING_BACKING_PAGE_SIZE)) << "Stall should have covered erasing the whole bank";
+
+    EXPECT_EQ(wear_leveling_init(), WEAR_LEVELING_SUCCESS) << "Init returned incorrect status";
+    verify_readback();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Power loss simulation
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/**
+ * Lets a fixed number of backing store operations through -- counting each element written or erased -- after which
+ * every write and erase fails without effect, as if power had been lost.
+ */
+struct PowerSupply {
+    std::uint64_t remaining;
+    bool          lost;
+
+    explicit PowerSupply(std::uint64_t operations) : remaining(operations), lost(false) {
+        auto& inst = MockBackingStore::Instance();
+        inst.set_write_callback([this](std::uint64_t, std::uint32_t) { return consume(); });
+        inst.set_erase_callback([this](std::uint64_t) { return consume(); });
+    }
+    ~PowerSupply() {
+        auto& inst = MockBackingStore::Instance();
+        inst.set_write_callback([](std::uint64_t, std::uint32_t) { return true; });
+        inst.set_erase_callback([](std::uint64_t) { return true; });
+    }
+    bool consume() {
+        if (remaining == 0) {
+            lost = true;
+            return false;
+        }
+        --remaining;
+        return true;
+    }
+};
+
+/**
+ * Writes a mix of single and multi-byte values, stepping the background consolidation twice per write at first, then
+ * not at all so that the write log fills up. Stops as soon as power is lost.
+ *
+ * @param committed[out] the logical data, including every write that completed before power was lost
+ * @param in_flight[out] the logical data, also including the write that was under way when power was lost
+ */
+static void run_workload(PowerSupply& power, std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& committed, std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE>& in_flight) {
+    committed.fill(0);
+    in_flight.fill(0);
+    for (int i = 0; i < 48; ++i) {
+        const uint8_t  value[2] = {(uint8_t)(0x80 + i), (uint8_t)(0x10 + i)};
+        const size_t   length   = (i % 3 == 0) ? 2 : 1;
+        const uint32_t address  = (i * 5) % (WEAR_LEVELING_LOGICAL_SIZE - 1);
+
+        memcpy(&in_flight[address], value, length);
+        wear_leveling_write(address, value, length);
+        if (power.lost) {
+            return;
+        }
+        committed = in_flight;
+
+        for (int j = 0; i < 32 && j < 2; ++j) {
+            wear_leveling_task();
+            if (power.lost) {
+                return;
+            }
+        }
+    }
+}
+
+/**
+ * This test cuts the power after every possible number of backing store operations throughout a workload spanning
+ * several consolidations, verifying that every completed write survives, and that the wear-leveling keeps working
+ * afterwards.
+ */
+TEST_F(WearLevelingIncremental, PowerLossAtEveryStep) {
+    auto& inst = MockBackingStore::Instance();
+
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> committed;
+    std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> in_flight;
+
+    // Work out how many operations the uninterrupted workload takes
+    std::uint64_t total;
+    {
+        PowerSupply power(UINT64_MAX);
+        run_workload(power, committed, in_flight);
+        total = UINT64_MAX - power.remaining;
+
+        wear_leveling_stats_t stats;
+        wear_leveling_get_stats(&stats);
+        EXPECT_GE(stats.consolidations, 2) << "Workload should have consolidated in the background";
+        EXPECT_GE(stats.forced, 1) << "Workload should have consolidated in-line";
+    }
+
+    for (std::uint64_t operations = 0; operations < total; ++operations) {
+        SCOPED_TRACE(testing::Message() << "Power lost after " << operations << " of " << total << " operations");
+        inst.reset_instance();
+        wear_leveling_init();
+
+        {
+            PowerSupply power(operations);
+            run_workload(power, committed, in_flight);
+            ASSERT_TRUE(power.lost) << "Workload should have been interrupted";
+        }
+
+        // Power back on
+        ASSERT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init returned incorrect status";
+        std::array<std::uint8_t, WEAR_LEVELING_LOGICAL_SIZE> readback;
+        EXPECT_EQ(wear_leveling_read(0, readback.data(), readback.size()), WEAR_LEVELING_SUCCESS) << "Failed to read";
+        for (int i = 0; i < WEAR_LEVELING_LOGICAL_SIZE; ++i) {
+            ASSERT_TRUE(readback[i] == committed[i] || readback[i] == in_flight[i]) << "Invalid readback at " << i;
+        }
+
+        // Keep going until the next consolidation has been committed
+        std::iota(verify_data.begin(), verify_data.end(), (uint8_t)operations);
+        ASSERT_NE(wear_leveling_write(0, verify_data.data(), verify_data.size()), WEAR_LEVELING_FAILED) << "Write returned incorrect status";
+        for (std::size_t step = 0; step < CONSOLIDATION_STEPS::value && wear_leveling_task() == WEAR_LEVELING_SUCCESS; ++step) {
+        }
+        ASSERT_NE(wear_leveling_init(), WEAR_LEVELING_FAILED) << "Init returned incorrect status";
+        verify_readback();
+        if (testing::Test::HasFailure()) {
+            break;
+        }
+    }
+}
@@ -4,6 +4,9 @@
 #include "fnv.h"
 #include "wear_leveling.h"
 #include "wear_leveling_internal.h"
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#    include "timer.h"
+#endif
 
 /*
     This wear leveling algorithm is adapted from algorithms from previous
@@ -153,7 +156,40 @@
         ║  │Address >> 1 ║
         ║  └── Value: 1  ║
         ╚════════════════╝
-        0 <= Address <= 0x3FFE (16382) */
+        0 <= Address <= 0x3FFE (16382)
+
+    Incremental consolidation:
+
+        With WEAR_LEVELING_INCREMENTAL_CONSOLIDATION defined, the backing store
+        is split into two equally-sized banks, each laid out as above with the
+        addition of a sequence number following the hash. The hash covers both
+        the consolidated data and the sequence number.
+
+        Only one bank is in use at a time -- during initialization, the bank
+        with a valid hash and the highest sequence number is selected.
+
+        Once the write log of the bank in use is half full, the cache is
+        consolidated into the other bank in steps, performed by
+        wear_leveling_task():
+            * The other bank is erased, one page per step.
+            * The cache is copied across, WEAR_LEVELING_CONSOLIDATION_STEP_SIZE
+                bytes per step. From then on, writes to data that has already
+                been copied are appended to both write logs.
+            * The sequence number and then the hash are written, after which
+                the other bank is the one in use.
+
+        Until its hash is written, the other bank is ignored during
+        initialization, whereas the bank in use is untouched apart from its
+        write log. A power loss at any point therefore leaves a valid bank
+        containing every completed write. If the write log fills up before the
+        background consolidation has finished, it is completed in-line. */
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Progress of a background consolidation.
+ */
+typedef enum consolidation_state_t { CONSOLIDATION_IDLE = 0, CONSOLIDATION_ERASING, CONSOLIDATION_COPYING, CONSOLIDATION_COMMITTING } consolidation_state_t;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
 /**
  * Storage area for the wear-leveling cache.
@@ -162,8 +198,25 @@ static struct __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) {
     __attribute__((__aligned__(BACKING_STORE_WRITE_SIZE))) uint8_t cache[(WEAR_LEVELING_LOGICAL_SIZE)];
     uint32_t                                                       write_address;
     bool                                                           unlocked;
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    uint32_t              bank_address;         // start of the bank in use
+    uint32_t              sequence;             // sequence number of the bank in use
+    consolidation_state_t state;                // progress of the background consolidation
+    uint32_t              target_offset;        // next page to erase, or byte of the cache to copy, in the other bank
+    uint32_t              target_write_address; // next write log slot in the other bank
+    uint64_t              target_hash;          // FNV1a_64 of the data copied into the other bank so far
+    bool                  mirror;               // whether log entries are also appended to the other bank's write log
+    wear_leveling_stats_t stats;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 } wear_leveling;
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#    define ACTIVE_BANK_ADDRESS (wear_leveling.bank_address)
+#    define TARGET_BANK_ADDRESS ((WEAR_LEVELING_BANK_SIZE) - wear_leveling.bank_address)
+#else
+#    define ACTIVE_BANK_ADDRESS 0
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Locking helper: status
  */
@@ -202,9 +255,200 @@ static inline backing_store_lock_status_t wear_leveling_lock(void) {
  */
 static void wear_leveling_clear_cache(void) {
     memset(wear_leveling.cache, 0, (WEAR_LEVELING_LOGICAL_SIZE));
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 is due to the FNV1a_64 of the consolidated buffer
+    wear_leveling.write_address = ACTIVE_BANK_ADDRESS + (WEAR_LEVELING_LOG_START); // the write log follows the consolidated buffer and its header
+}
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Reads an 8-byte header field from the backing store.
+ */
+static bool wear_leveling_read_header(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_read_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_read_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_read(address, &entry->raw64);
+#    endif
+}
+
+/**
+ * Writes an 8-byte header field to the backing store.
+ */
+static bool wear_leveling_write_header(uint32_t address, write_log_entry_t *entry) {
+#    if BACKING_STORE_WRITE_SIZE == 2
+    return backing_store_write_bulk(address, entry->raw16, 4);
+#    elif BACKING_STORE_WRITE_SIZE == 4
+    return backing_store_write_bulk(address, entry->raw32, 2);
+#    elif BACKING_STORE_WRITE_SIZE == 8
+    return backing_store_write(address, entry->raw64);
+#    endif
+}
+
+/**
+ * Reads the consolidated data of a bank into the cache, verifying it against the bank's hash.
+ *
+ * @return true if the bank holds a committed consolidation
+ */
+static bool wear_leveling_read_bank(uint32_t bank_address, uint32_t *sequence) {
+    write_log_entry_t hash;
+    write_log_entry_t header;
+    if (!backing_store_read_bulk(bank_address, (backing_store_int_t *)wear_leveling.cache, sizeof(wear_leveling.cache) / sizeof(backing_store_int_t)) || !wear_leveling_read_header(bank_address + (WEAR_LEVELING_LOGICAL_SIZE), &hash) || !wear_leveling_read_header(bank_address + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &header)) {
+        wl_dprintf("Failed to read from backing store\n");
+        return false;
+    }
+
+    uint64_t expected = fnv_64a_buf(wear_leveling.cache, (WEAR_LEVELING_LOGICAL_SIZE), FNV1A_64_INIT);
+    expected          = fnv_64a_buf(header.raw8, sizeof(header), expected);
+    *sequence         = header.raw32[0];
+    return hash.raw64 == expected;
+}
+
+/**
+ * Selects the bank holding the most recent consolidation, and reads its consolidated data into the cache.
+ * Does not consider the write log.
+ */
+static wear_leveling_status_t wear_leveling_read_consolidated(void) {
+    wl_dprintf("Reading consolidated data\n");
+
+    uint32_t sequence[2];
+    bool     valid[2];
+    for (int i = 0; i < 2; ++i) {
+        valid[i] = wear_leveling_read_bank(i * (WEAR_LEVELING_BANK_SIZE), &sequence[i]);
+    }
+
+    // Sequence numbers are compared so that wrapping around is handled
+    int bank = (valid[1] && (!valid[0] || (int32_t)(sequence[1] - sequence[0]) > 0)) ? 1 : 0;
+
+    wear_leveling.bank_address = bank * (WEAR_LEVELING_BANK_SIZE);
+    if (!valid[bank]) {
+        // Neither bank has been committed, which will cater for the completely clean MCU case.
+        wl_dprintf("No valid bank, clearing cache\n");
+        wear_leveling.sequence = 0;
+        wear_leveling_clear_cache();
+        return WEAR_LEVELING_SUCCESS;
+    }
+
+    wl_dprintf("Using bank %d\n", bank);
+    wear_leveling.sequence      = sequence[bank];
+    wear_leveling.write_address = wear_leveling.bank_address + (WEAR_LEVELING_LOG_START);
+    if (bank == 0 && !wear_leveling_read_bank(0, &sequence[0])) {
+        wear_leveling_clear_cache();
+        return WEAR_LEVELING_FAILED;
+    }
+    return WEAR_LEVELING_SUCCESS;
+}
+
+/**
+ * Records the time spent in a wear-leveling call, if it's the longest so far.
+ */
+static void wear_leveling_record_stall(uint32_t start) {
+    uint32_t stall = timer_read32() - start;
+    if (stall > wear_leveling.stats.stall_max) {
+        wear_leveling.stats.stall_max = stall;
+    }
+}
+
+/**
+ * Starts consolidating the cache into the other bank.
+ */
+static void wear_leveling_consolidation_begin(void) {
+    wl_dprintf("Starting consolidation into bank at 0x%04X\n", (int)TARGET_BANK_ADDRESS);
+    wear_leveling.state         = CONSOLIDATION_ERASING;
+    wear_leveling.target_offset = 0;
+    wear_leveling.mirror        = false;
+}
+
+/**
+ * Performs the next step of consolidating the cache into the other bank.
+ * The bank in use is not touched, so a power loss at any point leaves it valid.
+ * The backing store must already be unlocked.
+ */
+static wear_leveling_status_t wear_leveling_consolidation_step(void) {
+    const uint32_t target = TARGET_BANK_ADDRESS;
+    bool           ok     = true;
+
+    switch (wear_leveling.state) {
+        case CONSOLIDATION_ERASING:
+            ok = backing_store_erase_page(target + wear_leveling.target_offset);
+            wear_leveling.target_offset += (WEAR_LEVELING_BACKING_PAGE_SIZE);
+            if (wear_leveling.target_offset >= (WEAR_LEVELING_BANK_SIZE)) {
+                wear_leveling.state                = CONSOLIDATION_COPYING;
+                wear_leveling.target_offset        = 0;
+                wear_leveling.target_hash          = FNV1A_64_INIT;
+                wear_leveling.target_write_address = target + (WEAR_LEVELING_LOG_START);
+            }
+            break;
+
+        case CONSOLIDATION_COPYING: {
+            const uint32_t offset = wear_leveling.target_offset;
+            const uint32_t remaining = (WEAR_LEVELING_LOGICAL_SIZE) - offset;
+            const uint32_t length    = remaining < (WEAR_LEVELING_CONSOLIDATION_STEP_SIZE) ? remaining : (WEAR_LEVELING_CONSOLIDATION_STEP_SIZE);
+            ok                       = backing_store_write_bulk(target + offset, (backing_store_int_t *)&wear_leveling.cache[offset], length / sizeof(backing_store_int_t));
+            // The hash covers the data as it was copied, as the cache may change before the copy is complete
+            wear_leveling.target_hash = fnv_64a_buf(&wear_leveling.cache[offset], length, wear_leveling.target_hash);
+            wear_leveling.target_offset += length;
+            if (wear_leveling.target_offset >= (WEAR_LEVELING_LOGICAL_SIZE)) {
+                wear_leveling.state = CONSOLIDATION_COMMITTING;
+            }
+        } break;
+
+        case CONSOLIDATION_COMMITTING: {
+            write_log_entry_t header = {.raw64 = 0};
+            header.raw32[0]          = wear_leveling.sequence + 1;
+            write_log_entry_t hash   = {.raw64 = fnv_64a_buf(header.raw8, sizeof(header), wear_leveling.target_hash)};
+
+            // The hash is written last, as the bank only becomes valid once it's complete
+            ok = wear_leveling_write_header(target + (WEAR_LEVELING_LOGICAL_SIZE) + 8, &header) && wear_leveling_write_header(target + (WEAR_LEVELING_LOGICAL_SIZE), &hash);
+            if (ok) {
+                wl_dprintf("Consolidation committed, sequence %lu\n", (unsigned long)header.raw32[0]);
+                wear_leveling.bank_address  = target;
+                wear_leveling.sequence      = header.raw32[0];
+                wear_leveling.write_address = wear_leveling.target_write_address;
+                wear_leveling.state         = CONSOLIDATION_IDLE;
+                wear_leveling.mirror        = false;
+                return WEAR_LEVELING_CONSOLIDATED;
+            }
+        } break;
+
+        default:
+            return WEAR_LEVELING_SUCCESS;
+    }
+
+    if (!ok) {
+        // Start over next time, as the other bank is in an unknown state
+        wl_dprintf("Failed to consolidate into other bank\n");
+        wear_leveling.state  = CONSOLIDATION_IDLE;
+        wear_leveling.mirror = false;
+        return WEAR_LEVELING_FAILED;
+    }
+    return WEAR_LEVELING_SUCCESS;
 }
 
+/**
+ * Forces a consolidation of the current cache, restarting any consolidation in progress and completing it in-line.
+ * Power-loss safe, as the bank in use is only replaced once the other bank has been committed.
+ */
+static wear_leveling_status_t wear_leveling_consolidate_force(void) {
+    wl_dprintf("Consolidating in-line\n");
+
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    wear_leveling_status_t      status      = WEAR_LEVELING_SUCCESS;
+    wear_leveling_consolidation_begin();
+    while (status == WEAR_LEVELING_SUCCESS) {
+        status = wear_leveling_consolidation_step();
+    }
+
+    if (status == WEAR_LEVELING_CONSOLIDATED) {
+        wear_leveling.stats.forced++;
+    }
+
+    if (lock_status == STATUS_SUCCESS) {
+        wear_leveling_lock();
+    }
+    return status;
+}
+#else
 /**
  * Reads the consolidated data from the backing store into the cache.
  * Does not consider the write log.
@@ -316,10 +560,11 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
     }
 
     // Next write of the log occurs after the consolidated values at the start of the backing store.
-    wear_leveling.write_address = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
+    wear_leveling.write_address = (WEAR_LEVELING_LOG_START); // the write log follows the FNV1a_64 of the consolidated area
 
     return status;
 }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
 /**
  * Potential write of the current cache to the backing store.
@@ -329,9 +574,15 @@ static wear_leveling_status_t wear_leveling_consolidate_force(void) {
  * @return true if consolidation occurred
  */
 static wear_leveling_status_t wear_leveling_consolidate_if_needed(void) {
-    if (wear_leveling.write_address >= (WEAR_LEVELING_BACKING_SIZE)) {
+    if (wear_leveling.write_address >= ACTIVE_BANK_ADDRESS + (WEAR_LEVELING_BANK_SIZE)) {
+        return wear_leveling_consolidate_force();
+    }
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    if (wear_leveling.mirror && wear_leveling.target_write_address >= TARGET_BANK_ADDRESS + (WEAR_LEVELING_BANK_SIZE)) {
         return wear_leveling_consolidate_force();
     }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
     return WEAR_LEVELING_SUCCESS;
 }
@@ -348,6 +599,19 @@ static wear_leveling_status_t wear_leveling_append_raw(backing_store_int_t value
         return WEAR_LEVELING_FAILED;
     }
     wear_leveling.write_address += (BACKING_STORE_WRITE_SIZE);
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    // Entries for data already copied into the other bank are needed there too, in case that bank gets committed
+    if (wear_leveling.mirror) {
+        ok = backing_store_write(wear_leveling.target_write_address, value);
+        if (!ok) {
+            wl_dprintf("Failed to write to backing store\n");
+            return WEAR_LEVELING_FAILED;
+        }
+        wear_leveling.target_write_address += (BACKING_STORE_WRITE_SIZE);
+    }
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
     return wear_leveling_consolidate_if_needed();
 }
 
@@ -477,8 +741,8 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 
     wear_leveling_status_t status          = WEAR_LEVELING_SUCCESS;
     bool                   cancel_playback = false;
-    uint32_t               address         = (WEAR_LEVELING_LOGICAL_SIZE) + 8; // +8 due to the FNV1a_64 of the consolidated area
-    while (!cancel_playback && address < (WEAR_LEVELING_BACKING_SIZE)) {
+    uint32_t               address         = ACTIVE_BANK_ADDRESS + (WEAR_LEVELING_LOG_START); // the write log follows the header of the consolidated area
+    while (!cancel_playback && address < ACTIVE_BANK_ADDRESS + (WEAR_LEVELING_BANK_SIZE)) {
         backing_store_int_t value;
         bool                ok = backing_store_read(address, &value);
         if (!ok) {
@@ -617,6 +881,14 @@ static wear_leveling_status_t wear_leveling_playback_log(void) {
 wear_leveling_status_t wear_leveling_init(void) {
     wl_dprintf("Init\n");
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    // Reset the consolidation state, the bank in use is determined when reading the consolidated data
+    wear_leveling.bank_address = 0;
+    wear_leveling.state        = CONSOLIDATION_IDLE;
+    wear_leveling.mirror       = false;
+    memset(&wear_leveling.stats, 0, sizeof(wear_leveling.stats));
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
     // Reset the cache
     wear_leveling_clear_cache();
 
@@ -661,6 +933,11 @@ wear_leveling_status_t wear_leveling_erase(void) {
 
     // Perform the erase
     bool ret = backing_store_erase();
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    wear_leveling.bank_address = 0;
+    wear_leveling.sequence     = 0;
+    wear_leveling.state        = CONSOLIDATION_IDLE;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
     wear_leveling_clear_cache();
 
     // Lock the backing store if we acquired the lock successfully
@@ -698,6 +975,13 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
         return WEAR_LEVELING_FAILED;
     }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    const uint32_t stall_start = timer_read32();
+
+    // Data already copied into the other bank won't pick up this write from the cache
+    wear_leveling.mirror = (wear_leveling.state == CONSOLIDATION_COPYING || wear_leveling.state == CONSOLIDATION_COMMITTING) && address < wear_leveling.target_offset;
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
     // Perform the actual write
     wear_leveling_status_t status = wear_leveling_write_raw(address, value, length);
     switch (status) {
@@ -717,15 +1001,65 @@ wear_leveling_status_t wear_leveling_write(const uint32_t address, const void *v
             break;
     }
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+    wear_leveling.mirror = false;
+    wear_leveling_record_stall(stall_start);
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
+    if (lock_status == STATUS_SUCCESS) {
+        if (wear_leveling_lock() == STATUS_FAILURE) {
+            status = WEAR_LEVELING_FAILED;
+        }
+    }
+
+    return status;
+}
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * Performs the next step of a background consolidation, starting one once the write log is half full.
+ */
+wear_leveling_status_t wear_leveling_task(void) {
+    if (wear_leveling.state == CONSOLIDATION_IDLE) {
+        // Leave the second half of the write log to absorb writes made while consolidating
+        if (wear_leveling.write_address - wear_leveling.bank_address < (WEAR_LEVELING_LOG_START) + ((WEAR_LEVELING_BANK_SIZE) - (WEAR_LEVELING_LOG_START)) / 2) {
+            return WEAR_LEVELING_SUCCESS;
+        }
+        wear_leveling_consolidation_begin();
+    }
+
+    const uint32_t stall_start = timer_read32();
+
+    // Unlock the backing store
+    backing_store_lock_status_t lock_status = wear_leveling_unlock();
+    if (lock_status == STATUS_FAILURE) {
+        wear_leveling_lock();
+        return WEAR_LEVELING_FAILED;
+    }
+
+    wear_leveling_status_t status = wear_leveling_consolidation_step();
+    if (status == WEAR_LEVELING_CONSOLIDATED) {
+        wear_leveling.stats.consolidations++;
+    }
+
     if (lock_status == STATUS_SUCCESS) {
         if (wear_leveling_lock() == STATUS_FAILURE) {
             status = WEAR_LEVELING_FAILED;
         }
     }
 
+    wear_leveling_record_stall(stall_start);
     return status;
 }
 
+/**
+ * Retrieves the statistics gathered since initialization.
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t *stats) {
+    *stats = wear_leveling.stats;
+}
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
 /**
  * Reads logical data from the cache.
  */
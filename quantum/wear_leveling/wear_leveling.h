@@ -52,3 +52,31 @@ wear_leveling_status_t wear_leveling_write(uint32_t address, const void* value,
  * @return Status of the request
  */
 wear_leveling_status_t wear_leveling_read(uint32_t address, void* value, size_t length);
+
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+/**
+ * @typedef Statistics gathered while consolidating in the background.
+ */
+typedef struct wear_leveling_stats_t {
+    uint32_t stall_max;      //< Longest time spent in a single wear-leveling call, in milliseconds
+    uint16_t consolidations; //< Consolidations completed in the background
+    uint16_t forced;         //< Consolidations completed synchronously, as the write log filled up before the background one finished
+} wear_leveling_stats_t;
+
+/**
+ * Performs the next step of a background consolidation, starting one once the write log is half full.
+ *
+ * Each step erases at most one page or writes at most WEAR_LEVELING_CONSOLIDATION_STEP_SIZE bytes, and reads keep
+ * being served from the cache throughout.
+ *
+ * @return Status of the request, WEAR_LEVELING_CONSOLIDATED once a consolidation has been committed
+ */
+wear_leveling_status_t wear_leveling_task(void);
+
+/**
+ * Retrieves the statistics gathered since initialization.
+ *
+ * @param stats[out] destination for the statistics
+ */
+void wear_leveling_get_stats(wear_leveling_stats_t* stats);
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
@@ -61,15 +61,40 @@ typedef uint64_t backing_store_int_t;
         } while (0)
 #endif // WEAR_LEVELING_ASSERTS
 
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+#    ifndef WEAR_LEVELING_BACKING_PAGE_SIZE
+#        error WEAR_LEVELING_BACKING_PAGE_SIZE was not set.
+#    endif
+// Number of bytes of consolidated data written by each step of a background consolidation
+#    ifndef WEAR_LEVELING_CONSOLIDATION_STEP_SIZE
+#        define WEAR_LEVELING_CONSOLIDATION_STEP_SIZE 64
+#    endif
+// The backing store is split into two banks, each with its own consolidated data and write log
+#    define WEAR_LEVELING_BANK_SIZE ((WEAR_LEVELING_BACKING_SIZE) / 2)
+#    define WEAR_LEVELING_HEADER_SIZE 16 // FNV1a_64 of the consolidated data and sequence number, followed by the sequence number
+#else
+#    define WEAR_LEVELING_BANK_SIZE (WEAR_LEVELING_BACKING_SIZE)
+#    define WEAR_LEVELING_HEADER_SIZE 8 // FNV1a_64 of the consolidated data
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+
+// Offset of the write log from the start of its bank
+#define WEAR_LEVELING_LOG_START ((WEAR_LEVELING_LOGICAL_SIZE) + (WEAR_LEVELING_HEADER_SIZE))
+
 // Compile-time validation of configurable options
 _Static_assert(WEAR_LEVELING_BACKING_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "Total backing size must be at least twice the size of the logical size");
 _Static_assert(WEAR_LEVELING_LOGICAL_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Logical size must be a multiple of write size");
 _Static_assert(WEAR_LEVELING_BACKING_SIZE % WEAR_LEVELING_LOGICAL_SIZE == 0, "Backing size must be a multiple of logical size");
+#ifdef WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
+_Static_assert(WEAR_LEVELING_BANK_SIZE >= (WEAR_LEVELING_LOGICAL_SIZE * 2), "Each bank must be at least twice the size of the logical size");
+_Static_assert(WEAR_LEVELING_BANK_SIZE % WEAR_LEVELING_BACKING_PAGE_SIZE == 0, "Bank size must be a multiple of page size");
+_Static_assert(WEAR_LEVELING_CONSOLIDATION_STEP_SIZE % BACKING_STORE_WRITE_SIZE == 0, "Consolidation step size must be a multiple of write size");
+#endif // WEAR_LEVELING_INCREMENTAL_CONSOLIDATION
 
 // Backing Store API, to be implemented elsewhere by flash driver etc.
 bool backing_store_init(void);
 bool backing_store_unlock(void);
 bool backing_store_erase(void);
+bool backing_store_erase_page(uint32_t address); // only required by WEAR_LEVELING_INCREMENTAL_CONSOLIDATION, erases the WEAR_LEVELING_BACKING_PAGE_SIZE bytes starting at address
 bool backing_store_write(uint32_t address, backing_store_int_t value);
 bool backing_store_write_bulk(uint32_t address, backing_store_int_t* values, size_t item_count); // weak implementation already provided, optimized implementation can be implemented by driver
 bool backing_store_lock(void);
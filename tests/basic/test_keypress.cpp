@@ -290,3 +290,66 @@ TEST_F(KeyPress, PressEqualPlusDontReleaseBeforePress) {
     run_one_scan_loop();
     testing::Mock::VerifyAndClearExpectations(&driver);
 }
+
+TEST_F(KeyPress, SeventhKeyIsNotReportedWhileSixAreHeld) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_a = KeymapKey(0, 0, 0, KC_A);
+    auto       key_b = KeymapKey(0, 1, 0, KC_B);
+    auto       key_c = KeymapKey(0, 2, 0, KC_C);
+    auto       key_d = KeymapKey(0, 3, 0, KC_D);
+    auto       key_e = KeymapKey(0, 4, 0, KC_E);
+    auto       key_f = KeymapKey(0, 5, 0, KC_F);
+    auto       key_g = KeymapKey(0, 6, 0, KC_G);
+
+    set_keymap({key_a, key_b, key_c, key_d, key_e, key_f, key_g});
+
+    key_g.press();
+    EXPECT_REPORT(driver, (KC_G));
+    run_one_scan_loop();
+    key_f.press();
+    EXPECT_REPORT(driver, (KC_G, KC_F));
+    run_one_scan_loop();
+    key_e.press();
+    EXPECT_REPORT(driver, (KC_G, KC_F, KC_E));
+    run_one_scan_loop();
+    key_d.press();
+    EXPECT_REPORT(driver, (KC_G, KC_F, KC_E, KC_D));
+    run_one_scan_loop();
+    key_c.press();
+    EXPECT_REPORT(driver, (KC_G, KC_F, KC_E, KC_D, KC_C));
+    run_one_scan_loop();
+    key_b.press();
+    EXPECT_REPORT(driver, (KC_G, KC_F, KC_E, KC_D, KC_C, KC_B));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    // No slot left, and none of the held keys may be dropped to make room
+    key_a.press();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_g.release();
+    EXPECT_REPORT(driver, (KC_F, KC_E, KC_D, KC_C, KC_B));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_a.release();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    key_b.release();
+    key_c.release();
+    key_d.release();
+    key_e.release();
+    key_f.release();
+    EXPECT_REPORT(driver, (KC_F, KC_E, KC_D, KC_C));
+    EXPECT_REPORT(driver, (KC_F, KC_E, KC_D));
+    EXPECT_REPORT(driver, (KC_F, KC_E));
+    EXPECT_REPORT(driver, (KC_F));
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
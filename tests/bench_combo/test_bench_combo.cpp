@@ -0,0 +1,40 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "keycode.h"
+#include "process_combo.h"
+}
+
+// Home row and bottom row pairs, which chords in the steno workload will regularly hit
+static const uint16_t PROGMEM combo_df[]   = {KC_D, KC_F, COMBO_END};
+static const uint16_t PROGMEM combo_jk[]   = {KC_J, KC_K, COMBO_END};
+static const uint16_t PROGMEM combo_sd[]   = {KC_S, KC_D, COMBO_END};
+static const uint16_t PROGMEM combo_kl[]   = {KC_K, KC_L, COMBO_END};
+static const uint16_t PROGMEM combo_xc[]   = {KC_X, KC_C, COMBO_END};
+static const uint16_t PROGMEM combo_mc[]   = {KC_M, KC_COMM, COMBO_END};
+static const uint16_t PROGMEM combo_we[]   = {KC_W, KC_E, COMBO_END};
+static const uint16_t PROGMEM combo_asd[]  = {KC_A, KC_S, KC_D, COMBO_END};
+
+extern "C" {
+combo_t key_combos[] = {
+    COMBO(combo_df, KC_TAB),  COMBO(combo_jk, KC_ESC),  COMBO(combo_sd, KC_LBRC), COMBO(combo_kl, KC_RBRC),
+    COMBO(combo_xc, KC_COPY), COMBO(combo_mc, KC_MINS), COMBO(combo_we, KC_EQL),  COMBO(combo_asd, KC_CAPS),
+};
+uint16_t COMBO_LEN = sizeof(key_combos) / sizeof(key_combos[0]);
+}
@@ -0,0 +1,26 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "quantum.h"
+
+// Shifted overrides, so that every capital letter in the prose workload is checked against them
+static const key_override_t shift_bspc = ko_make_basic(MOD_MASK_SHIFT, KC_BSPC, KC_DEL);
+static const key_override_t shift_comm = ko_make_basic(MOD_MASK_SHIFT, KC_COMM, KC_SCLN);
+static const key_override_t shift_dot  = ko_make_basic(MOD_MASK_SHIFT, KC_DOT, KC_QUOT);
+static const key_override_t ctrl_h     = ko_make_basic(MOD_MASK_CTRL, KC_H, KC_LEFT);
+static const key_override_t ctrl_l     = ko_make_basic(MOD_MASK_CTRL, KC_L, KC_RGHT);
+
+const key_override_t **key_overrides = (const key_override_t *[]){&shift_bspc, &shift_comm, &shift_dot, &ctrl_h, &ctrl_l, NULL};
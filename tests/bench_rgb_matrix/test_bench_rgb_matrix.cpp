@@ -0,0 +1,86 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+extern "C" {
+#include "rgb_matrix.h"
+
+// One LED under each key, spread over the usual 224x64 grid
+// clang-format off
+led_config_t g_led_config = {
+    {
+        { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9},
+        {10, 11, 12, 13, 14, 15, 16, 17, 18, 19},
+        {20, 21, 22, 23, 24, 25, 26, 27, 28, 29},
+        {30, 31, 32, 33, 34, 35, 36, 37, 38, 39},
+    }, {
+        {  0,  0}, { 24,  0}, { 49,  0}, { 74,  0}, { 99,  0}, {124,  0}, {149,  0}, {174,  0}, {199,  0}, {224,  0},
+        {  0, 21}, { 24, 21}, { 49, 21}, { 74, 21}, { 99, 21}, {124, 21}, {149, 21}, {174, 21}, {199, 21}, {224, 21},
+        {  0, 42}, { 24, 42}, { 49, 42}, { 74, 42}, { 99, 42}, {124, 42}, {149, 42}, {174, 42}, {199, 42}, {224, 42},
+        {  0, 64}, { 24, 64}, { 49, 64}, { 74, 64}, { 99, 64}, {124, 64}, {149, 64}, {174, 64}, {199, 64}, {224, 64},
+    }, {
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        4, 4, 4, 4, 4, 4, 4, 4, 4, 4,
+        1, 1, 1, 1, 4, 4, 1, 1, 1, 1,
+    }
+};
+// clang-format on
+
+static void bench_rgb_init(void) {}
+static void bench_rgb_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {}
+static void bench_rgb_set_color_all(uint8_t red, uint8_t green, uint8_t blue) {}
+static void bench_rgb_flush(void) {}
+
+const rgb_matrix_driver_t rgb_matrix_driver = {
+    .init          = bench_rgb_init,
+    .set_color     = bench_rgb_set_color,
+    .set_color_all = bench_rgb_set_color_all,
+    .flush         = bench_rgb_flush,
+};
+}
+
+/* Each workload under a background animation, a reactive effect and two framebuffer effects,
+ * the Bench suite covering the default effect */
+class BenchRgbMatrix : public BenchFixture, public testing::WithParamInterface<std::tuple<uint8_t, std::string>> {};
+
+TEST_P(BenchRgbMatrix, Workload) {
+    rgb_matrix_enable_noeeprom();
+    rgb_matrix_mode_noeeprom(std::get<0>(GetParam()));
+    run_workload(std::get<1>(GetParam()));
+}
+
+static std::string effect_name(uint8_t effect) {
+    switch (effect) {
+        case RGB_MATRIX_CYCLE_SPIRAL:
+            return "CycleSpiral";
+        case RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE:
+            return "SolidReactiveMultiwide";
+        case RGB_MATRIX_SPLASH:
+            return "Splash";
+        case RGB_MATRIX_TYPING_HEATMAP:
+            return "TypingHeatmap";
+        default:
+            return std::to_string(effect);
+    }
+}
+
+static std::string test_name(const testing::TestParamInfo<std::tuple<uint8_t, std::string>>& info) {
+    return effect_name(std::get<0>(info.param)) + bench_workload_name(std::get<1>(info.param));
+}
+
+INSTANTIATE_TEST_CASE_P(Effects, BenchRgbMatrix, testing::Combine(testing::Values(RGB_MATRIX_CYCLE_SPIRAL, RGB_MATRIX_SOLID_REACTIVE_MULTIWIDE, RGB_MATRIX_SPLASH, RGB_MATRIX_TYPING_HEATMAP), testing::ValuesIn(bench_workloads())), test_name);
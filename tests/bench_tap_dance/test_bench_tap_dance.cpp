@@ -0,0 +1,26 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+#include "test_common.hpp"
+
+/* Tap dances (see tap_dances.c) on keys that all three workloads press often */
+void bench_setup(BenchFixture& fixture) {
+    fixture.remap(KeymapKey(0, 2, 0, TD(0)));
+    fixture.remap(KeymapKey(0, 4, 0, TD(1)));
+    fixture.remap(KeymapKey(0, 9, 1, TD(2)));
+    fixture.remap(KeymapKey(0, 4, 3, TD(3)));
+}
@@ -0,0 +1,113 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+#define MAX_TEST_COMBOS 1000
+
+extern "C" {
+uint16_t COMBO_LEN = MAX_TEST_COMBOS;
+combo_t  key_combos[MAX_TEST_COMBOS];
+
+static uint16_t combo_keys[MAX_TEST_COMBOS][3];
+}
+
+namespace {
+
+// Combo 0 is KC_A + KC_B = KC_C, every other combo chords two keycodes that
+// are never typed, so that it only adds to the number of combos to search.
+void setup_combos(uint16_t count) {
+    for (uint16_t i = 0; i < MAX_TEST_COMBOS; i++) {
+        if (i == 0) {
+            combo_keys[i][0] = KC_A;
+            combo_keys[i][1] = KC_B;
+        } else {
+            combo_keys[i][0] = SAFE_RANGE + 2 * i;
+            combo_keys[i][1] = SAFE_RANGE + 2 * i + 1;
+        }
+        combo_keys[i][2] = COMBO_END;
+        key_combos[i]    = (combo_t)COMBO(combo_keys[i], i == 0 ? KC_C : KC_NO);
+    }
+    COMBO_LEN = count;
+}
+
+class Combo : public TestFixture {};
+
+TEST_F(Combo, ComboFiresAmongManyCombos) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_b(0, 1, 0, KC_B);
+    set_keymap({key_a, key_b});
+    setup_combos(MAX_TEST_COMBOS);
+
+    {
+        InSequence s;
+        EXPECT_REPORT(driver, (KC_C));
+        EXPECT_EMPTY_REPORT(driver);
+        EXPECT_REPORT(driver, (KC_A));
+        EXPECT_EMPTY_REPORT(driver);
+    }
+
+    tap_combo({key_a, key_b});
+    tap_key(key_a);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+class ComboBenchmark : public TestFixture, public ::testing::WithParamInterface<uint16_t> {};
+
+// Measures key events per second through the whole pipeline. Combo 0 shares
+// KC_A, so every tap of it goes through the combo key buffer as well.
+TEST_P(ComboBenchmark, EventsPerSecond) {
+    TestDriver driver;
+    KeymapKey  key_a(0, 0, 0, KC_A);
+    KeymapKey  key_1(0, 2, 0, KC_1);
+    set_keymap({key_a, key_1});
+    setup_combos(GetParam());
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    const unsigned iterations = 2000;
+    auto           start      = std::chrono::steady_clock::now();
+    for (unsigned i = 0; i < iterations; i++) {
+        tap_key(key_a);
+        tap_key(key_1);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    // Every tap is one press and one release event.
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double events  = iterations * 4;
+    std::cout << "[ BENCHMARK] " << GetParam() << " combos: " << static_cast<uint64_t>(events / seconds) << " events/sec" << std::endl;
+    RecordProperty("events_per_second", static_cast<int>(events / seconds));
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+INSTANTIATE_TEST_CASE_P(Combos, ComboBenchmark, ::testing::Values(10, 100, 1000));
+
+} // namespace
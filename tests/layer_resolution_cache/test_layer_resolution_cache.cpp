@@ -0,0 +1,189 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+using testing::_;
+using testing::InSequence;
+
+#define TEST_LAYER_COUNT 6
+
+class LayerResolutionCache : public TestFixture {
+   protected:
+    /* Every key is mapped on every layer, as the cache resolves the whole matrix at once. Layer 0 is fully opaque and
+     * the upper layers are a scattering of opaque keys over transparent ones, so that each key resolves differently. */
+    void set_layered_keymap(uint8_t changed_layer = 0, keypos_t changed_key = {.col = 0, .row = 0}, uint16_t changed_code = KC_NO) {
+        keymap.clear();
+        for (uint8_t layer = 0; layer < TEST_LAYER_COUNT; layer++) {
+            for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+                for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                    uint16_t code = (layer == 0 || (layer * 7 + row * 3 + col) % 4 == 0) ? KC_A + layer : KC_TRANSPARENT;
+                    if (layer == changed_layer && row == changed_key.row && col == changed_key.col) {
+                        code = changed_code;
+                    }
+                    add_key(KeymapKey(layer, col, row, code));
+                }
+            }
+        }
+        layer_resolution_cache_invalidate();
+    }
+
+    /* Reference resolution, walking the layers the way the uncached lookup does */
+    uint8_t resolve(keypos_t key) const {
+        layer_state_t layers = layer_state | default_layer_state;
+        for (int8_t layer = TEST_LAYER_COUNT - 1; layer >= 0; layer--) {
+            if ((layers & ((layer_state_t)1 << layer)) && find_key(layer, key)->code != KC_TRANSPARENT) {
+                return layer;
+            }
+        }
+        return 0;
+    }
+
+    void expect_cache_matches(void) const {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keypos_t key = {.col = col, .row = row};
+                EXPECT_EQ(layer_switch_get_layer(key), resolve(key)) << "layers " << (layer_state | default_layer_state) << " key (" << +col << "," << +row << ")";
+            }
+        }
+    }
+};
+
+TEST_F(LayerResolutionCache, MatchesLayerWalkAcrossLayerChanges) {
+    TestDriver driver;
+    set_layered_keymap();
+
+    expect_cache_matches();
+
+    /* Every combination of upper layers, reached by flipping one or more layers at a time */
+    for (layer_state_t state = 0; state < (1 << TEST_LAYER_COUNT); state++) {
+        layer_state_set(state);
+        expect_cache_matches();
+        layer_state_set(state ^ ((1 << TEST_LAYER_COUNT) - 1));
+        expect_cache_matches();
+    }
+
+    layer_clear();
+    expect_cache_matches();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerResolutionCache, MatchesLayerWalkAcrossDefaultLayerChanges) {
+    TestDriver driver;
+    set_layered_keymap();
+
+    /* Default layer without layer 0 underneath, so keys transparent all the way down fall back to layer 0 */
+    default_layer_set((layer_state_t)1 << 2);
+    expect_cache_matches();
+    layer_on(4);
+    expect_cache_matches();
+    default_layer_set((layer_state_t)1 << 1);
+    expect_cache_matches();
+    layer_off(4);
+    default_layer_set(1);
+    expect_cache_matches();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerResolutionCache, RefreshesEditedKey) {
+    TestDriver driver;
+    keypos_t   key = {.col = 3, .row = 2};
+    set_layered_keymap();
+
+    layer_state_set(0b111110);
+    expect_cache_matches();
+
+    /* Make the key opaque on layer 5, as a dynamic keymap edit would */
+    set_layered_keymap(5, key, KC_Z);
+    layer_state_set(0b111110);
+    expect_cache_matches();
+    EXPECT_EQ(layer_switch_get_layer(key), 5);
+
+    /* Now transparent on every upper layer, refreshing just that key */
+    keymap.clear();
+    for (uint8_t layer = 0; layer < TEST_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                bool     edited = row == key.row && col == key.col;
+                uint16_t code   = (layer == 0 || (!edited && (layer * 7 + row * 3 + col) % 4 == 0)) ? KC_A + layer : KC_TRANSPARENT;
+                add_key(KeymapKey(layer, col, row, code));
+            }
+        }
+    }
+    layer_resolution_cache_refresh_key(key);
+    EXPECT_EQ(layer_switch_get_layer(key), 0);
+    expect_cache_matches();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(LayerResolutionCache, MomentaryLayerUsesResolvedLayer) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_layer = KeymapKey(0, 0, 0, MO(3));
+    auto       key_a     = KeymapKey(0, 1, 0, KC_A);
+
+    /* Position (1,0) is opaque on layer 3 only, so holding MO(3) must send layer 3's keycode */
+    keymap.clear();
+    for (uint8_t layer = 0; layer < TEST_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                if (layer == 0 && row == 0 && col == 0) {
+                    add_key(key_layer);
+                } else if (layer == 0 && row == 0 && col == 1) {
+                    add_key(key_a);
+                } else if (layer == 3 && row == 0 && col == 1) {
+                    add_key(KeymapKey(3, 1, 0, KC_B));
+                } else {
+                    add_key(KeymapKey(layer, col, row, layer == 0 ? KC_NO : KC_TRANSPARENT));
+                }
+            }
+        }
+    }
+    layer_resolution_cache_invalidate();
+
+    key_a.press();
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    key_a.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+
+    key_layer.press();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+    key_a.press();
+    EXPECT_REPORT(driver, (KC_B));
+    run_one_scan_loop();
+    key_a.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    key_layer.release();
+    EXPECT_NO_REPORT(driver);
+    run_one_scan_loop();
+
+    key_a.press();
+    EXPECT_REPORT(driver, (KC_A));
+    run_one_scan_loop();
+    key_a.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
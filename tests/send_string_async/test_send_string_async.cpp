@@ -0,0 +1,229 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+#include "keyboard_report_util.hpp"
+#include "test_common.hpp"
+
+extern "C" {
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::AnyNumber;
+using testing::InSequence;
+
+/* Stands in for the USB endpoint: when busy, the previous report hasn't been taken by the host yet */
+static bool endpoint_busy = false;
+
+extern "C" bool keyboard_report_ready(void) {
+    return !endpoint_busy;
+}
+
+class SendStringAsync : public TestFixture {
+   protected:
+    void SetUp() override {
+        endpoint_busy = false;
+        send_string_async_cancel();
+    }
+
+    /* Runs the main loop until the player is done, returning the number of scans it took */
+    unsigned run_until_idle(unsigned limit = 10000) {
+        unsigned scans = 0;
+        while (send_string_async_active() && scans < limit) {
+            run_one_scan_loop();
+            scans++;
+        }
+        EXPECT_FALSE(send_string_async_active());
+        return scans;
+    }
+};
+
+TEST_F(SendStringAsync, TypesOneReportPerScan) {
+    TestDriver driver;
+    InSequence s;
+
+    /* Modifiers go out in the same report as the key they apply to */
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_LEFT_SHIFT, KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_ENTER));
+    EXPECT_EMPTY_REPORT(driver);
+
+    EXPECT_TRUE(send_string_async("aB" SS_TAP(X_ENTER)));
+    EXPECT_EQ(run_until_idle(), 7);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, WaitsForTheHost) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_X));
+    EXPECT_TRUE(send_string_async("x"));
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Nothing more goes out while the previous report is still waiting to be collected */
+    endpoint_busy = true;
+    EXPECT_NO_REPORT(driver);
+    idle_for(10);
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    endpoint_busy = false;
+    EXPECT_EMPTY_REPORT(driver);
+    run_until_idle();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, KeepsScanningWhileTyping) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_c = KeymapKey(0, 1, 0, KC_C);
+    set_keymap({key_c});
+
+    EXPECT_REPORT(driver, (KC_A));
+    EXPECT_TRUE(send_string_async_with_delay("ab", 20));
+    run_one_scan_loop();
+
+    /* A key pressed in the middle of a delay is reported straight away */
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    key_c.press();
+    EXPECT_REPORT(driver, (KC_C));
+    run_one_scan_loop();
+    key_c.release();
+    EXPECT_EMPTY_REPORT(driver);
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_REPORT(driver, (KC_B));
+    EXPECT_EMPTY_REPORT(driver);
+    run_until_idle();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, DelaysWithoutBlocking) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+
+    uint32_t start = timer_read32();
+    EXPECT_TRUE(send_string_async("1" SS_DELAY(100) "2"));
+    run_until_idle();
+    EXPECT_GE(timer_elapsed32(start), 100);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, PlaysQueuedStringsInOrder) {
+    TestDriver driver;
+    InSequence s;
+
+    EXPECT_REPORT(driver, (KC_1));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_2));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_3));
+    EXPECT_EMPTY_REPORT(driver);
+    EXPECT_REPORT(driver, (KC_4));
+    EXPECT_EMPTY_REPORT(driver);
+
+    EXPECT_TRUE(send_string_async("1"));
+    EXPECT_TRUE(send_string_async("2"));
+    EXPECT_TRUE(send_string_async("3"));
+    EXPECT_TRUE(send_string_async("4"));
+    EXPECT_FALSE(send_string_async("5"));
+    run_until_idle();
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, CancelKeycodeStopsTypingAndReleasesKeys) {
+    TestDriver driver;
+    InSequence s;
+    auto       key_cancel = KeymapKey(0, 0, 0, QK_SEND_STRING_CANCEL);
+    set_keymap({key_cancel});
+
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL, KC_A));
+    EXPECT_TRUE(send_string_async(SS_DOWN(X_LCTL) "abc"));
+    run_one_scan_loop();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    /* Both the half-typed key and the held modifier are let go */
+    EXPECT_REPORT(driver, (KC_LEFT_CTRL));
+    EXPECT_EMPTY_REPORT(driver);
+    key_cancel.press();
+    run_one_scan_loop();
+    EXPECT_FALSE(send_string_async_active());
+    key_cancel.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_NO_REPORT(driver);
+    idle_for(10);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(SendStringAsync, Benchmark) {
+    TestDriver  driver;
+    std::string text = "The quick brown fox jumps over the lazy dog. ";
+    text += text;
+    text += text;
+
+    EXPECT_CALL(driver, send_keyboard_mock(_)).Times(AnyNumber());
+
+    /* The blocking version stalls the main loop for as long as it takes to type */
+    uint32_t start = timer_read32();
+    send_string_with_delay(text.c_str(), 1);
+    uint32_t blocking_stall = timer_elapsed32(start);
+
+    /* The background version types one report per scan, without holding up the loop */
+    uint32_t longest_stall = 0;
+    unsigned scans         = 0;
+    start                  = timer_read32();
+    EXPECT_TRUE(send_string_async_with_delay(text.c_str(), 1));
+    while (send_string_async_active()) {
+        uint32_t scan_start = timer_read32();
+        keyboard_task();
+        longest_stall = std::max(longest_stall, timer_elapsed32(scan_start));
+        advance_time(1);
+        scans++;
+    }
+    uint32_t total = timer_elapsed32(start);
+
+    std::printf("%u characters: blocking send_string stalled the main loop for %u ms; background send_string took %u ms over %u scans (%.2f characters/ms), longest stall %u ms\n", (unsigned)text.size(), (unsigned)blocking_stall, (unsigned)total, scans, (double)text.size() / total, (unsigned)longest_stall);
+    EXPECT_GE(blocking_stall, text.size());
+    EXPECT_EQ(longest_stall, 0);
+
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
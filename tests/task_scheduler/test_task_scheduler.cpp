@@ -0,0 +1,226 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#include "keyboard_report_util.hpp"
+#include "keycode.h"
+#include "test_common.hpp"
+#include "test_fixture.hpp"
+#include "test_keymap_key.hpp"
+
+extern "C" {
+#include "task_scheduler.h"
+
+void set_time(uint32_t t);
+void advance_time(uint32_t ms);
+}
+
+using testing::_;
+using testing::InSequence;
+
+class TaskScheduler : public TestFixture {};
+
+/* Tasks for a table of their own, a slow task spends its runtime by moving the test timer on */
+static uint32_t slow_task_ms = 0;
+
+static void slow_task(void) {
+    advance_time(slow_task_ms);
+}
+
+static void idle_task(void) {}
+
+class TaskSchedulerTable : public testing::Test {
+   protected:
+    void SetUp() override {
+        set_time(1000);
+        slow_task_ms = 0;
+        memset(stats, 0, sizeof(stats));
+    }
+
+    /* Runs a loop iteration, and moves the timer on by a millisecond if no task did */
+    void run_loop(const task_scheduler_task_t* tasks, uint8_t count) {
+        uint32_t start = timer_read32();
+        task_scheduler_run(tasks, stats, count);
+        if (timer_read32() == start) {
+            advance_time(1);
+        }
+    }
+
+    task_scheduler_stats_t stats[3];
+};
+
+static int find_task(const char* name) {
+    for (uint8_t i = 0; i < task_scheduler_count(); i++) {
+        if (strcmp(task_scheduler_get_task(i)->name, name) == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+TEST_F(TaskScheduler, KeypressIsReported) {
+    TestDriver driver;
+    auto       key = KeymapKey(0, 0, 0, KC_A);
+
+    set_keymap({key});
+
+    EXPECT_REPORT(driver, (KC_A));
+    key.press();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+
+    EXPECT_EMPTY_REPORT(driver);
+    key.release();
+    run_one_scan_loop();
+    testing::Mock::VerifyAndClearExpectations(&driver);
+}
+
+TEST_F(TaskScheduler, RealtimeTasksRunEveryLoop) {
+    TestDriver driver;
+
+    int matrix = find_task("matrix_scan_task");
+    ASSERT_GE(matrix, 0);
+    EXPECT_EQ(task_scheduler_get_task(matrix)->priority, TASK_PRIORITY_REALTIME);
+
+    task_scheduler_reset_stats();
+    for (int i = 0; i < 10; i++) {
+        run_one_scan_loop();
+    }
+    EXPECT_EQ(task_scheduler_get_stats(matrix)->runs, 10);
+    EXPECT_EQ(task_scheduler_get_stats(matrix)->postponed, 0);
+}
+
+TEST_F(TaskScheduler, RawHidStats) {
+    TestDriver driver;
+
+    int matrix = find_task("matrix_scan_task");
+    ASSERT_GE(matrix, 0);
+
+    task_scheduler_reset_stats();
+    for (int i = 0; i < 3; i++) {
+        run_one_scan_loop();
+    }
+
+    uint8_t data[32] = {TASK_SCHEDULER_RAW_HID_ID, (uint8_t)matrix};
+    task_scheduler_raw_hid_stats(data, sizeof(data));
+    EXPECT_EQ(data[2], task_scheduler_count());
+    EXPECT_EQ(data[3], 3);
+    EXPECT_EQ(data[4], 0);
+}
+
+TEST_F(TaskSchedulerTable, PeriodIsRespected) {
+    const task_scheduler_task_t tasks[] = {
+        TASK_SCHEDULER_TASK(idle_task, 10, TASK_PRIORITY_NORMAL),
+        TASK_SCHEDULER_TASK(idle_task, 10, TASK_PRIORITY_BULK),
+        TASK_SCHEDULER_TASK(idle_task, 10, TASK_PRIORITY_REALTIME),
+    };
+
+    for (int i = 0; i < 30; i++) {
+        run_loop(tasks, 3);
+    }
+    // Each task runs straight away, then once every period
+    EXPECT_EQ(stats[0].runs, 3);
+    EXPECT_EQ(stats[1].runs, 3);
+    EXPECT_EQ(stats[1].postponed, 0);
+    // Realtime tasks ignore the period
+    EXPECT_EQ(stats[2].runs, 30);
+}
+
+TEST_F(TaskSchedulerTable, BulkTaskRunsWithinBudget) {
+    const task_scheduler_task_t tasks[] = {
+        TASK_SCHEDULER_TASK(slow_task, 0, TASK_PRIORITY_REALTIME),
+        TASK_SCHEDULER_TASK(idle_task, 0, TASK_PRIORITY_BULK),
+    };
+
+    for (int i = 0; i < 10; i++) {
+        run_loop(tasks, 2);
+    }
+    EXPECT_EQ(stats[1].runs, 10);
+    EXPECT_EQ(stats[1].postponed, 0);
+}
+
+TEST_F(TaskSchedulerTable, BudgetOverrunPostponesBulkTasks) {
+    const task_scheduler_task_t tasks[] = {
+        TASK_SCHEDULER_TASK(idle_task, 0, TASK_PRIORITY_BULK),
+        TASK_SCHEDULER_TASK(slow_task, 0, TASK_PRIORITY_REALTIME),
+        TASK_SCHEDULER_TASK(idle_task, 0, TASK_PRIORITY_BULK),
+    };
+
+    slow_task_ms = 2;
+    // The first loop runs everything, as nothing has run yet
+    run_loop(tasks, 3);
+    EXPECT_EQ(stats[2].runs, 1);
+    for (int i = 0; i < 10; i++) {
+        run_loop(tasks, 3);
+    }
+    // Only the bulk task that comes after the overrun is postponed
+    EXPECT_EQ(stats[0].runs, 11);
+    EXPECT_EQ(stats[0].postponed, 0);
+    EXPECT_EQ(stats[1].runs, 11);
+    EXPECT_EQ(stats[1].max_us, 2000);
+    EXPECT_EQ(stats[2].runs, 1);
+    EXPECT_EQ(stats[2].postponed, 10);
+
+    // It runs again once the loop is back within budget
+    slow_task_ms = 0;
+    run_loop(tasks, 3);
+    EXPECT_EQ(stats[2].runs, 2);
+    EXPECT_EQ(stats[2].postponed, 10);
+}
+
+TEST_F(TaskSchedulerTable, RuntimeDoesNotWrap) {
+    const task_scheduler_task_t tasks[] = {
+        TASK_SCHEDULER_TASK(slow_task, 0, TASK_PRIORITY_REALTIME),
+    };
+
+    // Well past the 71 minutes a 32 bit count of microseconds holds
+    slow_task_ms = 60000;
+    for (int i = 0; i < 100; i++) {
+        run_loop(tasks, 1);
+    }
+    EXPECT_EQ(stats[0].runs, 100);
+    EXPECT_EQ(stats[0].total_us, 100 * 60000000ULL);
+    EXPECT_EQ(stats[0].total_us / stats[0].runs, 60000000);
+}
+
+TEST_F(TaskSchedulerTable, PostponingIsLimited) {
+    const task_scheduler_task_t tasks[] = {
+        TASK_SCHEDULER_TASK(slow_task, 0, TASK_PRIORITY_REALTIME),
+        TASK_SCHEDULER_TASK(idle_task, 20, TASK_PRIORITY_BULK),
+    };
+    uint32_t last_run = 0;
+
+    slow_task_ms = 2;
+    run_loop(tasks, 2);
+    ASSERT_EQ(stats[1].runs, 1);
+    for (int i = 0; i < 500; i++) {
+        uint32_t runs = stats[1].runs;
+        uint32_t now  = timer_read32();
+        run_loop(tasks, 2);
+        if (stats[1].runs != runs) {
+            // Never overdue by more than the limit plus the loop it became overdue in
+            if (last_run) {
+                EXPECT_GE(now - last_run, 20 + TASK_SCHEDULER_MAX_POSTPONE_MS);
+                EXPECT_LE(now - last_run, 20 + TASK_SCHEDULER_MAX_POSTPONE_MS + slow_task_ms);
+            }
+            last_run = now;
+        }
+    }
+    // The budget is always overrun, so the task only ever runs when it has waited too long
+    EXPECT_GE(stats[1].runs, 500 * 2 / (20 + TASK_SCHEDULER_MAX_POSTPONE_MS));
+    EXPECT_GT(stats[1].postponed, 0);
+}
@@ -0,0 +1,252 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "bench.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+extern "C" {
+#include "host.h"
+#include "keycode.h"
+#include "test_matrix.h"
+#include "timer.h"
+
+void advance_time(uint32_t ms);
+}
+
+/* Heap allocations are counted by wrapping the C library allocator, which firmware and C++
+ * code both end up in. Only glibc offers a way to call the real one from the wrappers. */
+static bool    counting_allocations = false;
+static int64_t allocation_count     = 0;
+
+#if defined(__GLIBC__)
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+
+void* malloc(size_t size) {
+    allocation_count += counting_allocations;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size) {
+    allocation_count += counting_allocations;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* ptr, size_t size) {
+    allocation_count += counting_allocations;
+    return __libc_realloc(ptr, size);
+}
+}
+#    define BENCH_COUNTS_ALLOCATIONS
+#endif
+
+/* A host driver that only counts, so that mock bookkeeping doesn't end up in the timings */
+static BenchResult* current_result = nullptr;
+
+static uint8_t bench_keyboard_leds(void) {
+    return 0;
+}
+
+static void bench_send_keyboard(report_keyboard_t* report) {
+    current_result->keyboard_reports++;
+    current_result->keys_left_down = false;
+    for (uint8_t i = 0; i < sizeof(report->raw); i++) {
+        current_result->report_hash = (current_result->report_hash ^ report->raw[i]) * 16777619;
+        current_result->keys_left_down |= report->raw[i] != 0;
+    }
+}
+
+static void bench_send_mouse(report_mouse_t* report) {
+    current_result->mouse_reports++;
+}
+
+static void bench_send_extra(uint8_t report_id, uint16_t data) {
+    current_result->extra_reports++;
+}
+
+static host_driver_t bench_driver = {bench_keyboard_leds, bench_send_keyboard, bench_send_mouse, bench_send_extra};
+
+std::vector<BenchEvent> bench_load_trace(const std::string& name) {
+    std::string directory = std::getenv("QMK_BENCH_TRACE_DIR") ? std::getenv("QMK_BENCH_TRACE_DIR") : "tests/test_common/bench";
+    std::string path      = directory + "/" + name + ".trace";
+    std::ifstream           file(path);
+    std::vector<BenchEvent> events;
+    std::string             line;
+    unsigned                line_number = 0;
+
+    if (!file) {
+        ADD_FAILURE() << "Can't open trace " << path;
+        return events;
+    }
+
+    while (std::getline(file, line)) {
+        line_number++;
+        line = line.substr(0, line.find('#'));
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        uint32_t           time;
+        unsigned           row, col;
+        char               direction;
+        if (!(fields >> time >> row >> col >> direction) || (direction != 'd' && direction != 'u') || row >= MATRIX_ROWS || col >= MATRIX_COLS || (!events.empty() && time < events.back().time)) {
+            ADD_FAILURE() << path << ":" << line_number << ": invalid event \"" << line << "\"";
+            return {};
+        }
+        events.push_back({time, (uint8_t)row, (uint8_t)col, direction == 'd'});
+    }
+    return events;
+}
+
+BenchFixture::BenchFixture() {
+    // clang-format off
+    static const uint16_t qwerty[MATRIX_ROWS][MATRIX_COLS] = {
+        {KC_Q,    KC_W,    KC_E,    KC_R,    KC_T,   KC_Y,   KC_U,    KC_I,    KC_O,    KC_P},
+        {KC_A,    KC_S,    KC_D,    KC_F,    KC_G,   KC_H,   KC_J,    KC_K,    KC_L,    KC_SCLN},
+        {KC_Z,    KC_X,    KC_C,    KC_V,    KC_B,   KC_N,   KC_M,    KC_COMM, KC_DOT,  KC_SLSH},
+        {KC_LSFT, KC_LCTL, KC_LALT, KC_LGUI, KC_SPC, KC_ENT, KC_BSPC, KC_TAB,  KC_ESC,  KC_RSFT},
+    };
+    // clang-format on
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            add_key(KeymapKey(0, col, row, qwerty[row][col]));
+        }
+    }
+}
+
+void BenchFixture::remap(KeymapKey key) {
+    std::vector<KeymapKey> remapped;
+    for (auto& existing : keymap) {
+        if (existing.layer != key.layer || existing.position.row != key.position.row || existing.position.col != key.position.col) {
+            remapped.push_back(existing);
+        }
+    }
+    remapped.push_back(key);
+    keymap.swap(remapped);
+}
+
+BenchResult BenchFixture::replay(const std::vector<BenchEvent>& events, unsigned settle_ms) {
+    using clock = std::chrono::steady_clock;
+
+    BenchResult result   = {};
+    result.report_hash   = 2166136261;
+    clock::duration idle = {}, input = {};
+    size_t          next = 0;
+    uint32_t        end  = (events.empty() ? 0 : events.back().time) + settle_ms;
+
+    host_set_driver(&bench_driver);
+    current_result       = &result;
+    allocation_count     = 0;
+    counting_allocations = true;
+
+    for (uint32_t now = 0; now <= end; now++) {
+        uint32_t applied = 0;
+        for (; next < events.size() && events[next].time == now; next++, applied++) {
+            if (events[next].pressed) {
+                press_key(events[next].col, events[next].row);
+            } else {
+                release_key(events[next].col, events[next].row);
+            }
+        }
+
+        auto start = clock::now();
+        keyboard_task();
+        (applied ? input : idle) += clock::now() - start;
+
+        result.scans++;
+        result.events += applied;
+        result.input_scans += applied ? 1 : 0;
+        advance_time(1);
+    }
+
+    counting_allocations = false;
+    current_result       = nullptr;
+    host_set_driver(nullptr);
+
+    result.ns_per_scan  = std::chrono::duration<double, std::nano>(idle + input).count() / result.scans;
+    result.ns_per_event = result.events ? std::chrono::duration<double, std::nano>(input).count() / result.events : 0;
+#ifdef BENCH_COUNTS_ALLOCATIONS
+    result.allocations = allocation_count;
+#else
+    result.allocations = -1;
+#endif
+    return result;
+}
+
+BenchResult BenchFixture::run_workload(const std::string& name) {
+    std::vector<BenchEvent> events = bench_load_trace(name);
+    if (events.empty()) {
+        ADD_FAILURE() << "Trace " << name << " has no events";
+        return {};
+    }
+
+    // The first run warms up caches and lazily initialised state, the second one is reported
+    BenchResult first  = replay(events);
+    BenchResult result = replay(events);
+
+    const ::testing::TestInfo* const test_info = ::testing::UnitTest::GetInstance()->current_test_info();
+    std::cout << "[  BENCH   ] " << test_info->test_case_name() << "." << test_info->name() << " (" << name << "): " << result.events << " events, " << result.scans << " scans, " << std::fixed << std::setprecision(1) << result.ns_per_scan << " ns/scan, " << result.ns_per_event << " ns/event, " << result.keyboard_reports << " keyboard + " << result.mouse_reports << " mouse + " << result.extra_reports << " extra reports, ";
+    if (result.allocations >= 0) {
+        std::cout << result.allocations << " allocations" << std::endl;
+    } else {
+        std::cout << "allocations not counted" << std::endl;
+    }
+
+    EXPECT_EQ(first.keyboard_reports, result.keyboard_reports) << "Replaying " << name << " twice sent a different number of reports";
+    EXPECT_EQ(first.report_hash, result.report_hash) << "Replaying " << name << " twice sent different reports";
+    EXPECT_FALSE(result.keys_left_down) << "Keys were still held after replaying " << name;
+    EXPECT_GT(result.keyboard_reports, 0) << "Replaying " << name << " sent no reports";
+    return result;
+}
+
+const std::vector<std::string>& bench_workloads() {
+    // Built on first use, as test suites in other files are instantiated during static initialisation
+    static const std::vector<std::string> workloads = {"prose_typing", "steno_chords", "gaming_rollover"};
+    return workloads;
+}
+
+__attribute__((weak)) void bench_setup(BenchFixture& fixture) {}
+
+std::string bench_workload_name(const std::string& name) {
+    std::string result;
+    bool        upper = true;
+    for (char c : name) {
+        if (c == '_') {
+            upper = true;
+        } else {
+            result += upper ? (char)std::toupper(c) : c;
+            upper = false;
+        }
+    }
+    return result;
+}
+
+TEST_P(Bench, Workload) {
+    run_workload(GetParam());
+}
+
+INSTANTIATE_TEST_CASE_P(Workloads, Bench, testing::ValuesIn(bench_workloads()), [](const testing::TestParamInfo<std::string>& info) { return bench_workload_name(info.param); });
@@ -0,0 +1,104 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "test_fixture.hpp"
+
+/* A recorded key event, at a time in milliseconds from the start of the trace */
+struct BenchEvent {
+    uint32_t time;
+    uint8_t  row;
+    uint8_t  col;
+    bool     pressed;
+};
+
+struct BenchResult {
+    uint32_t events;
+    uint32_t scans;
+    uint32_t input_scans; // scans that had at least one new event to process
+    double   ns_per_scan;
+    double   ns_per_event; // time spent in input scans, divided by the events they processed
+    int64_t  allocations;  // heap allocations made while replaying, or -1 if they can't be counted here
+    uint32_t keyboard_reports;
+    uint32_t mouse_reports;
+    uint32_t extra_reports;
+    uint32_t report_hash;    // of every keyboard report in order, to check replays are deterministic
+    bool     keys_left_down; // the last keyboard report was not empty
+};
+
+/**
+ * @brief Loads a trace from tests/test_common/bench/<name>.trace, or from the directory in
+ * the QMK_BENCH_TRACE_DIR environment variable.
+ *
+ * Each line is "<time ms> <row> <col> <d|u>", with times never going backwards. Blank lines
+ * and anything after a '#' are ignored.
+ */
+std::vector<BenchEvent> bench_load_trace(const std::string& name);
+
+/**
+ * @brief Fixture that replays traces through keyboard_task() with the virtual clock,
+ * on a 4x10 QWERTY layer 0 that tests can add to or replace with set_keymap().
+ */
+class BenchFixture : public TestFixture {
+   public:
+    BenchFixture();
+
+    /**
+     * @brief Replaces whatever is mapped at the key's layer and position.
+     */
+    void remap(KeymapKey key);
+
+    /**
+     * @brief Replays the trace, idling for `settle_ms` afterwards so that pending timers fire.
+     */
+    BenchResult replay(const std::vector<BenchEvent>& events, unsigned settle_ms = 1000);
+
+    /**
+     * @brief Loads and replays the named trace twice, printing the results of the second run
+     * and checking that both runs sent the same reports and released every key.
+     */
+    BenchResult run_workload(const std::string& name);
+};
+
+/**
+ * @brief The bundled workloads, each replayed by the Bench suite in every bench_* test.
+ */
+const std::vector<std::string>& bench_workloads();
+
+/**
+ * @brief Prepares a fixture before its workload runs, for feature sets that change the keymap
+ * or other state. Does nothing unless a bench_* test defines it.
+ */
+void bench_setup(BenchFixture& fixture);
+
+/**
+ * @brief Turns a workload name such as "prose_typing" into a test name such as "ProseTyping".
+ */
+std::string bench_workload_name(const std::string& name);
+
+/**
+ * @brief Replays every workload in bench_workloads(), after bench_setup().
+ */
+class Bench : public BenchFixture, public testing::WithParamInterface<std::string> {
+   public:
+    Bench() {
+        bench_setup(*this);
+    }
+};
@@ -43,6 +43,8 @@
 #include "usb_device_state.h"
 #include "usb_descriptor.h"
 #include "usb_driver.h"
+#include "usb_report_queue.h"
+#include "latency_trace.h"
 
 #ifdef NKRO_ENABLE
 #    include "keycode_config.h"
@@ -177,6 +179,18 @@ static const USBEndpointConfig shared_ep_config = {
 };
 #endif
 
+/* Reports waiting for the keyboard, mouse and shared endpoints, drained from
+ * their IN callbacks so that sending a report never waits on the host */
+#ifndef KEYBOARD_SHARED_EP
+static usb_report_queue_t kbd_report_queue;
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+static usb_report_queue_t mouse_report_queue;
+#endif
+#ifdef SHARED_EP_ENABLE
+static usb_report_queue_t shared_report_queue;
+#endif
+
 #ifdef USB_ENDPOINTS_ARE_REORDERABLE
 typedef struct {
     size_t              queue_capacity_in;
@@ -477,14 +491,18 @@ static void usb_event_cb(USBDriver *usbp, usbevent_t event) {
 
         case USB_EVENT_CONFIGURED:
             osalSysLockFromISR();
-            /* Enable the endpoints specified into the configuration. */
+            /* Enable the endpoints specified into the configuration.
+             * Any reports still queued were meant for the previous configuration. */
 #ifndef KEYBOARD_SHARED_EP
+            usb_report_queue_clear(&kbd_report_queue);
             usbInitEndpointI(usbp, KEYBOARD_IN_EPNUM, &kbd_ep_config);
 #endif
 #if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+            usb_report_queue_clear(&mouse_report_queue);
             usbInitEndpointI(usbp, MOUSE_IN_EPNUM, &mouse_ep_config);
 #endif
 #ifdef SHARED_EP_ENABLE
+            usb_report_queue_clear(&shared_report_queue);
             usbInitEndpointI(usbp, SHARED_IN_EPNUM, &shared_ep_config);
 #endif
             for (int i = 0; i < NUM_USB_DRIVERS; i++) {
@@ -763,6 +781,78 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
     usbConnectBus(usbp);
 }
 
+/* ---------------------------------------------------------
+ *                  IN report queues
+ * ---------------------------------------------------------
+ */
+
+/* The queues only compare timestamps, so the raw system time will do */
+#define REPORT_QUEUE_NOW() ((uint16_t)chVTGetSystemTimeX())
+
+static usb_report_queue_t *usb_report_queue_for(usbep_t ep) {
+#ifndef KEYBOARD_SHARED_EP
+    if (ep == KEYBOARD_IN_EPNUM) {
+        return &kbd_report_queue;
+    }
+#endif
+#if defined(MOUSE_ENABLE) && !defined(MOUSE_SHARED_EP)
+    if (ep == MOUSE_IN_EPNUM) {
+        return &mouse_report_queue;
+    }
+#endif
+#ifdef SHARED_EP_ENABLE
+    if (ep == SHARED_IN_EPNUM) {
+        return &shared_report_queue;
+    }
+#endif
+    return NULL;
+}
+
+/* start sending the next queued report, if the endpoint is free
+ * called from ISR or locked state */
+static void usb_report_queue_kick_i(usbep_t ep) {
+    if (usbGetTransmitStatusI(&USB_DRIVER, ep)) {
+        return;
+    }
+    usb_report_queue_entry_t *entry = usb_report_queue_start(usb_report_queue_for(ep));
+    if (entry) {
+        usbStartTransmitI(&USB_DRIVER, ep, entry->data, entry->size);
+    }
+}
+
+/* a report has made it IN, release it and move on to the next one
+ * called from ISR, unlocked state */
+static void usb_report_queue_in_cb(usbep_t ep) {
+    osalSysLockFromISR();
+    usb_report_queue_complete(usb_report_queue_for(ep), REPORT_QUEUE_NOW());
+    usb_report_queue_kick_i(ep);
+    osalSysUnlockFromISR();
+}
+
+/* queue a report IN, without waiting for the previous one to go out
+ * not callable from ISR or locked state */
+static void send_report(usbep_t ep, uint8_t kind, const void *data, uint8_t size, usb_report_merge_t merge) {
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE) {
+        usb_report_queue_push(usb_report_queue_for(ep), kind, data, size, merge, REPORT_QUEUE_NOW());
+        usb_report_queue_kick_i(ep);
+    }
+    osalSysUnlock();
+}
+
+bool usb_report_queue_get_stats(usbep_t ep, usb_report_queue_stats_t *stats) {
+    usb_report_queue_t *queue = usb_report_queue_for(ep);
+    if (!queue) {
+        return false;
+    }
+
+    osalSysLock();
+    *stats = queue->stats;
+    osalSysUnlock();
+    stats->stall_max = TIME_I2MS(stats->stall_max);
+    return true;
+}
+
 /* ---------------------------------------------------------
  *                  Keyboard functions
  * ---------------------------------------------------------
@@ -770,9 +860,9 @@ __attribute__((weak)) void restart_usb_driver(USBDriver *usbp) {
 /* keyboard IN callback hander (a kbd report has made it IN) */
 #ifndef KEYBOARD_SHARED_EP
 void kbd_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
-    (void)ep;
+    latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+    usb_report_queue_in_cb(ep);
 }
 #endif
 
@@ -808,7 +898,8 @@ static void keyboard_idle_timer_cb(void *arg) {
     if (keyboard_idle && keyboard_protocol) {
 #endif /* NKRO_ENABLE */
         /* TODO: are we sure we want the KBD_ENDPOINT? */
-        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM)) {
+        /* queued reports are newer than the one being repeated, and go out first */
+        if (!usbGetTransmitStatusI(usbp, KEYBOARD_IN_EPNUM) && usb_report_queue_depth(usb_report_queue_for(KEYBOARD_IN_EPNUM)) == 0) {
             usbStartTransmitI(usbp, KEYBOARD_IN_EPNUM, (uint8_t *)&keyboard_report_sent, KEYBOARD_EPSIZE);
         }
         /* rearm the timer */
@@ -825,65 +916,49 @@ uint8_t keyboard_leds(void) {
     return keyboard_led_state;
 }
 
-/* prepare and start sending a report IN
- * not callable from ISR or locked state */
-void send_keyboard(report_keyboard_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        goto unlock;
+/* the endpoint keyboard reports currently go out on */
+static usbep_t keyboard_in_epnum(void) {
+#ifdef NKRO_ENABLE
+    if (keymap_config.nkro && keyboard_protocol) {
+        return SHARED_IN_EPNUM;
     }
+#endif /* NKRO_ENABLE */
+    return KEYBOARD_IN_EPNUM;
+}
 
+/* prepare and queue a report IN
+ * not callable from ISR or locked state */
+void send_keyboard(report_keyboard_t *report) {
 #ifdef NKRO_ENABLE
     if (keymap_config.nkro && keyboard_protocol) { /* NKRO protocol */
-        /* need to wait until the previous packet has made it through */
-        /* can rewrite this using the synchronous API, then would wait
-         * until *after* the packet has been transmitted. I think
-         * this is more efficient */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)report, sizeof(struct nkro_report));
+        send_report(SHARED_IN_EPNUM, REPORT_ID_NKRO, report, sizeof(struct nkro_report), usb_report_merge_bits);
     } else
 #endif /* NKRO_ENABLE */
     {  /* regular protocol */
-        /* need to wait until the previous packet has made it through */
-        /* busy wait, should be short and not very common */
-        if (usbGetTransmitStatusI(&USB_DRIVER, KEYBOARD_IN_EPNUM)) {
-            /* Need to either suspend, or loop and call unlock/lock during
-             * every iteration - otherwise the system will remain locked,
-             * no interrupts served, so USB not going through as well.
-             * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-            osalThreadSuspendS(&(&USB_DRIVER)->epc[KEYBOARD_IN_EPNUM]->in_state->thread);
-
-            /* after osalThreadSuspendS returns USB status might have changed */
-            if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-                goto unlock;
-            }
-        }
-        uint8_t *data, size;
         if (keyboard_protocol) {
-            data = (uint8_t *)report;
-            size = KEYBOARD_REPORT_SIZE;
+            send_report(KEYBOARD_IN_EPNUM, REPORT_ID_KEYBOARD, report, KEYBOARD_REPORT_SIZE, usb_report_merge_keys);
         } else { /* boot protocol */
-            data = &report->mods;
-            size = 8;
+            send_report(KEYBOARD_IN_EPNUM, REPORT_ID_KEYBOARD, &report->mods, 8, usb_report_merge_keys);
         }
-        usbStartTransmitI(&USB_DRIVER, KEYBOARD_IN_EPNUM, data, size);
     }
+
+    /* kept for the idle timer and GET_REPORT requests */
+    osalSysLock();
     keyboard_report_sent = *report;
+    osalSysUnlock();
+}
 
-unlock:
+/* whether every keyboard report has made it IN, so that sending another one
+ * won't have to queue behind them */
+bool keyboard_report_ready(void) {
+    bool ready = true;
+    osalSysLock();
+    if (usbGetDriverStateI(&USB_DRIVER) == USB_ACTIVE) {
+        usbep_t ep = keyboard_in_epnum();
+        ready      = !usbGetTransmitStatusI(&USB_DRIVER, ep) && usb_report_queue_depth(usb_report_queue_for(ep)) == 0;
+    }
     osalSysUnlock();
+    return ready;
 }
 
 /* ---------------------------------------------------------
@@ -893,33 +968,49 @@ unlock:
 
 #ifdef MOUSE_ENABLE
 
+#    ifdef MOUSE_EXTENDED_REPORT
+#        define MOUSE_REPORT_XY_MAX INT16_MAX
+#    else
+#        define MOUSE_REPORT_XY_MAX INT8_MAX
+#    endif
+
+/* motion adds up, so reports can be folded together as long as no button changes along the way */
+static bool mouse_report_merge(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size) {
+    report_mouse_t *      a = (report_mouse_t *)pending;
+    const report_mouse_t *b = (const report_mouse_t *)next;
+    if (!prev || ((const report_mouse_t *)prev)->buttons != a->buttons || a->buttons != b->buttons) {
+        return false;
+    }
+
+    int32_t x = (int32_t)a->x + b->x;
+    int32_t y = (int32_t)a->y + b->y;
+    int16_t v = (int16_t)a->v + b->v;
+    int16_t h = (int16_t)a->h + b->h;
+    if (x < -MOUSE_REPORT_XY_MAX || x > MOUSE_REPORT_XY_MAX || y < -MOUSE_REPORT_XY_MAX || y > MOUSE_REPORT_XY_MAX || v < -INT8_MAX || v > INT8_MAX || h < -INT8_MAX || h > INT8_MAX) {
+        return false;
+    }
+
+    a->x = x;
+    a->y = y;
+    a->v = v;
+    a->h = h;
+#    ifdef MOUSE_EXTENDED_REPORT
+    a->boot_x = (x > 127) ? 127 : ((x < -127) ? -127 : x);
+    a->boot_y = (y > 127) ? 127 : ((y < -127) ? -127 : y);
+#    endif
+    return true;
+}
+
 #    ifndef MOUSE_SHARED_EP
 /* mouse IN callback hander (a mouse report has made it IN) */
 void mouse_in_cb(USBDriver *usbp, usbep_t ep) {
     (void)usbp;
-    (void)ep;
+    usb_report_queue_in_cb(ep);
 }
 #    endif
 
 void send_mouse(report_mouse_t *report) {
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, MOUSE_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[MOUSE_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    usbStartTransmitI(&USB_DRIVER, MOUSE_IN_EPNUM, (uint8_t *)report, sizeof(report_mouse_t));
-    osalSysUnlock();
+    send_report(MOUSE_IN_EPNUM, REPORT_ID_MOUSE, report, sizeof(report_mouse_t), mouse_report_merge);
 }
 
 #else  /* MOUSE_ENABLE */
@@ -935,9 +1026,11 @@ void send_mouse(report_mouse_t *report) {
 #ifdef SHARED_EP_ENABLE
 /* shared IN callback hander */
 void shared_in_cb(USBDriver *usbp, usbep_t ep) {
-    /* STUB */
     (void)usbp;
-    (void)ep;
+#    if defined(KEYBOARD_SHARED_EP) || defined(NKRO_ENABLE)
+    latency_trace_mark(LATENCY_TRACE_STAGE_USB);
+#    endif
+    usb_report_queue_in_cb(ep);
 }
 #endif
 
@@ -948,71 +1041,27 @@ void shared_in_cb(USBDriver *usbp, usbep_t ep) {
 
 void send_extra(uint8_t report_id, uint16_t data) {
 #ifdef EXTRAKEY_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
+    report_extra_t report = {.report_id = report_id, .usage = data};
 
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-
-    static report_extra_t report;
-    report = (report_extra_t){.report_id = report_id, .usage = data};
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report_extra_t));
-    osalSysUnlock();
+    send_report(SHARED_IN_EPNUM, report_id, &report, sizeof(report_extra_t), usb_report_merge_value);
 #endif
 }
 
 void send_programmable_button(uint32_t data) {
 #ifdef PROGRAMMABLE_BUTTON_ENABLE
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    if (usbGetTransmitStatusI(&USB_DRIVER, SHARED_IN_EPNUM)) {
-        /* Need to either suspend, or loop and call unlock/lock during
-         * every iteration - otherwise the system will remain locked,
-         * no interrupts served, so USB not going through as well.
-         * Note: for suspend, need USB_USE_WAIT == TRUE in halconf.h */
-        if (osalThreadSuspendTimeoutS(&(&USB_DRIVER)->epc[SHARED_IN_EPNUM]->in_state->thread, TIME_MS2I(10)) == MSG_TIMEOUT) {
-            osalSysUnlock();
-            return;
-        }
-    }
-    static report_programmable_button_t report = {
+    report_programmable_button_t report = {
         .report_id = REPORT_ID_PROGRAMMABLE_BUTTON,
+        .usage     = data,
     };
 
-    report.usage = data;
-
-    usbStartTransmitI(&USB_DRIVER, SHARED_IN_EPNUM, (uint8_t *)&report, sizeof(report));
-    osalSysUnlock();
+    send_report(SHARED_IN_EPNUM, REPORT_ID_PROGRAMMABLE_BUTTON, &report, sizeof(report), usb_report_merge_bits);
 #endif
 }
 
 void send_digitizer(report_digitizer_t *report) {
 #ifdef DIGITIZER_ENABLE
 #    ifdef DIGITIZER_SHARED_EP
-    osalSysLock();
-    if (usbGetDriverStateI(&USB_DRIVER) != USB_ACTIVE) {
-        osalSysUnlock();
-        return;
-    }
-
-    usbStartTransmitI(&USB_DRIVER, DIGITIZER_IN_EPNUM, (uint8_t *)report, sizeof(report_digitizer_t));
-    osalSysUnlock();
+    send_report(DIGITIZER_IN_EPNUM, REPORT_ID_DIGITIZER, report, sizeof(report_digitizer_t), NULL);
 #    else
     chnWrite(&drivers.digitizer_driver.driver, (uint8_t *)report, sizeof(report_digitizer_t));
 #    endif
@@ -23,6 +23,8 @@
 #include <ch.h>
 #include <hal.h>
 
+#include "usb_report_queue.h"
+
 /* -------------------------
  * General USB driver header
  * -------------------------
@@ -85,6 +87,15 @@ void mouse_in_cb(USBDriver *usbp, usbep_t ep);
 /* shared IN request callback handler */
 void shared_in_cb(USBDriver *usbp, usbep_t ep);
 
+/* ---------------
+ * IN report queue
+ * ---------------
+ */
+
+/* Copies out the statistics of the report queue behind an IN endpoint, with the
+ * stall time converted to milliseconds. Returns false if the endpoint has none. */
+bool usb_report_queue_get_stats(usbep_t ep, usb_report_queue_stats_t *stats);
+
 /* --------------
  * Console header
  * --------------
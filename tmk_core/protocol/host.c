@@ -23,6 +23,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #include "util.h"
 #include "debug.h"
 #include "digitizer.h"
+#include "latency_trace.h"
 
 #ifdef BLUETOOTH_ENABLE
 #    include "outputselect.h"
@@ -72,6 +73,8 @@ led_t host_keyboard_led_state(void) {
 
 /* send report */
 void host_keyboard_send(report_keyboard_t *report) {
+    latency_trace_mark(LATENCY_TRACE_STAGE_REPORT);
+
 #ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
 #    ifdef BLUETOOTH_BLUEFRUIT_LE
@@ -109,6 +112,22 @@ void host_keyboard_send(report_keyboard_t *report) {
     }
 }
 
+/* whether a keyboard report can be sent without waiting on the previous one */
+bool host_keyboard_ready(void) {
+#ifdef BLUETOOTH_ENABLE
+    if (where_to_send() == OUTPUT_BLUETOOTH) {
+        return true;
+    }
+#endif
+
+    if (!driver) return false;
+    return keyboard_report_ready();
+}
+
+__attribute__((weak)) bool keyboard_report_ready(void) {
+    return true;
+}
+
 void host_mouse_send(report_mouse_t *report) {
 #ifdef BLUETOOTH_ENABLE
     if (where_to_send() == OUTPUT_BLUETOOTH) {
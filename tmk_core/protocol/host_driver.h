@@ -18,6 +18,7 @@ along with this program.  If not, see <http://www.gnu.org/licenses/>.
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "report.h"
 #ifdef MIDI_ENABLE
 #    include "midi.h"
@@ -32,3 +33,4 @@ typedef struct {
 } host_driver_t;
 
 void send_digitizer(report_digitizer_t *report);
+bool keyboard_report_ready(void);
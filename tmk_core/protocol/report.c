@@ -279,6 +279,138 @@ void clear_keys_from_report(report_keyboard_t* keyboard_report) {
     memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
 }
 
+/** \brief Marks a key as pressed
+ *
+ * Constant time, as the report is only built from the bitmap when it is sent.
+ */
+void key_bitmap_add(key_bitmap_t* bitmap, uint8_t key) {
+    if (key == KC_NO) {
+        return;
+    }
+    bitmap->pressed[key >> 3] |= 1 << (key & 7);
+    bitmap->fresh[key >> 3] |= 1 << (key & 7);
+    bitmap->has_fresh = true;
+}
+
+/** \brief Marks a key as released
+ *
+ * Constant time, as the report is only built from the bitmap when it is sent.
+ */
+void key_bitmap_del(key_bitmap_t* bitmap, uint8_t key) {
+    bitmap->pressed[key >> 3] &= ~(1 << (key & 7));
+    bitmap->fresh[key >> 3] &= ~(1 << (key & 7));
+}
+
+/** \brief Marks every key as released
+ */
+void key_bitmap_clear(key_bitmap_t* bitmap) {
+    memset(bitmap->pressed, 0, sizeof(bitmap->pressed));
+    memset(bitmap->fresh, 0, sizeof(bitmap->fresh));
+    bitmap->has_fresh = false;
+}
+
+/** \brief Checks if a key is pressed
+ *
+ * Returns false for KC_NO
+ */
+bool key_bitmap_has(const key_bitmap_t* bitmap, uint8_t key) {
+    return key != KC_NO && (bitmap->pressed[key >> 3] & (1 << (key & 7)));
+}
+
+/* Fills the 6KRO key slots from the bitmap. Held keys keep their slot, so that
+ * the host never sees them move, and newly pressed keys take the free ones. */
+static void key_bitmap_build_keys(key_bitmap_t* bitmap, uint8_t* keys) {
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+    // Slots are kept in order of age, so that the oldest key makes way once they are all taken
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t key = keys[i];
+        keys[i]     = 0;
+        if (key_bitmap_has(bitmap, key)) {
+            keys[count++] = key;
+        }
+    }
+#else
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keys[i] && !key_bitmap_has(bitmap, keys[i])) {
+            keys[i] = 0;
+        }
+    }
+#endif
+
+    if (!bitmap->has_fresh) {
+        return;
+    }
+
+    for (uint8_t byte = 0; byte < sizeof(bitmap->fresh); byte++) {
+        for (uint8_t bit = 0; bitmap->fresh[byte] >> bit; bit++) {
+            if (!(bitmap->fresh[byte] & (1 << bit))) {
+                continue;
+            }
+
+            uint8_t code  = byte << 3 | bit;
+            int8_t  empty = -1;
+            uint8_t i     = 0;
+            for (; i < KEYBOARD_REPORT_KEYS && keys[i] != code; i++) {
+                if (empty == -1 && keys[i] == 0) {
+                    empty = i;
+                }
+            }
+            if (i < KEYBOARD_REPORT_KEYS) {
+                // Released and pressed again since the last report
+                continue;
+            }
+#ifdef RING_BUFFERED_6KRO_REPORT_ENABLE
+            if (empty == -1) {
+                memmove(keys, keys + 1, KEYBOARD_REPORT_KEYS - 1);
+                empty = KEYBOARD_REPORT_KEYS - 1;
+            }
+#endif
+            if (empty != -1) {
+                keys[empty] = code;
+            }
+        }
+    }
+}
+
+/** \brief Builds the keys of a keyboard report from the bitmap
+ *
+ * Modifiers are left alone.
+ */
+void key_bitmap_build_report(key_bitmap_t* bitmap, report_keyboard_t* keyboard_report) {
+    bool nkro = false;
+#ifdef NKRO_ENABLE
+    _Static_assert(KEYBOARD_REPORT_BITS <= sizeof(bitmap->pressed), "NKRO report is larger than the key bitmap");
+    nkro = keyboard_protocol && keymap_config.nkro;
+#endif
+
+    // The two layouts overlap, so start over from every held key when switching between them
+    if (nkro != bitmap->nkro) {
+        bitmap->nkro = nkro;
+        memcpy(bitmap->fresh, bitmap->pressed, sizeof(bitmap->fresh));
+        bitmap->has_fresh = true;
+#ifdef NKRO_ENABLE
+        memset(keyboard_report->nkro.bits, 0, sizeof(keyboard_report->nkro.bits));
+#endif
+        keyboard_report->reserved = 0;
+        memset(keyboard_report->keys, 0, sizeof(keyboard_report->keys));
+    }
+
+#ifdef NKRO_ENABLE
+    if (nkro) {
+        memcpy(keyboard_report->nkro.bits, bitmap->pressed, sizeof(keyboard_report->nkro.bits));
+    } else
+#endif
+    {
+        key_bitmap_build_keys(bitmap, keyboard_report->keys);
+    }
+
+    if (bitmap->has_fresh) {
+        memset(bitmap->fresh, 0, sizeof(bitmap->fresh));
+        bitmap->has_fresh = false;
+    }
+}
+
 #ifdef MOUSE_ENABLE
 /**
  * @brief Compares 2 mouse reports for difference and returns result
@@ -247,6 +247,18 @@ typedef struct {
 #endif
 } __attribute__((packed)) joystick_report_t;
 
+/*
+ * Every pressed keyboard usage, one bit each. This is the single source of
+ * truth for the keys held down, and the 6KRO or NKRO report is built from it
+ * on demand, just before it is sent.
+ */
+typedef struct {
+    uint8_t pressed[32];
+    uint8_t fresh[32]; /* pressed since the report was last built */
+    bool    has_fresh;
+    bool    nkro; /* layout the report was last built in */
+} key_bitmap_t;
+
 /* keycode to system usage */
 static inline uint16_t KEYCODE2SYSTEM(uint8_t key) {
     switch (key) {
@@ -330,6 +342,12 @@ void add_key_to_report(report_keyboard_t* keyboard_report, uint8_t key);
 void del_key_from_report(report_keyboard_t* keyboard_report, uint8_t key);
 void clear_keys_from_report(report_keyboard_t* keyboard_report);
 
+void key_bitmap_add(key_bitmap_t* bitmap, uint8_t key);
+void key_bitmap_del(key_bitmap_t* bitmap, uint8_t key);
+void key_bitmap_clear(key_bitmap_t* bitmap);
+bool key_bitmap_has(const key_bitmap_t* bitmap, uint8_t key);
+void key_bitmap_build_report(key_bitmap_t* bitmap, report_keyboard_t* keyboard_report);
+
 #ifdef MOUSE_ENABLE
 bool has_mouse_report_changed(report_mouse_t* new_report, report_mouse_t* old_report);
 #endif
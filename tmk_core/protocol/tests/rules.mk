@@ -0,0 +1,6 @@
+usb_report_queue_DEFS := -DNO_DEBUG -DNO_PRINT
+usb_report_queue_INC := $(PROTOCOL_PATH)
+
+usb_report_queue_SRC := \
+	$(PROTOCOL_PATH)/tests/usb_report_queue_tests.cpp \
+	$(PROTOCOL_PATH)/usb_report_queue.c
@@ -0,0 +1,315 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+extern "C" {
+#include "usb_report_queue.h"
+#include "report.h"
+}
+
+enum { KIND_KEYBOARD = 1, KIND_CONSUMER };
+
+// A boot keyboard report: mods, reserved, then the keys
+typedef std::vector<uint8_t> report_t;
+
+static report_t keys(uint8_t mods, std::initializer_list<uint8_t> pressed) {
+    report_t report(2 + KEYBOARD_REPORT_KEYS, 0);
+    report[0] = mods;
+    std::copy(pressed.begin(), pressed.end(), report.begin() + 2);
+    return report;
+}
+
+static report_t usage(uint16_t value) {
+    return {REPORT_ID_CONSUMER, (uint8_t)(value & 0xFF), (uint8_t)(value >> 8)};
+}
+
+class UsbReportQueue : public ::testing::Test {
+   protected:
+    usb_report_queue_t queue;
+    uint16_t           now;
+
+    void SetUp() override {
+        memset(&queue, 0, sizeof(queue));
+        now = 0;
+    }
+
+    bool push(uint8_t kind, const report_t &report, usb_report_merge_t merge) {
+        return usb_report_queue_push(&queue, kind, report.data(), report.size(), merge, now);
+    }
+
+    // Plays the host polling the endpoint: completes whatever is in flight, and collects the next report
+    bool poll(report_t *sent = nullptr) {
+        usb_report_queue_complete(&queue, now);
+        usb_report_queue_entry_t *entry = usb_report_queue_start(&queue);
+        if (!entry) {
+            return false;
+        }
+        if (sent) {
+            sent->assign(entry->data, entry->data + entry->size);
+        }
+        return true;
+    }
+
+    std::vector<report_t> drain(void) {
+        std::vector<report_t> sent;
+        report_t              report;
+        while (poll(&report)) {
+            sent.push_back(report);
+        }
+        return sent;
+    }
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Queueing
+
+TEST_F(UsbReportQueue, SendsReportsInOrder) {
+    report_t sent;
+    EXPECT_FALSE(poll());
+
+    EXPECT_TRUE(push(KIND_KEYBOARD, keys(0, {KC_A}), NULL));
+    EXPECT_TRUE(push(KIND_KEYBOARD, keys(0, {}), NULL));
+    EXPECT_EQ(usb_report_queue_depth(&queue), 2);
+
+    // Nothing else goes out until the report in flight has completed
+    ASSERT_NE(usb_report_queue_start(&queue), nullptr);
+    EXPECT_EQ(usb_report_queue_start(&queue), nullptr);
+    usb_report_queue_complete(&queue, now);
+
+    ASSERT_TRUE(poll(&sent));
+    EXPECT_EQ(sent, keys(0, {}));
+    EXPECT_FALSE(poll());
+    EXPECT_EQ(usb_report_queue_depth(&queue), 0);
+}
+
+TEST_F(UsbReportQueue, ClearDiscardsPendingReports) {
+    push(KIND_KEYBOARD, keys(0, {KC_A}), NULL);
+    poll();
+    push(KIND_KEYBOARD, keys(0, {}), NULL);
+    usb_report_queue_clear(&queue);
+    EXPECT_EQ(usb_report_queue_depth(&queue), 0);
+    EXPECT_FALSE(poll());
+
+    // A completion for a transfer that was aborted along with the configuration is ignored
+    push(KIND_KEYBOARD, keys(0, {KC_B}), NULL);
+    usb_report_queue_complete(&queue, now);
+    EXPECT_EQ(usb_report_queue_depth(&queue), 1);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Coalescing
+
+TEST_F(UsbReportQueue, CoalescesSupersededKeyboardReports) {
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    poll();
+
+    // Rolling onto more keys while the endpoint is busy only needs the latest report
+    push(KIND_KEYBOARD, keys(0, {KC_A}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(MOD_BIT(KC_LSFT), {KC_A}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(MOD_BIT(KC_LSFT), {KC_A, KC_B}), usb_report_merge_keys);
+    EXPECT_EQ(usb_report_queue_depth(&queue), 2);
+    EXPECT_EQ(queue.stats.coalesced, 2);
+
+    std::vector<report_t> sent = drain();
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0], keys(MOD_BIT(KC_LSFT), {KC_A, KC_B}));
+}
+
+TEST_F(UsbReportQueue, KeepsEveryKeyboardTransition) {
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    poll();
+
+    // A tap: dropping the press would lose it altogether
+    push(KIND_KEYBOARD, keys(0, {KC_A}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+    drain();
+
+    // A modifier tap
+    push(KIND_KEYBOARD, keys(MOD_BIT(KC_LCTL), {}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+    drain();
+
+    // A key reusing the slot freed by another must not hide either of them
+    push(KIND_KEYBOARD, keys(0, {KC_A}), usb_report_merge_keys);
+    poll();
+    push(KIND_KEYBOARD, keys(0, {KC_B}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(0, {KC_D}), usb_report_merge_keys);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+    drain();
+
+    // A release followed by a press of the same key
+    push(KIND_KEYBOARD, keys(0, {KC_A, KC_B}), usb_report_merge_keys);
+    poll();
+    push(KIND_KEYBOARD, keys(0, {KC_B}), usb_report_merge_keys);
+    push(KIND_KEYBOARD, keys(0, {KC_B, KC_A}), usb_report_merge_keys);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+}
+
+TEST_F(UsbReportQueue, CoalescesOnlyTheNewestReport) {
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    poll();
+
+    // The consumer report behind the keyboard one must not be overtaken
+    push(KIND_KEYBOARD, keys(0, {KC_A}), usb_report_merge_keys);
+    push(KIND_CONSUMER, usage(AUDIO_VOL_UP), usb_report_merge_value);
+    push(KIND_KEYBOARD, keys(0, {KC_A, KC_B}), usb_report_merge_keys);
+    EXPECT_EQ(queue.stats.coalesced, 0);
+    EXPECT_EQ(usb_report_queue_depth(&queue), 4);
+
+    // Consumer reports merge with consumer reports only, and only when nothing is lost in between
+    report_t sent;
+    ASSERT_TRUE(poll(&sent));
+    EXPECT_EQ(sent, keys(0, {KC_A}));
+    push(KIND_CONSUMER, usage(0), usb_report_merge_value);
+    push(KIND_CONSUMER, usage(0), usb_report_merge_value);
+    EXPECT_EQ(queue.stats.coalesced, 1);
+
+    std::vector<report_t> rest = drain();
+    ASSERT_EQ(rest.size(), 3);
+    EXPECT_EQ(rest[0], usage(AUDIO_VOL_UP));
+    EXPECT_EQ(rest[1], keys(0, {KC_A, KC_B}));
+    EXPECT_EQ(rest[2], usage(0));
+}
+
+TEST_F(UsbReportQueue, FullQueueKeepsFinalState) {
+    push(KIND_KEYBOARD, keys(0, {}), usb_report_merge_keys);
+    poll();
+
+    // Taps can never be merged, so they fill the queue up
+    for (uint8_t i = 0; i < USB_REPORT_QUEUE_SIZE - 1; i++) {
+        EXPECT_TRUE(push(KIND_KEYBOARD, keys(0, {(uint8_t)(i % 2 ? 0 : KC_A)}), usb_report_merge_keys));
+    }
+    EXPECT_FALSE(push(KIND_KEYBOARD, keys(0, {KC_Z}), usb_report_merge_keys));
+    EXPECT_EQ(queue.stats.dropped, 1);
+    EXPECT_EQ(queue.stats.depth_max, USB_REPORT_QUEUE_SIZE);
+
+    std::vector<report_t> sent = drain();
+    ASSERT_FALSE(sent.empty());
+    EXPECT_EQ(sent.back(), keys(0, {KC_Z}));
+}
+
+TEST_F(UsbReportQueue, RecordsLongestStall) {
+    push(KIND_KEYBOARD, keys(0, {KC_A}), NULL);
+    push(KIND_KEYBOARD, keys(0, {}), NULL);
+    now = 1;
+    poll();
+    now = 9;
+    poll();
+    now = 12;
+    poll();
+    EXPECT_EQ(queue.stats.stall_max, 12);
+    EXPECT_EQ(queue.stats.depth_max, 2);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Random typing, with the host polling once every millisecond
+
+struct typing_result_t {
+    uint32_t events;
+    uint32_t reports;
+    bool     transitions_kept;
+};
+
+// Feeds random press and release events through the queue, and checks that the host sees each key go through exactly
+// the same sequence of states as the keyboard did
+static typing_result_t type_randomly(usb_report_queue_t *queue, usb_report_merge_t merge, bool nkro, uint32_t seed) {
+    std::mt19937                       rng(seed);
+    std::vector<std::vector<bool>>     typed(256), seen(256);
+    std::vector<uint8_t>               held;
+    std::vector<uint8_t>               host(nkro ? 16 : 2 + KEYBOARD_REPORT_KEYS, 0);
+    typing_result_t                    result = {0, 0, true};
+    auto record = [](std::vector<bool> &history, bool state) {
+        if (history.empty() ? state : history.back() != state) {
+            history.push_back(state);
+        }
+    };
+
+    for (uint16_t now = 0; now < 5000; now++) {
+        // A burst of up to a few events within each millisecond
+        uint8_t burst = rng() % 4;
+        for (uint8_t i = 0; i < burst; i++) {
+            uint8_t key = KC_A + rng() % 12;
+            auto    it  = std::find(held.begin(), held.end(), key);
+            if (it != held.end()) {
+                held.erase(it);
+            } else if (held.size() < KEYBOARD_REPORT_KEYS) {
+                held.push_back(key);
+            } else {
+                continue;
+            }
+
+            std::vector<uint8_t> report(host.size(), 0);
+            for (size_t slot = 0; slot < held.size(); slot++) {
+                if (nkro) {
+                    report[held[slot] / 8] |= 1 << (held[slot] % 8);
+                } else {
+                    report[2 + slot] = held[slot];
+                }
+            }
+            for (uint8_t k = KC_A; k < KC_A + 12; k++) {
+                record(typed[k], std::find(held.begin(), held.end(), k) != held.end());
+            }
+            usb_report_queue_push(queue, KIND_KEYBOARD, report.data(), report.size(), merge, now);
+            result.events++;
+        }
+
+        usb_report_queue_complete(queue, now);
+        usb_report_queue_entry_t *entry = usb_report_queue_start(queue);
+        if (entry) {
+            host.assign(entry->data, entry->data + entry->size);
+            result.reports++;
+            for (uint8_t k = KC_A; k < KC_A + 12; k++) {
+                bool pressed = nkro ? (host[k / 8] >> (k % 8)) & 1 : std::find(host.begin() + 2, host.end(), k) != host.end();
+                record(seen[k], pressed);
+            }
+        }
+    }
+
+    while (usb_report_queue_start(queue)) {
+        usb_report_queue_complete(queue, 0);
+    }
+    result.transitions_kept = typed == seen;
+    return result;
+}
+
+TEST_F(UsbReportQueue, RandomTypingKeepsEveryTransition) {
+    struct {
+        const char *       name;
+        usb_report_merge_t merge;
+        bool               nkro;
+    } configs[] = {
+        {"6KRO", usb_report_merge_keys, false},
+        {"NKRO", usb_report_merge_bits, true},
+    };
+
+    for (auto &config : configs) {
+        SetUp();
+        typing_result_t result = type_randomly(&queue, config.merge, config.nkro, 42);
+        std::printf("%s: %u events sent in %u reports, %u coalesced, %u dropped, queue depth %u, longest stall %ums\n", config.name, (unsigned)result.events, (unsigned)result.reports, (unsigned)queue.stats.coalesced, (unsigned)queue.stats.dropped, (unsigned)queue.stats.depth_max, (unsigned)queue.stats.stall_max);
+        EXPECT_GT(queue.stats.coalesced, 0);
+        EXPECT_EQ(queue.stats.dropped, 0);
+        EXPECT_TRUE(result.transitions_kept) << config.name;
+    }
+}
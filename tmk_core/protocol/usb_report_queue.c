@@ -0,0 +1,172 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "usb_report_queue.h"
+#include "report.h"
+#include <string.h>
+
+// The head and tail run freely and wrap at 256, so the size has to divide evenly into that
+_Static_assert(USB_REPORT_QUEUE_SIZE <= 128 && (USB_REPORT_QUEUE_SIZE & (USB_REPORT_QUEUE_SIZE - 1)) == 0, "USB_REPORT_QUEUE_SIZE must be a power of two, no larger than 128");
+
+#define QUEUE_ENTRY(queue, index) (&(queue)->entries[(uint8_t)(index) % USB_REPORT_QUEUE_SIZE])
+
+void usb_report_queue_clear(usb_report_queue_t *queue) {
+    queue->tail      = queue->head;
+    queue->in_flight = false;
+}
+
+uint8_t usb_report_queue_depth(usb_report_queue_t *queue) {
+    return (uint8_t)(queue->head - queue->tail);
+}
+
+bool usb_report_queue_push(usb_report_queue_t *queue, uint8_t kind, const void *data, uint8_t size, usb_report_merge_t merge, uint16_t now) {
+    uint8_t head  = queue->head;
+    uint8_t first = queue->tail + (queue->in_flight ? 1 : 0);
+
+    if (size > USB_REPORT_QUEUE_REPORT_SIZE) {
+        return false;
+    }
+
+    // Only the newest report can be merged into, as anything queued after it would otherwise be overtaken
+    if (merge && head != first) {
+        usb_report_queue_entry_t *pending = QUEUE_ENTRY(queue, head - 1);
+        if (pending->kind == kind && pending->size == size) {
+            const uint8_t *prev = NULL;
+            for (uint8_t i = head - 1; i != queue->tail;) {
+                usb_report_queue_entry_t *entry = QUEUE_ENTRY(queue, --i);
+                if (entry->kind == kind && entry->size == size) {
+                    prev = entry->data;
+                    break;
+                }
+            }
+            if (merge(prev, pending->data, (const uint8_t *)data, size)) {
+                queue->stats.coalesced++;
+                return true;
+            }
+        }
+    }
+
+    if (usb_report_queue_depth(queue) == USB_REPORT_QUEUE_SIZE) {
+        queue->stats.dropped++;
+        // Overwrite the newest pending report of the same kind, so that the host at least ends up in the right state
+        for (uint8_t i = head; i != first;) {
+            usb_report_queue_entry_t *entry = QUEUE_ENTRY(queue, --i);
+            if (entry->kind == kind && entry->size == size) {
+                memcpy(entry->data, data, size);
+                break;
+            }
+        }
+        return false;
+    }
+
+    usb_report_queue_entry_t *entry = QUEUE_ENTRY(queue, head);
+    memcpy(entry->data, data, size);
+    entry->size      = size;
+    entry->kind      = kind;
+    entry->queued_at = now;
+    queue->head      = head + 1;
+
+    if (usb_report_queue_depth(queue) > queue->stats.depth_max) {
+        queue->stats.depth_max = usb_report_queue_depth(queue);
+    }
+    return true;
+}
+
+usb_report_queue_entry_t *usb_report_queue_start(usb_report_queue_t *queue) {
+    if (queue->in_flight || queue->head == queue->tail) {
+        return NULL;
+    }
+    queue->in_flight = true;
+    return QUEUE_ENTRY(queue, queue->tail);
+}
+
+void usb_report_queue_complete(usb_report_queue_t *queue, uint16_t now) {
+    if (!queue->in_flight) {
+        return;
+    }
+
+    uint16_t stall = now - QUEUE_ENTRY(queue, queue->tail)->queued_at;
+    if (stall > queue->stats.stall_max) {
+        queue->stats.stall_max = stall;
+    }
+    queue->tail++;
+    queue->in_flight = false;
+}
+
+/* ---------------------------------------------------------
+ *                     Merge policies
+ * ---------------------------------------------------------
+ */
+
+// A bit is lost if it changes in the pending report, only to change back in the next one
+static bool bits_preserved(const uint8_t *prev, const uint8_t *pending, const uint8_t *next, uint8_t size) {
+    for (uint8_t i = 0; i < size; i++) {
+        if ((prev[i] ^ pending[i]) & ~(prev[i] ^ next[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool has_key(const uint8_t *keys, uint8_t key) {
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        if (keys[i] == key) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool usb_report_merge_bits(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size) {
+    if (!prev || !bits_preserved(prev, pending, next, size)) {
+        return false;
+    }
+    memcpy(pending, next, size);
+    return true;
+}
+
+bool usb_report_merge_keys(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size) {
+    if (!prev || size < KEYBOARD_REPORT_KEYS) {
+        return false;
+    }
+
+    uint8_t offset = size - KEYBOARD_REPORT_KEYS;
+    if (!bits_preserved(prev, pending, next, offset)) {
+        return false;
+    }
+
+    // Keys may move between slots, so compare them as sets
+    for (uint8_t i = 0; i < KEYBOARD_REPORT_KEYS; i++) {
+        uint8_t pressed  = pending[offset + i];
+        uint8_t released = prev[offset + i];
+        if (pressed && !has_key(&prev[offset], pressed) && !has_key(&next[offset], pressed)) {
+            return false;
+        }
+        if (released && !has_key(&pending[offset], released) && has_key(&next[offset], released)) {
+            return false;
+        }
+    }
+    memcpy(pending, next, size);
+    return true;
+}
+
+bool usb_report_merge_value(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size) {
+    if (!prev || (memcmp(pending, prev, size) != 0 && memcmp(pending, next, size) != 0)) {
+        return false;
+    }
+    memcpy(pending, next, size);
+    return true;
+}
@@ -0,0 +1,99 @@
+/* Copyright 2022 QMK
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/* Queue of HID reports waiting for an interrupt IN endpoint.
+ *
+ * The main loop pushes reports and the endpoint's IN-complete callback drains
+ * them, so sending a report never has to wait for the previous one to make it
+ * to the host. When reports arrive faster than the host polls for them, the
+ * newest pending report is merged with the incoming one -- but only if the
+ * host would still see every press and release.
+ *
+ * The queue itself is not thread-aware: the caller is expected to wrap every
+ * call in whatever critical section its USB stack already needs to start a
+ * transfer. All calls are short and bounded by the queue size.
+ */
+
+#ifndef USB_REPORT_QUEUE_SIZE
+#    define USB_REPORT_QUEUE_SIZE 4
+#endif
+
+#ifndef USB_REPORT_QUEUE_REPORT_SIZE
+#    define USB_REPORT_QUEUE_REPORT_SIZE 32
+#endif
+
+/* Merges `next` into `pending`, writing the result to `pending` and returning
+ * true if that is possible without the host missing a transition. `prev` is
+ * the report of the same kind queued ahead of `pending`, which the host will
+ * have received by the time `pending` goes out, or NULL if there is none. */
+typedef bool (*usb_report_merge_t)(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size);
+
+typedef struct {
+    uint8_t  data[USB_REPORT_QUEUE_REPORT_SIZE] __attribute__((aligned(4)));
+    uint8_t  size;
+    uint8_t  kind;
+    uint16_t queued_at;
+} usb_report_queue_entry_t;
+
+typedef struct {
+    uint8_t  depth_max; // most reports ever waiting at once, including the one being sent
+    uint16_t coalesced; // reports merged into one already waiting
+    uint16_t dropped;   // reports lost to a full queue
+    uint16_t stall_max; // longest a report has waited to be sent, in the caller's clock units
+} usb_report_queue_stats_t;
+
+typedef struct {
+    usb_report_queue_entry_t entries[USB_REPORT_QUEUE_SIZE];
+    volatile uint8_t         head; // advanced by the producer
+    volatile uint8_t         tail; // advanced by the consumer
+    volatile bool            in_flight;
+    usb_report_queue_stats_t stats;
+} usb_report_queue_t;
+
+/* Discards all pending reports, keeping the statistics */
+void usb_report_queue_clear(usb_report_queue_t *queue);
+
+/* Number of reports waiting, including the one being sent */
+uint8_t usb_report_queue_depth(usb_report_queue_t *queue);
+
+/* Queues a report of the given kind, merging it into the newest pending report
+ * of the same kind when `merge` allows. Returns false if the queue was full and
+ * a transition had to be given up -- the host still ends up in the right state
+ * whenever a pending report of the same kind could be overwritten. */
+bool usb_report_queue_push(usb_report_queue_t *queue, uint8_t kind, const void *data, uint8_t size, usb_report_merge_t merge, uint16_t now);
+
+/* Returns the next report to send, marking it in flight, or NULL if there is
+ * nothing to send or a report is already in flight */
+usb_report_queue_entry_t *usb_report_queue_start(usb_report_queue_t *queue);
+
+/* Releases the report in flight, once its transfer has completed */
+void usb_report_queue_complete(usb_report_queue_t *queue, uint16_t now);
+
+/* Merge policies for the standard report layouts */
+
+/* Every bit is an independent button or key, as in NKRO and programmable button reports */
+bool usb_report_merge_bits(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size);
+
+/* 6KRO keyboard reports: bitwise leading bytes followed by KEYBOARD_REPORT_KEYS keycodes */
+bool usb_report_merge_keys(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size);
+
+/* The report holds a single value, such as a consumer or system control usage */
+bool usb_report_merge_value(const uint8_t *prev, uint8_t *pending, const uint8_t *next, uint8_t size);